@@ -0,0 +1,413 @@
+#ifndef BATCH_RING_H
+#define BATCH_RING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace fleet {
+
+namespace detail {
+
+// Bounded lock-free MPMC queue of trivially copyable values (Vyukov's
+// sequence-numbered ring). Capacity is rounded up to a power of two.
+template <typename T>
+class RingQueue {
+public:
+    explicit RingQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+
+    bool try_push(T value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    size_t mask_ = 0;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+// Waits for a lock-free condition: retries, then yields, then sleeps on a
+// condition variable. notify() only takes the mutex when someone sleeps,
+// so the uncontended hand-off stays lock-free.
+class Parker {
+public:
+    // Wait until ready() returns true; ready() may have side effects
+    // (a successful try_pop) and is never called after it returned true
+    template <typename Ready>
+    void wait(Ready&& ready) {
+        for (int i = 0; i < 64; i++) {
+            if (ready()) return;
+        }
+        for (int i = 0; i < 16; i++) {
+            if (ready()) return;
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleepers_.fetch_add(1, std::memory_order_acq_rel);
+        cv_.wait(lock, ready);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Call after making a waiter's condition true. Both sides update
+    // sleepers_ with a read-modify-write, so either this sees the sleeper or
+    // the sleeper's re-check sees the new state.
+    void notify() {
+        if (sleepers_.fetch_add(0, std::memory_order_acq_rel) == 0) return;
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        cv_.notify_all();
+    }
+
+private:
+    std::atomic<int> sleepers_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+}  // namespace detail
+
+// Bounded ring of reusable batch slots between parser threads and sinks.
+//
+// Producers acquire() an empty slot, fill it and publish() it; every sink
+// then sees the batch on its own thread, so parsing, aggregation and
+// writing overlap instead of running in turn inside one callback. Once the
+// last sink is done the slot is clear()ed and handed back to acquire(),
+// keeping its capacity, so steady-state streaming allocates nothing.
+// acquire() blocks while every slot is in flight: that is the
+// backpressure on the parser when a sink falls behind.
+//
+// Hand-offs go through lock-free queues of slot indices; threads only
+// sleep on a mutex when there is nothing to do. Any number of threads may
+// acquire and publish (one producer gives an SPSC ring per sink); with a
+// single producer every sink sees batches in publish order (see
+// OrderedPublisher for parallel producers that must keep an order). A sink
+// that throws stops receiving batches; from then on failed() is true and
+// acquire() rethrows its error, so producers stop instead of parsing into
+// a ring nobody drains, and close() rethrows it too.
+template <typename Batch>
+class BatchRing {
+public:
+    using Sink = std::function<void(const Batch&)>;
+
+    BatchRing(size_t slots, std::vector<Sink> sinks)
+        : slot_count_(slots == 0 ? 1 : slots),
+          slots_(new Slot[slot_count_]),
+          free_(slot_count_) {
+        for (size_t i = 0; i < slot_count_; i++) free_.try_push(i);
+        for (auto& sink : sinks) {
+            lanes_.push_back(std::make_unique<Lane>(std::move(sink), slot_count_));
+        }
+        for (auto& lane : lanes_) {
+            Lane* l = lane.get();
+            l->thread = std::thread([this, l]() { run_sink(*l); });
+        }
+    }
+
+    ~BatchRing() {
+        try {
+            close();
+        } catch (...) {
+            // Reported by an explicit close(); a destructor cannot
+        }
+    }
+
+    BatchRing(const BatchRing&) = delete;
+    BatchRing& operator=(const BatchRing&) = delete;
+
+    // Index of an empty slot; blocks while all slots are in flight. Throws
+    // the first sink error once a sink has failed.
+    size_t acquire() {
+        size_t slot = 0;
+        if (failed()) std::rethrow_exception(error_);
+        if (!free_.try_pop(slot)) {
+            stalls_.fetch_add(1, std::memory_order_relaxed);
+            free_parker_.wait([&]() { return failed() || free_.try_pop(slot); });
+            if (failed()) std::rethrow_exception(error_);
+        }
+        return slot;
+    }
+
+    Batch& operator[](size_t slot) { return slots_[slot].batch; }
+
+    // Hand a filled slot to every sink
+    void publish(size_t slot) {
+        published_.fetch_add(1, std::memory_order_relaxed);
+        if (lanes_.empty()) {
+            recycle(slot);
+            return;
+        }
+        slots_[slot].pending.store(lanes_.size(), std::memory_order_relaxed);
+        for (auto& lane : lanes_) {
+            // Never full: a lane queue holds every slot
+            while (!lane->queue.try_push(slot)) std::this_thread::yield();
+            lane->parker.notify();
+        }
+    }
+
+    // Return an acquired slot without publishing it
+    void discard(size_t slot) { recycle(slot); }
+
+    // Once every producer is done: let the sinks drain, join them and
+    // rethrow the first sink error
+    void close() {
+        if (closed_) return;
+        closed_ = true;
+        closing_.store(true, std::memory_order_release);
+        for (auto& lane : lanes_) lane->parker.notify();
+        for (auto& lane : lanes_) {
+            if (lane->thread.joinable()) lane->thread.join();
+        }
+        if (failed()) std::rethrow_exception(error_);
+    }
+
+    // True once a sink has thrown
+    bool failed() const { return failed_.load(std::memory_order_acquire); }
+
+    size_t slots() const { return slot_count_; }
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    // acquire() calls that found no free slot (sinks behind the producers)
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        Batch batch;
+        std::atomic<size_t> pending{0};   // sinks yet to see the batch
+    };
+
+    struct Lane {
+        Lane(Sink s, size_t capacity) : sink(std::move(s)), queue(capacity) {}
+        Sink sink;
+        detail::RingQueue<size_t> queue;
+        detail::Parker parker;
+        std::thread thread;
+        bool failed = false;
+    };
+
+    void recycle(size_t slot) {
+        slots_[slot].batch.clear();
+        free_.try_push(slot);   // never full: it holds every slot
+        free_parker_.notify();
+    }
+
+    // Keep the first sink error and wake producers waiting for a slot
+    void record_error(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (failed_.load(std::memory_order_relaxed)) return;
+            error_ = error;   // written once, before failed_ publishes it
+            failed_.store(true, std::memory_order_release);
+        }
+        free_parker_.notify();
+    }
+
+    void run_sink(Lane& lane) {
+        for (;;) {
+            size_t slot = 0;
+            bool got = false;
+            lane.parker.wait([&]() {
+                got = lane.queue.try_pop(slot);
+                return got || closing_.load(std::memory_order_acquire);
+            });
+            if (!got && !lane.queue.try_pop(slot)) return;
+
+            if (!lane.failed) {
+                try {
+                    lane.sink(slots_[slot].batch);
+                } catch (...) {
+                    lane.failed = true;
+                    record_error(std::current_exception());
+                }
+            }
+            if (slots_[slot].pending.fetch_sub(1, std::memory_order_acq_rel) == 1) recycle(slot);
+        }
+    }
+
+    size_t slot_count_;
+    std::unique_ptr<Slot[]> slots_;
+    detail::RingQueue<size_t> free_;
+    detail::Parker free_parker_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::atomic<bool> closing_{false};
+    bool closed_ = false;
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+    std::atomic<bool> failed_{false};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> stalls_{0};
+};
+
+// Keeps batches from parallel producers in sequence order on a BatchRing.
+//
+// The input is split into numbered sequences (e.g. file chunks), each
+// filled by one producer straight into ring slots. The producer of the
+// earliest unfinished sequence, the head, publishes its slots as it fills
+// them; the others park theirs until every sequence before them is done.
+// Sinks therefore see batches in sequence order without a copy or a
+// hand-off through another thread. Parked slots draw on slots() - 1
+// credits, so the head can always get a slot once the sinks free one; a
+// producer that needs a slot while out of credits waits to become head.
+//
+// A producer that fails calls fail(): the slots parked so far are dropped,
+// later publish() calls discard their slot and acquire() throws, so the
+// other producers stop too. rethrow() reports the first failure.
+template <typename Batch>
+class OrderedPublisher {
+public:
+    OrderedPublisher(BatchRing<Batch>& ring, size_t sequences)
+        : ring_(ring),
+          credits_(ring.slots() - 1),
+          parked_(sequences),
+          held_(sequences, 0),
+          done_(sequences, false) {}
+
+    OrderedPublisher(const OrderedPublisher&) = delete;
+    OrderedPublisher& operator=(const OrderedPublisher&) = delete;
+
+    // An empty slot for sequence; blocks while the sequence may not take
+    // one yet, then like BatchRing::acquire()
+    size_t acquire(size_t sequence) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]() { return error_ || head_ == sequence || credits_ > 0; });
+            if (error_) throw std::runtime_error("Ordered publishing stopped by an earlier failure");
+            if (head_ != sequence) {
+                credits_--;
+                held_[sequence]++;
+            }
+        }
+        return ring_.acquire();
+    }
+
+    Batch& operator[](size_t slot) { return ring_[slot]; }
+
+    // Publish now if sequence is the head, else park the slot
+    void publish(size_t sequence, size_t slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) {
+            ring_.discard(slot);
+        } else if (head_ == sequence) {
+            ring_.publish(slot);
+        } else {
+            parked_[sequence].push_back(slot);
+        }
+    }
+
+    // Return an acquired slot unpublished
+    void discard(size_t sequence, size_t slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (head_ != sequence && !error_) {
+            held_[sequence]--;
+            credits_++;
+        }
+        ring_.discard(slot);
+        cv_.notify_all();
+    }
+
+    // sequence has published its last slot
+    void finish(size_t sequence) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_[sequence] = true;
+        if (error_) return;
+        // Move the head past finished sequences, publishing what they parked
+        while (head_ < done_.size()) {
+            for (size_t slot : parked_[head_]) ring_.publish(slot);
+            parked_[head_].clear();
+            credits_ += held_[head_];
+            held_[head_] = 0;
+            if (!done_[head_]) break;
+            head_++;
+        }
+        cv_.notify_all();
+    }
+
+    void fail(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) return;
+        error_ = error;
+        // Free parked slots for producers still blocked in the ring
+        for (auto& parked : parked_) {
+            for (size_t slot : parked) ring_.discard(slot);
+            parked.clear();
+        }
+        cv_.notify_all();
+    }
+
+    // Throw the first failure, if any
+    void rethrow() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+    BatchRing<Batch>& ring_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t head_ = 0;
+    size_t credits_;
+    std::vector<std::vector<size_t>> parked_;
+    std::vector<size_t> held_;       // credits taken per sequence
+    std::vector<bool> done_;
+    std::exception_ptr error_;
+};
+
+}  // namespace fleet
+
+#endif  // BATCH_RING_H
@@ -0,0 +1,183 @@
+#include "batch_validator.h"
+#include "simd_scanner.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FLEET_VALIDATE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace fleet {
+
+// ============================================================================
+// BatchValidation implementation
+// ============================================================================
+
+void BatchValidation::begin(size_t n) {
+    rows = n;
+    valid.assign((n + 63) / 64, 0);
+    valid_rows = 0;
+    std::fill(std::begin(rejected), std::end(rejected), 0);
+}
+
+void BatchValidation::finish() {
+    size_t invalid_rows = 0;
+    for (uint64_t& word : valid) {
+        invalid_rows += __builtin_popcountll(word);
+        word = ~word;
+    }
+    // Rows past the end are neither valid nor counted
+    if (rows % 64) valid.back() &= (uint64_t(1) << (rows % 64)) - 1;
+    valid_rows = rows - invalid_rows;
+}
+
+namespace detail {
+
+namespace {
+
+// Merge one word of rule failures; returns the rows it newly rejects
+inline size_t merge_failures(uint64_t* invalid, size_t word, uint64_t failed) {
+    size_t fresh = __builtin_popcountll(failed & ~invalid[word]);
+    invalid[word] |= failed;
+    return fresh;
+}
+
+// Rows [begin, n) one at a time; begin is a multiple of 64
+template <typename T, typename Fail>
+size_t reject_tail(const T* column, size_t begin, size_t n, uint64_t* invalid, Fail fail) {
+    size_t rejected = 0;
+    for (size_t base = begin; base < n; base += 64) {
+        uint64_t failed = 0;
+        size_t count = std::min<size_t>(64, n - base);
+        for (size_t j = 0; j < count; j++) {
+            failed |= static_cast<uint64_t>(fail(column[base + j])) << j;
+        }
+        rejected += merge_failures(invalid, base / 64, failed);
+    }
+    return rejected;
+}
+
+// Portable kernel: the compares go to a byte per row in a loop the
+// compiler can vectorize, then eight bytes at a time are packed into bits
+template <typename T, typename Fail>
+size_t reject_scalar(const T* column, size_t n, uint64_t* invalid, Fail fail) {
+    size_t rejected = 0;
+    size_t base = 0;
+    for (; base + 64 <= n; base += 64) {
+        uint8_t flags[64];
+        for (size_t j = 0; j < 64; j++) flags[j] = fail(column[base + j]);
+        uint64_t failed = 0;
+        for (size_t j = 0; j < 64; j += 8) {
+            uint64_t bytes;
+            std::memcpy(&bytes, flags + j, sizeof(bytes));
+            failed |= ((bytes * 0x0102040810204080ull) >> 56) << j;
+        }
+        rejected += merge_failures(invalid, base / 64, failed);
+    }
+    return rejected + reject_tail(column, base, n, invalid, fail);
+}
+
+template <typename T>
+size_t range_scalar(const T* column, size_t n, T min, T max, uint64_t* invalid) {
+    return reject_scalar(column, n, invalid, [min, max](T v) { return (v < min) | (v > max); });
+}
+
+size_t zero_scalar(const uint32_t* column, size_t n, uint64_t* invalid) {
+    return reject_scalar(column, n, invalid, [](uint32_t v) { return v == 0; });
+}
+
+#if FLEET_VALIDATE_X86
+
+// One 64-row word per outer iteration: 16 x 4 doubles or 8 x 8 ints,
+// each compare pair folded into the word with movemask
+
+__attribute__((target("avx2")))
+size_t range_avx2(const double* column, size_t n, double min, double max, uint64_t* invalid) {
+    const __m256d lo = _mm256_set1_pd(min);
+    const __m256d hi = _mm256_set1_pd(max);
+    size_t rejected = 0;
+    size_t base = 0;
+    for (; base + 64 <= n; base += 64) {
+        uint64_t failed = 0;
+        for (size_t j = 0; j < 64; j += 4) {
+            __m256d v = _mm256_loadu_pd(column + base + j);
+            __m256d out = _mm256_or_pd(_mm256_cmp_pd(v, lo, _CMP_LT_OQ), _mm256_cmp_pd(v, hi, _CMP_GT_OQ));
+            failed |= static_cast<uint64_t>(_mm256_movemask_pd(out)) << j;
+        }
+        rejected += merge_failures(invalid, base / 64, failed);
+    }
+    return rejected + reject_tail(column, base, n, invalid,
+                                  [min, max](double v) { return (v < min) | (v > max); });
+}
+
+__attribute__((target("avx2")))
+size_t range_avx2(const int32_t* column, size_t n, int32_t min, int32_t max, uint64_t* invalid) {
+    const __m256i lo = _mm256_set1_epi32(min);
+    const __m256i hi = _mm256_set1_epi32(max);
+    size_t rejected = 0;
+    size_t base = 0;
+    for (; base + 64 <= n; base += 64) {
+        uint64_t failed = 0;
+        for (size_t j = 0; j < 64; j += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + base + j));
+            __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+            failed |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(out))) << j;
+        }
+        rejected += merge_failures(invalid, base / 64, failed);
+    }
+    return rejected + reject_tail(column, base, n, invalid,
+                                  [min, max](int32_t v) { return (v < min) | (v > max); });
+}
+
+__attribute__((target("avx2")))
+size_t zero_avx2(const uint32_t* column, size_t n, uint64_t* invalid) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t rejected = 0;
+    size_t base = 0;
+    for (; base + 64 <= n; base += 64) {
+        uint64_t failed = 0;
+        for (size_t j = 0; j < 64; j += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + base + j));
+            __m256i out = _mm256_cmpeq_epi32(v, zero);
+            failed |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(out))) << j;
+        }
+        rejected += merge_failures(invalid, base / 64, failed);
+    }
+    return rejected + reject_tail(column, base, n, invalid, [](uint32_t v) { return v == 0; });
+}
+
+// Kernels follow the scanner's choice, so FLEET_SIMD=scalar forces both
+bool use_avx2() {
+    static const bool avx2 = StructuralScanner::detect_kernel() == ScanKernel::AVX2;
+    return avx2;
+}
+
+#endif  // FLEET_VALIDATE_X86
+
+}  // namespace
+
+size_t reject_out_of_range(const double* column, size_t n, double min, double max, uint64_t* invalid) {
+#if FLEET_VALIDATE_X86
+    if (use_avx2()) return range_avx2(column, n, min, max, invalid);
+#endif
+    return range_scalar(column, n, min, max, invalid);
+}
+
+size_t reject_out_of_range(const int32_t* column, size_t n, int32_t min, int32_t max, uint64_t* invalid) {
+#if FLEET_VALIDATE_X86
+    if (use_avx2()) return range_avx2(column, n, min, max, invalid);
+#endif
+    return range_scalar(column, n, min, max, invalid);
+}
+
+size_t reject_zero(const uint32_t* column, size_t n, uint64_t* invalid) {
+#if FLEET_VALIDATE_X86
+    if (use_avx2()) return zero_avx2(column, n, invalid);
+#endif
+    return zero_scalar(column, n, invalid);
+}
+
+}  // namespace detail
+
+}  // namespace fleet
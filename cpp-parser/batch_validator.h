@@ -0,0 +1,165 @@
+#ifndef BATCH_VALIDATOR_H
+#define BATCH_VALIDATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "parse_profile.h"
+#include "telemetry_batch.h"
+
+namespace fleet {
+
+// ============================================================================
+// Columnar batch validation
+// ============================================================================
+//
+// Runs the range rules over whole TelemetryBatch columns at once instead of
+// calling is_valid() per record. Each rule is one compare kernel over one
+// contiguous column (AVX2 where the CPU has it, see StructuralScanner for
+// the FLEET_SIMD override) that ORs its failures into a bitmap, 64 rows
+// per word. The rule set is a template parameter list, so a rule that is
+// not listed costs nothing at run time:
+//
+//   BatchValidation result;
+//   validate_batch(batch, result);                        // is_valid() rules
+//
+//   struct HotEngine { static constexpr double min = -40, max = 130; };
+//   using Strict = ValidationRules<VehicleIdRule, LatitudeRule, LongitudeRule,
+//                                  EngineTempRule<HotEngine>>;
+//   validate_batch<Strict>(batch, result);
+//
+// Rules are checked in list order and a rejected row is counted under the
+// first rule it broke, matching ParseStats::rejected.
+
+// Validity mask and reject counts for one batch
+struct BatchValidation {
+    std::vector<uint64_t> valid;          // bit i of word i / 64 set = row i passed
+    size_t rows = 0;
+    size_t valid_rows = 0;
+    size_t rejected[kRejectReasonCount] = {};
+
+    bool is_valid(size_t i) const { return (valid[i >> 6] >> (i & 63)) & 1; }
+    size_t rejected_by(RejectReason reason) const { return rejected[static_cast<size_t>(reason)]; }
+
+    // Start a batch of n rows with no failures recorded (valid holds the
+    // failure bits until finish() inverts them)
+    void begin(size_t n);
+    void record(RejectReason reason, size_t newly_rejected) {
+        rejected[static_cast<size_t>(reason)] += newly_rejected;
+    }
+    void finish();
+};
+
+namespace detail {
+
+// Set bit i of invalid when column[i] is outside [min, max]; returns how
+// many of those rows were not already marked
+size_t reject_out_of_range(const double* column, size_t n, double min, double max, uint64_t* invalid);
+size_t reject_out_of_range(const int32_t* column, size_t n, int32_t min, int32_t max, uint64_t* invalid);
+
+// Same for column[i] == 0 (the empty dictionary code)
+size_t reject_zero(const uint32_t* column, size_t n, uint64_t* invalid);
+
+}  // namespace detail
+
+// Row passes when Bounds::min <= (batch.*Column)[i] <= Bounds::max
+template <auto Column, RejectReason Reason, typename Bounds>
+struct RangeRule {
+    static constexpr RejectReason reason = Reason;
+
+    static size_t apply(const TelemetryBatch& batch, uint64_t* invalid) {
+        const auto& column = batch.*Column;
+        using T = typename std::decay_t<decltype(column)>::value_type;
+        return detail::reject_out_of_range(column.data(), column.size(),
+                                           static_cast<T>(Bounds::min),
+                                           static_cast<T>(Bounds::max), invalid);
+    }
+};
+
+// Row passes when its dictionary code is not the empty string
+template <auto Column, RejectReason Reason>
+struct NonEmptyRule {
+    static constexpr RejectReason reason = Reason;
+
+    static size_t apply(const TelemetryBatch& batch, uint64_t* invalid) {
+        const auto& column = batch.*Column;
+        return detail::reject_zero(column.data(), column.size(), invalid);
+    }
+};
+
+// Bounds of the per-record is_valid() rules
+struct LatitudeBounds {
+    static constexpr double min = -90.0;
+    static constexpr double max = 90.0;
+};
+struct LongitudeBounds {
+    static constexpr double min = -180.0;
+    static constexpr double max = 180.0;
+};
+struct SpeedBounds {
+    static constexpr double min = 0.0;
+    static constexpr double max = std::numeric_limits<double>::infinity();
+};
+struct FuelLevelBounds {
+    static constexpr double min = 0.0;
+    static constexpr double max = 100.0;
+};
+struct EngineRpmBounds {
+    static constexpr int32_t min = 0;
+    static constexpr int32_t max = std::numeric_limits<int32_t>::max();
+};
+
+// Defaults for the opt-in engine_temp / battery_volt rules
+struct EngineTempBounds {
+    static constexpr double min = -40.0;
+    static constexpr double max = 150.0;
+};
+struct BatteryVoltBounds {
+    static constexpr double min = 9.0;
+    static constexpr double max = 16.0;
+};
+
+using VehicleIdRule = NonEmptyRule<&TelemetryBatch::vehicle_id, RejectReason::MissingVehicleId>;
+using LatitudeRule = RangeRule<&TelemetryBatch::latitude, RejectReason::Latitude, LatitudeBounds>;
+using LongitudeRule = RangeRule<&TelemetryBatch::longitude, RejectReason::Longitude, LongitudeBounds>;
+using SpeedRule = RangeRule<&TelemetryBatch::speed, RejectReason::Speed, SpeedBounds>;
+using FuelLevelRule = RangeRule<&TelemetryBatch::fuel_level, RejectReason::FuelLevel, FuelLevelBounds>;
+using EngineRpmRule = RangeRule<&TelemetryBatch::engine_rpm, RejectReason::EngineRpm, EngineRpmBounds>;
+
+template <typename Bounds = EngineTempBounds>
+using EngineTempRule = RangeRule<&TelemetryBatch::engine_temp, RejectReason::EngineTemp, Bounds>;
+template <typename Bounds = BatteryVoltBounds>
+using BatteryVoltRule = RangeRule<&TelemetryBatch::battery_volt, RejectReason::BatteryVolt, Bounds>;
+
+// A compile-time rule set
+template <typename... Rules>
+struct ValidationRules {
+    static void apply(const TelemetryBatch& batch, BatchValidation& out) {
+        out.begin(batch.size());
+        uint64_t* invalid = out.valid.data();
+        (out.record(Rules::reason, Rules::apply(batch, invalid)), ...);
+        out.finish();
+    }
+};
+
+// Same rules as TelemetryData::is_valid()
+using DefaultRules = ValidationRules<VehicleIdRule, LatitudeRule, LongitudeRule,
+                                     SpeedRule, FuelLevelRule, EngineRpmRule>;
+
+template <typename Rules = DefaultRules>
+void validate_batch(const TelemetryBatch& batch, BatchValidation& out) {
+    Rules::apply(batch, out);
+}
+
+template <typename Rules = DefaultRules>
+BatchValidation validate_batch(const TelemetryBatch& batch) {
+    BatchValidation out;
+    Rules::apply(batch, out);
+    return out;
+}
+
+}  // namespace fleet
+
+#endif  // BATCH_VALIDATOR_H
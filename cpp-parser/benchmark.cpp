@@ -0,0 +1,970 @@
+// Fleet parser benchmark suite (Google Benchmark).
+//
+// Build with -DBUILD_BENCHMARK=ON, then:
+//
+//   ./fleet_benchmark                          micro benchmarks + 1M-row datasets
+//   ./fleet_benchmark --rows=1000000,10000000,100000000 --vehicles=10,1000,100000
+//   ./fleet_benchmark --benchmark_filter=Macro --benchmark_repetitions=10
+//
+// Every benchmark reports bytes/s and items/s (rows or fields). Runs are
+// repeated (5 times unless --benchmark_repetitions is given) and p50 / p90 /
+// p99 aggregates are reported next to mean, median and stddev.
+//
+// Macro datasets are CSV files in the generate_data.py layout, written once
+// to --data-dir (default /tmp) and reused by later runs; the first timed
+// iteration reads them from the page cache like any warm re-parse.
+
+#include "batch_ring.h"
+#include "batch_validator.h"
+#include "binary_format.h"
+#include "columnar_export.h"
+#include "fast_decode.h"
+#include "file_set.h"
+#include "read_ahead.h"
+#include "record_arena.h"
+#include "record_sorter.h"
+#include "record_writer.h"
+#include "sqlite_loader.h"
+#include "telemetry_batch.h"
+#include "telemetry_parser.h"
+#include "timestamp.h"
+#include "vehicle_aggregator.h"
+#include "window_rollup.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// ============================================================================
+// Inputs
+// ============================================================================
+
+// The pre-fast_decode.h TelemetryParser::fast_stod, kept as the baseline
+double legacy_stod(const char* str, size_t len) {
+    if (len == 0) return 0.0;
+
+    double result = 0.0;
+    double sign = 1.0;
+    size_t i = 0;
+
+    if (str[0] == '-') {
+        sign = -1.0;
+        i = 1;
+    } else if (str[0] == '+') {
+        i = 1;
+    }
+
+    while (i < len && str[i] >= '0' && str[i] <= '9') {
+        result = result * 10.0 + (str[i] - '0');
+        i++;
+    }
+
+    if (i < len && str[i] == '.') {
+        i++;
+        double factor = 0.1;
+        while (i < len && str[i] >= '0' && str[i] <= '9') {
+            result += (str[i] - '0') * factor;
+            factor *= 0.1;
+            i++;
+        }
+    }
+
+    return result * sign;
+}
+
+// Float field shapes seen in production feeds
+std::vector<std::string> make_float_corpus(size_t count) {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> lat(-90.0, 90.0);
+    std::uniform_real_distribution<double> pct(0.0, 100.0);
+    std::vector<std::string> corpus;
+    corpus.reserve(count);
+
+    char buf[64];
+    for (size_t i = 0; i < count; i++) {
+        switch (i % 4) {
+            case 0: std::snprintf(buf, sizeof(buf), "%.6f", lat(rng)); break;   // GPS
+            case 1: std::snprintf(buf, sizeof(buf), "%.1f", pct(rng)); break;   // gauges
+            case 2: std::snprintf(buf, sizeof(buf), "%.2f", pct(rng) * 1000); break;
+            default: std::snprintf(buf, sizeof(buf), "%.17g", lat(rng)); break; // Python repr
+        }
+        corpus.emplace_back(buf);
+    }
+    return corpus;
+}
+
+std::vector<std::string> make_int_corpus(size_t count) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> rpm(800, 6000);
+    std::vector<std::string> corpus;
+    corpus.reserve(count);
+    for (size_t i = 0; i < count; i++) corpus.push_back(std::to_string(rpm(rng)));
+    return corpus;
+}
+
+// ISO 8601 date-time with microseconds, as written by generate_data.py
+void put_iso_timestamp(std::string& out, uint64_t ms) {
+    const uint64_t secs = ms / 1000;
+    char buf[40];
+    int n = std::snprintf(buf, sizeof(buf), "2024-01-%02uT%02u:%02u:%02u.%03u000",
+                          static_cast<unsigned>(1 + secs / 86400),
+                          static_cast<unsigned>(secs / 3600 % 24),
+                          static_cast<unsigned>(secs / 60 % 60),
+                          static_cast<unsigned>(secs % 60),
+                          static_cast<unsigned>(ms % 1000));
+    out.append(buf, n);
+}
+
+std::vector<std::string> make_timestamp_corpus(size_t count, bool iso) {
+    std::vector<std::string> corpus;
+    corpus.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t ms = i * 1237;
+        std::string s;
+        if (iso) {
+            put_iso_timestamp(s, ms);
+        } else {
+            s = std::to_string(1704067200000ull + ms);
+        }
+        corpus.push_back(std::move(s));
+    }
+    return corpus;
+}
+
+void put_double(std::string& out, double value) {
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);  // shortest round-trip, like Python repr
+    out.append(buf, res.ptr);
+}
+
+// Append rows [first, first + count) of the synthetic fleet to out as CSV
+void append_csv_rows(std::string& out, uint64_t first, uint64_t count, uint64_t vehicles) {
+    static const char* const kCodes[] = {"", "", "", "", "", "", "", "",
+                                         "P0420", "P0171", "P0300", "P0442"};
+    std::mt19937_64 rng(first * 0x9E3779B97F4A7C15ull + vehicles);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    char buf[32];
+
+    for (uint64_t i = first; i < first + count; i++) {
+        const uint64_t v = i % vehicles;
+        out += "VEH-";
+        int n = std::snprintf(buf, sizeof(buf), "%03llu", static_cast<unsigned long long>(v + 1));
+        out.append(buf, n);
+        out += ',';
+        put_iso_timestamp(out, i * 10);
+        out += ',';
+        put_double(out, 28.5 + (unit(rng) - 0.5) * 0.01);
+        out += ',';
+        put_double(out, -81.3 + (unit(rng) - 0.5) * 0.01);
+        out += ',';
+        put_double(out, unit(rng) * 120);
+        out += ',';
+        put_double(out, unit(rng) * 360);
+        out += ',';
+        out += std::to_string(800 + static_cast<int>(unit(rng) * 5200));
+        out += ',';
+        put_double(out, 15 + unit(rng) * 85);
+        out += ',';
+        put_double(out, 50000 + static_cast<double>(v) * 7 + static_cast<double>(i / vehicles) * 0.01);
+        out += ',';
+        put_double(out, 75 + unit(rng) * 35);
+        out += ',';
+        put_double(out, 11.5 + unit(rng) * 2.5);
+        out += ',';
+        out += kCodes[i % 12];
+        out += '\n';
+    }
+}
+
+const char* const kCsvHeader =
+    "vehicle_id,timestamp,latitude,longitude,speed,heading,engine_rpm,"
+    "fuel_level,odometer_km,engine_temp,battery_volt,diagnostic_code\n";
+
+// In-memory sample rows for the row-level benchmarks
+std::vector<std::string> make_lines(size_t count, uint64_t vehicles) {
+    std::string text;
+    append_csv_rows(text, 0, count, vehicles);
+    std::vector<std::string> lines;
+    lines.reserve(count);
+    size_t start = 0;
+    for (size_t nl; (nl = text.find('\n', start)) != std::string::npos; start = nl + 1) {
+        lines.emplace_back(text, start, nl - start);
+    }
+    return lines;
+}
+
+std::vector<fleet::TelemetryData> make_records(size_t count) {
+    fleet::TelemetryParser parser;
+    std::vector<fleet::TelemetryData> records;
+    records.reserve(count);
+    for (const auto& line : make_lines(count, 100)) {
+        if (auto data = parser.parse_line(line)) records.push_back(std::move(*data));
+    }
+    return records;
+}
+
+size_t total_bytes(const std::vector<std::string>& corpus) {
+    size_t bytes = 0;
+    for (const auto& s : corpus) bytes += s.size();
+    return bytes;
+}
+
+void set_throughput(benchmark::State& state, size_t items, size_t bytes) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * items));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+// Sink for serializer benchmarks: measures formatting, not the page cache
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+std::string temp_path(const std::string& name) {
+    const char* dir = std::getenv("TMPDIR");
+    return std::string(dir && *dir ? dir : "/tmp") + "/" + name;
+}
+
+uint64_t ulp_distance(double a, double b) {
+    int64_t ia, ib;
+    std::memcpy(&ia, &a, sizeof(a));
+    std::memcpy(&ib, &b, sizeof(b));
+    return static_cast<uint64_t>(ia > ib ? ia - ib : ib - ia);
+}
+
+// Percentile over the repetitions of one benchmark
+template <int P>
+double percentile(const std::vector<double>& values) {
+    if (values.empty()) return 0;
+    std::vector<double> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    const double rank = (P / 100.0) * static_cast<double>(sorted.size() - 1);
+    const size_t lo = static_cast<size_t>(std::floor(rank));
+    const size_t hi = static_cast<size_t>(std::ceil(rank));
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - static_cast<double>(lo));
+}
+
+void add_percentiles(benchmark::internal::Benchmark* b) {
+    b->ComputeStatistics("p50", percentile<50>)
+     ->ComputeStatistics("p90", percentile<90>)
+     ->ComputeStatistics("p99", percentile<99>);
+}
+
+// ============================================================================
+// Micro benchmarks
+// ============================================================================
+
+void BM_FastStod(benchmark::State& state) {
+    const auto corpus = make_float_corpus(1 << 16);
+    uint64_t max_ulp = 0;
+    for (const auto& s : corpus) {
+        double v = 0;
+        fleet::fast_stod(s, v);
+        max_ulp = std::max(max_ulp, ulp_distance(v, std::strtod(s.c_str(), nullptr)));
+    }
+    for (auto _ : state) {
+        for (const auto& s : corpus) {
+            double v;
+            fleet::fast_stod(s, v);
+            benchmark::DoNotOptimize(v);
+        }
+    }
+    set_throughput(state, corpus.size(), total_bytes(corpus));
+    state.counters["max_ulp"] = static_cast<double>(max_ulp);
+}
+BENCHMARK(BM_FastStod)->Apply(add_percentiles);
+
+void BM_LegacyStod(benchmark::State& state) {
+    const auto corpus = make_float_corpus(1 << 16);
+    uint64_t max_ulp = 0;
+    for (const auto& s : corpus) {
+        max_ulp = std::max(max_ulp, ulp_distance(legacy_stod(s.data(), s.size()),
+                                                 std::strtod(s.c_str(), nullptr)));
+    }
+    for (auto _ : state) {
+        for (const auto& s : corpus) {
+            benchmark::DoNotOptimize(legacy_stod(s.data(), s.size()));
+        }
+    }
+    set_throughput(state, corpus.size(), total_bytes(corpus));
+    state.counters["max_ulp"] = static_cast<double>(max_ulp);
+}
+BENCHMARK(BM_LegacyStod)->Apply(add_percentiles);
+
+void BM_FastStoi(benchmark::State& state) {
+    const auto corpus = make_int_corpus(1 << 16);
+    for (auto _ : state) {
+        for (const auto& s : corpus) {
+            int v;
+            fleet::fast_stoi(s, v);
+            benchmark::DoNotOptimize(v);
+        }
+    }
+    set_throughput(state, corpus.size(), total_bytes(corpus));
+}
+BENCHMARK(BM_FastStoi)->Apply(add_percentiles);
+
+// Arg: 1 = ISO 8601, 0 = epoch milliseconds
+void BM_ParseTimestamp(benchmark::State& state) {
+    const auto corpus = make_timestamp_corpus(1 << 16, state.range(0) != 0);
+    for (auto _ : state) {
+        for (const auto& s : corpus) {
+            benchmark::DoNotOptimize(fleet::TelemetryParser::parse_timestamp(s));
+        }
+    }
+    set_throughput(state, corpus.size(), total_bytes(corpus));
+}
+BENCHMARK(BM_ParseTimestamp)->ArgName("iso")->Arg(1)->Arg(0)->Apply(add_percentiles);
+
+// Same, with the format sniffed once up front as the row parser does
+void BM_ParseTimestampKnownFormat(benchmark::State& state) {
+    const auto corpus = make_timestamp_corpus(1 << 16, state.range(0) != 0);
+    const fleet::TimestampFormat format = fleet::sniff_timestamp(corpus.front());
+    for (auto _ : state) {
+        for (const auto& s : corpus) {
+            int64_t ms;
+            benchmark::DoNotOptimize(fleet::parse_timestamp_as(s, format, ms));
+            benchmark::DoNotOptimize(ms);
+        }
+    }
+    set_throughput(state, corpus.size(), total_bytes(corpus));
+}
+BENCHMARK(BM_ParseTimestampKnownFormat)->ArgName("iso")->Arg(1)->Arg(0)->Apply(add_percentiles);
+
+void BM_SplitLine(benchmark::State& state) {
+    const auto lines = make_lines(1 << 14, 100);
+    fleet::TelemetryParser parser;
+    std::vector<std::string_view> fields;
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            parser.split_line(line, fields);
+            benchmark::DoNotOptimize(fields.data());
+        }
+    }
+    set_throughput(state, lines.size(), total_bytes(lines));
+}
+BENCHMARK(BM_SplitLine)->Apply(add_percentiles);
+
+void BM_ParseLine(benchmark::State& state) {
+    const auto lines = make_lines(1 << 14, 100);
+    fleet::TelemetryParser parser;
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            benchmark::DoNotOptimize(parser.parse_line(line));
+        }
+    }
+    set_throughput(state, lines.size(), total_bytes(lines));
+}
+BENCHMARK(BM_ParseLine)->Apply(add_percentiles);
+
+void BM_ParseLineCompact(benchmark::State& state) {
+    const auto lines = make_lines(1 << 14, 100);
+    fleet::TelemetryParser parser;
+    fleet::TelemetryRecord record;
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            benchmark::DoNotOptimize(parser.parse_line_compact(line, record));
+        }
+    }
+    set_throughput(state, lines.size(), total_bytes(lines));
+}
+BENCHMARK(BM_ParseLineCompact)->Apply(add_percentiles);
+
+// Arg: 1 = standard header (unrolled StandardSchema path), 0 = the same
+// rows under a header naming two columns in the other order, which forces
+// the dynamic column mapping
+void BM_ParseSchema(benchmark::State& state) {
+    std::string text = state.range(0)
+        ? std::string(kCsvHeader)
+        : std::string("vehicle_id,timestamp,latitude,longitude,speed,heading,engine_rpm,"
+                      "fuel_level,odometer_km,battery_volt,engine_temp,diagnostic_code\n");
+    const size_t header_bytes = text.size();
+    constexpr size_t kRows = 1 << 16;
+    append_csv_rows(text, 0, kRows, 100);
+    for (auto _ : state) {
+        fleet::TelemetryParser parser;
+        benchmark::DoNotOptimize(parser.parse_string(text).size());
+    }
+    set_throughput(state, kRows, text.size() - header_bytes);
+}
+BENCHMARK(BM_ParseSchema)->ArgName("fixed")->Arg(1)->Arg(0)->Apply(add_percentiles);
+
+// Arg: 1 = results and strings in a RecordArena, 0 = on the heap. Each
+// iteration parses a warm file and then drops every record.
+void BM_ParseFileArena(benchmark::State& state) {
+    const std::string path = temp_path("fleet_bench_arena.csv");
+    std::string text = kCsvHeader;
+    constexpr size_t kRows = 1 << 16;
+    append_csv_rows(text, 0, kRows, 100);
+    std::ofstream(path, std::ios::binary) << text;
+
+    fleet::RecordArena arena;
+    for (auto _ : state) {
+        fleet::TelemetryParser parser;
+        if (state.range(0)) {
+            benchmark::DoNotOptimize(parser.parse_file(path, &arena).size());
+            arena.release();
+        } else {
+            benchmark::DoNotOptimize(parser.parse_file(path).size());
+        }
+    }
+    set_throughput(state, kRows, text.size());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ParseFileArena)->ArgName("arena")->Arg(1)->Arg(0)->Apply(add_percentiles);
+
+// Arg: 1 = keep one vehicle of 100 through ParserConfig::filter, 0 = parse
+// every row and drop the others afterwards
+void BM_ParseFiltered(benchmark::State& state) {
+    std::string text = kCsvHeader;
+    constexpr size_t kRows = 1 << 16;
+    append_csv_rows(text, 0, kRows, 100);
+    fleet::ParserConfig config;
+    if (state.range(0)) config.filter.vehicle_ids = {"VEH-042"};
+    for (auto _ : state) {
+        fleet::TelemetryParser parser(config);
+        auto records = parser.parse_string(text);
+        records.erase(std::remove_if(records.begin(), records.end(),
+                                     [](const fleet::TelemetryData& r) { return r.vehicle_id != "VEH-042"; }),
+                      records.end());
+        benchmark::DoNotOptimize(records.size());
+    }
+    set_throughput(state, kRows, text.size());
+}
+BENCHMARK(BM_ParseFiltered)->ArgName("pushdown")->Arg(1)->Arg(0)->Apply(add_percentiles);
+
+// Range rules per record, as the row paths check them
+void BM_ValidateRecords(benchmark::State& state) {
+    const auto records = make_records(1 << 16);
+    for (auto _ : state) {
+        size_t valid = 0;
+        for (const auto& r : records) valid += r.is_valid();
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * records.size()));
+}
+BENCHMARK(BM_ValidateRecords)->Apply(add_percentiles);
+
+// Same rules as column kernels writing a validity bitmap
+void BM_ValidateBatch(benchmark::State& state) {
+    fleet::TelemetryBatch batch;
+    for (const auto& r : make_records(1 << 16)) batch.append(r);
+    fleet::BatchValidation validation;
+    for (auto _ : state) {
+        fleet::validate_batch(batch, validation);
+        benchmark::DoNotOptimize(validation.valid_rows);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+BENCHMARK(BM_ValidateBatch)->Apply(add_percentiles);
+
+// Arg: vehicles in the sample. Per-vehicle rollups from parsed records.
+void BM_AggregateRecords(benchmark::State& state) {
+    const auto lines = make_lines(1 << 16, static_cast<uint64_t>(state.range(0)));
+    fleet::TelemetryParser parser;
+    std::vector<fleet::TelemetryData> records;
+    for (const auto& line : lines) {
+        if (auto data = parser.parse_line(line)) records.push_back(std::move(*data));
+    }
+    for (auto _ : state) {
+        fleet::VehicleAggregator aggregator;
+        for (const auto& record : records) aggregator.add(record);
+        benchmark::DoNotOptimize(aggregator.record_count());
+    }
+    set_throughput(state, records.size(), total_bytes(lines));
+}
+BENCHMARK(BM_AggregateRecords)->ArgName("vehicles")->Arg(100)->Arg(10000)->Apply(add_percentiles);
+
+// Same rows from a TelemetryBatch: one lookup per dictionary code
+void BM_AggregateBatch(benchmark::State& state) {
+    const auto lines = make_lines(1 << 16, static_cast<uint64_t>(state.range(0)));
+    fleet::TelemetryParser parser;
+    fleet::TelemetryBatch batch;
+    for (const auto& line : lines) parser.parse_line_into(line, batch);
+    for (auto _ : state) {
+        fleet::VehicleAggregator aggregator;
+        aggregator.add(batch);
+        benchmark::DoNotOptimize(aggregator.record_count());
+    }
+    set_throughput(state, batch.size(), total_bytes(lines));
+}
+BENCHMARK(BM_AggregateBatch)->ArgName("vehicles")->Arg(100)->Arg(10000)->Apply(add_percentiles);
+
+// Arg: window length in seconds. Tumbling-window downsampling of records.
+void BM_WindowRollup(benchmark::State& state) {
+    const auto records = make_records(1 << 16);
+    fleet::WindowConfig config;
+    config.window_ms = state.range(0) * 1000;
+    for (auto _ : state) {
+        size_t windows = 0;
+        fleet::WindowRollup rollup(config, [&windows](fleet::TelemetryWindow&&) { windows++; });
+        for (const auto& record : records) rollup.add(record);
+        rollup.flush();
+        benchmark::DoNotOptimize(windows);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * records.size()));
+}
+BENCHMARK(BM_WindowRollup)->ArgName("window_s")->Arg(60)->Arg(3600)->Apply(add_percentiles);
+
+// Arg: 1 = RecordSorter (radix-sorted runs, in memory), 0 = std::stable_sort
+// of the records on (vehicle_id, timestamp). Input rows are shuffled.
+void BM_SortRecords(benchmark::State& state) {
+    auto records = make_records(1 << 16);
+    std::shuffle(records.begin(), records.end(), std::mt19937_64(42));
+    for (auto _ : state) {
+        size_t sorted = 0;
+        if (state.range(0)) {
+            fleet::RecordSorter sorter;
+            for (const auto& record : records) sorter.add(record);
+            sorter.finish([&sorted](fleet::TelemetryData&&) { sorted++; });
+        } else {
+            auto copy = records;
+            std::stable_sort(copy.begin(), copy.end(),
+                             [](const fleet::TelemetryData& a, const fleet::TelemetryData& b) {
+                                 int c = a.vehicle_id.compare(b.vehicle_id);
+                                 return c != 0 ? c < 0 : a.timestamp < b.timestamp;
+                             });
+            sorted = copy.size();
+        }
+        benchmark::DoNotOptimize(sorted);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * records.size()));
+}
+BENCHMARK(BM_SortRecords)->ArgName("radix")->Arg(1)->Arg(0)->Apply(add_percentiles);
+
+// Arg: 0 = ReadAhead on its reader thread, 1 = on io_uring (skipped where
+// the kernel refuses a ring). Drains a warm file block by block while the
+// "parse" counts rows in the previous block.
+void BM_ReadAhead(benchmark::State& state) {
+    const std::string path = temp_path("fleet_bench_read_ahead.csv");
+    std::string text = kCsvHeader;
+    constexpr size_t kRows = 1 << 18;
+    append_csv_rows(text, 0, kRows, 100);
+    std::ofstream(path, std::ios::binary) << text;
+
+    fleet::ReadAheadConfig config;
+    config.use_io_uring = state.range(0) != 0;
+    if (config.use_io_uring && std::string(fleet::ReadAhead(path, config).backend()) != "io_uring") {
+        state.SkipWithError("io_uring not available");
+        std::remove(path.c_str());
+        return;
+    }
+    for (auto _ : state) {
+        fleet::ReadAhead reader(path, config);
+        size_t rows = 0;
+        for (std::string_view block = reader.next(); !block.empty(); block = reader.next()) {
+            rows += static_cast<size_t>(std::count(block.begin(), block.end(), '\n'));
+        }
+        benchmark::DoNotOptimize(rows);
+    }
+    set_throughput(state, kRows, text.size());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ReadAhead)->ArgName("io_uring")->Arg(0)->Arg(1)->Apply(add_percentiles);
+
+// Arg: number of files the same 2^18 rows are spread over (1 = one file
+// split into chunks, 256 = small files batched into tasks), on all cores
+void BM_ParseFileSet(benchmark::State& state) {
+    const size_t files = static_cast<size_t>(state.range(0));
+    constexpr size_t kRows = 1 << 18;
+    std::vector<std::string> paths;
+    size_t bytes = 0;
+    for (size_t f = 0; f < files; f++) {
+        std::string text = kCsvHeader;
+        append_csv_rows(text, f * (kRows / files), kRows / files, 100);
+        paths.push_back(temp_path("fleet_bench_set_" + std::to_string(f) + ".csv"));
+        std::ofstream(paths.back(), std::ios::binary) << text;
+        bytes += text.size();
+    }
+
+    fleet::FileSetConfig config;
+    config.parser.num_threads = 0;
+    config.format = fleet::InputFormat::Csv;
+    config.chunk_bytes = 1 << 20;
+    for (auto _ : state) {
+        fleet::FileSetParser parser(config);
+        size_t records = 0;
+        parser.parse(paths, [&records](size_t, std::vector<fleet::TelemetryData>&& batch) {
+            records += batch.size();
+        });
+        benchmark::DoNotOptimize(records);
+    }
+    set_throughput(state, kRows, bytes);
+    for (const auto& path : paths) std::remove(path.c_str());
+}
+BENCHMARK(BM_ParseFileSet)->ArgName("files")->Arg(1)->Arg(256)->UseRealTime()->Apply(add_percentiles);
+
+// Arg: producer threads. 1024-row batches pass through an 8-slot ring to
+// two sinks (a row counter and a speed sum), i.e. the hand-off cost per
+// batch with slot recycling, not the cost of filling or consuming it.
+void BM_BatchRing(benchmark::State& state) {
+    const size_t producers = static_cast<size_t>(state.range(0));
+    constexpr size_t kBatchRows = 1024;
+    constexpr size_t kBatches = 4096;
+    fleet::TelemetryBatch source;
+    for (const auto& r : make_records(kBatchRows)) source.append(r);
+
+    for (auto _ : state) {
+        std::atomic<size_t> rows{0};
+        double speed = 0;
+        fleet::BatchRing<fleet::TelemetryBatch> ring(8, {
+            [&rows](const fleet::TelemetryBatch& batch) { rows += batch.size(); },
+            [&speed](const fleet::TelemetryBatch& batch) { speed += batch.speed.front(); },
+        });
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; p++) {
+            threads.emplace_back([&ring, &source, producers]() {
+                for (size_t b = 0; b < kBatches / producers; b++) {
+                    size_t slot = ring.acquire();
+                    ring[slot].append(source);
+                    ring.publish(slot);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        ring.close();
+        if (rows != kBatches * kBatchRows) state.SkipWithError("row count mismatch");
+        benchmark::DoNotOptimize(speed);
+    }
+    set_throughput(state, kBatches * kBatchRows, 0);
+}
+BENCHMARK(BM_BatchRing)->ArgName("producers")->Arg(1)->Arg(4)->UseRealTime()->Apply(add_percentiles);
+
+// Args: format version, codec
+void BM_BinaryWrite(benchmark::State& state) {
+    const auto records = make_records(1 << 16);
+    fleet::BinaryWriterConfig config;
+    config.version = static_cast<uint8_t>(state.range(0));
+    config.codec = static_cast<fleet::binary::Codec>(state.range(1));
+    if (!fleet::binary::codec_available(config.codec)) {
+        state.SkipWithError("codec not available in this build");
+        return;
+    }
+
+    NullBuffer null_buffer;
+    std::ostream sink(&null_buffer);
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        fleet::BinaryWriter writer(sink, config);
+        writer.write_batch(records);
+        writer.close();
+        bytes = writer.bytes_written();
+    }
+    set_throughput(state, records.size(), bytes);
+}
+BENCHMARK(BM_BinaryWrite)
+    ->ArgNames({"version", "codec"})
+    ->Args({1, static_cast<int>(fleet::binary::Codec::None)})
+    ->Args({2, static_cast<int>(fleet::binary::Codec::None)})
+    ->Args({2, static_cast<int>(fleet::binary::Codec::Zlib)})
+    ->Apply(add_percentiles);
+
+// Args: format version, codec. Whole-file parse_binary() of a warm file.
+void BM_BinaryRead(benchmark::State& state) {
+    const auto records = make_records(1 << 16);
+    fleet::BinaryWriterConfig config;
+    config.version = static_cast<uint8_t>(state.range(0));
+    config.codec = static_cast<fleet::binary::Codec>(state.range(1));
+    if (!fleet::binary::codec_available(config.codec)) {
+        state.SkipWithError("codec not available in this build");
+        return;
+    }
+
+    const std::string path = temp_path("fleet_bench_read_v" + std::to_string(state.range(0)) +
+                                       "_c" + std::to_string(state.range(1)) + ".fbin");
+    {
+        fleet::BinaryWriter writer(path, config);
+        writer.write_batch(records);
+        writer.close();
+    }
+    struct stat st;
+    ::stat(path.c_str(), &st);
+
+    for (auto _ : state) {
+        fleet::TelemetryParser parser;
+        benchmark::DoNotOptimize(parser.parse_binary(path));
+    }
+    set_throughput(state, records.size(), static_cast<size_t>(st.st_size));
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_BinaryRead)
+    ->ArgNames({"version", "codec"})
+    ->Args({1, static_cast<int>(fleet::binary::Codec::None)})
+    ->Args({2, static_cast<int>(fleet::binary::Codec::None)})
+    ->Args({2, static_cast<int>(fleet::binary::Codec::Zlib)})
+    ->Apply(add_percentiles);
+
+// Arg: 1 = a time range covering ~1% of a v2 file, so the block index
+// skips all but one or two blocks; 0 = parse the whole file
+void BM_BinaryReadRange(benchmark::State& state) {
+    const auto records = make_records(1 << 16);
+    const std::string path = temp_path("fleet_bench_range.fbin");
+    {
+        fleet::BinaryWriterConfig config;
+        config.version = fleet::binary::kVersion2;
+        fleet::BinaryWriter writer(path, config);
+        writer.write_batch(records);
+        writer.close();
+    }
+
+    fleet::ParserConfig config;
+    if (state.range(0)) {
+        config.filter.min_timestamp = records[records.size() / 2].timestamp;
+        config.filter.max_timestamp = records[records.size() / 2 + records.size() / 100].timestamp;
+    }
+    for (auto _ : state) {
+        fleet::TelemetryParser parser(config);
+        benchmark::DoNotOptimize(parser.parse_binary(path));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * records.size()));
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_BinaryReadRange)->ArgName("range")->Arg(1)->Arg(0)->Apply(add_percentiles);
+
+void BM_AppendJson(benchmark::State& state) {
+    const auto records = make_records(1 << 14);
+    std::string out;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        out.clear();
+        for (const auto& record : records) fleet::append_json(out, record);
+        bytes = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_throughput(state, records.size(), bytes);
+}
+BENCHMARK(BM_AppendJson)->Apply(add_percentiles);
+
+// Arg: fleet::OutputFormat
+void BM_RecordWriter(benchmark::State& state) {
+    const auto records = make_records(1 << 14);
+    const auto format = static_cast<fleet::OutputFormat>(state.range(0));
+
+    // One pass to learn the output size
+    std::ostringstream sized;
+    {
+        fleet::RecordWriter writer(sized, format);
+        for (const auto& record : records) writer.write(record);
+    }
+
+    NullBuffer null_buffer;
+    std::ostream sink(&null_buffer);
+    for (auto _ : state) {
+        fleet::RecordWriter writer(sink, format);
+        for (const auto& record : records) writer.write(record);
+        writer.finish();
+    }
+    set_throughput(state, records.size(), sized.str().size());
+}
+BENCHMARK(BM_RecordWriter)
+    ->ArgName("format")
+    ->Arg(static_cast<int>(fleet::OutputFormat::JsonArray))
+    ->Arg(static_cast<int>(fleet::OutputFormat::NDJson))
+    ->Arg(static_cast<int>(fleet::OutputFormat::Csv))
+    ->Apply(add_percentiles);
+
+// Arg: 1 = telemetry indexes dropped during the load and rebuilt at the end,
+// 0 = maintained row by row. Each iteration loads a fresh database file.
+void BM_SqliteLoad(benchmark::State& state) {
+    if (!fleet::SqliteLoader::available()) {
+        state.SkipWithError("SQLite not available in this build");
+        return;
+    }
+    const auto records = make_records(1 << 16);
+    const std::string path = temp_path("fleet_bench_load.db");
+    fleet::SqliteLoaderConfig config;
+    config.defer_indexes = state.range(0) != 0;
+    for (auto _ : state) {
+        std::remove(path.c_str());
+        fleet::SqliteLoader loader(path, config);
+        for (const auto& record : records) loader.write(record);
+        loader.finish();
+    }
+    set_throughput(state, records.size(), 0);
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_SqliteLoad)->ArgName("defer_indexes")->Arg(1)->Arg(0)->UseRealTime()->Apply(add_percentiles);
+
+// Arg: ExportFormat. Columnar export of a parsed batch, four groups per file
+// (compare BM_WriteRecords for the JSON / CSV text the analytics jobs re-parse).
+void BM_ColumnarExport(benchmark::State& state) {
+    const auto format = static_cast<fleet::ExportFormat>(state.range(0));
+    fleet::TelemetryBatch batch;
+    for (const auto& r : make_records(1 << 16)) batch.append(r);
+    const std::string path = temp_path(std::string("fleet_bench_export.") + fleet::export_format_name(format));
+    fleet::ColumnarExportConfig config;
+    config.row_group_rows = batch.size() / 4;
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        fleet::ColumnarWriter writer(path, format, config);
+        writer.write(batch);
+        writer.close();
+        bytes = writer.bytes_written();
+    }
+    set_throughput(state, batch.size(), bytes);
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ColumnarExport)
+    ->ArgName("format")
+    ->Arg(static_cast<int>(fleet::ExportFormat::Arrow))
+    ->Arg(static_cast<int>(fleet::ExportFormat::Parquet))
+    ->Apply(add_percentiles);
+
+// ============================================================================
+// Macro benchmarks over generated datasets
+// ============================================================================
+
+struct Dataset {
+    std::string path;
+    uint64_t rows;
+    uint64_t vehicles;
+    uint64_t bytes;
+};
+
+// Write the dataset unless a complete copy from an earlier run exists
+Dataset prepare_dataset(const std::string& dir, uint64_t rows, uint64_t vehicles) {
+    Dataset ds{dir + "/fleet_bench_" + std::to_string(rows) + "_" + std::to_string(vehicles) + ".csv",
+               rows, vehicles, 0};
+    const std::string done = ds.path + ".done";
+
+    struct stat st;
+    if (::stat(done.c_str(), &st) != 0 || ::stat(ds.path.c_str(), &st) != 0) {
+        std::fprintf(stderr, "Generating %s ...\n", ds.path.c_str());
+        std::ofstream out(ds.path, std::ios::binary);
+        if (!out) {
+            std::fprintf(stderr, "Cannot write %s\n", ds.path.c_str());
+            std::exit(1);
+        }
+        constexpr uint64_t kChunk = 1 << 16;
+        std::string buffer = kCsvHeader;
+        for (uint64_t first = 0; first < rows; first += kChunk) {
+            append_csv_rows(buffer, first, std::min(kChunk, rows - first), vehicles);
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+        out.close();
+        std::ofstream(done).put('\n');
+        ::stat(ds.path.c_str(), &st);
+    }
+    ds.bytes = static_cast<uint64_t>(st.st_size);
+    return ds;
+}
+
+void run_streaming(benchmark::State& state, const Dataset& ds, size_t threads) {
+    fleet::ParserConfig config;
+    config.num_threads = threads;
+    for (auto _ : state) {
+        fleet::TelemetryParser parser(config);
+        size_t rows = 0;
+        parser.parse_file_streaming(ds.path, [&rows](fleet::TelemetryData&& data) {
+            benchmark::DoNotOptimize(data.speed);
+            rows++;
+        });
+        if (rows != ds.rows) state.SkipWithError("row count mismatch");
+    }
+    set_throughput(state, ds.rows, ds.bytes);
+}
+
+void run_columnar(benchmark::State& state, const Dataset& ds) {
+    for (auto _ : state) {
+        fleet::TelemetryParser parser;
+        size_t rows = 0;
+        parser.parse_file_columnar(ds.path, [&rows](const fleet::TelemetryBatch& batch) {
+            rows += batch.size();
+        });
+        if (rows != ds.rows) state.SkipWithError("row count mismatch");
+    }
+    set_throughput(state, ds.rows, ds.bytes);
+}
+
+// ============================================================================
+// Driver
+// ============================================================================
+
+std::vector<uint64_t> parse_list(const char* text) {
+    std::vector<uint64_t> values;
+    const char* p = text;
+    while (*p) {
+        char* end;
+        unsigned long long v = std::strtoull(p, &end, 10);
+        if (end == p) break;
+        values.push_back(v);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<uint64_t> rows = {1000000};
+    std::vector<uint64_t> vehicles = {10, 1000, 100000};
+    std::string data_dir = "/tmp";
+    bool repetitions_given = false;
+
+    // Take our flags out before Google Benchmark sees the rest
+    std::vector<char*> args;
+    for (int i = 0; i < argc; i++) {
+        if (std::strncmp(argv[i], "--rows=", 7) == 0) {
+            rows = parse_list(argv[i] + 7);
+        } else if (std::strncmp(argv[i], "--vehicles=", 11) == 0) {
+            vehicles = parse_list(argv[i] + 11);
+        } else if (std::strncmp(argv[i], "--data-dir=", 11) == 0) {
+            data_dir = argv[i] + 11;
+        } else {
+            if (std::strncmp(argv[i], "--benchmark_repetitions", 23) == 0) repetitions_given = true;
+            args.push_back(argv[i]);
+        }
+    }
+    static char default_repetitions[] = "--benchmark_repetitions=5";
+    if (!repetitions_given) args.push_back(default_repetitions);
+
+    int bench_argc = static_cast<int>(args.size());
+    benchmark::Initialize(&bench_argc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(bench_argc, args.data())) return 1;
+
+    // Datasets are generated lazily: only those a filter keeps are written
+    for (uint64_t r : rows) {
+        for (uint64_t v : vehicles) {
+            if (r == 0 || v == 0) continue;
+            const std::string suffix = "/rows:" + std::to_string(r) + "/vehicles:" + std::to_string(v);
+            auto dataset = [data_dir, r, v]() {
+                static std::vector<Dataset> cache;
+                for (const auto& ds : cache) {
+                    if (ds.rows == r && ds.vehicles == v) return ds;
+                }
+                cache.push_back(prepare_dataset(data_dir, r, v));
+                return cache.back();
+            };
+
+            benchmark::RegisterBenchmark(("Macro/ParseStreaming" + suffix).c_str(),
+                [dataset](benchmark::State& state) { run_streaming(state, dataset(), 1); })
+                ->Unit(benchmark::kMillisecond)->UseRealTime()->Apply(add_percentiles);
+            benchmark::RegisterBenchmark(("Macro/ParseParallel" + suffix).c_str(),
+                [dataset](benchmark::State& state) { run_streaming(state, dataset(), 0); })
+                ->Unit(benchmark::kMillisecond)->UseRealTime()->Apply(add_percentiles);
+            benchmark::RegisterBenchmark(("Macro/ParseColumnar" + suffix).c_str(),
+                [dataset](benchmark::State& state) { run_columnar(state, dataset()); })
+                ->Unit(benchmark::kMillisecond)->UseRealTime()->Apply(add_percentiles);
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
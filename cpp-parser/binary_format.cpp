@@ -0,0 +1,697 @@
+#include "binary_format.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef FLEET_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef FLEET_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef FLEET_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace fleet {
+
+using namespace binary;
+
+// ============================================================================
+// Block codecs
+// ============================================================================
+
+namespace binary {
+
+const char* codec_name(Codec codec) {
+    switch (codec) {
+        case Codec::None: return "none";
+        case Codec::Zlib: return "zlib";
+        case Codec::Zstd: return "zstd";
+        case Codec::LZ4:  return "lz4";
+    }
+    return "unknown";
+}
+
+bool codec_available(Codec codec) {
+    switch (codec) {
+        case Codec::None: return true;
+#ifdef FLEET_HAVE_ZLIB
+        case Codec::Zlib: return true;
+#endif
+#ifdef FLEET_HAVE_ZSTD
+        case Codec::Zstd: return true;
+#endif
+#ifdef FLEET_HAVE_LZ4
+        case Codec::LZ4: return true;
+#endif
+        default: return false;
+    }
+}
+
+std::optional<Codec> parse_codec(std::string_view name) {
+    for (Codec codec : {Codec::None, Codec::Zlib, Codec::Zstd, Codec::LZ4}) {
+        if (name == codec_name(codec)) return codec;
+    }
+    return std::nullopt;
+}
+
+}  // namespace binary
+
+// Compress src into out (resized to the compressed length)
+static void compress_bytes(Codec codec, int level, const char* src, size_t size,
+                           std::vector<char>& out) {
+    switch (codec) {
+#ifdef FLEET_HAVE_ZLIB
+        case Codec::Zlib: {
+            uLongf len = compressBound(static_cast<uLong>(size));
+            out.resize(len);
+            int rc = compress2(reinterpret_cast<Bytef*>(out.data()), &len,
+                               reinterpret_cast<const Bytef*>(src), static_cast<uLong>(size),
+                               level > 0 ? level : Z_DEFAULT_COMPRESSION);
+            if (rc != Z_OK) throw std::runtime_error("zlib compression failed");
+            out.resize(len);
+            return;
+        }
+#endif
+#ifdef FLEET_HAVE_ZSTD
+        case Codec::Zstd: {
+            out.resize(ZSTD_compressBound(size));
+            size_t len = ZSTD_compress(out.data(), out.size(), src, size,
+                                       level > 0 ? level : ZSTD_CLEVEL_DEFAULT);
+            if (ZSTD_isError(len)) throw std::runtime_error("zstd compression failed");
+            out.resize(len);
+            return;
+        }
+#endif
+#ifdef FLEET_HAVE_LZ4
+        case Codec::LZ4: {
+            // level is LZ4's acceleration factor (1 = best ratio)
+            out.resize(LZ4_compressBound(static_cast<int>(size)));
+            int len = LZ4_compress_fast(src, out.data(), static_cast<int>(size),
+                                        static_cast<int>(out.size()), level > 0 ? level : 1);
+            if (len <= 0) throw std::runtime_error("lz4 compression failed");
+            out.resize(len);
+            return;
+        }
+#endif
+        default:
+            break;
+    }
+    throw std::runtime_error(std::string("Compression codec not available in this build: ") +
+                             codec_name(codec));
+}
+
+// Decompress exactly dst_size bytes; false on corrupt input
+static bool decompress_bytes(Codec codec, const char* src, size_t size,
+                             char* dst, size_t dst_size) {
+    switch (codec) {
+#ifdef FLEET_HAVE_ZLIB
+        case Codec::Zlib: {
+            uLongf len = static_cast<uLongf>(dst_size);
+            int rc = uncompress(reinterpret_cast<Bytef*>(dst), &len,
+                                reinterpret_cast<const Bytef*>(src), static_cast<uLong>(size));
+            return rc == Z_OK && len == dst_size;
+        }
+#endif
+#ifdef FLEET_HAVE_ZSTD
+        case Codec::Zstd: {
+            size_t len = ZSTD_decompress(dst, dst_size, src, size);
+            return !ZSTD_isError(len) && len == dst_size;
+        }
+#endif
+#ifdef FLEET_HAVE_LZ4
+        case Codec::LZ4: {
+            int len = LZ4_decompress_safe(src, dst, static_cast<int>(size), static_cast<int>(dst_size));
+            return len >= 0 && static_cast<size_t>(len) == dst_size;
+        }
+#endif
+        default:
+            break;
+    }
+    throw std::runtime_error(std::string("Binary file uses ") + codec_name(codec) +
+                             " compression, which this build does not support");
+}
+
+// ============================================================================
+// Column-major block image
+// ============================================================================
+
+// Bytes per row once padding is dropped
+constexpr size_t kColumnBytes = 9 * sizeof(double) + 3 * sizeof(uint32_t);
+
+template <typename T, typename Get>
+static char* put_column(char* p, const TelemetryRecord* rows, size_t n, Get get) {
+    for (size_t i = 0; i < n; i++) {
+        T v = get(rows[i]);
+        std::memcpy(p, &v, sizeof(T));
+        p += sizeof(T);
+    }
+    return p;
+}
+
+template <typename T, typename Set>
+static const char* get_column(const char* p, TelemetryRecord* rows, size_t n, Set set) {
+    for (size_t i = 0; i < n; i++) {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        set(rows[i], v);
+        p += sizeof(T);
+    }
+    return p;
+}
+
+static uint64_t double_bits(double d) {
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static double bits_double(uint64_t bits) {
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// Timestamps and odometer grow slowly row to row, so store wrapping
+// differences of their bit patterns; that keeps the encoding lossless.
+static void encode_columns(const TelemetryRecord* rows, size_t n, std::vector<char>& out) {
+    out.resize(n * kColumnBytes);
+    char* p = out.data();
+
+    uint64_t prev_ts = 0;
+    p = put_column<uint64_t>(p, rows, n, [&](const TelemetryRecord& r) {
+        uint64_t ts = static_cast<uint64_t>(r.timestamp);
+        uint64_t delta = ts - prev_ts;
+        prev_ts = ts;
+        return delta;
+    });
+    p = put_column<double>(p, rows, n, [](const TelemetryRecord& r) { return r.latitude; });
+    p = put_column<double>(p, rows, n, [](const TelemetryRecord& r) { return r.longitude; });
+    p = put_column<double>(p, rows, n, [](const TelemetryRecord& r) { return r.speed; });
+    p = put_column<double>(p, rows, n, [](const TelemetryRecord& r) { return r.heading; });
+    p = put_column<double>(p, rows, n, [](const TelemetryRecord& r) { return r.fuel_level; });
+    uint64_t prev_odo = 0;
+    p = put_column<uint64_t>(p, rows, n, [&](const TelemetryRecord& r) {
+        uint64_t bits = double_bits(r.odometer_km);
+        uint64_t delta = bits - prev_odo;
+        prev_odo = bits;
+        return delta;
+    });
+    p = put_column<double>(p, rows, n, [](const TelemetryRecord& r) { return r.engine_temp; });
+    p = put_column<double>(p, rows, n, [](const TelemetryRecord& r) { return r.battery_volt; });
+    p = put_column<int32_t>(p, rows, n, [](const TelemetryRecord& r) { return r.engine_rpm; });
+    p = put_column<uint32_t>(p, rows, n, [](const TelemetryRecord& r) { return r.vehicle_id; });
+    put_column<uint32_t>(p, rows, n, [](const TelemetryRecord& r) { return r.diagnostic_code; });
+}
+
+static void decode_columns(const char* p, size_t n, std::vector<TelemetryRecord>& out) {
+    out.resize(n);
+    TelemetryRecord* rows = out.data();
+
+    uint64_t ts = 0;
+    p = get_column<uint64_t>(p, rows, n, [&](TelemetryRecord& r, uint64_t delta) {
+        ts += delta;
+        r.timestamp = static_cast<int64_t>(ts);
+    });
+    p = get_column<double>(p, rows, n, [](TelemetryRecord& r, double v) { r.latitude = v; });
+    p = get_column<double>(p, rows, n, [](TelemetryRecord& r, double v) { r.longitude = v; });
+    p = get_column<double>(p, rows, n, [](TelemetryRecord& r, double v) { r.speed = v; });
+    p = get_column<double>(p, rows, n, [](TelemetryRecord& r, double v) { r.heading = v; });
+    p = get_column<double>(p, rows, n, [](TelemetryRecord& r, double v) { r.fuel_level = v; });
+    uint64_t odo = 0;
+    p = get_column<uint64_t>(p, rows, n, [&](TelemetryRecord& r, uint64_t delta) {
+        odo += delta;
+        r.odometer_km = bits_double(odo);
+    });
+    p = get_column<double>(p, rows, n, [](TelemetryRecord& r, double v) { r.engine_temp = v; });
+    p = get_column<double>(p, rows, n, [](TelemetryRecord& r, double v) { r.battery_volt = v; });
+    p = get_column<int32_t>(p, rows, n, [](TelemetryRecord& r, int32_t v) { r.engine_rpm = v; });
+    p = get_column<uint32_t>(p, rows, n, [](TelemetryRecord& r, uint32_t v) { r.vehicle_id = v; });
+    get_column<uint32_t>(p, rows, n, [](TelemetryRecord& r, uint32_t v) { r.diagnostic_code = v; });
+}
+
+// ============================================================================
+// BinaryReader implementation
+// ============================================================================
+
+BinaryReader::BinaryReader(const std::string& filename) : file_(filename) {
+    uint32_t magic = 0;
+    if (file_.size() < sizeof(magic) + 1) {
+        throw std::runtime_error("Invalid binary file format");
+    }
+    std::memcpy(&magic, file_.data(), sizeof(magic));
+    version_ = static_cast<uint8_t>(file_.data()[sizeof(magic)]);
+
+    if (magic != kMagic || (version_ != kVersion1 && version_ != kVersion2)) {
+        throw std::runtime_error("Invalid binary file format");
+    }
+    if (version_ == kVersion2) {
+        open_v2(filename);
+    }
+}
+
+void BinaryReader::open_v2(const std::string& filename) {
+    const char* base = file_.data();
+    const uint64_t size = file_.size();
+    const auto corrupt = [&filename]() {
+        return std::runtime_error("Corrupt binary file: " + filename);
+    };
+
+    if (size < sizeof(FileHeader) + sizeof(FileTrailer)) throw corrupt();
+
+    const auto* header = reinterpret_cast<const FileHeader*>(base);
+    if (header->byte_order != kLittleEndian) {
+        throw std::runtime_error("Unsupported byte order in binary file: " + filename);
+    }
+    if (header->record_size != sizeof(TelemetryRecord)) throw corrupt();
+
+    const uint64_t trailer_offset = size - sizeof(FileTrailer);
+    const auto* trailer = reinterpret_cast<const FileTrailer*>(base + trailer_offset);
+    if (trailer->magic != kTrailerMagic || trailer_offset % 8 != 0) throw corrupt();
+
+    // Sections must appear in order, header <= dictionaries <= index <=
+    // trailer; every comparison below is between in-range values, so none of
+    // the subtractions can wrap
+    const uint64_t vehicle_dict = trailer->vehicle_dict_offset;
+    const uint64_t diagnostic_dict = trailer->diagnostic_dict_offset;
+    const uint64_t index_offset = trailer->index_offset;
+    if (vehicle_dict < sizeof(FileHeader) ||
+        diagnostic_dict < vehicle_dict ||
+        index_offset < diagnostic_dict ||
+        trailer_offset < index_offset ||
+        index_offset % 8 != 0 ||
+        uint64_t(trailer->block_count) * sizeof(BlockIndexEntry) > trailer_offset - index_offset) {
+        throw corrupt();
+    }
+
+    vehicles_ = load_dictionary(vehicle_dict, diagnostic_dict, filename);
+    diagnostics_ = load_dictionary(diagnostic_dict, index_offset, filename);
+
+    index_ = reinterpret_cast<const BlockIndexEntry*>(base + index_offset);
+    block_count_ = trailer->block_count;
+
+    // Check every block once so block() can hand out spans unchecked: header
+    // and payload must lie between the file header and the first dictionary
+    uint64_t records = 0;
+    for (size_t i = 0; i < block_count_; i++) {
+        const BlockIndexEntry& entry = index_[i];
+        if (entry.offset % 8 != 0 ||
+            entry.offset < sizeof(FileHeader) ||
+            entry.offset > vehicle_dict ||
+            vehicle_dict - entry.offset < sizeof(BlockHeader) ||
+            entry.payload_bytes > vehicle_dict - entry.offset - sizeof(BlockHeader) ||
+            entry.record_count > header->block_records ||
+            entry.max_vehicle >= vehicles_.count) {
+            throw corrupt();
+        }
+        const uint64_t raw_bytes = uint64_t(entry.record_count) * sizeof(TelemetryRecord);
+        const bool payload_ok = entry.codec == static_cast<uint8_t>(Codec::None)
+            ? entry.payload_bytes == raw_bytes
+            : entry.codec <= static_cast<uint8_t>(Codec::LZ4);
+        if (!payload_ok) throw corrupt();
+        const auto* block = reinterpret_cast<const BlockHeader*>(base + entry.offset);
+        if (block->magic != kBlockMagic || block->record_count != entry.record_count ||
+            block->codec != entry.codec || block->payload_bytes != entry.payload_bytes) {
+            throw corrupt();
+        }
+        records += entry.record_count;
+    }
+    if (records != trailer->record_count) throw corrupt();
+    record_count_ = static_cast<size_t>(records);
+}
+
+BinaryReader::Dictionary BinaryReader::load_dictionary(uint64_t offset, uint64_t limit,
+                                                       const std::string& filename) const {
+    const char* base = file_.data();
+    const auto corrupt = [&filename]() {
+        return std::runtime_error("Corrupt binary file: " + filename);
+    };
+
+    if (offset % 8 != 0 || limit - offset < 8) throw corrupt();
+
+    Dictionary dict;
+    std::memcpy(&dict.count, base + offset, sizeof(dict.count));
+
+    const uint64_t offsets_bytes = (uint64_t(dict.count) + 1) * sizeof(uint32_t);
+    if (dict.count == 0 || offsets_bytes > limit - offset - 8) throw corrupt();
+
+    dict.offsets = reinterpret_cast<const uint32_t*>(base + offset + 8);
+    dict.bytes = base + offset + 8 + offsets_bytes;
+
+    const uint64_t bytes_available = limit - offset - 8 - offsets_bytes;
+    for (uint32_t i = 0; i < dict.count; i++) {
+        if (dict.offsets[i] > dict.offsets[i + 1]) throw corrupt();
+    }
+    if (dict.offsets[0] != 0 || dict.offsets[dict.count] > bytes_available) throw corrupt();
+
+    return dict;
+}
+
+RecordSpan BinaryReader::block(size_t i) const {
+    const BlockIndexEntry& entry = index_[i];
+    if (entry.codec != static_cast<uint8_t>(Codec::None)) {
+        throw std::runtime_error("Compressed block requires read_block()");
+    }
+    const char* records = file_.data() + entry.offset + sizeof(BlockHeader);
+    return RecordSpan{reinterpret_cast<const TelemetryRecord*>(records), entry.record_count};
+}
+
+RecordSpan BinaryReader::read_block(size_t i, BlockBuffer& buffer) const {
+    const BlockIndexEntry& entry = index_[i];
+    if (entry.codec == static_cast<uint8_t>(Codec::None)) {
+        return block(i);
+    }
+
+    const char* payload = file_.data() + entry.offset + sizeof(BlockHeader);
+    buffer.columns.resize(entry.record_count * kColumnBytes);
+    if (!decompress_bytes(static_cast<Codec>(entry.codec), payload, entry.payload_bytes,
+                          buffer.columns.data(), buffer.columns.size())) {
+        throw std::runtime_error("Corrupt compressed block in binary file");
+    }
+    decode_columns(buffer.columns.data(), entry.record_count, buffer.records);
+    return RecordSpan{buffer.records.data(), buffer.records.size()};
+}
+
+std::string_view BinaryReader::v1_payload() const {
+    constexpr size_t kPreamble = sizeof(kMagic) + 1;
+    return file_.view().substr(kPreamble);
+}
+
+// ============================================================================
+// BinaryWriter implementation
+// ============================================================================
+
+BinaryWriter::BinaryWriter(const std::string& filename, const BinaryWriterConfig& config)
+    : filename_(filename), config_(config) {
+    begin();
+}
+
+BinaryWriter::BinaryWriter(std::ostream& out, const BinaryWriterConfig& config)
+    : out_(&out), filename_("<stream>"), config_(config) {
+    begin();
+}
+
+// Validate the configuration, open the file if we own it and emit the preamble
+void BinaryWriter::begin() {
+    if (config_.version != kVersion1 && config_.version != kVersion2) {
+        throw std::runtime_error("Unsupported binary format version: " +
+                                 std::to_string(config_.version));
+    }
+    if (config_.codec != Codec::None) {
+        if (config_.version == kVersion1) {
+            throw std::runtime_error("Block compression requires binary format version 2");
+        }
+        if (!codec_available(config_.codec)) {
+            throw std::runtime_error(std::string("Compression codec not available in this build: ") +
+                                     codec_name(config_.codec));
+        }
+    }
+    if (config_.block_records == 0) {
+        throw std::runtime_error("block_records must be positive");
+    }
+
+    if (out_ == &file_) {
+        file_.open(filename_, std::ios::binary);
+        if (!file_.is_open()) {
+            throw std::runtime_error("Failed to create file: " + filename_);
+        }
+    }
+    arena_.reserve(config_.buffer_size + 1024);
+
+    if (config_.version == kVersion1) {
+        write_bytes(&kMagic, sizeof(kMagic));
+        write_bytes(&config_.version, sizeof(config_.version));
+        return;
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kMagic;
+    header.version = kVersion2;
+    header.byte_order = kLittleEndian;
+    header.record_size = sizeof(TelemetryRecord);
+    header.block_records = config_.block_records;
+    write_bytes(&header, sizeof(header));
+
+    block_.reserve(config_.block_records);
+}
+
+BinaryWriter::~BinaryWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() to observe failures
+    }
+}
+
+void BinaryWriter::write(const TelemetryData& data) {
+    if (config_.version == kVersion1) {
+        write_v1(data);
+        records_written_++;
+        return;
+    }
+
+    // Zero the padding too so identical input gives identical files
+    TelemetryRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.timestamp = data.timestamp;
+    record.latitude = data.latitude;
+    record.longitude = data.longitude;
+    record.speed = data.speed;
+    record.heading = data.heading;
+    record.fuel_level = data.fuel_level;
+    record.odometer_km = data.odometer_km;
+    record.engine_temp = data.engine_temp;
+    record.battery_volt = data.battery_volt;
+    record.engine_rpm = data.engine_rpm;
+    record.vehicle_id = vehicle_dict_.intern(data.vehicle_id);
+    record.diagnostic_code = diagnostic_dict_.intern(data.diagnostic_code);
+
+    block_.push_back(record);
+    records_written_++;
+
+    if (block_.size() == config_.block_records) {
+        write_block();
+    }
+}
+
+void BinaryWriter::write_v1(const TelemetryData& data) {
+    // Largest record: two 255-byte strings with their length bytes plus fields
+    char buf[2 * 256 + 9 * sizeof(double) + sizeof(int)];
+    char* p = buf;
+    const auto put = [&p](const void* src, size_t n) {
+        std::memcpy(p, src, n);
+        p += n;
+    };
+
+    // vehicle_id (length-prefixed)
+    uint8_t vid_len = static_cast<uint8_t>(std::min(data.vehicle_id.size(), size_t(255)));
+    put(&vid_len, sizeof(vid_len));
+    put(data.vehicle_id.data(), vid_len);
+
+    // Fixed-size fields
+    put(&data.timestamp, sizeof(data.timestamp));
+    put(&data.latitude, sizeof(data.latitude));
+    put(&data.longitude, sizeof(data.longitude));
+    put(&data.speed, sizeof(data.speed));
+    put(&data.heading, sizeof(data.heading));
+    put(&data.engine_rpm, sizeof(data.engine_rpm));
+    put(&data.fuel_level, sizeof(data.fuel_level));
+    put(&data.odometer_km, sizeof(data.odometer_km));
+    put(&data.engine_temp, sizeof(data.engine_temp));
+    put(&data.battery_volt, sizeof(data.battery_volt));
+
+    // diagnostic_code (length-prefixed)
+    uint8_t diag_len = static_cast<uint8_t>(std::min(data.diagnostic_code.size(), size_t(255)));
+    put(&diag_len, sizeof(diag_len));
+    put(data.diagnostic_code.data(), diag_len);
+
+    write_bytes(buf, static_cast<size_t>(p - buf));
+}
+
+void BinaryWriter::write(const TelemetryRecord& record, const StringTable& vehicles,
+                         const StringTable& diagnostics) {
+    if (config_.version == kVersion1) {
+        TelemetryData data;
+        data.vehicle_id = vehicles.view(record.vehicle_id);
+        data.timestamp = record.timestamp;
+        data.latitude = record.latitude;
+        data.longitude = record.longitude;
+        data.speed = record.speed;
+        data.heading = record.heading;
+        data.engine_rpm = record.engine_rpm;
+        data.fuel_level = record.fuel_level;
+        data.odometer_km = record.odometer_km;
+        data.engine_temp = record.engine_temp;
+        data.battery_volt = record.battery_volt;
+        data.diagnostic_code = diagnostics.view(record.diagnostic_code);
+        write_v1(data);
+        records_written_++;
+        return;
+    }
+
+    // Copied field by field so the padding stays zero
+    TelemetryRecord out;
+    std::memset(&out, 0, sizeof(out));
+    out.timestamp = record.timestamp;
+    out.latitude = record.latitude;
+    out.longitude = record.longitude;
+    out.speed = record.speed;
+    out.heading = record.heading;
+    out.fuel_level = record.fuel_level;
+    out.odometer_km = record.odometer_km;
+    out.engine_temp = record.engine_temp;
+    out.battery_volt = record.battery_volt;
+    out.engine_rpm = record.engine_rpm;
+    out.vehicle_id = vehicle_dict_.intern(vehicles.view(record.vehicle_id));
+    out.diagnostic_code = diagnostic_dict_.intern(diagnostics.view(record.diagnostic_code));
+
+    block_.push_back(out);
+    records_written_++;
+
+    if (block_.size() == config_.block_records) {
+        write_block();
+    }
+}
+
+void BinaryWriter::write_batch(const std::vector<TelemetryData>& data) {
+    for (const auto& d : data) {
+        write(d);
+    }
+}
+
+void BinaryWriter::write_block() {
+    if (block_.empty()) return;
+
+    BlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kBlockMagic;
+    header.record_count = static_cast<uint32_t>(block_.size());
+    header.min_timestamp = std::numeric_limits<int64_t>::max();
+    header.max_timestamp = std::numeric_limits<int64_t>::min();
+    header.min_vehicle = std::numeric_limits<uint32_t>::max();
+    header.max_vehicle = 0;
+    for (const auto& r : block_) {
+        header.min_timestamp = std::min(header.min_timestamp, r.timestamp);
+        header.max_timestamp = std::max(header.max_timestamp, r.timestamp);
+        header.min_vehicle = std::min(header.min_vehicle, r.vehicle_id);
+        header.max_vehicle = std::max(header.max_vehicle, r.vehicle_id);
+    }
+
+    const char* payload = reinterpret_cast<const char*>(block_.data());
+    size_t payload_bytes = block_.size() * sizeof(TelemetryRecord);
+    header.codec = static_cast<uint8_t>(Codec::None);
+
+    if (config_.codec != Codec::None) {
+        encode_columns(block_.data(), block_.size(), columns_);
+        compress_bytes(config_.codec, config_.level, columns_.data(), columns_.size(), compressed_);
+        // Incompressible blocks stay raw so they can still be used in place
+        if (compressed_.size() < payload_bytes) {
+            payload = compressed_.data();
+            payload_bytes = compressed_.size();
+            header.codec = static_cast<uint8_t>(config_.codec);
+        }
+    }
+    header.payload_bytes = payload_bytes;
+
+    BlockIndexEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.offset = offset_;
+    entry.record_count = header.record_count;
+    entry.codec = header.codec;
+    entry.min_timestamp = header.min_timestamp;
+    entry.max_timestamp = header.max_timestamp;
+    entry.min_vehicle = header.min_vehicle;
+    entry.max_vehicle = header.max_vehicle;
+    entry.payload_bytes = header.payload_bytes;
+    index_.push_back(entry);
+
+    write_bytes(&header, sizeof(header));
+    write_bytes(payload, payload_bytes);
+    pad_to_alignment();
+    block_.clear();
+}
+
+void BinaryWriter::write_dictionary(const StringTable& table) {
+    const uint32_t count = static_cast<uint32_t>(table.size());
+    const uint32_t reserved = 0;
+    write_bytes(&count, sizeof(count));
+    write_bytes(&reserved, sizeof(reserved));
+
+    std::vector<uint32_t> offsets;
+    offsets.reserve(count + 1);
+    uint32_t pos = 0;
+    offsets.push_back(pos);
+    for (uint32_t i = 0; i < count; i++) {
+        pos += static_cast<uint32_t>(table.view(i).size());
+        offsets.push_back(pos);
+    }
+    write_bytes(offsets.data(), offsets.size() * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < count; i++) {
+        std::string_view s = table.view(i);
+        write_bytes(s.data(), s.size());
+    }
+    pad_to_alignment();
+}
+
+void BinaryWriter::write_bytes(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    arena_.insert(arena_.end(), bytes, bytes + size);
+    offset_ += size;
+    drain(false);
+}
+
+void BinaryWriter::pad_to_alignment() {
+    static const char zeros[8] = {};
+    const size_t pad = (8 - offset_ % 8) % 8;
+    write_bytes(zeros, pad);
+}
+
+// Hand the arena to the file once it holds buffer_size bytes (or on demand)
+void BinaryWriter::drain(bool force) {
+    if (arena_.empty() || (!force && arena_.size() < config_.buffer_size)) return;
+    out_->write(arena_.data(), static_cast<std::streamsize>(arena_.size()));
+    arena_.clear();
+}
+
+void BinaryWriter::flush() {
+    if (config_.version == kVersion2 && !closed_) {
+        write_block();
+    }
+    drain(true);
+    out_->flush();
+}
+
+void BinaryWriter::close() {
+    if (closed_) return;
+    closed_ = true;
+
+    if (config_.version == kVersion2) {
+        write_block();
+
+        FileTrailer trailer;
+        std::memset(&trailer, 0, sizeof(trailer));
+        trailer.vehicle_dict_offset = offset_;
+        write_dictionary(vehicle_dict_);
+        trailer.diagnostic_dict_offset = offset_;
+        write_dictionary(diagnostic_dict_);
+        trailer.index_offset = offset_;
+        write_bytes(index_.data(), index_.size() * sizeof(BlockIndexEntry));
+        trailer.record_count = records_written_;
+        trailer.block_count = static_cast<uint32_t>(index_.size());
+        trailer.magic = kTrailerMagic;
+        write_bytes(&trailer, sizeof(trailer));
+    }
+
+    drain(true);
+    out_->flush();
+    if (!*out_) {
+        throw std::runtime_error("Failed to write file: " + filename_);
+    }
+    if (file_.is_open()) file_.close();
+}
+
+}  // namespace fleet
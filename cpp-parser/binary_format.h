@@ -0,0 +1,271 @@
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "mapped_file.h"
+#include "string_table.h"
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+// ============================================================================
+// "FLET" binary format
+//
+// Every file starts with the 4-byte magic and a 1-byte version.
+//
+// v1: the 5-byte preamble followed by variable-length records
+//     (length-prefixed strings interleaved with packed fields).
+//
+// v2: fixed-width and mmap-able. All sections are 8-byte aligned and
+//     little-endian:
+//
+//     FileHeader                          64 bytes
+//     Block 0: BlockHeader                64 bytes
+//              TelemetryRecord[count]     88 bytes each
+//     Block 1 ...
+//     Vehicle dictionary
+//     Diagnostic dictionary
+//     BlockIndexEntry[block_count]        footer index
+//     FileTrailer                         last 40 bytes of the file
+//
+//     Records are byte images of TelemetryRecord whose handles are codes
+//     into the file's dictionaries (code 0 = empty), so a reader can hand
+//     out pointers into the mapping without decoding anything.
+//
+//     A block may instead be compressed (BlockHeader::codec != None). Its
+//     payload is then the compressed column-major image of the records:
+//     one array per field in TelemetryRecord order, without padding, with
+//     timestamp and odometer bits delta-coded against the previous row.
+//     Blocks that would not shrink are stored raw. Each block is padded
+//     to 8 bytes.
+//
+//     Dictionary: uint32 count, uint32 reserved, uint32 offsets[count + 1]
+//     (relative to the string bytes), then the bytes, padded to 8.
+// ============================================================================
+
+namespace binary {
+
+constexpr uint32_t kMagic = 0x464C4554;         // "FLET"
+constexpr uint32_t kBlockMagic = 0x4B4C4246;    // "FBLK"
+constexpr uint32_t kTrailerMagic = 0x58444E49;  // "INDX"
+constexpr uint8_t kVersion1 = 1;
+constexpr uint8_t kVersion2 = 2;
+constexpr uint8_t kLittleEndian = 1;
+constexpr uint32_t kDefaultBlockRecords = 4096;
+
+// Per-block compression. Zstd and LZ4 need the libraries at build time
+// (FLEET_HAVE_ZSTD / FLEET_HAVE_LZ4); zlib is used when FLEET_HAVE_ZLIB.
+enum class Codec : uint8_t {
+    None = 0,
+    Zlib = 1,
+    Zstd = 2,
+    LZ4 = 3,
+};
+
+const char* codec_name(Codec codec);
+bool codec_available(Codec codec);
+std::optional<Codec> parse_codec(std::string_view name);
+
+struct FileHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t byte_order;         // kLittleEndian
+    uint16_t reserved0;
+    uint32_t record_size;       // sizeof(TelemetryRecord)
+    uint32_t block_records;     // records per full block
+    uint8_t reserved[48];
+};
+
+struct BlockHeader {
+    uint32_t magic;             // kBlockMagic
+    uint32_t record_count;
+    int64_t min_timestamp;
+    int64_t max_timestamp;
+    uint32_t min_vehicle;       // dictionary code range
+    uint32_t max_vehicle;
+    uint64_t payload_bytes;     // stored bytes following this header
+    uint8_t codec;              // Codec
+    uint8_t reserved[23];
+};
+
+struct BlockIndexEntry {
+    uint64_t offset;            // file offset of the BlockHeader
+    uint32_t record_count;
+    uint8_t codec;
+    uint8_t reserved[3];
+    int64_t min_timestamp;
+    int64_t max_timestamp;
+    uint32_t min_vehicle;
+    uint32_t max_vehicle;
+    uint64_t payload_bytes;
+};
+
+struct FileTrailer {
+    uint64_t vehicle_dict_offset;
+    uint64_t diagnostic_dict_offset;
+    uint64_t index_offset;
+    uint64_t record_count;
+    uint32_t block_count;
+    uint32_t magic;             // kTrailerMagic
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout");
+static_assert(sizeof(BlockHeader) == 64, "BlockHeader layout");
+static_assert(sizeof(BlockIndexEntry) == 48, "BlockIndexEntry layout");
+static_assert(sizeof(FileTrailer) == 40, "FileTrailer layout");
+static_assert(sizeof(TelemetryRecord) == 88, "TelemetryRecord is the v2 record image");
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value,
+              "v2 records are loaded straight from the mapping");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "the v2 format is written in host order");
+
+}  // namespace binary
+
+// Contiguous run of records inside a mapped v2 file
+using RecordSpan = Span<const TelemetryRecord>;
+
+// Reusable decode space for compressed blocks
+struct BlockBuffer {
+    std::vector<char> columns;
+    std::vector<TelemetryRecord> records;
+};
+
+// Memory-mapped reader for both format versions.
+//
+// For v2 the footer index and dictionaries are resolved on open. block(i)
+// returns the records of an uncompressed block in place; read_block()
+// handles any block, decoding compressed ones into the caller's buffer.
+// v1 has no index, so only the raw payload is exposed for sequential
+// decoding.
+class BinaryReader {
+public:
+    explicit BinaryReader(const std::string& filename);
+
+    uint8_t version() const { return version_; }
+
+    // v2 only
+    size_t block_count() const { return block_count_; }
+    size_t record_count() const { return record_count_; }
+    const binary::BlockIndexEntry& block_info(size_t i) const { return index_[i]; }
+    RecordSpan block(size_t i) const;
+    RecordSpan read_block(size_t i, BlockBuffer& buffer) const;
+
+    std::string_view vehicle(uint32_t code) const { return vehicles_.view(code); }
+    std::string_view diagnostic(uint32_t code) const { return diagnostics_.view(code); }
+    size_t vehicle_count() const { return vehicles_.count; }
+    size_t diagnostic_count() const { return diagnostics_.count; }
+
+    // v1 only: bytes following the 5-byte preamble
+    std::string_view v1_payload() const;
+
+    size_t file_size() const { return file_.size(); }
+
+private:
+    struct Dictionary {
+        const uint32_t* offsets = nullptr;
+        const char* bytes = nullptr;
+        uint32_t count = 0;
+
+        std::string_view view(uint32_t code) const {
+            return std::string_view(bytes + offsets[code], offsets[code + 1] - offsets[code]);
+        }
+    };
+
+    void open_v2(const std::string& filename);
+    Dictionary load_dictionary(uint64_t offset, uint64_t limit, const std::string& filename) const;
+
+    MappedFile file_;
+    uint8_t version_ = 0;
+    const binary::BlockIndexEntry* index_ = nullptr;
+    size_t block_count_ = 0;
+    size_t record_count_ = 0;
+    Dictionary vehicles_;
+    Dictionary diagnostics_;
+};
+
+// Binary writer configuration
+struct BinaryWriterConfig {
+    uint8_t version = binary::kVersion1;
+    binary::Codec codec = binary::Codec::None;   // v2 only
+    int level = 0;                               // codec level (0 = codec default)
+    uint32_t block_records = binary::kDefaultBlockRecords;
+    size_t buffer_size = 4 * 1024 * 1024;        // write-behind arena
+};
+
+// Binary file writer.
+//
+// Output is encoded into an in-memory arena and handed to the file in
+// large writes once buffer_size is reached. Version 1 (the default) is the
+// legacy stream every release reads. v2 collects block_records rows per
+// block, optionally compresses each block, and writes the dictionaries and
+// footer index when the writer is closed; readers older than v2 reject it.
+class BinaryWriter {
+public:
+    explicit BinaryWriter(const std::string& filename,
+                          const BinaryWriterConfig& config = BinaryWriterConfig());
+    // Write to a caller-owned stream (e.g. an in-memory response buffer)
+    explicit BinaryWriter(std::ostream& out,
+                          const BinaryWriterConfig& config = BinaryWriterConfig());
+    ~BinaryWriter();
+
+    BinaryWriter(const BinaryWriter&) = delete;
+    BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+    void write(const TelemetryData& data);
+    void write_batch(const std::vector<TelemetryData>& data);
+
+    // Write a compact record whose handles index vehicles / diagnostics
+    // (e.g. a parser's tables), without materializing its strings
+    void write(const TelemetryRecord& record, const StringTable& vehicles,
+               const StringTable& diagnostics);
+
+    // Push buffered records to the file (v2: ends the current block early)
+    void flush();
+
+    // Finish the file: v2 appends dictionaries, index and trailer. Called by
+    // the destructor; call it explicitly to see write errors.
+    void close();
+
+    size_t records_written() const { return records_written_; }
+    uint64_t bytes_written() const { return offset_; }
+    uint8_t version() const { return config_.version; }
+
+private:
+    void begin();
+    void write_v1(const TelemetryData& data);
+    void write_block();
+    void write_dictionary(const StringTable& table);
+    void write_bytes(const void* data, size_t size);
+    void pad_to_alignment();
+    void drain(bool force);
+
+    std::ofstream file_;
+    std::ostream* out_ = &file_;  // file_, or the caller's stream
+    std::string filename_;
+    BinaryWriterConfig config_;
+    bool closed_ = false;
+    size_t records_written_ = 0;
+    uint64_t offset_ = 0;
+
+    // Encoded bytes not yet handed to file_
+    std::vector<char> arena_;
+
+    // v2 state
+    std::vector<TelemetryRecord> block_;
+    std::vector<char> columns_;
+    std::vector<char> compressed_;
+    std::vector<binary::BlockIndexEntry> index_;
+    StringTable vehicle_dict_;
+    StringTable diagnostic_dict_;
+};
+
+}  // namespace fleet
+
+#endif  // BINARY_FORMAT_H
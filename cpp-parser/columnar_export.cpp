@@ -0,0 +1,1050 @@
+#include "columnar_export.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef FLEET_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef FLEET_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef FLEET_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace fleet {
+
+const char* export_format_name(ExportFormat format) {
+    switch (format) {
+        case ExportFormat::Arrow: return "arrow";
+        case ExportFormat::Parquet: return "parquet";
+    }
+    return "unknown";
+}
+
+namespace {
+
+// Column names, in file order
+constexpr const char* kColumns[] = {
+    "vehicle_id", "timestamp", "latitude", "longitude", "speed", "heading", "engine_rpm",
+    "fuel_level", "odometer_km", "engine_temp", "battery_volt", "diagnostic_code",
+};
+constexpr size_t kColumnCount = sizeof(kColumns) / sizeof(kColumns[0]);
+
+// ============================================================================
+// Arrow IPC metadata (Schema.fbs, Message.fbs, File.fbs)
+// ============================================================================
+
+namespace arrow {
+
+constexpr char kMagic[] = "ARROW1";
+constexpr uint32_t kContinuation = 0xFFFFFFFF;
+constexpr int16_t kMetadataV5 = 4;
+
+// Type union
+constexpr uint8_t kTypeInt = 2;
+constexpr uint8_t kTypeFloatingPoint = 3;
+constexpr uint8_t kTypeUtf8 = 5;
+constexpr uint8_t kTypeTimestamp = 10;
+
+// MessageHeader union
+constexpr uint8_t kHeaderSchema = 1;
+constexpr uint8_t kHeaderDictionaryBatch = 2;
+constexpr uint8_t kHeaderRecordBatch = 3;
+
+constexpr int16_t kDouble = 2;
+constexpr int16_t kMillisecond = 1;
+
+constexpr int64_t kVehicleDictionary = 0;
+constexpr int64_t kDiagnosticDictionary = 1;
+
+// Minimal flatbuffer builder. Like the reference builder it fills the
+// buffer back to front, so children are finished before the tables that
+// point at them, and objects are identified by their distance from the
+// end of the buffer. Bytes are kept reversed until finish().
+class FlatBuilder {
+public:
+    using Ref = uint32_t;
+
+    uint32_t size() const { return static_cast<uint32_t>(bytes_.size()); }
+
+    // Pad so that n more bytes end on a multiple of alignment
+    void prep(size_t alignment, size_t n) {
+        while ((bytes_.size() + n) % alignment) bytes_.push_back(0);
+    }
+
+    template <typename T>
+    void scalar(T value) {
+        prep(sizeof(T), 0);
+        uint8_t raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        for (size_t i = sizeof(T); i-- > 0;) bytes_.push_back(raw[i]);
+    }
+
+    void offset(Ref ref) {
+        prep(4, 0);
+        scalar<uint32_t>(size() + 4 - ref);
+    }
+
+    Ref string(std::string_view str) {
+        prep(4, str.size() + 1);
+        bytes_.push_back(0);
+        for (size_t i = str.size(); i-- > 0;) bytes_.push_back(static_cast<uint8_t>(str[i]));
+        scalar<uint32_t>(static_cast<uint32_t>(str.size()));
+        return size();
+    }
+
+    Ref offsets(const std::vector<Ref>& refs) {
+        for (size_t i = refs.size(); i-- > 0;) offset(refs[i]);
+        scalar<uint32_t>(static_cast<uint32_t>(refs.size()));
+        return size();
+    }
+
+    // Vector of count structs, given as their little-endian image
+    Ref structs(const std::string& image, size_t count) {
+        prep(8, image.size());
+        for (size_t i = image.size(); i-- > 0;) bytes_.push_back(static_cast<uint8_t>(image[i]));
+        scalar<uint32_t>(static_cast<uint32_t>(count));
+        return size();
+    }
+
+    void start_table() {
+        fields_.clear();
+        table_start_ = size();
+    }
+
+    template <typename T>
+    void add(uint16_t id, T value) {
+        scalar(value);
+        fields_.emplace_back(id, size());
+    }
+
+    void add_offset(uint16_t id, Ref ref) {
+        offset(ref);
+        fields_.emplace_back(id, size());
+    }
+
+    Ref end_table() {
+        scalar<int32_t>(0);   // vtable soffset, patched below
+        const Ref table = size();
+        uint16_t slots = 0;
+        for (const auto& field : fields_) slots = std::max<uint16_t>(slots, field.first + 1);
+        std::vector<uint16_t> vtable(slots, 0);
+        for (const auto& field : fields_) vtable[field.first] = static_cast<uint16_t>(table - field.second);
+        for (size_t i = slots; i-- > 0;) scalar<uint16_t>(vtable[i]);
+        scalar<uint16_t>(static_cast<uint16_t>(table - table_start_));
+        scalar<uint16_t>(static_cast<uint16_t>(4 + 2 * slots));
+
+        // The table starts with the signed distance back to its vtable
+        const int32_t soffset = static_cast<int32_t>(size() - table);
+        uint8_t raw[4];
+        std::memcpy(raw, &soffset, sizeof(raw));
+        for (size_t i = 0; i < 4; i++) bytes_[table - 1 - i] = raw[i];
+        return table;
+    }
+
+    // Root offset in front; the result is a multiple of 8 bytes long
+    std::string finish(Ref root) {
+        prep(8, 4);
+        offset(root);
+        return std::string(bytes_.rbegin(), bytes_.rend());
+    }
+
+private:
+    std::vector<uint8_t> bytes_;
+    std::vector<std::pair<uint16_t, uint32_t>> fields_;
+    uint32_t table_start_ = 0;
+};
+
+using Ref = FlatBuilder::Ref;
+
+template <typename T>
+void put(std::string& image, T value) {
+    image.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+Ref int_type(FlatBuilder& fb, int32_t bits) {
+    fb.start_table();
+    fb.add<int32_t>(0, bits);
+    fb.add<uint8_t>(1, 1);   // is_signed
+    return fb.end_table();
+}
+
+Ref float_type(FlatBuilder& fb, int16_t precision) {
+    fb.start_table();
+    fb.add<int16_t>(0, precision);
+    return fb.end_table();
+}
+
+Ref field(FlatBuilder& fb, const char* name, bool nullable, uint8_t type_type, Ref type,
+          int64_t dictionary_id = -1) {
+    const Ref name_ref = fb.string(name);
+    const Ref children = fb.offsets({});
+    Ref dictionary = 0;
+    if (dictionary_id >= 0) {
+        const Ref index_type = int_type(fb, 32);
+        fb.start_table();
+        fb.add<int64_t>(0, dictionary_id);
+        fb.add_offset(1, index_type);
+        fb.add<uint8_t>(2, 0);   // isOrdered
+        dictionary = fb.end_table();
+    }
+    fb.start_table();
+    fb.add_offset(0, name_ref);
+    fb.add<uint8_t>(1, nullable);
+    fb.add<uint8_t>(2, type_type);
+    fb.add_offset(3, type);
+    if (dictionary_id >= 0) fb.add_offset(4, dictionary);
+    fb.add_offset(5, children);
+    return fb.end_table();
+}
+
+Ref schema(FlatBuilder& fb) {
+    std::vector<Ref> fields;
+    auto utf8 = [&fb]() {
+        fb.start_table();
+        return fb.end_table();
+    };
+    fields.push_back(field(fb, kColumns[0], false, kTypeUtf8, utf8(), kVehicleDictionary));
+
+    const Ref timezone = fb.string("UTC");
+    fb.start_table();
+    fb.add<int16_t>(0, kMillisecond);
+    fb.add_offset(1, timezone);
+    fields.push_back(field(fb, kColumns[1], false, kTypeTimestamp, fb.end_table()));
+
+    for (size_t i = 2; i <= 10; i++) {
+        if (i == 6) {
+            fields.push_back(field(fb, kColumns[i], false, kTypeInt, int_type(fb, 32)));
+        } else {
+            fields.push_back(field(fb, kColumns[i], false, kTypeFloatingPoint, float_type(fb, kDouble)));
+        }
+    }
+    fields.push_back(field(fb, kColumns[11], true, kTypeUtf8, utf8(), kDiagnosticDictionary));
+
+    const Ref field_vector = fb.offsets(fields);
+    fb.start_table();
+    fb.add<int16_t>(0, 0);   // little-endian
+    fb.add_offset(1, field_vector);
+    return fb.end_table();
+}
+
+// RecordBatch table over (length, null_count) nodes and (offset, length) buffers
+Ref record_batch(FlatBuilder& fb, int64_t length, const std::string& nodes, size_t node_count,
+                 const std::string& buffers, size_t buffer_count) {
+    const Ref node_vector = fb.structs(nodes, node_count);
+    const Ref buffer_vector = fb.structs(buffers, buffer_count);
+    fb.start_table();
+    fb.add<int64_t>(0, length);
+    fb.add_offset(1, node_vector);
+    fb.add_offset(2, buffer_vector);
+    return fb.end_table();
+}
+
+std::string message(FlatBuilder& fb, uint8_t header_type, Ref header, int64_t body_length) {
+    fb.start_table();
+    fb.add<int64_t>(3, body_length);
+    fb.add_offset(2, header);
+    fb.add<int16_t>(0, kMetadataV5);
+    fb.add<uint8_t>(1, header_type);
+    return fb.finish(fb.end_table());
+}
+
+// Body layout: buffers back to back, each padded to 8 bytes
+struct Body {
+    std::vector<std::string_view> parts;
+    std::string buffers;   // Buffer structs
+    size_t count = 0;
+    int64_t length = 0;
+
+    void add(const void* data, size_t size) {
+        parts.emplace_back(static_cast<const char*>(data), size);
+        put<int64_t>(buffers, size == 0 ? 0 : length);
+        put<int64_t>(buffers, static_cast<int64_t>(size));
+        count++;
+        length += static_cast<int64_t>((size + 7) & ~size_t(7));
+    }
+};
+
+}  // namespace arrow
+
+// ============================================================================
+// Parquet metadata (parquet.thrift, compact protocol)
+// ============================================================================
+
+namespace parquet {
+
+constexpr char kMagic[] = "PAR1";
+
+// Physical types
+constexpr int kInt32 = 1;
+constexpr int kInt64 = 2;
+constexpr int kDouble = 5;
+constexpr int kByteArray = 6;
+
+// Encodings
+constexpr int kPlain = 0;
+constexpr int kPlainDictionary = 2;
+constexpr int kRle = 3;
+
+// Page types
+constexpr int kDataPage = 0;
+constexpr int kDictionaryPage = 2;
+
+constexpr int kRequired = 0;
+constexpr int kOptional = 1;
+
+constexpr int kConvertedUtf8 = 0;
+constexpr int kConvertedTimestampMillis = 9;
+
+int codec_id(binary::Codec codec) {
+    switch (codec) {
+        case binary::Codec::None: return 0;   // UNCOMPRESSED
+        case binary::Codec::Zlib: return 2;   // GZIP
+        case binary::Codec::Zstd: return 6;   // ZSTD
+        case binary::Codec::LZ4: return 7;    // LZ4_RAW
+    }
+    return 0;
+}
+
+// Thrift compact protocol writer
+class ThriftWriter {
+public:
+    static constexpr uint8_t kTrue = 1;
+    static constexpr uint8_t kFalse = 2;
+    static constexpr uint8_t kI16 = 4;
+    static constexpr uint8_t kI32 = 5;
+    static constexpr uint8_t kI64 = 6;
+    static constexpr uint8_t kBinary = 8;
+    static constexpr uint8_t kList = 9;
+    static constexpr uint8_t kStruct = 12;
+
+    std::string& out() { return out_; }
+
+    void i16(int16_t id, int16_t value) { field(id, kI16); varint(zigzag(value)); }
+    void i32(int16_t id, int32_t value) { field(id, kI32); varint(zigzag(value)); }
+    void i64(int16_t id, int64_t value) { field(id, kI64); varint(zigzag(value)); }
+    void boolean(int16_t id, bool value) { field(id, value ? kTrue : kFalse); }
+    void binary(int16_t id, std::string_view value) { field(id, kBinary); bytes(value); }
+
+    void begin_struct(int16_t id) {
+        field(id, kStruct);
+        begin_element();
+    }
+    // A struct inside a list
+    void begin_element() {
+        stack_.push_back(last_);
+        last_ = 0;
+    }
+    void end_struct() {
+        out_.push_back(0);
+        last_ = stack_.back();
+        stack_.pop_back();
+    }
+
+    void begin_list(int16_t id, uint8_t element_type, size_t size) {
+        field(id, kList);
+        if (size < 15) {
+            out_.push_back(static_cast<char>(size << 4 | element_type));
+        } else {
+            out_.push_back(static_cast<char>(0xF0 | element_type));
+            varint(size);
+        }
+    }
+    void list_i32(int32_t value) { varint(zigzag(value)); }
+    void list_binary(std::string_view value) { bytes(value); }
+
+    // End of the top-level struct
+    void stop() { out_.push_back(0); }
+
+private:
+    static uint64_t zigzag(int64_t v) {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            out_.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        out_.push_back(static_cast<char>(v));
+    }
+
+    void bytes(std::string_view value) {
+        varint(value.size());
+        out_.append(value.data(), value.size());
+    }
+
+    void field(int16_t id, uint8_t type) {
+        const int delta = id - last_;
+        if (delta > 0 && delta <= 15) {
+            out_.push_back(static_cast<char>(delta << 4 | type));
+        } else {
+            out_.push_back(static_cast<char>(type));
+            varint(zigzag(id));
+        }
+        last_ = id;
+    }
+
+    std::string out_;
+    int16_t last_ = 0;
+    std::vector<int16_t> stack_;
+};
+
+// RLE / bit-packing hybrid encoding of values below 2^bit_width: runs of 8
+// or more equal values become RLE runs, the rest bit-packed groups of 8
+void encode_hybrid(const uint32_t* values, size_t n, int bit_width, std::string& out) {
+    auto varint = [&out](uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    };
+    // Length of the run of equal values at i, counted up to limit
+    auto run_at = [&](size_t i, size_t limit) {
+        size_t j = i + 1;
+        while (j < n && j - i < limit && values[j] == values[i]) j++;
+        return j - i;
+    };
+    const size_t value_bytes = (static_cast<size_t>(bit_width) + 7) / 8;
+
+    size_t i = 0;
+    while (i < n) {
+        const size_t run = run_at(i, std::numeric_limits<size_t>::max());
+        if (run >= 8) {
+            varint(static_cast<uint64_t>(run) << 1);
+            for (size_t b = 0; b < value_bytes; b++) out.push_back(static_cast<char>(values[i] >> (8 * b)));
+            i += run;
+            continue;
+        }
+        // Whole groups of 8 until a long run starts; only the last group
+        // of the page may be short (and is zero-padded)
+        size_t end = i;
+        do {
+            end += 8;
+        } while (end < n && run_at(end, 8) < 8);
+        const size_t groups = (end - i) / 8;
+        end = std::min(end, n);
+        varint(static_cast<uint64_t>(groups) << 1 | 1);
+        uint64_t bits = 0;
+        int filled = 0;
+        for (size_t k = i; k < i + groups * 8; k++) {
+            bits |= static_cast<uint64_t>(k < end ? values[k] : 0) << filled;
+            filled += bit_width;
+            while (filled >= 8) {
+                out.push_back(static_cast<char>(bits));
+                bits >>= 8;
+                filled -= 8;
+            }
+        }
+        i = end;
+    }
+}
+
+int bit_width(size_t max_value) {
+    int width = 1;
+    while (width < 32 && (max_value >> width) != 0) width++;
+    return width;
+}
+
+template <typename T>
+std::string plain(T value) {
+    return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Statistics of a fixed-width column; NaNs are left out and zero bounds
+// are written as -0.0 / +0.0, as the format asks
+template <typename T>
+void value_range(const std::vector<T>& values, std::optional<std::string>& min,
+                 std::optional<std::string>& max) {
+    bool any = false;
+    T lo = T();
+    T hi = T();
+    for (T v : values) {
+        if constexpr (std::is_floating_point<T>::value) {
+            if (std::isnan(v)) continue;
+        }
+        if (!any) {
+            lo = hi = v;
+            any = true;
+        } else {
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+    }
+    if (!any) return;
+    if constexpr (std::is_floating_point<T>::value) {
+        if (lo == 0) lo = -T(0);
+        if (hi == 0) hi = T(0);
+    }
+    min = plain(lo);
+    max = plain(hi);
+}
+
+}  // namespace parquet
+
+}  // namespace
+
+// ============================================================================
+// ColumnarWriter
+// ============================================================================
+
+ColumnarWriter::ColumnarWriter(const std::string& path, ExportFormat format,
+                               const ColumnarExportConfig& config)
+    : path_(path), format_(format), config_(config) {
+    if (config_.row_group_rows == 0 || config_.page_rows == 0) {
+        throw std::runtime_error("row_group_rows and page_rows must be positive");
+    }
+    if (format_ == ExportFormat::Parquet && !binary::codec_available(config_.codec)) {
+        throw std::runtime_error(std::string("Compression codec not available in this build: ") +
+                                 binary::codec_name(config_.codec));
+    }
+    file_.open(path_, std::ios::binary);
+    if (!file_.is_open()) {
+        throw std::runtime_error("Failed to create file: " + path_);
+    }
+    pending_.reserve(config_.row_group_rows);
+
+    if (format_ == ExportFormat::Arrow) {
+        arrow_begin();
+    } else {
+        write_bytes(parquet::kMagic, 4);
+    }
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Reported by an explicit close(); a destructor cannot
+    }
+}
+
+void ColumnarWriter::write(const TelemetryData& data) {
+    pending_.append(data);
+    if (pending_.size() >= config_.row_group_rows) flush_group();
+}
+
+void ColumnarWriter::write(const TelemetryBatch& batch) {
+    size_t begin = 0;
+    while (begin < batch.size()) {
+        const size_t end = std::min(batch.size(), begin + (config_.row_group_rows - pending_.size()));
+        pending_.append(batch, begin, end);
+        if (pending_.size() >= config_.row_group_rows) flush_group();
+        begin = end;
+    }
+}
+
+void ColumnarWriter::close() {
+    if (closed_) return;
+    closed_ = true;
+
+    flush_group();
+    if (format_ == ExportFormat::Arrow) {
+        arrow_end();
+    } else {
+        parquet_end();
+    }
+    file_.flush();
+    if (!file_) {
+        throw std::runtime_error("Failed to write file: " + path_);
+    }
+    file_.close();
+}
+
+void ColumnarWriter::flush_group() {
+    if (pending_.empty()) return;
+    if (format_ == ExportFormat::Arrow) {
+        arrow_record_batch();
+    } else {
+        parquet_row_group();
+    }
+    rows_written_ += pending_.size();
+    groups_++;
+    pending_.clear();   // keeps the dictionaries: Arrow codes stay valid
+}
+
+void ColumnarWriter::write_bytes(const void* data, size_t size) {
+    file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    offset_ += size;
+}
+
+void ColumnarWriter::pad_to(size_t alignment) {
+    static const char zeros[8] = {};
+    const size_t pad = (alignment - offset_ % alignment) % alignment;
+    write_bytes(zeros, pad);
+}
+
+// ----------------------------------------------------------------------------
+// Arrow IPC file
+// ----------------------------------------------------------------------------
+
+void ColumnarWriter::arrow_begin() {
+    write_bytes(arrow::kMagic, 6);
+    pad_to(8);
+    arrow::FlatBuilder fb;
+    const arrow::Ref schema = arrow::schema(fb);
+    arrow_message(arrow::message(fb, arrow::kHeaderSchema, schema, 0), {}, nullptr);
+}
+
+// Encapsulated message: continuation marker, metadata length, flatbuffer
+// (a multiple of 8 bytes), then the body buffers
+void ColumnarWriter::arrow_message(const std::string& metadata, const std::vector<std::string_view>& body,
+                                   std::vector<ArrowBlock>* blocks) {
+    ArrowBlock block;
+    block.offset = static_cast<int64_t>(offset_);
+    block.metadata_length = static_cast<int32_t>(8 + metadata.size());
+    const int32_t length = static_cast<int32_t>(metadata.size());
+    write_bytes(&arrow::kContinuation, sizeof(arrow::kContinuation));
+    write_bytes(&length, sizeof(length));
+    write_bytes(metadata.data(), metadata.size());
+
+    const uint64_t body_start = offset_;
+    for (std::string_view part : body) {
+        write_bytes(part.data(), part.size());
+        pad_to(8);
+    }
+    block.body_length = static_cast<int64_t>(offset_ - body_start);
+    if (blocks) blocks->push_back(block);
+}
+
+void ColumnarWriter::arrow_record_batch() {
+    const size_t rows = pending_.size();
+    const auto length = static_cast<int64_t>(rows);
+
+    // diagnostic_code is null where it is empty (code 0)
+    std::vector<uint8_t> validity;
+    int64_t nulls = 0;
+    for (size_t i = 0; i < rows; i++) {
+        if (pending_.diagnostic_code[i] == 0) nulls++;
+    }
+    if (nulls > 0) {
+        validity.assign((rows + 7) / 8, 0);
+        for (size_t i = 0; i < rows; i++) {
+            if (pending_.diagnostic_code[i] != 0) validity[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        }
+    }
+
+    // Every column: an empty validity buffer and its values, in place
+    arrow::Body body;
+    std::string nodes;
+    auto column = [&](const auto& values, int64_t null_count) {
+        arrow::put<int64_t>(nodes, length);
+        arrow::put<int64_t>(nodes, null_count);
+        if (null_count > 0) {
+            body.add(validity.data(), validity.size());
+        } else {
+            body.add(nullptr, 0);
+        }
+        body.add(values.data(), values.size() * sizeof(values[0]));
+    };
+    column(pending_.vehicle_id, 0);   // uint32 codes, read as int32 indices
+    column(pending_.timestamp, 0);
+    column(pending_.latitude, 0);
+    column(pending_.longitude, 0);
+    column(pending_.speed, 0);
+    column(pending_.heading, 0);
+    column(pending_.engine_rpm, 0);
+    column(pending_.fuel_level, 0);
+    column(pending_.odometer_km, 0);
+    column(pending_.engine_temp, 0);
+    column(pending_.battery_volt, 0);
+    column(pending_.diagnostic_code, nulls);
+
+    arrow_dictionaries();
+    arrow::FlatBuilder fb;
+    const arrow::Ref batch = arrow::record_batch(fb, length, nodes, kColumnCount, body.buffers, body.count);
+    arrow_message(arrow::message(fb, arrow::kHeaderRecordBatch, batch, body.length), body.parts,
+                  &arrow_batches_);
+}
+
+// Dictionary entries from begin on as one utf8 column (offsets, then the
+// bytes): the whole dictionary, or with begin > 0 a delta appending to it
+void ColumnarWriter::arrow_dictionary(int64_t id, const StringTable& dict, size_t begin) {
+    const size_t count = dict.size() - begin;
+    std::vector<int32_t> offsets;
+    offsets.reserve(count + 1);
+    std::string bytes;
+    offsets.push_back(0);
+    for (size_t i = begin; i < dict.size(); i++) {
+        const std::string_view value = dict.view(static_cast<uint32_t>(i));
+        bytes.append(value.data(), value.size());
+        offsets.push_back(static_cast<int32_t>(bytes.size()));
+    }
+
+    arrow::Body body;
+    body.add(nullptr, 0);
+    body.add(offsets.data(), offsets.size() * sizeof(int32_t));
+    body.add(bytes.data(), bytes.size());
+    std::string nodes;
+    arrow::put<int64_t>(nodes, static_cast<int64_t>(count));
+    arrow::put<int64_t>(nodes, 0);
+
+    arrow::FlatBuilder fb;
+    const arrow::Ref data = arrow::record_batch(fb, static_cast<int64_t>(count), nodes, 1,
+                                                body.buffers, body.count);
+    fb.start_table();
+    fb.add<int64_t>(0, id);
+    fb.add_offset(1, data);
+    fb.add<uint8_t>(2, begin > 0);   // isDelta
+    const arrow::Ref batch = fb.end_table();
+    arrow_message(arrow::message(fb, arrow::kHeaderDictionaryBatch, batch, body.length), body.parts,
+                  &arrow_dictionaries_);
+}
+
+// Send the dictionary entries added since the last batch ahead of the
+// batch that uses them: the first time the whole dictionary, then deltas
+void ColumnarWriter::arrow_dictionaries() {
+    const StringTable* dicts[] = {&pending_.vehicle_dict, &pending_.diagnostic_dict};
+    const int64_t ids[] = {arrow::kVehicleDictionary, arrow::kDiagnosticDictionary};
+    const bool first = arrow_dictionaries_.empty();
+    for (size_t d = 0; d < 2; d++) {
+        size_t& sent = arrow_dict_sent_[d];
+        if (!first && sent == dicts[d]->size()) continue;
+        arrow_dictionary(ids[d], *dicts[d], sent);
+        sent = dicts[d]->size();
+    }
+}
+
+// End-of-stream marker, footer, footer length and magic
+void ColumnarWriter::arrow_end() {
+    arrow_dictionaries();   // a file without rows still defines both
+    const uint32_t eos[2] = {arrow::kContinuation, 0};
+    write_bytes(eos, sizeof(eos));
+
+    auto blocks = [](const std::vector<ArrowBlock>& list) {
+        std::string image;
+        for (const ArrowBlock& block : list) {
+            arrow::put<int64_t>(image, block.offset);
+            arrow::put<int32_t>(image, block.metadata_length);
+            arrow::put<int32_t>(image, 0);
+            arrow::put<int64_t>(image, block.body_length);
+        }
+        return image;
+    };
+    arrow::FlatBuilder fb;
+    const arrow::Ref schema = arrow::schema(fb);
+    const arrow::Ref dictionaries = fb.structs(blocks(arrow_dictionaries_), arrow_dictionaries_.size());
+    const arrow::Ref batches = fb.structs(blocks(arrow_batches_), arrow_batches_.size());
+    fb.start_table();
+    fb.add_offset(1, schema);
+    fb.add_offset(2, dictionaries);
+    fb.add_offset(3, batches);
+    fb.add<int16_t>(0, arrow::kMetadataV5);
+    const std::string footer = fb.finish(fb.end_table());
+
+    const int32_t footer_length = static_cast<int32_t>(footer.size());
+    write_bytes(footer.data(), footer.size());
+    write_bytes(&footer_length, sizeof(footer_length));
+    write_bytes(arrow::kMagic, 6);
+}
+
+// ----------------------------------------------------------------------------
+// Parquet file
+// ----------------------------------------------------------------------------
+
+void ColumnarWriter::parquet_row_group() {
+    ParquetRowGroup group;
+    group.num_rows = static_cast<int64_t>(pending_.size());
+    group.file_offset = static_cast<int64_t>(offset_);
+    group.columns.resize(kColumnCount);
+
+    parquet_dictionary_column(pending_.vehicle_id, pending_.vehicle_dict, false, group.columns[0]);
+    parquet_plain_column(pending_.timestamp, parquet::kInt64, group.columns[1]);
+    parquet_plain_column(pending_.latitude, parquet::kDouble, group.columns[2]);
+    parquet_plain_column(pending_.longitude, parquet::kDouble, group.columns[3]);
+    parquet_plain_column(pending_.speed, parquet::kDouble, group.columns[4]);
+    parquet_plain_column(pending_.heading, parquet::kDouble, group.columns[5]);
+    parquet_plain_column(pending_.engine_rpm, parquet::kInt32, group.columns[6]);
+    parquet_plain_column(pending_.fuel_level, parquet::kDouble, group.columns[7]);
+    parquet_plain_column(pending_.odometer_km, parquet::kDouble, group.columns[8]);
+    parquet_plain_column(pending_.engine_temp, parquet::kDouble, group.columns[9]);
+    parquet_plain_column(pending_.battery_volt, parquet::kDouble, group.columns[10]);
+    parquet_dictionary_column(pending_.diagnostic_code, pending_.diagnostic_dict, true, group.columns[11]);
+
+    group.total_byte_size = 0;
+    group.total_compressed_size = 0;
+    for (const ParquetColumn& column : group.columns) {
+        group.total_byte_size += column.uncompressed_size;
+        group.total_compressed_size += column.compressed_size;
+    }
+    row_groups_.push_back(std::move(group));
+}
+
+template <typename T>
+void ColumnarWriter::parquet_plain_column(const std::vector<T>& values, int type, ParquetColumn& column) {
+    column.type = type;
+    column.encodings = {parquet::kPlain};
+    column.num_values = static_cast<int64_t>(values.size());
+    parquet::value_range(values, column.min, column.max);
+
+    for (size_t begin = 0; begin < values.size(); begin += config_.page_rows) {
+        const size_t end = std::min(values.size(), begin + config_.page_rows);
+        parquet_page(parquet::kDataPage, end - begin, parquet::kPlain,
+                     std::string_view(reinterpret_cast<const char*>(values.data() + begin),
+                                      (end - begin) * sizeof(T)),
+                     column);
+    }
+}
+
+// Dictionary page of the values this row group uses (in first-use order),
+// then pages of [definition levels] + bit width + hybrid-coded indices.
+// With nullable, code 0 (empty) is written as null.
+void ColumnarWriter::parquet_dictionary_column(const std::vector<uint32_t>& codes, const StringTable& dict,
+                                               bool nullable, ParquetColumn& column) {
+    constexpr uint32_t kUnused = std::numeric_limits<uint32_t>::max();
+    column.type = parquet::kByteArray;
+    column.num_values = static_cast<int64_t>(codes.size());
+
+    local_codes_.assign(dict.size(), kUnused);
+    used_codes_.clear();
+    for (uint32_t code : codes) {
+        if (nullable && code == 0) {
+            column.null_count++;
+        } else if (local_codes_[code] == kUnused) {
+            local_codes_[code] = static_cast<uint32_t>(used_codes_.size());
+            used_codes_.push_back(code);
+        }
+    }
+
+    const bool dictionary = !used_codes_.empty();
+    column.encodings = {dictionary ? parquet::kPlainDictionary : parquet::kPlain};
+    if (nullable) column.encodings.push_back(parquet::kRle);
+    if (dictionary) {
+        column.distinct_count = static_cast<int64_t>(used_codes_.size());
+        std::string_view lo = dict.view(used_codes_[0]);
+        std::string_view hi = lo;
+        page_.clear();
+        for (uint32_t code : used_codes_) {
+            const std::string_view value = dict.view(code);
+            const auto length = static_cast<uint32_t>(value.size());
+            page_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            page_.append(value.data(), value.size());
+            lo = std::min(lo, value);
+            hi = std::max(hi, value);
+        }
+        column.min = std::string(lo);
+        column.max = std::string(hi);
+        parquet_page(parquet::kDictionaryPage, used_codes_.size(), parquet::kPlainDictionary, page_, column);
+    }
+
+    const int width = parquet::bit_width(used_codes_.empty() ? 0 : used_codes_.size() - 1);
+    for (size_t begin = 0; begin < codes.size(); begin += config_.page_rows) {
+        const size_t end = std::min(codes.size(), begin + config_.page_rows);
+        page_.clear();
+        levels_.clear();
+        indices_.clear();
+        for (size_t i = begin; i < end; i++) {
+            const bool present = !nullable || codes[i] != 0;
+            if (nullable) levels_.push_back(present ? 1 : 0);
+            if (present) indices_.push_back(local_codes_[codes[i]]);
+        }
+        if (nullable) {
+            page_.append(4, '\0');
+            parquet::encode_hybrid(levels_.data(), levels_.size(), 1, page_);
+            const auto length = static_cast<uint32_t>(page_.size() - 4);
+            std::memcpy(&page_[0], &length, sizeof(length));
+        }
+        if (dictionary) {
+            page_.push_back(static_cast<char>(width));
+            parquet::encode_hybrid(indices_.data(), indices_.size(), width, page_);
+        }
+        parquet_page(parquet::kDataPage, end - begin, dictionary ? parquet::kPlainDictionary : parquet::kPlain,
+                     page_, column);
+    }
+}
+
+// PageHeader, then the (compressed) page
+void ColumnarWriter::parquet_page(int page_type, size_t num_values, int encoding, std::string_view data,
+                                  ParquetColumn& column) {
+    const std::string_view stored = parquet_compress(data);
+
+    parquet::ThriftWriter header;
+    header.i32(1, page_type);
+    header.i32(2, static_cast<int32_t>(data.size()));
+    header.i32(3, static_cast<int32_t>(stored.size()));
+    if (page_type == parquet::kDictionaryPage) {
+        header.begin_struct(7);
+        header.i32(1, static_cast<int32_t>(num_values));
+        header.i32(2, encoding);
+        header.end_struct();
+    } else {
+        header.begin_struct(5);
+        header.i32(1, static_cast<int32_t>(num_values));
+        header.i32(2, encoding);
+        header.i32(3, parquet::kRle);   // definition levels
+        header.i32(4, parquet::kRle);   // repetition levels
+        header.end_struct();
+    }
+    header.stop();
+
+    if (page_type == parquet::kDictionaryPage) {
+        column.dictionary_page_offset = static_cast<int64_t>(offset_);
+    } else if (column.data_page_offset == 0) {
+        column.data_page_offset = static_cast<int64_t>(offset_);
+    }
+    column.uncompressed_size += static_cast<int64_t>(header.out().size() + data.size());
+    column.compressed_size += static_cast<int64_t>(header.out().size() + stored.size());
+    write_bytes(header.out().data(), header.out().size());
+    write_bytes(stored.data(), stored.size());
+}
+
+std::string_view ColumnarWriter::parquet_compress(std::string_view data) {
+    switch (config_.codec) {
+        case binary::Codec::None:
+            return data;
+#ifdef FLEET_HAVE_ZLIB
+        case binary::Codec::Zlib: {
+            // Parquet's GZIP codec is the gzip container, not a zlib stream
+            z_stream stream;
+            std::memset(&stream, 0, sizeof(stream));
+            if (deflateInit2(&stream, config_.level > 0 ? config_.level : Z_DEFAULT_COMPRESSION,
+                             Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("gzip compression failed");
+            }
+            compressed_.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            stream.avail_in = static_cast<uInt>(data.size());
+            stream.next_out = reinterpret_cast<Bytef*>(&compressed_[0]);
+            stream.avail_out = static_cast<uInt>(compressed_.size());
+            const int rc = deflate(&stream, Z_FINISH);
+            deflateEnd(&stream);
+            if (rc != Z_STREAM_END) throw std::runtime_error("gzip compression failed");
+            compressed_.resize(stream.total_out);
+            return compressed_;
+        }
+#endif
+#ifdef FLEET_HAVE_ZSTD
+        case binary::Codec::Zstd: {
+            compressed_.resize(ZSTD_compressBound(data.size()));
+            const size_t length = ZSTD_compress(&compressed_[0], compressed_.size(), data.data(), data.size(),
+                                                config_.level > 0 ? config_.level : ZSTD_CLEVEL_DEFAULT);
+            if (ZSTD_isError(length)) throw std::runtime_error("zstd compression failed");
+            compressed_.resize(length);
+            return compressed_;
+        }
+#endif
+#ifdef FLEET_HAVE_LZ4
+        case binary::Codec::LZ4: {
+            compressed_.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(data.size()))));
+            const int length = LZ4_compress_default(data.data(), &compressed_[0], static_cast<int>(data.size()),
+                                                    static_cast<int>(compressed_.size()));
+            if (length <= 0) throw std::runtime_error("lz4 compression failed");
+            compressed_.resize(static_cast<size_t>(length));
+            return compressed_;
+        }
+#endif
+        default:
+            break;
+    }
+    throw std::runtime_error(std::string("Compression codec not available in this build: ") +
+                             binary::codec_name(config_.codec));
+}
+
+// FileMetaData, its length and the closing magic
+void ColumnarWriter::parquet_end() {
+    using parquet::ThriftWriter;
+    ThriftWriter meta;
+    meta.i32(1, 1);   // version
+
+    // Schema: the root, then one flat column per field
+    meta.begin_list(2, ThriftWriter::kStruct, kColumnCount + 1);
+    meta.begin_element();
+    meta.binary(4, "schema");
+    meta.i32(5, static_cast<int32_t>(kColumnCount));
+    meta.end_struct();
+    const int types[] = {
+        parquet::kByteArray, parquet::kInt64, parquet::kDouble, parquet::kDouble, parquet::kDouble,
+        parquet::kDouble, parquet::kInt32, parquet::kDouble, parquet::kDouble, parquet::kDouble,
+        parquet::kDouble, parquet::kByteArray,
+    };
+    for (size_t i = 0; i < kColumnCount; i++) {
+        meta.begin_element();
+        meta.i32(1, types[i]);
+        meta.i32(3, i == kColumnCount - 1 ? parquet::kOptional : parquet::kRequired);
+        meta.binary(4, kColumns[i]);
+        if (types[i] == parquet::kByteArray) {
+            meta.i32(6, parquet::kConvertedUtf8);
+            meta.begin_struct(10);   // LogicalType
+            meta.begin_struct(1);    // STRING
+            meta.end_struct();
+            meta.end_struct();
+        } else if (types[i] == parquet::kInt64) {
+            meta.i32(6, parquet::kConvertedTimestampMillis);
+            meta.begin_struct(10);   // LogicalType
+            meta.begin_struct(8);    // TIMESTAMP
+            meta.boolean(1, true);   // isAdjustedToUTC
+            meta.begin_struct(2);    // unit
+            meta.begin_struct(1);    // MILLIS
+            meta.end_struct();
+            meta.end_struct();
+            meta.end_struct();
+            meta.end_struct();
+        }
+        meta.end_struct();
+    }
+
+    meta.i64(3, static_cast<int64_t>(rows_written_));
+
+    meta.begin_list(4, ThriftWriter::kStruct, row_groups_.size());
+    for (size_t g = 0; g < row_groups_.size(); g++) {
+        const ParquetRowGroup& group = row_groups_[g];
+        meta.begin_element();
+        meta.begin_list(1, ThriftWriter::kStruct, group.columns.size());
+        for (size_t i = 0; i < group.columns.size(); i++) {
+            const ParquetColumn& column = group.columns[i];
+            meta.begin_element();
+            meta.i64(2, 0);          // file_offset (deprecated)
+            meta.begin_struct(3);    // ColumnMetaData
+            meta.i32(1, column.type);
+            meta.begin_list(2, ThriftWriter::kI32, column.encodings.size());
+            for (int encoding : column.encodings) meta.list_i32(encoding);
+            meta.begin_list(3, ThriftWriter::kBinary, 1);
+            meta.list_binary(kColumns[i]);
+            meta.i32(4, parquet::codec_id(config_.codec));
+            meta.i64(5, column.num_values);
+            meta.i64(6, column.uncompressed_size);
+            meta.i64(7, column.compressed_size);
+            meta.i64(9, column.data_page_offset);
+            if (column.dictionary_page_offset >= 0) meta.i64(11, column.dictionary_page_offset);
+            meta.begin_struct(12);   // Statistics
+            meta.i64(3, column.null_count);
+            if (column.distinct_count >= 0) meta.i64(4, column.distinct_count);
+            if (column.max) meta.binary(5, *column.max);
+            if (column.min) meta.binary(6, *column.min);
+            meta.end_struct();
+            meta.end_struct();
+            meta.end_struct();
+        }
+        meta.i64(2, group.total_byte_size);
+        meta.i64(3, group.num_rows);
+        meta.i64(5, group.file_offset);
+        meta.i64(6, group.total_compressed_size);
+        meta.i16(7, static_cast<int16_t>(g));
+        meta.end_struct();
+    }
+
+    meta.binary(6, "fleet_parser version 1.0.0");
+
+    // Statistics use each type's natural order (signed numbers, unsigned bytes)
+    meta.begin_list(7, ThriftWriter::kStruct, kColumnCount);
+    for (size_t i = 0; i < kColumnCount; i++) {
+        meta.begin_element();
+        meta.begin_struct(1);    // TYPE_ORDER
+        meta.end_struct();
+        meta.end_struct();
+    }
+    meta.stop();
+
+    const auto length = static_cast<uint32_t>(meta.out().size());
+    write_bytes(meta.out().data(), meta.out().size());
+    write_bytes(&length, sizeof(length));
+    write_bytes(parquet::kMagic, 4);
+}
+
+}  // namespace fleet
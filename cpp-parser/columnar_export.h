@@ -0,0 +1,173 @@
+#ifndef COLUMNAR_EXPORT_H
+#define COLUMNAR_EXPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "binary_format.h"
+#include "telemetry_batch.h"
+
+namespace fleet {
+
+// ============================================================================
+// Columnar export for analytics engines (DuckDB, Spark, pandas)
+//
+// Both formats carry the same twelve columns, named as in the JSON output:
+//
+//   vehicle_id       string, dictionary-encoded
+//   timestamp        timestamp (ms, UTC)
+//   latitude         float64      longitude     float64
+//   speed            float64      heading       float64
+//   engine_rpm       int32        fuel_level    float64
+//   odometer_km      float64      engine_temp   float64
+//   battery_volt     float64
+//   diagnostic_code  string, dictionary-encoded, null when empty
+//
+// Arrow: an IPC file ("Feather v2"), metadata version V5. Each group of
+// rows is one record batch whose buffers are the TelemetryBatch columns
+// written as-is, 8-byte aligned and uncompressed, so readers can
+// memory-map the file and use the columns in place. Dictionary codes are
+// the writer's own (stable for the whole file). Each dictionary is written
+// whole before the first record batch, and the values that later batches
+// add follow as delta dictionary batches ahead of them. The stream part of
+// the file is therefore readable front to back as well as via the footer.
+//
+// Parquet: format version 1 data pages. Each group of rows is one row
+// group; the dictionary columns get a per-row-group dictionary page and
+// RLE / bit-packed index pages, the others PLAIN pages of page_rows
+// values. Every column chunk records min / max, null count (and distinct
+// count for dictionary columns) so engines can skip row groups on
+// timestamp, vehicle or position predicates. Input ordered with --sort
+// gives row groups that each hold a narrow vehicle range.
+// ============================================================================
+
+enum class ExportFormat : uint8_t {
+    Arrow,
+    Parquet,
+};
+
+const char* export_format_name(ExportFormat format);
+
+struct ColumnarExportConfig {
+    // Rows per Parquet row group / Arrow record batch. 1M rows is ~50 MB
+    // of column data: large enough for efficient scans, small enough for
+    // statistics to prune time ranges and for engines to parallelize
+    // over groups.
+    size_t row_group_rows = 1 << 20;
+    size_t page_rows = 64 * 1024;                // Parquet data page size
+    binary::Codec codec = binary::Codec::None;   // Parquet page compression (Arrow is never compressed)
+    int level = 0;                               // codec level (0 = codec default)
+};
+
+// Writes telemetry to an Arrow IPC or Parquet file.
+//
+// Rows are gathered into a TelemetryBatch until row_group_rows are
+// pending and then written as one group, straight from the columns. May
+// be used as a BatchRing sink; it is not thread-safe otherwise.
+class ColumnarWriter {
+public:
+    ColumnarWriter(const std::string& path, ExportFormat format,
+                   const ColumnarExportConfig& config = ColumnarExportConfig());
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    void write(const TelemetryData& data);
+    void write(const TelemetryBatch& batch);
+
+    // Write the pending rows and the footer. Called by the destructor;
+    // call it explicitly to see write errors.
+    void close();
+
+    ExportFormat format() const { return format_; }
+    uint64_t rows_written() const { return rows_written_; }
+    uint64_t bytes_written() const { return offset_; }
+    size_t groups_written() const { return groups_; }
+
+private:
+    // Location of an Arrow IPC message (footer Block)
+    struct ArrowBlock {
+        int64_t offset;
+        int32_t metadata_length;
+        int64_t body_length;
+    };
+
+    // Footer metadata of one Parquet column chunk
+    struct ParquetColumn {
+        int type;
+        std::vector<int> encodings;
+        int64_t num_values = 0;
+        int64_t uncompressed_size = 0;
+        int64_t compressed_size = 0;
+        int64_t data_page_offset = 0;
+        int64_t dictionary_page_offset = -1;
+        int64_t null_count = 0;
+        int64_t distinct_count = -1;
+        std::optional<std::string> min;   // PLAIN-encoded statistics
+        std::optional<std::string> max;
+    };
+
+    struct ParquetRowGroup {
+        std::vector<ParquetColumn> columns;
+        int64_t num_rows;
+        int64_t file_offset;
+        int64_t total_byte_size;
+        int64_t total_compressed_size;
+    };
+
+    void flush_group();
+    void write_bytes(const void* data, size_t size);
+    void pad_to(size_t alignment);
+
+    // Arrow IPC
+    void arrow_begin();
+    void arrow_message(const std::string& metadata, const std::vector<std::string_view>& body,
+                       std::vector<ArrowBlock>* blocks);
+    void arrow_record_batch();
+    void arrow_dictionary(int64_t id, const StringTable& dict, size_t begin);
+    void arrow_dictionaries();
+    void arrow_end();
+
+    // Parquet
+    void parquet_row_group();
+    template <typename T>
+    void parquet_plain_column(const std::vector<T>& values, int type, ParquetColumn& column);
+    void parquet_dictionary_column(const std::vector<uint32_t>& codes, const StringTable& dict,
+                                   bool nullable, ParquetColumn& column);
+    void parquet_page(int page_type, size_t num_values, int encoding, std::string_view data,
+                      ParquetColumn& column);
+    std::string_view parquet_compress(std::string_view data);
+    void parquet_end();
+
+    std::ofstream file_;
+    std::string path_;
+    ExportFormat format_;
+    ColumnarExportConfig config_;
+    bool closed_ = false;
+    uint64_t offset_ = 0;
+    uint64_t rows_written_ = 0;
+    size_t groups_ = 0;
+
+    TelemetryBatch pending_;   // its dictionaries are the file's (Arrow codes)
+
+    std::vector<ArrowBlock> arrow_dictionaries_;
+    std::vector<ArrowBlock> arrow_batches_;
+    size_t arrow_dict_sent_[2] = {0, 0};   // dictionary entries written so far
+
+    std::vector<ParquetRowGroup> row_groups_;
+    std::vector<uint32_t> local_codes_;   // file code -> row group dictionary index
+    std::vector<uint32_t> used_codes_;    // row group dictionary, as file codes
+    std::vector<uint32_t> levels_;        // scratch for one page
+    std::vector<uint32_t> indices_;
+    std::string page_;
+    std::string compressed_;
+};
+
+}  // namespace fleet
+
+#endif  // COLUMNAR_EXPORT_H
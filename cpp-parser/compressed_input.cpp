@@ -0,0 +1,403 @@
+#include "compressed_input.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef FLEET_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef FLEET_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace fleet {
+
+// ============================================================================
+// Detection
+// ============================================================================
+
+const char* compression_name(Compression compression) {
+    switch (compression) {
+        case Compression::None: return "none";
+        case Compression::Gzip: return "gzip";
+        case Compression::Zstd: return "zstd";
+    }
+    return "unknown";
+}
+
+bool compression_available(Compression compression) {
+    switch (compression) {
+        case Compression::None: return true;
+#ifdef FLEET_HAVE_ZLIB
+        case Compression::Gzip: return true;
+#endif
+#ifdef FLEET_HAVE_ZSTD
+        case Compression::Zstd: return true;
+#endif
+        default: return false;
+    }
+}
+
+Compression detect_compression(std::string_view head) {
+    const auto* p = reinterpret_cast<const unsigned char*>(head.data());
+    if (head.size() >= 2 && p[0] == 0x1f && p[1] == 0x8b) return Compression::Gzip;
+    if (head.size() >= 4 && p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd) {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+Compression detect_compression(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char head[4];
+    file.read(head, sizeof(head));
+    return detect_compression(std::string_view(head, static_cast<size_t>(file.gcount())));
+}
+
+// ============================================================================
+// Codecs
+// ============================================================================
+
+namespace {
+
+inline uint32_t load_le32(const unsigned char* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+// Size of the BGZF member at p (its BC extra subfield), or 0 if it is not one
+size_t bgzf_member_size(const unsigned char* p, size_t avail) {
+    if (avail < 18 || p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || !(p[3] & 0x04)) return 0;
+    size_t xlen = p[10] | size_t(p[11]) << 8;
+    if (avail < 12 + xlen) return 0;
+    for (size_t pos = 12; pos + 4 <= 12 + xlen;) {
+        size_t slen = p[pos + 2] | size_t(p[pos + 3]) << 8;
+        if (p[pos] == 'B' && p[pos + 1] == 'C' && slen == 2 && pos + 6 <= 12 + xlen) {
+            size_t size = (p[pos + 4] | size_t(p[pos + 5]) << 8) + 1;
+            return size >= 12 + xlen + 8 && size <= avail ? size : 0;
+        }
+        pos += 4 + slen;
+    }
+    return 0;
+}
+
+#ifdef FLEET_HAVE_ZLIB
+// gzip stream state (RAII)
+struct Inflater {
+    z_stream zs;
+    Inflater() {
+        std::memset(&zs, 0, sizeof(zs));
+        if (inflateInit2(&zs, 15 + 16) != Z_OK) throw std::runtime_error("zlib initialisation failed");
+    }
+    ~Inflater() { inflateEnd(&zs); }
+};
+#endif
+
+#ifdef FLEET_HAVE_ZSTD
+struct ZstdStream {
+    ZSTD_DStream* ds = ZSTD_createDStream();
+    ZstdStream() {
+        if (!ds) throw std::runtime_error("zstd initialisation failed");
+        ZSTD_initDStream(ds);
+    }
+    ~ZstdStream() { ZSTD_freeDStream(ds); }
+};
+#endif
+
+}  // namespace
+
+// ============================================================================
+// DecompressReader implementation
+// ============================================================================
+
+DecompressReader::DecompressReader(const std::string& filename, const DecompressConfig& config)
+    : filename_(filename), config_(config), input_(filename) {
+    if (config_.block_size == 0) config_.block_size = DecompressConfig().block_size;
+    config_.depth = std::max<size_t>(config_.depth, 1);
+
+    compression_ = detect_compression(input_.view().substr(0, 4));
+    if (compression_ == Compression::None) {
+        throw std::runtime_error("Not a gzip or zstd file: " + filename);
+    }
+    if (!compression_available(compression_)) {
+        throw std::runtime_error(std::string(compression_name(compression_)) +
+                                 " input is not supported by this build: " + filename);
+    }
+
+    size_t threads = ThreadPool::resolve_threads(config_.num_threads);
+    if (threads > 1 && find_members() && members_.size() > 1) {
+        // Tasks of about block_size decoded bytes, so small BGZF members
+        // are not dispatched one by one
+        for (size_t i = 0; i < members_.size();) {
+            size_t first = i;
+            uint64_t bytes = 0;
+            while (i < members_.size() && bytes < config_.block_size) {
+                const Member& m = members_[i++];
+                bytes += m.decoded_size ? m.decoded_size : m.size * 4;
+            }
+            tasks_.emplace_back(first, i);
+        }
+        pool_ = std::make_unique<ThreadPool>(threads);
+        size_t in_flight = std::max(threads * 2, config_.depth);
+        for (size_t i = 0; i < in_flight; i++) submit_next();
+    } else {
+        members_.clear();
+        decoder_ = std::thread([this]() { decoder_loop(); });
+    }
+}
+
+DecompressReader::~DecompressReader() {
+    if (decoder_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        decoder_.join();
+    }
+    // Let queued tasks finish while the members they read are still alive
+    pending_.clear();
+    pool_.reset();
+}
+
+std::string_view DecompressReader::next() {
+    if (pool_) {
+        while (!pending_.empty()) {
+            current_ = pending_.front().get();
+            pending_.pop_front();
+            submit_next();
+            if (!current_.empty()) {
+                bytes_out_ += current_.size();
+                return current_;
+            }
+        }
+        current_.clear();
+        return std::string_view();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (current_.capacity() > 0) spare_.push_back(std::move(current_));
+    current_ = std::string();
+    cv_.wait(lock, [this]() { return !ready_.empty() || finished_; });
+    if (!ready_.empty()) {
+        current_ = std::move(ready_.front());
+        ready_.pop_front();
+        cv_.notify_all();
+        bytes_out_ += current_.size();
+        return current_;
+    }
+    // Every good block is out; now report what stopped the decoder
+    if (!error_.empty()) throw std::runtime_error(error_);
+    return std::string_view();
+}
+
+// Split the input into independently decodable members, if it is made of them
+bool DecompressReader::find_members() {
+    const auto* data = reinterpret_cast<const unsigned char*>(input_.data());
+    const size_t size = input_.size();
+
+    if (compression_ == Compression::Gzip) {
+        for (size_t pos = 0; pos < size;) {
+            size_t member = bgzf_member_size(data + pos, size - pos);
+            if (member == 0) return false;
+            members_.push_back(Member{pos, member, load_le32(data + pos + member - 4)});
+            pos += member;
+        }
+        return true;
+    }
+
+#ifdef FLEET_HAVE_ZSTD
+    for (size_t pos = 0; pos < size;) {
+        size_t frame = ZSTD_findFrameCompressedSize(data + pos, size - pos);
+        if (ZSTD_isError(frame) || frame == 0) return false;
+        // Skippable frames (e.g. a seekable archive's seek table) hold no data
+        bool skippable = size - pos >= 4 && (load_le32(data + pos) & 0xFFFFFFF0u) == 0x184D2A50u;
+        if (!skippable) {
+            unsigned long long content = ZSTD_getFrameContentSize(data + pos, size - pos);
+            uint64_t decoded = content == ZSTD_CONTENTSIZE_UNKNOWN || content == ZSTD_CONTENTSIZE_ERROR
+                ? 0 : static_cast<uint64_t>(content);
+            members_.push_back(Member{pos, frame, decoded});
+        }
+        pos += frame;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string DecompressReader::decode_members(size_t first, size_t last) const {
+    std::string out;
+    uint64_t expected = 0;
+    for (size_t i = first; i < last; i++) expected += members_[i].decoded_size;
+    out.reserve(static_cast<size_t>(expected));
+
+    for (size_t i = first; i < last; i++) {
+        const Member& m = members_[i];
+        const char* src = input_.data() + m.offset;
+        size_t at = out.size();
+#ifdef FLEET_HAVE_ZLIB
+        if (compression_ == Compression::Gzip) {
+            if (m.decoded_size == 0) continue;   // BGZF end-of-file marker
+            out.resize(at + static_cast<size_t>(m.decoded_size));
+            Inflater inflater;
+            inflater.zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src));
+            inflater.zs.avail_in = static_cast<uInt>(m.size);
+            inflater.zs.next_out = reinterpret_cast<Bytef*>(&out[at]);
+            inflater.zs.avail_out = static_cast<uInt>(m.decoded_size);
+            if (inflate(&inflater.zs, Z_FINISH) != Z_STREAM_END || inflater.zs.avail_out != 0) {
+                throw std::runtime_error("Corrupt gzip member in " + filename_);
+            }
+        }
+#endif
+#ifdef FLEET_HAVE_ZSTD
+        if (compression_ == Compression::Zstd && m.decoded_size > 0) {
+            out.resize(at + static_cast<size_t>(m.decoded_size));
+            size_t len = ZSTD_decompress(&out[at], static_cast<size_t>(m.decoded_size), src, m.size);
+            if (ZSTD_isError(len) || len != m.decoded_size) {
+                throw std::runtime_error("Corrupt zstd frame in " + filename_);
+            }
+        } else if (compression_ == Compression::Zstd) {
+            // Frame without a content size: grow the output as it decodes
+            ZstdStream stream;
+            ZSTD_inBuffer in{src, m.size, 0};
+            for (;;) {
+                out.resize(at + ZSTD_DStreamOutSize());
+                ZSTD_outBuffer buffer{&out[0], out.size(), at};
+                size_t ret = ZSTD_decompressStream(stream.ds, &buffer, &in);
+                if (ZSTD_isError(ret)) throw std::runtime_error("Corrupt zstd frame in " + filename_);
+                at = buffer.pos;
+                if (ret == 0) break;
+                if (in.pos == in.size && buffer.pos < buffer.size) {
+                    throw std::runtime_error("Truncated zstd frame in " + filename_);
+                }
+            }
+            out.resize(at);
+        }
+#endif
+        (void)src;
+        (void)at;
+    }
+    return out;
+}
+
+void DecompressReader::submit_next() {
+    if (next_task_ >= tasks_.size()) return;
+    auto [first, last] = tasks_[next_task_++];
+    pending_.push_back(pool_->submit([this, first, last]() { return decode_members(first, last); }));
+}
+
+bool DecompressReader::publish(std::string&& block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return stopping_ || ready_.size() < config_.depth; });
+    if (stopping_) return false;
+    ready_.push_back(std::move(block));
+    block = std::string();
+    if (!spare_.empty()) {
+        block = std::move(spare_.back());
+        spare_.pop_back();
+    }
+    cv_.notify_all();
+    return true;
+}
+
+void DecompressReader::decoder_loop() {
+    const size_t block_size = config_.block_size;
+    std::string block(block_size, '\0');
+    size_t filled = 0;
+
+    // Full block out; false once the reader is being destroyed
+    auto flush = [&]() {
+        block.resize(filled);
+        if (!publish(std::move(block))) return false;
+        block.resize(block_size);
+        filled = 0;
+        return true;
+    };
+
+    std::string error;
+    try {
+        const size_t size = input_.size();
+#ifdef FLEET_HAVE_ZLIB
+        if (compression_ == Compression::Gzip) {
+            const auto* data = reinterpret_cast<const unsigned char*>(input_.data());
+            Inflater inflater;
+            z_stream& zs = inflater.zs;
+            size_t pos = 0;
+            for (;;) {
+                size_t chunk = std::min<size_t>(size - pos, UINT_MAX);
+                zs.next_in = const_cast<Bytef*>(data + pos);
+                zs.avail_in = static_cast<uInt>(chunk);
+                zs.next_out = reinterpret_cast<Bytef*>(&block[filled]);
+                zs.avail_out = static_cast<uInt>(block_size - filled);
+                int rc = inflate(&zs, Z_NO_FLUSH);
+                pos += chunk - zs.avail_in;
+                filled = block_size - zs.avail_out;
+                if (filled == block_size && !flush()) return;
+
+                if (rc == Z_STREAM_END) {
+                    // Concatenated members continue the stream; other trailing
+                    // bytes are ignored, as gzip itself does
+                    if (size - pos >= 2 && data[pos] == 0x1f && data[pos + 1] == 0x8b) {
+                        inflateReset(&zs);
+                        continue;
+                    }
+                    break;
+                }
+                if (rc == Z_BUF_ERROR && zs.avail_out > 0) {
+                    throw std::runtime_error("Truncated gzip input: " + filename_);
+                }
+                if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                    throw std::runtime_error("Corrupt gzip input " + filename_ + ": " +
+                                             (zs.msg ? zs.msg : "inflate failed"));
+                }
+            }
+        }
+#endif
+#ifdef FLEET_HAVE_ZSTD
+        if (compression_ == Compression::Zstd) {
+            ZstdStream stream;
+            ZSTD_inBuffer in{input_.data(), size, 0};
+            size_t ret = 0;
+            for (;;) {
+                ZSTD_outBuffer out{&block[0], block_size, filled};
+                ret = ZSTD_decompressStream(stream.ds, &out, &in);
+                if (ZSTD_isError(ret)) {
+                    throw std::runtime_error("Corrupt zstd input " + filename_ + ": " +
+                                             ZSTD_getErrorName(ret));
+                }
+                filled = out.pos;
+                bool room = out.pos < out.size;
+                if (filled == block_size && !flush()) return;
+                // All input taken and the decoder stopped short of a full block
+                if (in.pos == in.size && room) break;
+            }
+            if (ret != 0) throw std::runtime_error("Truncated zstd input: " + filename_);
+        }
+#endif
+        (void)size;
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    if (error.empty() && filled > 0 && !flush()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    error_ = error;
+    cv_.notify_all();
+}
+
+std::string decompress_file(const std::string& filename, size_t num_threads) {
+    DecompressConfig config;
+    config.num_threads = num_threads;
+    DecompressReader reader(filename, config);
+    std::string out;
+    for (std::string_view block = reader.next(); !block.empty(); block = reader.next()) {
+        out.append(block.data(), block.size());
+    }
+    return out;
+}
+
+}  // namespace fleet
@@ -0,0 +1,114 @@
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "mapped_file.h"
+
+namespace fleet {
+
+class ThreadPool;
+
+// Whole-file compression of a text input
+enum class Compression : uint8_t {
+    None,
+    Gzip,    // gzip, incl. multi-member and BGZF
+    Zstd,    // zstd frames, incl. the seekable format
+};
+
+const char* compression_name(Compression compression);
+bool compression_available(Compression compression);   // compiled in (zlib / zstd)
+
+// By magic bytes: 1f 8b is gzip, 28 b5 2f fd zstd
+Compression detect_compression(std::string_view head);
+// Of a file's first bytes; None when it cannot be read
+Compression detect_compression(const std::string& path);
+
+struct DecompressConfig {
+    size_t block_size = 1024 * 1024;   // decompressed bytes per block (sequential decode)
+    size_t depth = 3;                  // blocks decoded ahead of the caller
+    size_t num_threads = 1;            // > 1: decode independent members in parallel (0 = all cores)
+};
+
+// Streaming decompression of a gzip or zstd file, read like ReadAhead.
+//
+// The compressed file is mapped and decoded on a background thread into
+// rotating blocks, so decompression overlaps whatever the caller does with
+// the previous block. When the file is made of independently decodable
+// pieces and num_threads > 1 they are decoded in parallel on a thread pool
+// and handed over in file order: BGZF blocks (their BSIZE field gives
+// each member's length) and zstd frames (seekable archives, pzstd and
+// zstd -T output). Ordinary multi-member gzip members can only be found by
+// inflating, so those decode sequentially on the background thread.
+// Blocks end wherever the decoder does; callers carry straddling rows.
+class DecompressReader {
+public:
+    explicit DecompressReader(const std::string& filename, const DecompressConfig& config = DecompressConfig());
+    ~DecompressReader();
+
+    DecompressReader(const DecompressReader&) = delete;
+    DecompressReader& operator=(const DecompressReader&) = delete;
+
+    // The next decompressed block, empty at end of input. The view stays
+    // valid until the following call. Throws on corrupt or truncated input.
+    std::string_view next();
+
+    Compression compression() const { return compression_; }
+    bool parallel() const { return pool_ != nullptr; }
+    size_t members() const { return members_.size(); }   // independent pieces found (parallel)
+    uint64_t bytes_out() const { return bytes_out_; }
+
+private:
+    struct Member {
+        size_t offset;
+        size_t size;
+        uint64_t decoded_size;   // 0 = unknown
+    };
+
+    bool find_members();
+    std::string decode_members(size_t first, size_t last) const;
+    void submit_next();
+    void decoder_loop();
+    // Hand a decoded block to the caller; false once stopping
+    bool publish(std::string&& block);
+
+    std::string filename_;
+    DecompressConfig config_;
+    MappedFile input_;
+    Compression compression_ = Compression::None;
+    std::string current_;                // block the caller holds
+    uint64_t bytes_out_ = 0;
+
+    // Parallel decode: tasks of consecutive members, in file order
+    std::vector<Member> members_;
+    std::vector<std::pair<size_t, size_t>> tasks_;
+    size_t next_task_ = 0;
+    std::unique_ptr<ThreadPool> pool_;
+    std::deque<std::future<std::string>> pending_;
+
+    // Sequential decode on one background thread
+    std::thread decoder_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::string> ready_;
+    std::vector<std::string> spare_;     // drained blocks, reused for their capacity
+    bool finished_ = false;
+    bool stopping_ = false;
+    std::string error_;
+};
+
+// Decompress a whole file into memory (for passes that need every byte at once)
+std::string decompress_file(const std::string& filename, size_t num_threads = 1);
+
+}  // namespace fleet
+
+#endif  // COMPRESSED_INPUT_H
@@ -0,0 +1,208 @@
+#ifndef FAST_DECODE_H
+#define FAST_DECODE_H
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+namespace fleet {
+
+// Numeric field decoders shared by the CSV, log and binary-conversion paths.
+//
+// All decoders skip surrounding spaces, accept an optional leading sign and
+// treat an empty field as 0. They return false (leaving a zero in out) if
+// the field is not entirely a number, so callers can reject the row instead
+// of silently keeping a partial value or throwing.
+
+namespace detail {
+
+inline std::string_view trim_spaces(std::string_view str) {
+    while (!str.empty() && str.front() == ' ') str.remove_prefix(1);
+    while (!str.empty() && str.back() == ' ') str.remove_suffix(1);
+    return str;
+}
+
+// Exactly representable powers of ten (Clinger's fast path)
+constexpr double kExactPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19
+};
+
+// 128-bit truncated (rounded up for negative q) normalized 5^q, q in [-19, 0],
+// as used by the Eisel-Lemire algorithm
+struct Pow5 {
+    uint64_t high;
+    uint64_t low;
+};
+
+constexpr Pow5 kPow5[] = {
+    {0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull},  // 5^-19
+    {0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull},  // 5^-18
+    {0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull},  // 5^-17
+    {0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull},  // 5^-16
+    {0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull},  // 5^-15
+    {0xb424dc35095cd80full, 0x538484c19ef38c95ull},  // 5^-14
+    {0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull},  // 5^-13
+    {0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull},  // 5^-12
+    {0xafebff0bcb24aafeull, 0xf78f69a51539d749ull},  // 5^-11
+    {0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull},  // 5^-10
+    {0x89705f4136b4a597ull, 0x31680a88f8953031ull},  // 5^-9
+    {0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull},  // 5^-8
+    {0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull},  // 5^-7
+    {0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull},  // 5^-6
+    {0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull},  // 5^-5
+    {0xd1b71758e219652bull, 0xd3c36113404ea4a9ull},  // 5^-4
+    {0x83126e978d4fdf3bull, 0x645a1cac083126eaull},  // 5^-3
+    {0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull},  // 5^-2
+    {0xccccccccccccccccull, 0xcccccccccccccccdull},  // 5^-1
+    {0x8000000000000000ull, 0x0000000000000000ull},  // 5^0
+};
+
+// Correctly rounded w * 10^q for w > 0 and q in [-19, 0] (Eisel-Lemire).
+// In this exponent range the 128-bit product is always precise enough, so
+// unlike the general algorithm there is no fallback case.
+inline double eisel_lemire(uint64_t w, int q) {
+    const Pow5& pow5 = kPow5[q + 19];
+    int lz = __builtin_clzll(w);
+    w <<= lz;
+    
+    unsigned __int128 first = static_cast<unsigned __int128>(w) * pow5.high;
+    uint64_t hi = static_cast<uint64_t>(first >> 64);
+    uint64_t lo = static_cast<uint64_t>(first);
+    if ((hi & 0x1FF) == 0x1FF) {
+        uint64_t second = static_cast<uint64_t>((static_cast<unsigned __int128>(w) * pow5.low) >> 64);
+        lo += second;
+        if (second > lo) hi++;
+    }
+    
+    int upperbit = static_cast<int>(hi >> 63);
+    int shift = upperbit + 9;
+    uint64_t mantissa = hi >> shift;
+    int power2 = ((217706 * q) >> 16) + 63 + upperbit - lz + 1023;
+    
+    // Exact halfway between two doubles: round to even
+    if (lo <= 1 && q >= -4 && (mantissa & 3) == 1 && (mantissa << shift) == hi) {
+        mantissa &= ~uint64_t(1);
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (uint64_t(2) << 52)) {
+        mantissa = uint64_t(1) << 52;
+        power2++;
+    }
+    mantissa &= ~(uint64_t(1) << 52);
+    
+    uint64_t bits = mantissa | (static_cast<uint64_t>(power2) << 52);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// SWAR helpers: test and convert eight ASCII digits at once
+inline bool is_eight_digits(uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) |
+             (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+}
+
+inline uint32_t parse_eight_digits(uint64_t v) {
+    v = (v & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;
+    v = (v & 0x00FF00FF00FF00FFull) * 6553601 >> 16;
+    return static_cast<uint32_t>((v & 0x0000FFFF0000FFFFull) * 42949672960001ull >> 32);
+}
+
+}  // namespace detail
+
+// Correctly rounded string to double.
+//
+// Plain decimals with up to 19 significant digits are accumulated exactly
+// into a 64-bit mantissa in one pass. Mantissas below 2^53 (every gauge and
+// GPS field we emit) take Clinger's fast path, a single IEEE division by an
+// exact power of ten; longer ones (e.g. Python repr output) use Eisel-Lemire.
+// Exponents and oversized inputs go to std::from_chars, which is also
+// correctly rounded. "inf", "nan" and values out of double range are not
+// measurements and are rejected.
+inline bool fast_stod(std::string_view str, double& out) {
+    out = 0.0;
+    if (str.empty()) return true;
+    if (str.front() == ' ' || str.back() == ' ') {
+        str = detail::trim_spaces(str);
+        if (str.empty()) return true;
+    }
+    
+    const char* p = str.data();
+    const char* const end = p + str.size();
+    bool negative = (*p == '-');
+    p += (negative || *p == '+');
+    
+    const char* const digits_start = p;
+    const char* dot = nullptr;
+    uint64_t mantissa = 0;
+    
+    for (; p < end; ++p) {
+        unsigned digit = static_cast<unsigned>(*p - '0');
+        if (digit < 10) {
+            mantissa = mantissa * 10 + digit;
+            continue;
+        }
+        if (*p == '.' && dot == nullptr) {
+            dot = p;
+            // Long fractions: eight digits per step
+            while (end - p > 8) {
+                uint64_t chunk;
+                std::memcpy(&chunk, p + 1, sizeof(chunk));
+                if (!detail::is_eight_digits(chunk)) break;
+                mantissa = mantissa * 100000000 + detail::parse_eight_digits(chunk);
+                p += 8;
+            }
+            continue;
+        }
+        break;
+    }
+    
+    size_t digits = static_cast<size_t>(p - digits_start) - (dot != nullptr);
+    size_t frac_digits = dot ? static_cast<size_t>(p - dot - 1) : 0;
+    
+    if (p == end && digits - 1 < 19) {
+        double value;
+        if (mantissa < (uint64_t(1) << 53)) {
+            value = static_cast<double>(mantissa) / detail::kExactPow10[frac_digits];
+        } else {
+            value = detail::eisel_lemire(mantissa, -static_cast<int>(frac_digits));
+        }
+        out = negative ? -value : value;
+        return true;
+    }
+    
+    // Slow path: more than 19 digits, exponents, inf/nan, or garbage
+    if (digits_start < end && *digits_start == '-') return false;  // "+-1", "--1"
+    double value = 0.0;
+    auto [ptr, ec] = std::from_chars(digits_start, end, value);
+    if (ec != std::errc() || ptr != end || !std::isfinite(value)) return false;
+    out = negative ? -value : value;
+    return true;
+}
+
+// String to integer; rejects fractions and overflow
+template <typename Int>
+inline bool fast_stoi(std::string_view str, Int& out) {
+    out = 0;
+    str = detail::trim_spaces(str);
+    if (str.empty()) return true;
+    if (str.front() == '+') {
+        str.remove_prefix(1);
+        if (str.empty() || str.front() == '-') return false;
+    }
+    
+    Int value = 0;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (ec != std::errc() || ptr != str.data() + str.size()) return false;
+    out = value;
+    return true;
+}
+
+}  // namespace fleet
+
+#endif  // FAST_DECODE_H
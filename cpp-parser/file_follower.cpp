@@ -0,0 +1,162 @@
+#include "file_follower.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#define FLEET_FOLLOW_INOTIFY 1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#include <sys/event.h>
+#include <sys/time.h>
+#define FLEET_FOLLOW_KQUEUE 1
+#endif
+
+namespace fleet {
+
+FileFollower::FileFollower(const std::string& filename) : filename_(filename) {
+    open_file();
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+}
+
+FileFollower::~FileFollower() {
+    close_file();
+}
+
+const char* FileFollower::backend() {
+#if defined(FLEET_FOLLOW_INOTIFY)
+    return "inotify";
+#elif defined(FLEET_FOLLOW_KQUEUE)
+    return "kqueue";
+#else
+    return "poll";
+#endif
+}
+
+void FileFollower::open_file() {
+    int fd = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return;
+    }
+
+    close_file();
+    fd_ = fd;
+    device_ = static_cast<uint64_t>(st.st_dev);
+    inode_ = static_cast<uint64_t>(st.st_ino);
+
+    // Watch failures are not fatal: wait() then degrades to polling
+#if defined(FLEET_FOLLOW_INOTIFY)
+    notify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify_fd_ >= 0) {
+        watch_ = ::inotify_add_watch(notify_fd_, filename_.c_str(),
+                                     IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE |
+                                     IN_MOVE_SELF | IN_DELETE_SELF);
+    }
+#elif defined(FLEET_FOLLOW_KQUEUE)
+    notify_fd_ = ::kqueue();
+    if (notify_fd_ >= 0) {
+        struct kevent change;
+        EV_SET(&change, fd_, EVFILT_VNODE, EV_ADD | EV_CLEAR,
+               NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_RENAME | NOTE_DELETE, 0, nullptr);
+        watch_ = ::kevent(notify_fd_, &change, 1, nullptr, 0, nullptr) == 0 ? 0 : -1;
+    }
+#endif
+}
+
+void FileFollower::close_file() {
+    if (notify_fd_ >= 0) {
+        ::close(notify_fd_);
+        notify_fd_ = -1;
+    }
+    watch_ = -1;
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+// True once the path names a different file than the one we hold open
+bool FileFollower::replaced() const {
+    struct stat st;
+    if (::stat(filename_.c_str(), &st) != 0) return false;  // gone for now; keep draining ours
+    return static_cast<uint64_t>(st.st_dev) != device_ || static_cast<uint64_t>(st.st_ino) != inode_;
+}
+
+uint64_t FileFollower::file_size() const {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) return 0;
+    return static_cast<uint64_t>(st.st_size);
+}
+
+size_t FileFollower::read_appended(std::string& out, size_t max_bytes, bool& restarted) {
+    restarted = false;
+
+    uint64_t size = file_size();
+    if (size <= offset_ && replaced()) {
+        // Rotated: our copy is drained, continue with the new file
+        uint64_t old_inode = inode_;
+        open_file();
+        if (inode_ != old_inode) {
+            offset_ = 0;
+            restarted = true;
+            size = file_size();
+        }
+    }
+    if (size < offset_) {
+        // Truncated in place
+        offset_ = 0;
+        restarted = true;
+    }
+
+    size_t want = static_cast<size_t>(std::min<uint64_t>(size - offset_, max_bytes));
+    if (want == 0) return 0;
+
+    size_t start = out.size();
+    out.resize(start + want);
+    size_t got = 0;
+    while (got < want) {
+        ssize_t n = ::pread(fd_, &out[start + got], want - got, static_cast<off_t>(offset_ + got));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += static_cast<size_t>(n);
+    }
+    out.resize(start + got);
+    offset_ += got;
+    return got;
+}
+
+void FileFollower::wait(int timeout_ms) {
+#if defined(FLEET_FOLLOW_INOTIFY)
+    if (notify_fd_ >= 0 && watch_ >= 0) {
+        struct pollfd pfd = {notify_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, timeout_ms) > 0) {
+            // Drain the queued events; we only care that something happened
+            alignas(struct inotify_event) char buf[4096];
+            while (::read(notify_fd_, buf, sizeof(buf)) > 0) {
+            }
+        }
+        return;
+    }
+#elif defined(FLEET_FOLLOW_KQUEUE)
+    if (notify_fd_ >= 0 && watch_ >= 0) {
+        struct kevent event;
+        struct timespec ts = {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+        ::kevent(notify_fd_, nullptr, 0, &event, 1, &ts);
+        return;
+    }
+#endif
+    // No notification backend: sleep, waking early on signals
+    ::poll(nullptr, 0, timeout_ms);
+}
+
+}  // namespace fleet
@@ -0,0 +1,56 @@
+#ifndef FILE_FOLLOWER_H
+#define FILE_FOLLOWER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fleet {
+
+// Incremental reader for a file that keeps growing (tail -f).
+//
+// Remembers the byte offset already consumed and waits for changes with
+// inotify (Linux) or kqueue (BSD/macOS), falling back to timed polling
+// elsewhere. Truncation and replacement (log rotation by rename) are
+// detected; reading then restarts at offset 0 of the current file.
+class FileFollower {
+public:
+    explicit FileFollower(const std::string& filename);
+    ~FileFollower();
+
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+
+    // Append up to max_bytes written since the last call to out and return
+    // how many were added. restarted is set when the file was truncated or
+    // replaced, in which case the new bytes start at the top of the file.
+    size_t read_appended(std::string& out, size_t max_bytes, bool& restarted);
+
+    // Block until the file changes, a signal arrives or timeout_ms passes
+    void wait(int timeout_ms);
+
+    // Skip ahead without reading (e.g. start at the current end of file)
+    void seek(uint64_t offset) { offset_ = offset; }
+    uint64_t offset() const { return offset_; }
+    uint64_t file_size() const;
+
+    // Change notification mechanism compiled in: "inotify", "kqueue" or "poll"
+    static const char* backend();
+
+private:
+    void open_file();
+    void close_file();
+    bool replaced() const;
+
+    std::string filename_;
+    int fd_ = -1;
+    int notify_fd_ = -1;
+    int watch_ = -1;
+    uint64_t offset_ = 0;
+    uint64_t device_ = 0;
+    uint64_t inode_ = 0;
+};
+
+}  // namespace fleet
+
+#endif  // FILE_FOLLOWER_H
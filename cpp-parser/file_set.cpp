@@ -0,0 +1,389 @@
+#include "file_set.h"
+#include "binary_format.h"
+#include "compressed_input.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <glob.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unordered_set>
+
+namespace fleet {
+
+// ============================================================================
+// Formats and input expansion
+// ============================================================================
+
+const char* input_format_name(InputFormat format) {
+    switch (format) {
+        case InputFormat::Csv: return "csv";
+        case InputFormat::Log: return "log";
+        case InputFormat::Binary: return "binary";
+    }
+    return "unknown";
+}
+
+std::optional<InputFormat> parse_input_format(std::string_view name) {
+    for (InputFormat format : {InputFormat::Csv, InputFormat::Log, InputFormat::Binary}) {
+        if (name == input_format_name(format)) return format;
+    }
+    return std::nullopt;
+}
+
+InputFormat detect_format(const std::string& path, char delimiter) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    char head[4096];
+    file.read(head, sizeof(head));
+    std::string_view text(head, static_cast<size_t>(file.gcount()));
+
+    uint32_t magic = 0;
+    if (text.size() >= sizeof(magic)) {
+        std::memcpy(&magic, text.data(), sizeof(magic));
+        if (magic == binary::kMagic) return InputFormat::Binary;
+    }
+
+    // Compressed text: sniff the first decompressed block instead
+    std::string decoded;
+    if (detect_compression(text) != Compression::None) {
+        DecompressConfig decompress_config;
+        decompress_config.block_size = sizeof(head);
+        decompress_config.depth = 1;
+        DecompressReader reader(path, decompress_config);
+        decoded = std::string(reader.next());
+        text = decoded;
+    }
+
+    // First non-blank line
+    size_t start = text.find_first_not_of("\r\n");
+    if (start == std::string_view::npos) return InputFormat::Csv;
+    std::string_view line = text.substr(start, text.find('\n', start) - start);
+    if (line[0] == '#') return InputFormat::Log;
+    // A log row has at least nine pipe-separated fields; a CSV row split by
+    // something else rarely has that many pipes
+    if (delimiter != '|' && std::count(line.begin(), line.end(), '|') >= 8) return InputFormat::Log;
+    return InputFormat::Csv;
+}
+
+static bool has_glob_chars(const std::string& arg) {
+    return arg.find_first_of("*?[") != std::string::npos;
+}
+
+// Regular files below dir, skipping hidden files and directories
+static void walk_directory(const std::string& dir, std::vector<std::string>& out) {
+    namespace fs = std::filesystem;
+    fs::recursive_directory_iterator it(dir, fs::directory_options::skip_permission_denied);
+    for (; it != fs::recursive_directory_iterator(); ++it) {
+        const std::string name = it->path().filename().string();
+        if (!name.empty() && name[0] == '.') {
+            if (it->is_directory()) it.disable_recursion_pending();
+            continue;
+        }
+        if (it->is_regular_file()) out.push_back(it->path().string());
+    }
+}
+
+static void expand_path(const std::string& path, std::vector<std::string>& out) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        walk_directory(path, out);
+    } else {
+        out.push_back(path);
+    }
+}
+
+static void expand_argument(const std::string& arg, bool allow_list, std::vector<std::string>& out) {
+    if (allow_list && arg.size() > 1 && arg[0] == '@') {
+        const std::string list = arg.substr(1);
+        std::ifstream file;
+        if (list != "-") {
+            file.open(list);
+            if (!file.is_open()) throw std::runtime_error("Failed to open file list: " + list);
+        }
+        std::istream& in = list == "-" ? std::cin : file;
+        std::string line;
+        while (std::getline(in, line)) {
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            expand_argument(line, false, out);
+        }
+        return;
+    }
+
+    if (has_glob_chars(arg)) {
+        glob_t matches;
+        int rc = ::glob(arg.c_str(), 0, nullptr, &matches);
+        if (rc == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) expand_path(matches.gl_pathv[i], out);
+        }
+        ::globfree(&matches);
+        if (rc != 0 && rc != GLOB_NOMATCH) throw std::runtime_error("Failed to expand " + arg);
+        return;
+    }
+
+    struct stat st;
+    if (::stat(arg.c_str(), &st) != 0) throw std::runtime_error("Input not found: " + arg);
+    expand_path(arg, out);
+}
+
+std::vector<std::string> expand_inputs(const std::vector<std::string>& args) {
+    std::vector<std::string> files;
+    std::unordered_set<std::string> seen;
+    for (const std::string& arg : args) {
+        std::vector<std::string> found;
+        expand_argument(arg, true, found);
+        if (found.empty()) throw std::runtime_error("No input files match " + arg);
+        std::sort(found.begin(), found.end());
+        for (std::string& path : found) {
+            if (seen.insert(path).second) files.push_back(std::move(path));
+        }
+    }
+    return files;
+}
+
+// ============================================================================
+// FileSetParser implementation
+// ============================================================================
+
+namespace {
+
+struct PlannedFile {
+    InputFormat format = InputFormat::Csv;
+    std::unique_ptr<MappedFile> mapping;   // split text files, mapped while planning
+    bool compressed = false;               // gzip / zstd text: parsed whole, streaming
+    std::string header;                    // CSV header for pieces after the first
+    size_t pieces = 0;
+};
+
+// One unit of parsing: a byte range of a mapped file, or a whole file
+struct Piece {
+    size_t file;
+    size_t begin;
+    size_t end;
+    bool first;     // starts the file (header / leading comments)
+    bool whole;     // not mapped while planning: the worker opens the file
+};
+
+struct PieceResult {
+    std::vector<TelemetryData> records;
+    ParseStats stats;
+    std::string error;
+    bool done = false;
+};
+
+// Strip trailing CR/LF/space, as the parser does for headers
+std::string_view trim_line(std::string_view line) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' ')) {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+}  // namespace
+
+FileSetParser::FileSetParser(const FileSetConfig& config) : config_(config) {
+    if (config_.chunk_bytes == 0) config_.chunk_bytes = FileSetConfig().chunk_bytes;
+}
+
+void FileSetParser::parse(const std::vector<std::string>& files, const RecordsFn& on_records,
+                          const FileDoneFn& on_file_done) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    stats_ = ParseStats();
+    results_.assign(files.size(), FileResult());
+
+    // Plan: split large text files at newlines, keep everything else whole
+    std::vector<PlannedFile> planned(files.size());
+    std::vector<Piece> pieces;
+    for (size_t f = 0; f < files.size(); f++) {
+        PlannedFile& plan = planned[f];
+        results_[f].path = files[f];
+        try {
+            plan.format = config_.format ? *config_.format
+                                         : detect_format(files[f], config_.parser.delimiter);
+            results_[f].format = plan.format;
+            struct stat st;
+            if (::stat(files[f].c_str(), &st) != 0) {
+                throw std::runtime_error("Failed to stat file: " + files[f]);
+            }
+            const size_t size = static_cast<size_t>(st.st_size);
+            plan.compressed = plan.format != InputFormat::Binary &&
+                              detect_compression(files[f]) != Compression::None;
+            if (plan.format == InputFormat::Binary || plan.compressed || size <= config_.chunk_bytes) {
+                pieces.push_back(Piece{f, 0, size, true, true});
+                plan.pieces = 1;
+                continue;
+            }
+
+            plan.mapping = std::make_unique<MappedFile>(files[f]);
+            std::string_view text = plan.mapping->view();
+            if (plan.format == InputFormat::Csv && config_.parser.has_header) {
+                plan.header = std::string(trim_line(text.substr(0, text.find('\n'))));
+            }
+            for (size_t pos = 0; pos < text.size();) {
+                size_t end = std::min(pos + config_.chunk_bytes, text.size());
+                if (end < text.size()) {
+                    const char* nl = static_cast<const char*>(
+                        std::memchr(text.data() + end, '\n', text.size() - end));
+                    end = nl ? static_cast<size_t>(nl - text.data()) + 1 : text.size();
+                }
+                pieces.push_back(Piece{f, pos, end, pos == 0, false});
+                plan.pieces++;
+                pos = end;
+            }
+        } catch (const std::exception& e) {
+            results_[f].error = e.what();
+        }
+    }
+
+    // Tasks: runs of consecutive pieces of about chunk_bytes, so small files
+    // are batched and each slice of a large file stands alone
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t p = 0, bytes = 0; p < pieces.size(); p++) {
+        if (tasks.empty() || bytes >= config_.chunk_bytes) {
+            tasks.emplace_back(p, p);
+            bytes = 0;
+        }
+        tasks.back().second = p + 1;
+        bytes += pieces[p].end - pieces[p].begin;
+    }
+    // Delivered as they finish: start the largest tasks first
+    if (!config_.parser.preserve_order) {
+        auto task_bytes = [&pieces](const std::pair<size_t, size_t>& t) {
+            return pieces[t.second - 1].end - pieces[t.first].begin;
+        };
+        std::stable_sort(tasks.begin(), tasks.end(), [&](const auto& a, const auto& b) {
+            return pieces[a.first].whole == pieces[b.first].whole
+                ? task_bytes(a) > task_bytes(b)
+                : !pieces[a.first].whole;
+        });
+    }
+
+    ParserConfig piece_config = config_.parser;
+    piece_config.num_threads = 1;
+    piece_config.use_mmap = false;
+    const TelemetryParser prototype(piece_config);
+
+    std::vector<PieceResult> piece_results(pieces.size());
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> ready;
+
+    auto parse_piece = [&](size_t p) {
+        const Piece& piece = pieces[p];
+        const PlannedFile& plan = planned[piece.file];
+        const std::string& path = files[piece.file];
+        PieceResult& result = piece_results[p];
+        TelemetryParser parser(prototype);
+        try {
+            if (plan.format == InputFormat::Binary) {
+                result.records = parser.parse_binary(path);
+            } else if (plan.compressed) {
+                // Not splittable at newlines before decoding: one worker streams it
+                result.records = plan.format == InputFormat::Log ? parser.parse_log(path)
+                                                                 : parser.parse_file(path);
+            } else {
+                std::optional<MappedFile> own;
+                std::string_view text;
+                if (piece.whole) {
+                    own.emplace(path);
+                    text = own->view();
+                } else {
+                    text = plan.mapping->view().substr(piece.begin, piece.end - piece.begin);
+                }
+                if (plan.format == InputFormat::Log) {
+                    result.records = parser.parse_log_string(text, piece.first);
+                } else {
+                    if (!piece.first && !plan.header.empty()) parser.use_header(plan.header);
+                    result.records = parser.parse_string(text, piece.first);
+                }
+            }
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+        result.stats = parser.get_stats();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result.done = true;
+            ready.push_back(p);
+        }
+        cv.notify_one();
+    };
+
+    WorkStealingPool pool(config_.parser.num_threads, tasks.size(), [&](size_t t) {
+        for (size_t p = tasks[t].first; p < tasks[t].second; p++) parse_piece(p);
+    });
+    tasks_ = tasks.size();
+
+    std::vector<size_t> remaining(files.size());
+    for (size_t f = 0; f < files.size(); f++) remaining[f] = planned[f].pieces;
+
+    auto finish_file = [&](size_t f) {
+        stats_.merge(results_[f].stats);
+        if (on_file_done) on_file_done(f, results_[f]);
+    };
+    auto deliver = [&](size_t p) {
+        PieceResult& result = piece_results[p];
+        FileResult& file = results_[pieces[p].file];
+        file.stats.merge(result.stats);
+        file.stats.parse_time_ms += result.stats.parse_time_ms;
+        if (!result.error.empty() && file.error.empty()) file.error = result.error;
+        if (!result.records.empty()) on_records(pieces[p].file, std::move(result.records));
+        result.records = std::vector<TelemetryData>();
+        if (--remaining[pieces[p].file] == 0) finish_file(pieces[p].file);
+    };
+
+    // Files that failed while planning have no pieces; report them in order
+    size_t next_file = 0;
+    auto report_unplanned = [&](size_t up_to) {
+        for (; next_file < up_to; next_file++) {
+            if (planned[next_file].pieces == 0) finish_file(next_file);
+        }
+    };
+
+    if (config_.parser.preserve_order) {
+        for (size_t p = 0; p < pieces.size(); p++) {
+            report_unplanned(pieces[p].file);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return piece_results[p].done; });
+            }
+            deliver(p);
+        }
+    } else {
+        for (size_t delivered = 0; delivered < pieces.size();) {
+            std::deque<size_t> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return !ready.empty(); });
+                batch.swap(ready);
+            }
+            for (size_t p : batch) {
+                deliver(p);
+                delivered++;
+            }
+        }
+    }
+    report_unplanned(files.size());
+    pool.wait();
+    steals_ = pool.steals();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+}
+
+}  // namespace fleet
@@ -0,0 +1,97 @@
+#ifndef FILE_SET_H
+#define FILE_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+// ============================================================================
+// Input sets
+// ============================================================================
+
+enum class InputFormat : uint8_t {
+    Csv,
+    Log,
+    Binary,
+};
+
+const char* input_format_name(InputFormat format);
+std::optional<InputFormat> parse_input_format(std::string_view name);  // csv, log, binary
+
+// Sniff a file's format from its first bytes: the "FLET" magic is binary,
+// a first line that is a '#' comment or has the nine pipe-separated fields
+// of a log row (unless delimiter is '|') is a log, anything else CSV. A gzip
+// or zstd file is judged by its decompressed text. Throws if the file cannot be read.
+InputFormat detect_format(const std::string& path, char delimiter = ',');
+
+// Expand input arguments into a file list: a directory contributes every
+// regular file below it (hidden entries skipped), "@list" reads one path
+// per line from list ('-' = stdin), a pattern with * ? or [ is globbed,
+// anything else is taken as a file. Each argument's files are sorted;
+// duplicates are dropped. Throws if an argument matches nothing.
+std::vector<std::string> expand_inputs(const std::vector<std::string>& args);
+
+struct FileSetConfig {
+    ParserConfig parser;                 // num_threads = workers, preserve_order = delivery order
+    std::optional<InputFormat> format;   // nullopt: detect_format() per file
+    // Text files larger than this are split into pieces of about this size
+    // at newlines; smaller files are batched into tasks of about this size
+    size_t chunk_bytes = 4 << 20;
+};
+
+// Per-file outcome, with the file's share of the statistics
+struct FileResult {
+    std::string path;
+    InputFormat format = InputFormat::Csv;
+    ParseStats stats;
+    std::string error;     // first error reading or parsing the file, if any
+};
+
+// Parallel parse of many files.
+//
+// Files are planned into pieces (a whole small file, a newline-aligned
+// slice of a large text file, or a whole binary or gzip / zstd file), the pieces are
+// grouped into tasks of roughly chunk_bytes and the tasks run on a
+// WorkStealingPool, so one huge file and a directory of tiny ones both
+// keep every worker busy. Records are handed to on_records on the calling
+// thread a piece at a time: in file and row order with preserve_order,
+// else as pieces finish. on_file_done follows the last piece of a file.
+// Pieces of a CSV file after the first are parsed with the header of the
+// file's first line.
+class FileSetParser {
+public:
+    using RecordsFn = std::function<void(size_t file, std::vector<TelemetryData>&& records)>;
+    using FileDoneFn = std::function<void(size_t file, const FileResult& result)>;
+
+    explicit FileSetParser(const FileSetConfig& config = FileSetConfig());
+
+    // Parse every file. A file that cannot be read or decoded does not stop
+    // the others: its error lands in FileResult::error (records from its
+    // other pieces are still delivered)
+    void parse(const std::vector<std::string>& files, const RecordsFn& on_records,
+               const FileDoneFn& on_file_done = FileDoneFn());
+
+    // Totals over every file of the last parse(); parse_time_ms is wall time
+    const ParseStats& stats() const { return stats_; }
+    const std::vector<FileResult>& files() const { return results_; }
+    size_t tasks() const { return tasks_; }
+    size_t steals() const { return steals_; }
+
+private:
+    FileSetConfig config_;
+    ParseStats stats_;
+    std::vector<FileResult> results_;
+    size_t tasks_ = 0;
+    size_t steals_ = 0;
+};
+
+}  // namespace fleet
+
+#endif  // FILE_SET_H
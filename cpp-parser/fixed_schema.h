@@ -0,0 +1,156 @@
+#ifndef FIXED_SCHEMA_H
+#define FIXED_SCHEMA_H
+
+#include "fast_decode.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fleet {
+
+// ============================================================================
+// Compile-time CSV schemas
+// ============================================================================
+//
+// The dynamic CSV path maps header names to column indices and looks every
+// field up through them, bounds-checked, on every row. A FixedSchema names
+// the exact column order of a known feed as template arguments instead, so
+// decode() is one unrolled sequence of field decoders at constant offsets:
+//
+//   using StandardSchema = FixedSchema<TelemetryField::VehicleId, ...>;
+//   if (StandardSchema::matches(header_fields)) ...   // once per file
+//   StandardSchema::decode(fields.data(), row, decode_timestamp);
+//
+// The parser takes this path only when the header matches exactly (names
+// compared case-insensitively, as parse_header does) and the row has
+// exactly kColumns fields; anything else goes through the dynamic mapping,
+// which decodes such rows the same way.
+
+enum class TelemetryField : uint8_t {
+    VehicleId,
+    Timestamp,
+    Latitude,
+    Longitude,
+    Speed,
+    Heading,
+    EngineRpm,
+    FuelLevel,
+    OdometerKm,
+    EngineTemp,
+    BatteryVolt,
+    DiagnosticCode,
+};
+
+// Header name of a field
+constexpr std::string_view field_name(TelemetryField field) {
+    switch (field) {
+        case TelemetryField::VehicleId: return "vehicle_id";
+        case TelemetryField::Timestamp: return "timestamp";
+        case TelemetryField::Latitude: return "latitude";
+        case TelemetryField::Longitude: return "longitude";
+        case TelemetryField::Speed: return "speed";
+        case TelemetryField::Heading: return "heading";
+        case TelemetryField::EngineRpm: return "engine_rpm";
+        case TelemetryField::FuelLevel: return "fuel_level";
+        case TelemetryField::OdometerKm: return "odometer_km";
+        case TelemetryField::EngineTemp: return "engine_temp";
+        case TelemetryField::BatteryVolt: return "battery_volt";
+        case TelemetryField::DiagnosticCode: return "diagnostic_code";
+    }
+    return "";
+}
+
+namespace detail {
+
+// ASCII case-insensitive equality against a lowercase name
+inline bool header_name_equals(std::string_view field, std::string_view lower) {
+    if (field.size() != lower.size()) return false;
+    for (size_t i = 0; i < field.size(); i++) {
+        char c = field[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != lower[i]) return false;
+    }
+    return true;
+}
+
+// Decode one field into the like-named member of row; false if malformed.
+// Row is any struct with the DecodedRow members; ts maps a timestamp
+// field to Unix milliseconds.
+template <TelemetryField Field, typename Row, typename TimestampFn>
+inline bool decode_field(std::string_view str, Row& row, TimestampFn& ts) {
+    if constexpr (Field == TelemetryField::VehicleId) {
+        row.vehicle_id = str;
+        return true;
+    } else if constexpr (Field == TelemetryField::Timestamp) {
+        row.timestamp = ts(str);
+        return true;
+    } else if constexpr (Field == TelemetryField::Latitude) {
+        return fast_stod(str, row.latitude);
+    } else if constexpr (Field == TelemetryField::Longitude) {
+        return fast_stod(str, row.longitude);
+    } else if constexpr (Field == TelemetryField::Speed) {
+        return fast_stod(str, row.speed);
+    } else if constexpr (Field == TelemetryField::Heading) {
+        return fast_stod(str, row.heading);
+    } else if constexpr (Field == TelemetryField::EngineRpm) {
+        return fast_stoi(str, row.engine_rpm);
+    } else if constexpr (Field == TelemetryField::FuelLevel) {
+        return fast_stod(str, row.fuel_level);
+    } else if constexpr (Field == TelemetryField::OdometerKm) {
+        return fast_stod(str, row.odometer_km);
+    } else if constexpr (Field == TelemetryField::EngineTemp) {
+        return fast_stod(str, row.engine_temp);
+    } else if constexpr (Field == TelemetryField::BatteryVolt) {
+        return fast_stod(str, row.battery_volt);
+    } else {
+        row.diagnostic_code = str;
+        return true;
+    }
+}
+
+}  // namespace detail
+
+template <TelemetryField... Fields>
+struct FixedSchema {
+    static constexpr size_t kColumns = sizeof...(Fields);
+    static constexpr TelemetryField kFields[kColumns] = {Fields...};
+
+    // True if the header lists exactly these columns in this order
+    static bool matches(const std::vector<std::string_view>& header) {
+        if (header.size() != kColumns) return false;
+        for (size_t i = 0; i < kColumns; i++) {
+            if (!detail::header_name_equals(header[i], field_name(kFields[i]))) return false;
+        }
+        return true;
+    }
+
+    // Decode fields[0 .. kColumns) into row. Every field is decoded before
+    // the result is reported, like the dynamic path.
+    template <typename Row, typename TimestampFn>
+    static bool decode(const std::string_view* fields, Row& row, TimestampFn&& ts) {
+        return decode_all(fields, row, ts, std::make_index_sequence<kColumns>());
+    }
+
+private:
+    template <typename Row, typename TimestampFn, size_t... I>
+    static bool decode_all(const std::string_view* fields, Row& row, TimestampFn& ts,
+                           std::index_sequence<I...>) {
+        bool ok = true;
+        ((ok &= detail::decode_field<Fields>(fields[I], row, ts)), ...);
+        return ok;
+    }
+};
+
+// Column order of data/sample_telemetry.csv and generate_data.py, shared
+// by most feeds
+using StandardSchema = FixedSchema<
+    TelemetryField::VehicleId, TelemetryField::Timestamp, TelemetryField::Latitude,
+    TelemetryField::Longitude, TelemetryField::Speed, TelemetryField::Heading,
+    TelemetryField::EngineRpm, TelemetryField::FuelLevel, TelemetryField::OdometerKm,
+    TelemetryField::EngineTemp, TelemetryField::BatteryVolt, TelemetryField::DiagnosticCode>;
+
+}  // namespace fleet
+
+#endif  // FIXED_SCHEMA_H
@@ -0,0 +1,162 @@
+#include "fleet_capi.h"
+#include "telemetry_parser.h"
+#include <cstring>
+#include <exception>
+#include <string>
+
+// ============================================================================
+// C API implementation
+// ============================================================================
+
+struct fleet_parser {
+    fleet::ParserConfig config;
+    fleet::TelemetryParser parser;
+    fleet_format format;
+    std::string last_error;
+
+    fleet_parser(const fleet::ParserConfig& c, fleet_format f) : config(c), parser(c), format(f) {}
+};
+
+static fleet::ParserConfig make_config(const fleet_options& options) {
+    fleet::ParserConfig config;
+    config.validate = options.validate != 0;
+    config.has_header = options.has_header != 0;
+    config.delimiter = options.delimiter;
+    return config;
+}
+
+static const char* dictionary_entry(const fleet::StringTable& table, uint32_t code, size_t* length) {
+    if (code >= table.size()) {
+        if (length) *length = 0;
+        return nullptr;
+    }
+    std::string_view str = table.view(code);
+    if (length) *length = str.size();
+    return str.data();
+}
+
+extern "C" {
+
+const char* fleet_version(void) {
+    return "1.0.0";
+}
+
+void fleet_options_init(fleet_options* options) {
+    if (!options) return;
+    options->validate = 1;
+    options->has_header = 1;
+    options->delimiter = ',';
+    options->format = FLEET_FORMAT_CSV;
+}
+
+fleet_parser* fleet_parser_create(const fleet_options* options) {
+    fleet_options resolved;
+    fleet_options_init(&resolved);
+    if (options) resolved = *options;
+
+    try {
+        return new fleet_parser(make_config(resolved), resolved.format);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void fleet_parser_destroy(fleet_parser* parser) {
+    delete parser;
+}
+
+size_t fleet_row_capacity(const char* data, size_t size) {
+    if (!data || size == 0) return 0;
+    size_t lines = 0;
+    const char* p = data;
+    const char* end = data + size;
+    while (const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p))) {
+        lines++;
+        p = nl + 1;
+    }
+    return p < end ? lines + 1 : lines;
+}
+
+int fleet_parse(fleet_parser* parser, const char* data, size_t size, int at_start,
+                fleet_columns* out, size_t* consumed) {
+    if (!parser) return -1;
+    if (!out || (!data && size > 0)) {
+        parser->last_error = "fleet_parse: null argument";
+        return -1;
+    }
+
+    fleet::ColumnArrays columns;
+    columns.capacity = out->capacity;
+    columns.size = out->size;
+    columns.timestamp = out->timestamp;
+    columns.latitude = out->latitude;
+    columns.longitude = out->longitude;
+    columns.speed = out->speed;
+    columns.heading = out->heading;
+    columns.engine_rpm = out->engine_rpm;
+    columns.fuel_level = out->fuel_level;
+    columns.odometer_km = out->odometer_km;
+    columns.engine_temp = out->engine_temp;
+    columns.battery_volt = out->battery_volt;
+    columns.vehicle_id = out->vehicle_id;
+    columns.diagnostic_code = out->diagnostic_code;
+
+    try {
+        std::string_view buffer(data ? data : "", size);
+        size_t used = parser->format == FLEET_FORMAT_LOG
+            ? parser->parser.parse_log_columns(buffer, columns, at_start != 0)
+            : parser->parser.parse_columns(buffer, columns, at_start != 0);
+        out->size = columns.size;
+        if (consumed) *consumed = used;
+        parser->last_error.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        out->size = columns.size;
+        parser->last_error = e.what();
+    } catch (...) {
+        out->size = columns.size;
+        parser->last_error = "unknown error";
+    }
+    return -1;
+}
+
+uint32_t fleet_vehicle_count(const fleet_parser* parser) {
+    return parser ? static_cast<uint32_t>(parser->parser.vehicle_ids().size()) : 0;
+}
+
+const char* fleet_vehicle(const fleet_parser* parser, uint32_t code, size_t* length) {
+    if (!parser) return nullptr;
+    return dictionary_entry(parser->parser.vehicle_ids(), code, length);
+}
+
+uint32_t fleet_diagnostic_count(const fleet_parser* parser) {
+    return parser ? static_cast<uint32_t>(parser->parser.diagnostic_codes().size()) : 0;
+}
+
+const char* fleet_diagnostic(const fleet_parser* parser, uint32_t code, size_t* length) {
+    if (!parser) return nullptr;
+    return dictionary_entry(parser->parser.diagnostic_codes(), code, length);
+}
+
+void fleet_get_stats(const fleet_parser* parser, fleet_stats* stats) {
+    if (!parser || !stats) return;
+    const fleet::ParseStats& s = parser->parser.get_stats();
+    stats->total_lines = s.total_lines;
+    stats->valid_records = s.valid_records;
+    stats->invalid_records = s.invalid_records;
+    stats->malformed_records = s.malformed_records;
+    stats->bytes_processed = s.bytes_processed;
+    stats->parse_time_ms = s.parse_time_ms;
+}
+
+void fleet_parser_reset(fleet_parser* parser) {
+    if (!parser) return;
+    parser->parser = fleet::TelemetryParser(parser->config);
+    parser->last_error.clear();
+}
+
+const char* fleet_last_error(const fleet_parser* parser) {
+    return parser ? parser->last_error.c_str() : "invalid parser";
+}
+
+}  // extern "C"
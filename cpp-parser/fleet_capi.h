@@ -0,0 +1,108 @@
+#ifndef FLEET_CAPI_H
+#define FLEET_CAPI_H
+
+// Stable C interface to the telemetry parser (libfleet_parser.so).
+//
+// Plain C99: no C++ types cross the boundary and no exceptions escape.
+// Functions returning int use 0 for success and -1 for failure, with the
+// message available from fleet_last_error(). Text is decoded straight into
+// caller-allocated column arrays, so a binding (e.g. cgo) can pass its own
+// slices and read typed results back without copies or serialization.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define FLEET_API __declspec(dllexport)
+#else
+#define FLEET_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLEET_CAPI_VERSION 1
+
+typedef struct fleet_parser fleet_parser;  // opaque
+
+typedef enum fleet_format {
+    FLEET_FORMAT_CSV = 0,
+    FLEET_FORMAT_LOG = 1,  // timestamp|vehicle_id|lat,lon|speed|rpm|fuel|odo|temp|batt|diag
+} fleet_format;
+
+typedef struct fleet_options {
+    int validate;          // reject out-of-range rows (default 1)
+    int has_header;        // first row is a header (default 1)
+    char delimiter;        // CSV delimiter (default ',')
+    fleet_format format;   // default FLEET_FORMAT_CSV
+} fleet_options;
+
+// Column arrays owned by the caller. Rows are written at [size, capacity)
+// and size is advanced; any array may be NULL to skip that column.
+// vehicle_id / diagnostic_code are codes for fleet_vehicle() /
+// fleet_diagnostic(); code 0 is the empty string.
+typedef struct fleet_columns {
+    size_t capacity;
+    size_t size;
+    int64_t* timestamp;    // Unix milliseconds
+    double* latitude;
+    double* longitude;
+    double* speed;
+    double* heading;
+    int32_t* engine_rpm;
+    double* fuel_level;
+    double* odometer_km;
+    double* engine_temp;
+    double* battery_volt;
+    uint32_t* vehicle_id;
+    uint32_t* diagnostic_code;
+} fleet_columns;
+
+typedef struct fleet_stats {
+    uint64_t total_lines;
+    uint64_t valid_records;
+    uint64_t invalid_records;
+    uint64_t malformed_records;
+    uint64_t bytes_processed;
+    double parse_time_ms;  // last call
+} fleet_stats;
+
+FLEET_API const char* fleet_version(void);
+
+FLEET_API void fleet_options_init(fleet_options* options);
+
+// NULL options means defaults. Returns NULL if the parser cannot be created.
+FLEET_API fleet_parser* fleet_parser_create(const fleet_options* options);
+FLEET_API void fleet_parser_destroy(fleet_parser* parser);
+
+// Upper bound on the rows data can produce (its line count)
+FLEET_API size_t fleet_row_capacity(const char* data, size_t size);
+
+// Decode data into out. Parsing stops at a line boundary once out could
+// fill up; *consumed (if not NULL) receives the bytes used, so the rest
+// can be passed again with at_start = 0. The header and leading comments
+// are only looked for when at_start is non-zero.
+FLEET_API int fleet_parse(fleet_parser* parser, const char* data, size_t size, int at_start,
+                          fleet_columns* out, size_t* consumed);
+
+// Dictionaries behind the string codes; pointers stay valid until the
+// parser is destroyed or reset
+FLEET_API uint32_t fleet_vehicle_count(const fleet_parser* parser);
+FLEET_API const char* fleet_vehicle(const fleet_parser* parser, uint32_t code, size_t* length);
+FLEET_API uint32_t fleet_diagnostic_count(const fleet_parser* parser);
+FLEET_API const char* fleet_diagnostic(const fleet_parser* parser, uint32_t code, size_t* length);
+
+FLEET_API void fleet_get_stats(const fleet_parser* parser, fleet_stats* stats);
+
+// Clear statistics and dictionaries (previously returned codes become invalid)
+FLEET_API void fleet_parser_reset(fleet_parser* parser);
+
+// Message for the last failed call on this parser ("" if none)
+FLEET_API const char* fleet_last_error(const fleet_parser* parser);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FLEET_CAPI_H
@@ -1,65 +1,373 @@
 #include "telemetry_parser.h"
+#include "batch_ring.h"
+#include "binary_format.h"
+#include "columnar_export.h"
+#include "file_follower.h"
+#include "file_set.h"
+#include "parse_server.h"
+#include "record_sorter.h"
+#include "record_writer.h"
+#include "sqlite_loader.h"
+#include "telemetry_batch.h"
+#include "thread_pool.h"
+#include "vehicle_aggregator.h"
+#include "window_rollup.h"
 #include <iostream>
 #include <iomanip>
+#include <atomic>
+#include <charconv>
+#include <csignal>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <getopt.h>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+
+// Set by SIGINT/SIGTERM to end --follow and --serve
+static std::atomic<bool> g_stop{false};
+
+static void handle_stop_signal(int) {
+    g_stop.store(true);
+}
+
+// --stats-json / --summary: JSON to a file, or to console for "-"
+static bool write_json(const std::string& path, const std::string& json, std::ostream& console,
+                       const char* what) {
+    if (path == "-") {
+        console << json;
+        return true;
+    }
+    std::ofstream out(path);
+    out << json;
+    if (!out) {
+        std::cerr << "Error: Cannot write " << what << " to " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+static bool write_stats_json(const std::string& path, const fleet::ParseStats& stats,
+                             std::ostream& console) {
+    return write_json(path, fleet::stats_to_json(stats) + "\n", console, "statistics");
+}
+
+static bool write_summary_json(const std::string& path, const fleet::VehicleAggregator& aggregator,
+                               std::ostream& console) {
+    return write_json(path, fleet::summaries_to_json(aggregator.summaries()), console, "summaries");
+}
+
+// --from / --to: any timestamp form the input may use (see timestamp.h)
+static bool parse_time_option(const char* text, int64_t& out) {
+    out = fleet::TelemetryParser::parse_timestamp(text);
+    return out != 0 || std::strcmp(text, "0") == 0;
+}
+
+// --output-dir: <dir>/<input stem>.<json|ndjson|csv>, one name per input
+static std::vector<std::string> output_paths(const std::string& dir, const std::vector<std::string>& files,
+                                             fleet::OutputFormat format) {
+    const char* ext = format == fleet::OutputFormat::Csv ? ".csv"
+                    : format == fleet::OutputFormat::NDJson ? ".ndjson" : ".json";
+    std::vector<std::string> paths;
+    std::unordered_set<std::string> used;
+    for (const std::string& file : files) {
+        std::string stem = file.substr(file.find_last_of('/') + 1);
+        size_t dot = stem.find_last_of('.');
+        if (dot != std::string::npos && dot > 0) stem.resize(dot);
+        std::string path = dir + "/" + stem + ext;
+        for (int n = 2; !used.insert(path).second; n++) {
+            path = dir + "/" + stem + "-" + std::to_string(n) + ext;
+        }
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+// Whole-number options (-j, --row-group, ...): digits only, within [min, max]
+static bool parse_count_option(const char* text, size_t min, size_t max, size_t& out) {
+    const char* end = text + std::strlen(text);
+    size_t value = 0;
+    auto [ptr, ec] = std::from_chars(text, end, value);
+    if (ec != std::errc() || ptr == text || ptr != end || value < min || value > max) return false;
+    out = value;
+    return true;
+}
+
+static int invalid_count_option(const char* option, const char* text, size_t min, size_t max) {
+    std::cerr << "Error: Invalid " << option << " '" << text << "' (expected " << min << "-" << max << ")\n";
+    return 1;
+}
+
+// --bbox min_lat,min_lon,max_lat,max_lon
+static bool parse_bbox_option(const char* text, fleet::BoundingBox& box) {
+    char end;
+    return std::sscanf(text, "%lf,%lf,%lf,%lf%c", &box.min_latitude, &box.min_longitude,
+                       &box.max_latitude, &box.max_longitude, &end) == 4 &&
+           box.min_latitude <= box.max_latitude && box.min_longitude <= box.max_longitude;
+}
 
 void print_usage(const char* program) {
     std::cout << "Fleet Telemetry Parser - High-Performance C++ Data Parser\n\n"
-              << "Usage: " << program << " [options] <input_file>\n\n"
+              << "Usage: " << program << " [options] <input>...\n\n"
+              << "Inputs are files, directories (read recursively), glob patterns or @list\n"
+              << "files naming one input per line ('@-' = stdin). Several inputs are parsed\n"
+              << "in parallel (-j) and merged into one output. gzip and zstd compressed\n"
+              << "csv and log files are decompressed on the fly.\n\n"
               << "Options:\n"
-              << "  -f, --format <type>   Input format: csv, log, binary (default: csv)\n"
-              << "  -o, --output <file>   Output file (JSON format)\n"
+              << "  -f, --format <type>   Input format: auto, csv, log, binary (default: auto,\n"
+              << "                        detected per file)\n"
+              << "  -o, --output <file>   Output file (JSON array unless --output-format is given)\n"
+              << "      --output-dir <dir>    Also write one output per input file to dir\n"
+              << "      --output-format <fmt>  Output format: json, ndjson, csv (default: json)\n"
+              << "      --ndjson          Same as --output-format ndjson\n"
               << "  -b, --binary <file>   Convert to binary format for faster future parsing\n"
+              << "      --binary-version <n>  Binary format version to write: 1 or 2 (default: 1,\n"
+              << "                        which older releases read; 2 adds the block index\n"
+              << "                        and is implied by --compress)\n"
+              << "      --compress <codec>    Compress binary blocks and Parquet pages: none, zlib,\n"
+              << "                        zstd, lz4 (default: none)\n"
+              << "      --sqlite <db>     Load records into the telemetry table of a SQLite\n"
+              << "                        database (the Go server's schema, created if missing)\n"
+              << "      --arrow <file>    Write an Arrow IPC file (uncompressed, memory-mappable)\n"
+              << "      --parquet <file>  Write a Parquet file (dictionary-encoded strings,\n"
+              << "                        min/max statistics per row group)\n"
+              << "      --row-group <n>   Rows per Parquet row group / Arrow record batch\n"
+              << "                        (default: 1048576)\n"
+              << "  -F, --follow          Keep reading rows appended to a csv or log file until\n"
+              << "                        interrupted (NDJSON on stdout unless -o is given)\n"
+              << "      --serve <socket>  Stay resident and answer framed parse requests on a\n"
+              << "                        Unix socket ('-' = stdin/stdout; see parse_server.h)\n"
               << "  -v, --validate        Enable strict validation\n"
               << "  -n, --no-header       Input file has no header row\n"
               << "  -d, --delimiter <c>   Field delimiter (default: comma)\n"
+              << "  -m, --mmap            Memory-map the input and parse it in place\n"
+              << "  -j, --threads <n>     Parse in parallel with n threads (0 = all cores)\n"
+              << "  -u, --unordered       Don't preserve row order in parallel mode\n"
               << "  -s, --stats           Show detailed statistics\n"
+              << "      --stats-json <file>   Write statistics as one JSON object ('-' = console)\n"
+              << "      --summary <file>  Write per-vehicle rollups (speed, distance, fuel, engine\n"
+              << "                        temperature percentiles, diagnostic codes) as JSON\n"
+              << "      --window <dur>    Downsample to per-vehicle tumbling windows (e.g. 1m, 5m,\n"
+              << "                        1h): -o gets first/last/min/max/mean per window (json or\n"
+              << "                        ndjson), -b one mean record per window\n"
+              << "      --sort            Order records by (vehicle_id, timestamp) before output;\n"
+              << "                        runs beyond --sort-memory spill to $TMPDIR and are merged\n"
+              << "      --sort-memory <MiB>   Memory for in-memory sort runs (default: 512)\n"
+              << "      --vehicle <ids>   Keep only these vehicles (comma-separated, repeatable)\n"
+              << "      --from <time>     Keep rows at or after time (Unix s/ms or ISO 8601)\n"
+              << "      --to <time>       Keep rows at or before time\n"
+              << "      --with-diagnostic Keep only rows carrying a diagnostic code\n"
+              << "      --bbox <box>      Keep rows inside min_lat,min_lon,max_lat,max_lon\n"
+              << "                        (filters are tested before the rest of a row is decoded;\n"
+              << "                        v2 binary input skips non-matching blocks)\n"
               << "  -B, --benchmark <n>   Benchmark with n iterations\n"
               << "  -h, --help            Show this help message\n\n"
               << "Examples:\n"
               << "  " << program << " telemetry.csv\n"
               << "  " << program << " -f log -o output.json sensor_data.log\n"
               << "  " << program << " -b fast_data.fbin telemetry.csv\n"
-              << "  " << program << " -B 5 large_dataset.csv\n";
+              << "  " << program << " -B 5 large_dataset.csv\n"
+              << "  " << program << " -j 0 -o month.json backfill.csv\n"
+              << "  " << program << " -j 0 --summary rollups.json backfill.csv\n"
+              << "  " << program << " --window 1m --ndjson -o minutes.ndjson telemetry.csv\n"
+              << "  " << program << " --sort -b clustered.fbin gateway_dump.csv\n"
+              << "  " << program << " -j 0 --sqlite fleet.db drops/\n"
+              << "  " << program << " -j 0 --sort --parquet fleet.parquet drops/\n"
+              << "  " << program << " -j 0 --ndjson -o day.ndjson '/data/gateways/*/2024-03-01*'\n"
+              << "  " << program << " -j 0 --output-dir parsed/ --summary fleet.json drops/\n"
+              << "  " << program << " -f binary --vehicle VH-0042 --from 2024-03-01T00:00:00Z -o vh42.json fleet.fbin\n"
+              << "  " << program << " -f log -F /var/log/fleet/sensors.log\n"
+              << "  " << program << " --serve /tmp/fleet_parser.sock\n";
 }
 
+// Upper bounds for the numeric options
+constexpr size_t kMaxThreads = 1024;
+constexpr size_t kMaxRowGroupRows = size_t(1) << 30;
+constexpr size_t kMaxSortMemoryMiB = std::numeric_limits<size_t>::max() >> 20;
+constexpr size_t kMaxBenchmarkIterations = 1000000;
+
 int main(int argc, char* argv[]) {
     // Options
-    std::string format = "csv";
+    std::string format = "auto";
     std::string output_file;
+    std::string output_dir;
+    fleet::OutputFormat output_format = fleet::OutputFormat::JsonArray;
     std::string binary_output;
+    int binary_version = 0;     // 0: v1 unless --compress needs v2 blocks
+    fleet::binary::Codec binary_codec = fleet::binary::Codec::None;
+    std::string sqlite_output;
+    std::string arrow_output;
+    std::string parquet_output;
+    fleet::ColumnarExportConfig export_config;
     bool validate = false;
     bool has_header = true;
     char delimiter = ',';
+    bool use_mmap = false;
+    size_t num_threads = 1;
+    bool preserve_order = true;
     bool show_stats = false;
+    std::string stats_json;
+    std::string summary_json;
+    int64_t window_ms = 0;
+    fleet::RecordFilter filter;
+    bool sort = false;
+    fleet::SortConfig sort_config;
     int benchmark_iterations = 0;
+    bool follow = false;
+    std::string serve_socket;
     
     // Command line options
     static struct option long_options[] = {
         {"format",    required_argument, 0, 'f'},
         {"output",    required_argument, 0, 'o'},
+        {"output-format", required_argument, 0, 'O'},
+        {"output-dir", required_argument, 0, 'P'},
+        {"ndjson",    no_argument,       0, 'N'},
         {"binary",    required_argument, 0, 'b'},
+        {"binary-version", required_argument, 0, 'V'},
+        {"compress",  required_argument, 0, 'Z'},
+        {"sqlite",    required_argument, 0, 'L'},
+        {"arrow",     required_argument, 0, 'T'},
+        {"parquet",   required_argument, 0, 'U'},
+        {"row-group", required_argument, 0, 'G'},
+        {"follow",    no_argument,       0, 'F'},
+        {"serve",     required_argument, 0, 'S'},
         {"validate",  no_argument,       0, 'v'},
         {"no-header", no_argument,       0, 'n'},
         {"delimiter", required_argument, 0, 'd'},
+        {"mmap",      no_argument,       0, 'm'},
+        {"threads",   required_argument, 0, 'j'},
+        {"unordered", no_argument,       0, 'u'},
         {"stats",     no_argument,       0, 's'},
+        {"stats-json", required_argument, 0, 'J'},
+        {"summary",   required_argument, 0, 'A'},
+        {"window",    required_argument, 0, 'W'},
+        {"sort",      no_argument,       0, 'Q'},
+        {"sort-memory", required_argument, 0, 'K'},
+        {"vehicle",   required_argument, 0, 'I'},
+        {"from",      required_argument, 0, 'R'},
+        {"to",        required_argument, 0, 'E'},
+        {"with-diagnostic", no_argument, 0, 'D'},
+        {"bbox",      required_argument, 0, 'X'},
         {"benchmark", required_argument, 0, 'B'},
         {"help",      no_argument,       0, 'h'},
         {0, 0, 0, 0}
     };
     
     int opt;
-    while ((opt = getopt_long(argc, argv, "f:o:b:vnd:sB:h", long_options, nullptr)) != -1) {
+    while ((opt = getopt_long(argc, argv, "f:o:b:Fvnd:mj:usB:h", long_options, nullptr)) != -1) {
         switch (opt) {
             case 'f': format = optarg; break;
             case 'o': output_file = optarg; break;
+            case 'O': {
+                auto fmt = fleet::parse_output_format(optarg);
+                if (!fmt) {
+                    std::cerr << "Error: Unknown output format '" << optarg << "'\n";
+                    return 1;
+                }
+                output_format = *fmt;
+                break;
+            }
+            case 'N': output_format = fleet::OutputFormat::NDJson; break;
+            case 'P': output_dir = optarg; break;
             case 'b': binary_output = optarg; break;
+            case 'V': {
+                size_t version = 0;
+                if (!parse_count_option(optarg, 1, 2, version)) {
+                    return invalid_count_option("--binary-version", optarg, 1, 2);
+                }
+                binary_version = static_cast<int>(version);
+                break;
+            }
+            case 'Z': {
+                auto codec = fleet::binary::parse_codec(optarg);
+                if (!codec) {
+                    std::cerr << "Error: Unknown compression codec '" << optarg << "'\n";
+                    return 1;
+                }
+                binary_codec = *codec;
+                break;
+            }
+            case 'L': sqlite_output = optarg; break;
+            case 'T': arrow_output = optarg; break;
+            case 'U': parquet_output = optarg; break;
+            case 'G':
+                if (!parse_count_option(optarg, 1, kMaxRowGroupRows, export_config.row_group_rows)) {
+                    return invalid_count_option("--row-group", optarg, 1, kMaxRowGroupRows);
+                }
+                break;
+            case 'F': follow = true; break;
+            case 'S': serve_socket = optarg; break;
             case 'v': validate = true; break;
             case 'n': has_header = false; break;
             case 'd': delimiter = optarg[0]; break;
+            case 'm': use_mmap = true; break;
+            case 'j':
+                if (!parse_count_option(optarg, 0, kMaxThreads, num_threads)) {
+                    return invalid_count_option("thread count", optarg, 0, kMaxThreads);
+                }
+                break;
+            case 'u': preserve_order = false; break;
             case 's': show_stats = true; break;
-            case 'B': benchmark_iterations = std::stoi(optarg); break;
+            case 'J': stats_json = optarg; break;
+            case 'A': summary_json = optarg; break;
+            case 'W': {
+                auto ms = fleet::parse_window_duration(optarg);
+                if (!ms) {
+                    std::cerr << "Error: Invalid window '" << optarg << "' (e.g. 30s, 1m, 1h)\n";
+                    return 1;
+                }
+                window_ms = *ms;
+                break;
+            }
+            case 'Q': sort = true; break;
+            case 'K': {
+                size_t mib = 0;
+                if (!parse_count_option(optarg, 1, kMaxSortMemoryMiB, mib)) {
+                    return invalid_count_option("--sort-memory", optarg, 1, kMaxSortMemoryMiB);
+                }
+                sort_config.memory_bytes = mib << 20;
+                break;
+            }
+            case 'I': {
+                std::string_view ids(optarg);
+                while (!ids.empty()) {
+                    size_t comma = std::min(ids.find(','), ids.size());
+                    if (comma > 0) filter.vehicle_ids.emplace_back(ids.substr(0, comma));
+                    ids.remove_prefix(std::min(comma + 1, ids.size()));
+                }
+                break;
+            }
+            case 'R':
+            case 'E': {
+                int64_t& bound = opt == 'R' ? filter.min_timestamp : filter.max_timestamp;
+                if (!parse_time_option(optarg, bound)) {
+                    std::cerr << "Error: Invalid time '" << optarg << "'\n";
+                    return 1;
+                }
+                break;
+            }
+            case 'D': filter.diagnostics_only = true; break;
+            case 'X': {
+                fleet::BoundingBox box;
+                if (!parse_bbox_option(optarg, box)) {
+                    std::cerr << "Error: Invalid bounding box '" << optarg
+                              << "' (min_lat,min_lon,max_lat,max_lon)\n";
+                    return 1;
+                }
+                filter.bbox = box;
+                break;
+            }
+            case 'B': {
+                size_t iterations = 0;
+                if (!parse_count_option(optarg, 1, kMaxBenchmarkIterations, iterations)) {
+                    return invalid_count_option("benchmark iteration count", optarg, 1, kMaxBenchmarkIterations);
+                }
+                benchmark_iterations = static_cast<int>(iterations);
+                break;
+            }
             case 'h':
                 print_usage(argv[0]);
                 return 0;
@@ -69,40 +377,344 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    // Server mode: no input file, requests name their own
+    if (!serve_socket.empty()) {
+        try {
+            fleet::ParserConfig config;
+            config.validate = validate;
+            config.has_header = has_header;
+            config.delimiter = delimiter;
+            config.num_threads = num_threads;
+            config.preserve_order = preserve_order;
+            
+            // A client that hangs up mid-response must not kill the server
+            std::signal(SIGPIPE, SIG_IGN);
+            std::signal(SIGINT, handle_stop_signal);
+            std::signal(SIGTERM, handle_stop_signal);
+            
+            fleet::ParseServer server(config);
+            if (serve_socket == "-") {
+                server.serve_connection(0, 1, &g_stop);
+            } else {
+                std::cerr << "🚀 Fleet Telemetry Parser serving on " << serve_socket << "\n";
+                server.serve_unix_socket(serve_socket, &g_stop);
+                std::cerr << "✓ Served " << server.requests_served() << " requests\n";
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    
     if (optind >= argc) {
         std::cerr << "Error: No input file specified\n\n";
         print_usage(argv[0]);
         return 1;
     }
     
-    std::string input_file = argv[optind];
+    const std::vector<std::string> inputs(argv + optind, argv + argc);
+    std::string input_file = inputs[0];
     
     // Benchmark mode
     if (benchmark_iterations > 0) {
+        if (inputs.size() > 1) {
+            std::cerr << "Error: --benchmark takes a single input file\n";
+            return 1;
+        }
         fleet::benchmark_parser(input_file, benchmark_iterations);
         return 0;
     }
     
     try {
+        // A followed file may not exist yet: take it as named
+        const std::vector<std::string> files = follow ? inputs : fleet::expand_inputs(inputs);
+        const bool multi = files.size() != 1 || files[0] != inputs[0] || !output_dir.empty();
+        if (multi && follow) {
+            std::cerr << "Error: --follow takes a single input file\n";
+            return 1;
+        }
+        if (!output_dir.empty() && (window_ms > 0 || sort)) {
+            std::cerr << "Error: --output-dir cannot be combined with --window or --sort\n";
+            return 1;
+        }
+        std::optional<fleet::InputFormat> input_format;
+        if (format != "auto") {
+            input_format = fleet::parse_input_format(format);
+            if (!input_format) {
+                std::cerr << "Error: Unknown format '" << format << "'\n";
+                return 1;
+            }
+        } else if (!multi) {
+            // Sniff the single input; an unreadable one fails when it is parsed
+            try {
+                format = fleet::input_format_name(fleet::detect_format(input_file, delimiter));
+            } catch (const std::exception&) {
+                format = "csv";
+            }
+        }
+        
         // Configure parser
         fleet::ParserConfig config;
         config.validate = validate;
         config.has_header = has_header;
         config.delimiter = delimiter;
+        config.use_mmap = use_mmap;
+        config.num_threads = num_threads;
+        config.preserve_order = preserve_order;
+        config.filter = filter;
         
         fleet::TelemetryParser parser(config);
         
-        std::cout << "🚀 Fleet Telemetry Parser\n";
-        std::cout << "   Input:  " << input_file << "\n";
-        std::cout << "   Format: " << format << "\n\n";
+        // Followed records go to stdout when no -o is given; keep status off it
+        std::ostream& info = (follow && output_file.empty()) ? std::cerr : std::cout;
+        
+        info << "🚀 Fleet Telemetry Parser\n";
+        if (multi) {
+            info << "   Input:  " << files.size() << " files\n";
+        } else {
+            info << "   Input:  " << input_file << "\n";
+        }
+        info << "   Format: " << format << "\n\n";
+        
+        // Open the record output up front so text input can stream into it
+        std::ofstream out;
+        std::optional<fleet::RecordWriter> writer;
+        if (!output_file.empty()) {
+            out.open(output_file, std::ios::binary);
+            if (!out.is_open()) {
+                std::cerr << "Error: Cannot create output file\n";
+                return 1;
+            }
+            writer.emplace(out, output_format);
+        }
+        if (window_ms > 0 && output_format == fleet::OutputFormat::Csv) {
+            std::cerr << "Error: --window output supports json and ndjson only\n";
+            return 1;
+        }
+        fleet::WindowConfig window_config;
+        window_config.window_ms = window_ms;
+        
+        // Follow mode: emit rows as they are appended until interrupted
+        if (follow) {
+            if (format != "csv" && format != "log") {
+                std::cerr << "Error: --follow supports csv and log input only\n";
+                return 1;
+            }
+            if (!binary_output.empty() || !sqlite_output.empty() || !arrow_output.empty() ||
+                !parquet_output.empty() || sort) {
+                std::cerr << "Error: --follow cannot be combined with -b, --sqlite, --arrow, --parquet or --sort\n";
+                return 1;
+            }
+            if (!writer) {
+                writer.emplace(std::cout, fleet::OutputFormat::NDJson);
+            }
+            
+            std::signal(SIGINT, handle_stop_signal);
+            std::signal(SIGTERM, handle_stop_signal);
+            
+            fleet::FollowOptions follow_options;
+            follow_options.stop = &g_stop;
+            follow_options.on_idle = [&writer]() { writer->flush(); };
+            fleet::VehicleAggregator aggregator;
+            const bool summarize = !summary_json.empty();
+            std::optional<fleet::WindowRollup> rollup;
+            if (window_ms > 0) {
+                rollup.emplace(window_config, [&writer](fleet::TelemetryWindow&& window) {
+                    writer->write(window);
+                });
+            }
+            auto emit = [&](fleet::TelemetryData&& record) {
+                if (summarize) aggregator.add(record);
+                if (rollup) {
+                    rollup->add(record);
+                } else {
+                    writer->write(record);
+                }
+            };
+            
+            info << "   Following via " << fleet::FileFollower::backend()
+                 << " (Ctrl-C to stop)\n\n";
+            if (format == "csv") {
+                parser.follow_file(input_file, emit, follow_options);
+            } else {
+                parser.follow_log(input_file, emit, follow_options);
+            }
+            if (rollup) rollup->flush();
+            writer->finish();
+            
+            const auto& stats = parser.get_stats();
+            info << "✓ Followed " << stats.valid_records << " records\n";
+            if (rollup) {
+                info << "✓ Rolled up into " << rollup->windows_out() << " windows ("
+                     << rollup->late_records() << " late records dropped)\n";
+            }
+            if (show_stats) {
+                info << fleet::format_stats(stats) << "\n\n";
+            }
+            if (!stats_json.empty() && !write_stats_json(stats_json, stats, info)) {
+                return 1;
+            }
+            if (summarize && !write_summary_json(summary_json, aggregator, info)) {
+                return 1;
+            }
+            if (!output_file.empty()) {
+                info << "✓ Wrote output to: " << output_file
+                     << " (" << writer->records_written() << " records)\n";
+            }
+            return 0;
+        }
         
         // Parse file
         std::vector<fleet::TelemetryData> data;
+        bool streamed = false;
+        
+        // Nothing else needs the records when only -o / --summary / --window
+        // are given: serialize, aggregate and downsample them as they are
+        // parsed. --sort buffers them in the sorter instead and feeds the
+        // same outputs from its merge, -b included, as does a multi-file
+        // parse.
+        fleet::VehicleAggregator aggregator;
+        const bool summarize = !summary_json.empty();
+        fleet::BinaryWriterConfig binary_config;
+        if (binary_version == 0) {
+            binary_version = binary_codec != fleet::binary::Codec::None
+                ? fleet::binary::kVersion2 : fleet::binary::kVersion1;
+        }
+        binary_config.version = static_cast<uint8_t>(binary_version);
+        binary_config.codec = binary_codec;
+        std::optional<fleet::BinaryWriter> binary_writer;
+        if ((window_ms > 0 || sort || multi) && !binary_output.empty()) {
+            binary_writer.emplace(binary_output, binary_config);
+        }
+        std::optional<fleet::SqliteLoader> loader;
+        if (!sqlite_output.empty()) loader.emplace(sqlite_output);
+        export_config.codec = binary_codec;
+        std::vector<std::unique_ptr<fleet::ColumnarWriter>> exports;
+        if (!arrow_output.empty()) {
+            exports.push_back(std::make_unique<fleet::ColumnarWriter>(
+                arrow_output, fleet::ExportFormat::Arrow, export_config));
+        }
+        if (!parquet_output.empty()) {
+            exports.push_back(std::make_unique<fleet::ColumnarWriter>(
+                parquet_output, fleet::ExportFormat::Parquet, export_config));
+        }
+        std::optional<fleet::WindowRollup> rollup;
+        if (window_ms > 0) {
+            rollup.emplace(window_config, [&](fleet::TelemetryWindow&& window) {
+                if (writer) writer->write(window);
+                if (binary_writer || loader || !exports.empty()) {
+                    const fleet::TelemetryData record = window.to_record();
+                    if (binary_writer) binary_writer->write(record);
+                    if (loader) loader->write(record);
+                    for (auto& exporter : exports) exporter->write(record);
+                }
+            });
+        }
+        std::optional<fleet::RecordSorter> sorter;
+        if (sort) sorter.emplace(sort_config);
         
-        if (format == "csv") {
-            data = parser.parse_file(input_file);
+        const bool stream = sorter || ((writer || summarize || rollup || loader || !exports.empty()) &&
+                                       (binary_output.empty() || rollup));
+        auto deliver = [&](fleet::TelemetryData&& record) {
+            if (summarize) aggregator.add(record);
+            if (rollup) {
+                rollup->add(record);
+                return;
+            }
+            if (writer) writer->write(record);
+            if (binary_writer) binary_writer->write(record);
+            if (loader) loader->write(record);
+            for (auto& exporter : exports) exporter->write(record);
+        };
+        auto emit = [&](fleet::TelemetryData&& record) {
+            if (sorter) {
+                sorter->add(record);
+            } else {
+                deliver(std::move(record));
+            }
+        };
+        
+        std::optional<fleet::FileSetParser> file_set;
+        if (multi) {
+            fleet::FileSetConfig set_config;
+            set_config.parser = config;
+            set_config.format = input_format;
+            file_set.emplace(set_config);
+            
+            // --output-dir: a writer per file, open while its pieces arrive
+            struct FileOutput {
+                std::ofstream out;
+                std::optional<fleet::RecordWriter> writer;
+            };
+            std::vector<std::string> file_outputs;
+            std::vector<std::unique_ptr<FileOutput>> open_outputs(files.size());
+            if (!output_dir.empty()) {
+                std::filesystem::create_directories(output_dir);
+                file_outputs = output_paths(output_dir, files, output_format);
+            }
+            auto file_writer = [&](size_t file) {
+                auto& output = open_outputs[file];
+                if (!output) {
+                    output = std::make_unique<FileOutput>();
+                    output->out.open(file_outputs[file], std::ios::binary);
+                    if (!output->out.is_open()) {
+                        throw std::runtime_error("Cannot create output file " + file_outputs[file]);
+                    }
+                    output->writer.emplace(output->out, output_format);
+                }
+                return &*output->writer;
+            };
+            
+            file_set->parse(files, [&](size_t file, std::vector<fleet::TelemetryData>&& records) {
+                fleet::RecordWriter* per_file = file_outputs.empty() ? nullptr : file_writer(file);
+                for (auto& record : records) {
+                    if (per_file) per_file->write(record);
+                    emit(std::move(record));
+                }
+            }, [&](size_t file, const fleet::FileResult& result) {
+                if (!result.error.empty()) {
+                    std::cerr << "Error: " << result.path << ": " << result.error << "\n";
+                }
+                // An input without records still gets its (empty) output
+                if (!file_outputs.empty() && result.error.empty()) file_writer(file)->finish();
+                open_outputs[file].reset();
+            });
+            streamed = true;
+        } else if (format == "csv") {
+            if (stream && !writer && !rollup && !sorter) {
+                // Rollups / SQLite / Arrow / Parquet only: whole columnar batches
+                // through a ring, each consumer on its own thread so all of them
+                // overlap the parse
+                std::vector<fleet::BatchRing<fleet::TelemetryBatch>::Sink> sinks;
+                if (summarize) {
+                    sinks.push_back([&aggregator](const fleet::TelemetryBatch& batch) { aggregator.add(batch); });
+                }
+                if (loader) {
+                    sinks.push_back([&loader](const fleet::TelemetryBatch& batch) { loader->write(batch); });
+                }
+                for (auto& exporter : exports) {
+                    fleet::ColumnarWriter* sink = exporter.get();
+                    sinks.push_back([sink](const fleet::TelemetryBatch& batch) { sink->write(batch); });
+                }
+                fleet::BatchRing<fleet::TelemetryBatch> ring(
+                    std::max<size_t>(fleet::ThreadPool::resolve_threads(num_threads) * 2, 4), std::move(sinks));
+                parser.parse_file_columnar(input_file, ring);
+                ring.close();
+                streamed = true;
+            } else if (stream) {
+                parser.parse_file_streaming(input_file, emit);
+                streamed = true;
+            } else {
+                data = parser.parse_file(input_file);
+            }
         } else if (format == "log") {
-            data = parser.parse_log(input_file);
+            if (stream) {
+                parser.parse_log_streaming(input_file, emit);
+                streamed = true;
+            } else {
+                data = parser.parse_log(input_file);
+            }
         } else if (format == "binary") {
             data = parser.parse_binary(input_file);
         } else {
@@ -110,48 +722,124 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
-        const auto& stats = parser.get_stats();
+        if (!streamed && sorter) {
+            for (const auto& record : data) sorter->add(record);
+            data = std::vector<fleet::TelemetryData>();
+        } else if (!streamed && (summarize || rollup)) {
+            for (const auto& record : data) {
+                if (summarize) aggregator.add(record);
+                if (rollup) rollup->add(record);
+            }
+        }
+        if (sorter) sorter->finish(deliver);
+        if (rollup) rollup->flush();
         
+        const auto& stats = file_set ? file_set->stats() : parser.get_stats();
+        
+        size_t failed_files = 0;
+        if (file_set) {
+            for (const auto& result : file_set->files()) {
+                if (!result.error.empty()) failed_files++;
+            }
+            std::cout << "✓ Parsed " << files.size() - failed_files << " of " << files.size()
+                      << " files in " << file_set->tasks() << " tasks ("
+                      << file_set->steals() << " stolen)\n";
+        }
         std::cout << "✓ Parsed " << stats.valid_records << " records in "
                   << std::fixed << std::setprecision(2) << stats.parse_time_ms << " ms\n";
         std::cout << "  Speed: " << std::fixed << std::setprecision(0) 
-                  << stats.records_per_second << " records/second\n\n";
+                  << stats.records_per_second << " records/second\n";
+        if (filter.active()) {
+            std::cout << "  Filtered out: " << stats.filtered_records << " rows";
+            if (stats.skipped_blocks > 0) std::cout << " (" << stats.skipped_blocks << " blocks skipped)";
+            std::cout << "\n";
+        }
+        std::cout << "\n";
+        if (sorter) {
+            std::cout << "✓ Sorted " << sorter->records_in() << " records by vehicle and time ("
+                      << sorter->runs_spilled() << " runs spilled)\n";
+        }
+        if (rollup) {
+            std::cout << "✓ Rolled up " << rollup->records_in() << " records into "
+                      << rollup->windows_out() << " windows of " << window_ms << " ms ("
+                      << rollup->late_records() << " late records dropped)\n";
+        }
         
         // Show detailed stats
         if (show_stats) {
             std::cout << fleet::format_stats(stats) << "\n\n";
+            if (file_set) {
+                for (const auto& result : file_set->files()) {
+                    std::cout << "  " << result.path << " [" << fleet::input_format_name(result.format)
+                              << "]: " << result.stats.valid_records << " valid, "
+                              << result.stats.invalid_records << " invalid"
+                              << (result.error.empty() ? "" : " (failed)") << "\n";
+                }
+                std::cout << "\n";
+            }
+        }
+        if (!stats_json.empty() && !write_stats_json(stats_json, stats, std::cout)) {
+            return 1;
+        }
+        if (summarize && !write_summary_json(summary_json, aggregator, std::cout)) {
+            return 1;
         }
         
-        // Write JSON output
-        if (!output_file.empty()) {
-            std::ofstream out(output_file);
-            if (!out.is_open()) {
-                std::cerr << "Error: Cannot create output file\n";
-                return 1;
-            }
-            
-            out << "[\n";
-            for (size_t i = 0; i < data.size(); i++) {
-                out << "  " << data[i].to_json();
-                if (i < data.size() - 1) out << ",";
-                out << "\n";
+        // Write record output
+        if (writer) {
+            if (!streamed && !rollup && !sorter) {
+                for (const auto& record : data) writer->write(record);
             }
-            out << "]\n";
+            writer->finish();
             
-            std::cout << "✓ Wrote JSON output to: " << output_file << "\n";
+            std::cout << "✓ Wrote output to: " << output_file
+                      << " (" << writer->records_written() << (rollup ? " windows)\n" : " records)\n");
         }
         
         // Write binary output
-        if (!binary_output.empty()) {
-            fleet::BinaryWriter writer(binary_output);
+        if (binary_writer) {
+            binary_writer->close();
+            std::cout << "✓ Wrote binary output to: " << binary_output 
+                      << " (" << binary_writer->records_written()
+                      << (rollup ? " window records, " : " records, ")
+                      << binary_writer->bytes_written() << " bytes)\n";
+        } else if (!binary_output.empty()) {
+            fleet::BinaryWriter writer(binary_output, binary_config);
             writer.write_batch(data);
+            writer.close();
             
             std::cout << "✓ Wrote binary output to: " << binary_output 
-                      << " (" << writer.records_written() << " records)\n";
+                      << " (" << writer.records_written() << " records, "
+                      << writer.bytes_written() << " bytes)\n";
+        }
+        
+        // Load into SQLite
+        if (loader) {
+            if (!streamed && !rollup && !sorter) {
+                for (const auto& record : data) loader->write(record);
+            }
+            loader->finish();
+            std::cout << "✓ Loaded SQLite database: " << sqlite_output
+                      << " (" << loader->rows_written() << (rollup ? " window records)\n" : " records)\n");
+        }
+        
+        // Write Arrow / Parquet output
+        for (auto& exporter : exports) {
+            if (!streamed && !rollup && !sorter) {
+                for (const auto& record : data) exporter->write(record);
+            }
+            exporter->close();
+            const bool arrow = exporter->format() == fleet::ExportFormat::Arrow;
+            std::cout << "✓ Wrote " << (arrow ? "Arrow" : "Parquet") << " output to: "
+                      << (arrow ? arrow_output : parquet_output)
+                      << " (" << exporter->rows_written() << (rollup ? " window records, " : " records, ")
+                      << exporter->groups_written() << (arrow ? " record batches, " : " row groups, ")
+                      << exporter->bytes_written() << " bytes)\n";
         }
         
         // Show sample if no output specified
-        if (output_file.empty() && binary_output.empty() && !data.empty()) {
+        if (output_file.empty() && binary_output.empty() && sqlite_output.empty() && exports.empty() &&
+            !data.empty()) {
             std::cout << "Sample records (first 5):\n";
             for (size_t i = 0; i < std::min(size_t(5), data.size()); i++) {
                 const auto& r = data[i];
@@ -167,6 +855,13 @@ int main(int argc, char* argv[]) {
                 std::cout << "\n";
             }
         }
+        if (!output_dir.empty()) {
+            std::cout << "✓ Wrote per-file output to: " << output_dir << "\n";
+        }
+        if (failed_files > 0) {
+            std::cerr << "Error: " << failed_files << " of " << files.size() << " files failed\n";
+            return 1;
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
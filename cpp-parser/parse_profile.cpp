@@ -0,0 +1,141 @@
+#include "parse_profile.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef FLEET_PROFILE
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace fleet {
+
+// ============================================================================
+// ParseProfile implementation
+// ============================================================================
+
+const char* stage_name(ParseStage stage) {
+    switch (stage) {
+        case ParseStage::Read: return "read";
+        case ParseStage::Split: return "split";
+        case ParseStage::Decode: return "decode";
+        case ParseStage::Validate: return "validate";
+        case ParseStage::Emit: return "emit";
+    }
+    return "unknown";
+}
+
+const char* reject_reason_name(RejectReason reason) {
+    switch (reason) {
+        case RejectReason::Malformed: return "malformed";
+        case RejectReason::MissingVehicleId: return "missing_vehicle_id";
+        case RejectReason::Latitude: return "latitude";
+        case RejectReason::Longitude: return "longitude";
+        case RejectReason::Speed: return "speed";
+        case RejectReason::FuelLevel: return "fuel_level";
+        case RejectReason::EngineRpm: return "engine_rpm";
+        case RejectReason::EngineTemp: return "engine_temp";
+        case RejectReason::BatteryVolt: return "battery_volt";
+        case RejectReason::None: return "none";
+    }
+    return "unknown";
+}
+
+void ParseProfile::merge(const ParseProfile& other) {
+    for (size_t i = 0; i < kParseStageCount; i++) {
+        stages[i].ticks += other.stages[i].ticks;
+        stages[i].calls += other.stages[i].calls;
+        stages[i].bytes += other.stages[i].bytes;
+        stages[i].allocations += other.stages[i].allocations;
+    }
+}
+
+uint64_t ParseProfile::total_ticks() const {
+    uint64_t total = 0;
+    for (const StageCounters& c : stages) total += c.ticks;
+    return total;
+}
+
+#ifdef FLEET_PROFILE
+
+thread_local uint64_t tls_allocations = 0;
+
+namespace {
+
+// Reference point for calibration, taken when the library is loaded
+struct CalibrationStart {
+    uint64_t ticks = profile_ticks();
+    std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+};
+const CalibrationStart calibration_start;
+
+}  // namespace
+
+double profile_ticks_per_ms() {
+    // Ratio over the process lifetime so far; wait out the first few
+    // milliseconds so a short run still gets a stable figure
+    constexpr auto kMinSpan = std::chrono::milliseconds(20);
+    auto elapsed = std::chrono::steady_clock::now() - calibration_start.time;
+    if (elapsed < kMinSpan) {
+        std::this_thread::sleep_for(kMinSpan - elapsed);
+    }
+    uint64_t ticks = profile_ticks();
+    auto now = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - calibration_start.time).count();
+    return static_cast<double>(ticks - calibration_start.ticks) / ms;
+}
+
+#else
+
+double profile_ticks_per_ms() {
+    return 0.0;
+}
+
+#endif
+
+}  // namespace fleet
+
+#ifdef FLEET_PROFILE
+
+// ============================================================================
+// Counting allocation functions
+// ============================================================================
+
+static void* counted_alloc(std::size_t size) {
+    fleet::tls_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+static void* counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+    fleet::tls_allocations++;
+    std::size_t alignment = std::max(static_cast<std::size_t>(align), sizeof(void*));
+    void* p = nullptr;
+    if (::posix_memalign(&p, alignment, size ? size : 1) != 0) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef PARSE_PROFILE_H
+#define PARSE_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef FLEET_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace fleet {
+
+// ============================================================================
+// Per-stage parse profiling
+// ============================================================================
+//
+// Builds with FLEET_PROFILE defined time every row through the pipeline
+// stages below with the CPU timestamp counter and count the heap
+// allocations made in each stage. Without it every hook is an empty inline
+// function, so the counters stay zero and the parse loops compile exactly
+// as before. The structs keep the same layout either way.
+
+enum class ParseStage : uint8_t {
+    Read,      // file I/O (mapping, getline, follow reads)
+    Split,     // newline/delimiter scan and field slicing; mmap page faults land here
+    Decode,    // number and timestamp decoding
+    Validate,  // range rules (only when config.validate is set)
+    Emit,      // building the output record and running the callback
+};
+constexpr size_t kParseStageCount = 5;
+
+// First validation rule a rejected row broke
+enum class RejectReason : uint8_t {
+    Malformed,         // a field failed to decode
+    MissingVehicleId,
+    Latitude,
+    Longitude,
+    Speed,
+    FuelLevel,
+    EngineRpm,
+    EngineTemp,        // opt-in batch rules (batch_validator.h)
+    BatteryVolt,
+    None,              // row passed
+};
+constexpr size_t kRejectReasonCount = 9;
+
+const char* stage_name(ParseStage stage);
+const char* reject_reason_name(RejectReason reason);
+
+struct StageCounters {
+    uint64_t ticks = 0;        // timestamp-counter ticks, summed over threads
+    uint64_t calls = 0;        // rows (or reads) that went through the stage
+    uint64_t bytes = 0;        // input bytes of those rows
+    uint64_t allocations = 0;  // operator new calls made during the stage
+};
+
+struct ParseProfile {
+    StageCounters stages[kParseStageCount];
+
+    StageCounters& operator[](ParseStage stage) { return stages[static_cast<size_t>(stage)]; }
+    const StageCounters& operator[](ParseStage stage) const { return stages[static_cast<size_t>(stage)]; }
+
+    void merge(const ParseProfile& other);
+    uint64_t total_ticks() const;
+};
+
+#ifdef FLEET_PROFILE
+constexpr bool kProfileEnabled = true;
+#else
+constexpr bool kProfileEnabled = false;
+#endif
+
+// Timestamp-counter ticks per millisecond, calibrated against steady_clock
+double profile_ticks_per_ms();
+
+#ifdef FLEET_PROFILE
+// operator new calls made by the current thread (FLEET_PROFILE builds
+// replace the global allocation functions to count them)
+extern thread_local uint64_t tls_allocations;
+
+inline uint64_t profile_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+#endif
+
+// Lap timer: each lap() charges the ticks and allocations since the
+// previous lap (or start()) to one stage
+class StageClock {
+public:
+#ifdef FLEET_PROFILE
+    void start() {
+        last_ticks_ = profile_ticks();
+        last_allocations_ = tls_allocations;
+    }
+
+    void lap(ParseProfile& profile, ParseStage stage, uint64_t bytes = 0) {
+        uint64_t now = profile_ticks();
+        StageCounters& c = profile[stage];
+        c.ticks += now - last_ticks_;
+        c.calls++;
+        c.bytes += bytes;
+        c.allocations += tls_allocations - last_allocations_;
+        last_ticks_ = now;
+        last_allocations_ = tls_allocations;
+    }
+#else
+    void start() {}
+    void lap(ParseProfile&, ParseStage, uint64_t = 0) {}
+#endif
+
+private:
+    uint64_t last_ticks_ = 0;
+    uint64_t last_allocations_ = 0;
+};
+
+}  // namespace fleet
+
+#endif  // PARSE_PROFILE_H
@@ -0,0 +1,348 @@
+#include "parse_server.h"
+#include "binary_format.h"
+#include "record_writer.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <optional>
+#include <ostream>
+#include <poll.h>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fleet {
+
+using namespace service;
+
+// How often idle waits re-check the stop flags
+constexpr int kStopCheckMs = 200;
+
+// ============================================================================
+// Descriptor I/O
+// ============================================================================
+
+// Read exactly size bytes; false on EOF or error
+static bool read_exact(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool write_all(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Wait until fd is readable; -1 on error, 0 on timeout
+static int wait_readable(int fd, int timeout_ms) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    int ready = ::poll(&pfd, 1, timeout_ms);
+    if (ready < 0 && errno == EINTR) return 0;
+    return ready;
+}
+
+// Stream buffer sending everything written to it to fd as body chunks of
+// up to kMaxChunk bytes, so a response is never held in memory whole. The
+// buffer is allocated on first use; StatsOnly requests never touch it.
+class ChunkedBodyBuf : public std::streambuf {
+public:
+    explicit ChunkedBodyBuf(int fd) : fd_(fd) {}
+
+    uint64_t bytes_sent() const { return sent_; }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!send_buffered()) return traits_type::eof();
+        if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    // Large writes (a whole writer buffer) go out as they are
+    std::streamsize xsputn(const char* data, std::streamsize size) override {
+        if (size < epptr() - pptr()) return std::streambuf::xsputn(data, size);
+        if (!send_buffered()) return 0;
+        std::streamsize done = 0;
+        while (done < size) {
+            const auto n = static_cast<uint32_t>(std::min<std::streamsize>(size - done, kMaxChunk));
+            if (!send_chunk(data + done, n)) return done;
+            done += n;
+        }
+        return done;
+    }
+
+    int sync() override { return send_buffered() ? 0 : -1; }
+
+private:
+    // Send what is buffered and start an empty buffer
+    bool send_buffered() {
+        const auto n = static_cast<uint32_t>(pptr() - pbase());
+        if (buffer_.empty()) buffer_.resize(kMaxChunk);
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return n == 0 || send_chunk(buffer_.data(), n);
+    }
+
+    bool send_chunk(const char* data, uint32_t size) {
+        ChunkHeader header = {kChunkMagic, size};
+        if (!write_all(fd_, &header, sizeof(header)) || !write_all(fd_, data, size)) return false;
+        sent_ += size;
+        return true;
+    }
+
+    int fd_;
+    std::vector<char> buffer_;
+    uint64_t sent_ = 0;
+};
+
+// ============================================================================
+// ParseServer implementation
+// ============================================================================
+
+ParseServer::ParseServer(const ParserConfig& config, size_t max_connections)
+    : config_(config), max_connections_(max_connections == 0 ? 1 : max_connections) {}
+
+bool ParseServer::stopping(const std::atomic<bool>* stop) const {
+    return shutdown_.load() || (stop && stop->load());
+}
+
+ParseServer::Response ParseServer::handle(const RequestHeader& request, std::string_view payload,
+                                          std::ostream& body) {
+    ParserConfig config = config_;
+    if (request.flags & kFlagNoHeader) config.has_header = false;
+    if (request.flags & kFlagNoValidate) config.validate = false;
+    if (request.delimiter != 0) config.delimiter = static_cast<char>(request.delimiter);
+    if (request.threads != 0) {
+        // Up to one thread per core: a client cannot make the server spawn more
+        config.num_threads = std::min<size_t>(request.threads, ThreadPool::resolve_threads(0));
+    }
+
+    const auto input = static_cast<InputFormat>(request.input);
+    const auto result = static_cast<ResultFormat>(request.result);
+    if (request.input > static_cast<uint8_t>(InputFormat::Binary)) {
+        throw std::runtime_error("Unknown input format: " + std::to_string(request.input));
+    }
+
+    // Records are serialized into the body as they are parsed
+    std::optional<RecordWriter> records;
+    std::optional<BinaryWriter> binary;
+    switch (result) {
+        case ResultFormat::StatsOnly:
+            break;
+        case ResultFormat::Binary: {
+            BinaryWriterConfig writer_config;
+            writer_config.version = binary::kVersion2;
+            writer_config.codec = static_cast<binary::Codec>(request.codec);
+            binary.emplace(body, writer_config);
+            break;
+        }
+        case ResultFormat::NDJson:
+            records.emplace(body, OutputFormat::NDJson);
+            break;
+        case ResultFormat::Csv:
+            records.emplace(body, OutputFormat::Csv);
+            break;
+        case ResultFormat::Json:
+            records.emplace(body, OutputFormat::JsonArray);
+            break;
+        default:
+            throw std::runtime_error("Unknown result format: " + std::to_string(request.result));
+    }
+
+    auto emit = [&records, &binary](TelemetryData&& data) {
+        if (records) {
+            records->write(data);
+        } else if (binary) {
+            binary->write(data);
+        }
+    };
+
+    TelemetryParser parser(config);
+    if (static_cast<Op>(request.op) == Op::ParsePath) {
+        const std::string path(payload);
+        switch (input) {
+            case InputFormat::Csv:
+                parser.parse_file_streaming(path, emit);
+                break;
+            case InputFormat::Log:
+                parser.parse_log_streaming(path, emit);
+                break;
+            case InputFormat::Binary:
+                for (auto& data : parser.parse_binary(path)) emit(std::move(data));
+                break;
+        }
+    } else {
+        std::vector<TelemetryData> parsed;
+        switch (input) {
+            case InputFormat::Csv:
+                parsed = parser.parse_string(payload);
+                break;
+            case InputFormat::Log:
+                parsed = parser.parse_log_string(payload);
+                break;
+            case InputFormat::Binary:
+                throw std::runtime_error("Inline payloads must be csv or log text");
+        }
+        for (auto& data : parsed) emit(std::move(data));
+    }
+
+    if (records) records->finish();
+    if (binary) binary->close();
+    body.flush();
+    if (!body) throw std::runtime_error("Failed to send response body");
+
+    Response response;
+    response.result = result;
+    response.stats = stats_to_json(parser.get_stats());
+    return response;
+}
+
+// The header ending a response; its body chunks were sent before it
+static bool send_response(int fd, Status status, ResultFormat result,
+                          std::string_view stats, uint64_t body_size = 0) {
+    ResponseHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kResponseMagic;
+    header.status = static_cast<uint8_t>(status);
+    header.result = static_cast<uint8_t>(result);
+    header.stats_size = static_cast<uint32_t>(stats.size());
+    header.body_size = body_size;
+    return write_all(fd, &header, sizeof(header)) &&
+           write_all(fd, stats.data(), stats.size());
+}
+
+static bool send_error(int fd, std::string_view message, uint64_t body_size = 0) {
+    return send_response(fd, Status::Error, ResultFormat::StatsOnly, message, body_size);
+}
+
+bool ParseServer::serve_connection(int in_fd, int out_fd, const std::atomic<bool>* stop) {
+    std::string payload;
+    while (!stopping(stop)) {
+        // Idle between requests: wake up periodically to notice a stop
+        int ready = wait_readable(in_fd, kStopCheckMs);
+        if (ready < 0) break;
+        if (ready == 0) continue;
+
+        RequestHeader request;
+        if (!read_exact(in_fd, &request, sizeof(request))) break;  // peer closed
+        if (request.magic != kRequestMagic) {
+            send_error(out_fd, "Bad request magic");
+            break;  // framing is lost
+        }
+        if (request.payload_size > kMaxPayload) {
+            send_error(out_fd, "Request payload too large");
+            break;
+        }
+        payload.resize(request.payload_size);
+        if (!read_exact(in_fd, payload.data(), payload.size())) break;
+
+        bool sent = false;
+        switch (static_cast<Op>(request.op)) {
+            case Op::Ping:
+                sent = send_response(out_fd, Status::Ok, ResultFormat::StatsOnly, {});
+                break;
+            case Op::Shutdown:
+                shutdown_.store(true);
+                send_response(out_fd, Status::Ok, ResultFormat::StatsOnly, {});
+                return false;
+            case Op::ParsePath:
+            case Op::ParseInline: {
+                // The body goes out in chunks while the request is parsed;
+                // a failure part way through ends it with an error header
+                ChunkedBodyBuf body_buf(out_fd);
+                std::ostream body(&body_buf);
+                try {
+                    Response response = handle(request, payload, body);
+                    requests_served_++;
+                    sent = send_response(out_fd, response.status, response.result,
+                                         response.stats, body_buf.bytes_sent());
+                } catch (const std::exception& e) {
+                    sent = send_error(out_fd, e.what(), body_buf.bytes_sent());
+                }
+                break;
+            }
+            default:
+                sent = send_error(out_fd, "Unknown request op: " + std::to_string(request.op));
+                break;
+        }
+        if (!sent) break;
+    }
+    return !shutdown_.load();
+}
+
+void ParseServer::serve_unix_socket(const std::string& path, const std::atomic<bool>* stop) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Invalid socket path: " + path);
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // A socket file left behind by a previous run would make bind() fail
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        ::unlink(path.c_str());
+    }
+
+    int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error("Failed to create socket: " + path);
+    }
+    ::fcntl(listen_fd, F_SETFD, FD_CLOEXEC);
+    if (::bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(listen_fd);
+        throw std::runtime_error("Failed to listen on socket: " + path);
+    }
+    // Owner only, before listen() lets anyone connect: requests name files
+    // for the server to read with its own permissions
+    if (::chmod(path.c_str(), 0600) != 0 || ::listen(listen_fd, 64) != 0) {
+        ::close(listen_fd);
+        ::unlink(path.c_str());
+        throw std::runtime_error("Failed to listen on socket: " + path);
+    }
+
+    {
+        ThreadPool pool(max_connections_);
+        while (!stopping(stop)) {
+            int ready = wait_readable(listen_fd, kStopCheckMs);
+            if (ready < 0) break;
+            if (ready == 0) continue;
+
+            int client = ::accept(listen_fd, nullptr, nullptr);
+            if (client < 0) continue;
+            ::fcntl(client, F_SETFD, FD_CLOEXEC);
+            pool.submit([this, client, stop]() {
+                serve_connection(client, client, stop);
+                ::close(client);
+            });
+        }
+        // Pool destructor waits for open connections; they notice the stop
+        // at their next idle check
+    }
+
+    ::close(listen_fd);
+    ::unlink(path.c_str());
+}
+
+}  // namespace fleet
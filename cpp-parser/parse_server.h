@@ -0,0 +1,149 @@
+#ifndef PARSE_SERVER_H
+#define PARSE_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+// ============================================================================
+// Parse service wire protocol
+//
+// A resident fleet_parser (--serve) reads framed requests from a Unix
+// socket connection or stdin and answers each with one framed response on
+// the same connection (or stdout). Everything is little-endian:
+//
+//     RequestHeader    24 bytes
+//     payload          payload_size bytes: a file path (Op::ParsePath) or
+//                      the CSV / log text itself (Op::ParseInline)
+//
+// The response body is streamed while the input is parsed, as any number
+// of length-prefixed chunks, and the response ends with its header:
+//
+//     ChunkHeader      8 bytes         } zero or more, body bytes in the
+//     chunk            size bytes      } requested ResultFormat
+//     ResponseHeader   24 bytes
+//     stats            stats_size bytes: stats_to_json() on success, the
+//                      error message otherwise
+//
+// ResponseHeader::body_size is the total of the chunk sizes before it. A
+// request that fails part way through ends with Status::Error, and the
+// chunks already sent must be discarded. Ping, Shutdown and failures
+// before any output are answered with the header alone.
+//
+// ResultFormat::Binary bodies are complete "FLET" v2 files (see
+// binary_format.h); with a codec, blocks hold column-major images. A
+// connection stays open for any number of requests. The socket file is
+// created with mode 0600, so only the server's user can connect.
+// ============================================================================
+
+namespace service {
+
+constexpr uint32_t kRequestMagic = 0x51524A46;   // "FJRQ"
+constexpr uint32_t kResponseMagic = 0x53524A46;  // "FJRS"
+constexpr uint32_t kChunkMagic = 0x43524A46;     // "FJRC"
+constexpr uint32_t kMaxChunk = 1u << 20;         // body bytes per chunk
+constexpr uint64_t kMaxPayload = 1ull << 30;
+
+enum class Op : uint8_t {
+    Ping = 0,         // empty Ok response
+    ParsePath = 1,
+    ParseInline = 2,
+    Shutdown = 3,     // answered, then the server stops accepting work
+};
+
+enum class InputFormat : uint8_t { Csv = 0, Log = 1, Binary = 2 };
+
+enum class ResultFormat : uint8_t {
+    StatsOnly = 0,   // empty body
+    Binary = 1,      // FLET v2
+    NDJson = 2,
+    Csv = 3,
+    Json = 4,        // JSON array
+};
+
+enum class Status : uint8_t { Ok = 0, Error = 1 };
+
+// RequestHeader::flags
+constexpr uint8_t kFlagNoHeader = 1 << 0;    // input has no header row
+constexpr uint8_t kFlagNoValidate = 1 << 1;  // skip range validation
+
+struct RequestHeader {
+    uint32_t magic;          // kRequestMagic
+    uint8_t op;              // Op
+    uint8_t input;           // InputFormat
+    uint8_t result;          // ResultFormat
+    uint8_t flags;
+    uint8_t codec;           // binary::Codec for ResultFormat::Binary
+    uint8_t delimiter;       // CSV delimiter; 0 = server default
+    uint16_t reserved;
+    uint32_t threads;        // parse threads; 0 = server default, capped at the host's cores
+    uint64_t payload_size;
+};
+
+struct ResponseHeader {
+    uint32_t magic;          // kResponseMagic
+    uint8_t status;          // Status
+    uint8_t result;          // ResultFormat of the body
+    uint16_t reserved;
+    uint32_t stats_size;
+    uint32_t reserved2;
+    uint64_t body_size;      // bytes streamed in the chunks before it
+};
+
+struct ChunkHeader {
+    uint32_t magic;          // kChunkMagic
+    uint32_t size;           // at most kMaxChunk
+};
+
+static_assert(sizeof(RequestHeader) == 24, "RequestHeader layout is part of the protocol");
+static_assert(sizeof(ResponseHeader) == 24, "ResponseHeader layout is part of the protocol");
+static_assert(sizeof(ChunkHeader) == 8, "ChunkHeader layout is part of the protocol");
+
+}  // namespace service
+
+// Resident parse service.
+//
+// Each request gets a fresh TelemetryParser built from the server's
+// ParserConfig plus the request's flags, so requests never share state.
+// Unix socket connections are served concurrently on a fixed pool of
+// max_connections workers; further clients wait for a free worker.
+class ParseServer {
+public:
+    explicit ParseServer(const ParserConfig& config = ParserConfig(), size_t max_connections = 4);
+
+    // Serve one connection until the peer closes it, a Shutdown request
+    // arrives or stop is set. Returns false once the server should stop.
+    bool serve_connection(int in_fd, int out_fd, const std::atomic<bool>* stop = nullptr);
+
+    // Listen on a Unix domain socket (replacing a stale socket file) and
+    // serve clients until stop is set or a client sends Shutdown
+    void serve_unix_socket(const std::string& path, const std::atomic<bool>* stop = nullptr);
+
+    size_t requests_served() const { return requests_served_.load(); }
+
+private:
+    struct Response {
+        service::Status status = service::Status::Ok;
+        service::ResultFormat result = service::ResultFormat::StatsOnly;
+        std::string stats;
+    };
+
+    // Parse one request, writing its body to body as records are parsed
+    Response handle(const service::RequestHeader& request, std::string_view payload, std::ostream& body);
+    bool stopping(const std::atomic<bool>* stop) const;
+
+    ParserConfig config_;
+    size_t max_connections_;
+    std::atomic<bool> shutdown_{false};
+    std::atomic<size_t> requests_served_{0};
+};
+
+}  // namespace fleet
+
+#endif  // PARSE_SERVER_H
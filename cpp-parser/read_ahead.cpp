@@ -0,0 +1,362 @@
+#include "read_ahead.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define FLEET_READ_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace fleet {
+
+// ============================================================================
+// io_uring ring
+// ============================================================================
+
+#if defined(FLEET_READ_IO_URING)
+
+// Submission and completion rings of one io_uring instance, mapped from
+// the kernel. Only this thread submits and reaps, so the ring indices need
+// no more than acquire/release ordering against the kernel.
+struct ReadAhead::Ring {
+    int fd = -1;
+    void* sq_ptr = MAP_FAILED;
+    size_t sq_size = 0;
+    void* cq_ptr = MAP_FAILED;
+    size_t cq_size = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_size = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    std::vector<iovec> iovecs;   // one per slot; read by the kernel at submit
+    size_t inflight = 0;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) ::munmap(sqes, sqes_size);
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) ::munmap(cq_ptr, cq_size);
+        if (sq_ptr != MAP_FAILED) ::munmap(sq_ptr, sq_size);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) return false;
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = false;
+#if defined(IORING_FEAT_SINGLE_MMAP)
+        single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+        if (single_mmap) sq_size = cq_size = std::max(sq_size, cq_size);
+
+        sq_ptr = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) return false;
+        cq_ptr = single_mmap ? sq_ptr
+                             : ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED) return false;
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) return false;
+
+        char* sq = static_cast<char*>(sq_ptr);
+        char* cq = static_cast<char*>(cq_ptr);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // io_uring_enter(), retried on EINTR
+    void enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        for (;;) {
+            long rc = ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+            if (rc >= 0) return;
+            if (errno != EINTR) {
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+        }
+    }
+};
+
+#else
+
+struct ReadAhead::Ring {};
+
+#endif
+
+bool ReadAhead::io_uring_compiled() {
+#if defined(FLEET_READ_IO_URING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// ReadAhead implementation
+// ============================================================================
+
+ReadAhead::ReadAhead(const std::string& filename, const ReadAheadConfig& config)
+    : filename_(filename), config_(config) {
+    if (config_.block_size == 0) config_.block_size = ReadAheadConfig().block_size;
+    config_.depth = std::max<size_t>(config_.depth, 1);
+
+    fd_ = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    slots_.resize(config_.depth);
+    for (Slot& slot : slots_) slot.data = std::make_unique<char[]>(config_.block_size);
+
+    struct stat st;
+    regular_ = ::fstat(fd_, &st) == 0 && S_ISREG(st.st_mode);
+    if (config_.use_io_uring && regular_) {
+        file_size_ = static_cast<uint64_t>(st.st_size);
+        if (start_ring()) {
+            ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+            for (size_t i = 0; i < slots_.size() && next_offset_ < file_size_; i++) request(i);
+            return;
+        }
+    }
+    reader_ = std::thread([this]() { reader_loop(); });
+}
+
+ReadAhead::~ReadAhead() {
+#if defined(FLEET_READ_IO_URING)
+    // The kernel may still be writing into the buffers: wait it out
+    if (ring_) {
+        while (ring_->inflight > 0) {
+            try {
+                reap();  // a failed read still completes its slot
+            } catch (const std::exception&) {
+            }
+            if (ring_->inflight == 0) break;
+            try {
+                ring_->enter(0, 1, IORING_ENTER_GETEVENTS);
+            } catch (const std::exception&) {
+                break;   // the ring itself is gone
+            }
+        }
+        ring_.reset();
+    }
+#endif
+    if (reader_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        reader_.join();
+    }
+    if (fd_ >= 0) ::close(fd_);
+}
+
+const char* ReadAhead::backend() const {
+    return ring_ ? "io_uring" : "thread";
+}
+
+std::string_view ReadAhead::next() {
+    if (ring_) {
+        if (holding_) {
+            holding_ = false;
+            size_t slot = consumed_++ % slots_.size();
+            if (!done_ && next_offset_ < file_size_) request(slot);
+        }
+        if (done_ || static_cast<uint64_t>(consumed_) * config_.block_size >= file_size_) {
+            done_ = true;
+            return std::string_view();
+        }
+        Slot& slot = slots_[consumed_ % slots_.size()];
+        wait_ring(consumed_ % slots_.size());
+        if (slot.eof) done_ = true;
+        if (slot.size == 0) return std::string_view();
+        holding_ = true;
+        bytes_read_ += slot.size;
+        return std::string_view(slot.data.get(), slot.size);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (holding_) {
+        holding_ = false;
+        consumed_++;
+        cv_.notify_all();
+    }
+    if (done_) return std::string_view();
+    cv_.wait(lock, [this]() { return produced_ > consumed_; });
+    if (!error_.empty()) {
+        done_ = true;
+        throw std::runtime_error(error_);
+    }
+    Slot& slot = slots_[consumed_ % slots_.size()];
+    if (slot.eof) done_ = true;
+    if (slot.size == 0) return std::string_view();
+    holding_ = true;
+    bytes_read_ += slot.size;
+    return std::string_view(slot.data.get(), slot.size);
+}
+
+bool ReadAhead::start_ring() {
+#if defined(FLEET_READ_IO_URING)
+    auto ring = std::make_unique<Ring>();
+    if (!ring->setup(static_cast<unsigned>(slots_.size()))) return false;
+    ring->iovecs.resize(slots_.size());
+    ring_ = std::move(ring);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ReadAhead::request(size_t slot) {
+    Slot& s = slots_[slot];
+    s.offset = next_offset_;
+    s.wanted = static_cast<size_t>(std::min<uint64_t>(config_.block_size, file_size_ - next_offset_));
+    s.size = 0;
+    s.ready = false;
+    s.eof = next_offset_ + s.wanted >= file_size_;
+    next_offset_ += s.wanted;
+    submit(slot);
+}
+
+void ReadAhead::submit(size_t slot) {
+#if defined(FLEET_READ_IO_URING)
+    Slot& s = slots_[slot];
+    Ring& ring = *ring_;
+    iovec& iov = ring.iovecs[slot];
+    iov.iov_base = s.data.get() + s.size;
+    iov.iov_len = s.wanted - s.size;
+
+    unsigned tail = *ring.sq_tail;
+    unsigned index = tail & *ring.sq_mask;
+    io_uring_sqe& sqe = ring.sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = fd_;
+    sqe.addr = reinterpret_cast<uint64_t>(&iov);
+    sqe.len = 1;
+    sqe.off = s.offset + s.size;
+    sqe.user_data = slot;
+    ring.sq_array[index] = index;
+    __atomic_store_n(ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring.inflight++;
+    ring.enter(1, 0, 0);
+#else
+    (void)slot;
+#endif
+}
+
+// Handle every completion posted so far; short reads are queued again
+void ReadAhead::reap() {
+#if defined(FLEET_READ_IO_URING)
+    Ring& ring = *ring_;
+    unsigned head = *ring.cq_head;
+    std::string error;
+    while (head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe& cqe = ring.cqes[head & *ring.cq_mask];
+        size_t slot = static_cast<size_t>(cqe.user_data);
+        int res = cqe.res;
+        head++;
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+        ring.inflight--;
+
+        Slot& s = slots_[slot];
+        if (res == -EINTR || res == -EAGAIN) {
+            submit(slot);
+        } else if (res < 0) {
+            if (error.empty()) error = "Failed to read " + filename_ + ": " + std::strerror(-res);
+            s.ready = true;
+        } else if (res == 0) {
+            // The file shrank under us: this is where it ends now
+            s.eof = true;
+            s.ready = true;
+        } else {
+            s.size += static_cast<size_t>(res);
+            if (s.size < s.wanted) {
+                submit(slot);
+            } else {
+                s.ready = true;
+            }
+        }
+    }
+    if (!error.empty()) throw std::runtime_error(error);
+#endif
+}
+
+void ReadAhead::wait_ring(size_t slot) {
+#if defined(FLEET_READ_IO_URING)
+    for (;;) {
+        reap();
+        if (slots_[slot].ready) return;
+        ring_->enter(0, 1, IORING_ENTER_GETEVENTS);
+    }
+#else
+    (void)slot;
+#endif
+}
+
+void ReadAhead::reader_loop() {
+    for (size_t block = 0;; block++) {
+        Slot& slot = slots_[block % slots_.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]() { return stopping_ || block - consumed_ < slots_.size(); });
+            if (stopping_) return;
+        }
+
+        // Fill the block completely unless the file ends first
+        size_t filled = 0;
+        std::string error;
+        while (filled < config_.block_size) {
+            ssize_t got = ::read(fd_, slot.data.get() + filled, config_.block_size - filled);
+            if (got > 0) {
+                filled += static_cast<size_t>(got);
+            } else if (got == 0) {
+                break;
+            } else if (errno != EINTR) {
+                error = "Failed to read " + filename_ + ": " + std::strerror(errno);
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slot.size = filled;
+            slot.eof = filled < config_.block_size || !error.empty();
+            error_ = error;
+            produced_ = block + 1;
+        }
+        cv_.notify_all();
+        if (slot.eof) return;
+    }
+}
+
+}  // namespace fleet
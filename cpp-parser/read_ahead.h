@@ -0,0 +1,98 @@
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fleet {
+
+struct ReadAheadConfig {
+    size_t block_size = 1024 * 1024;   // bytes per read (ParserConfig::buffer_size)
+    size_t depth = 3;                  // blocks in flight: 2 = double, 3 = triple buffering
+    bool use_io_uring = true;          // false: always the reader thread
+};
+
+// Sequential read-ahead of a whole file in fixed-size blocks.
+//
+// Keeps up to depth blocks in flight while the caller works on the one
+// next() last returned, so reads overlap parsing instead of alternating
+// with it. On Linux, regular files are read with io_uring (raw syscalls,
+// no liburing needed); where the kernel or a sandbox refuses to set up a
+// ring, and for pipes and other platforms, a reader thread does blocking
+// reads into the same rotating buffers. Short reads are resumed, so every
+// block but the last is exactly block_size bytes. Blocks end wherever the
+// byte count does; callers carry rows that straddle two blocks.
+class ReadAhead {
+public:
+    explicit ReadAhead(const std::string& filename, const ReadAheadConfig& config = ReadAheadConfig());
+    ~ReadAhead();
+
+    ReadAhead(const ReadAhead&) = delete;
+    ReadAhead& operator=(const ReadAhead&) = delete;
+
+    // The next block in file order, empty at end of file. The view stays
+    // valid until the following call. Throws on a read error.
+    std::string_view next();
+
+    // Mechanism in use: "io_uring" or "thread"
+    const char* backend() const;
+    uint64_t bytes_read() const { return bytes_read_; }
+    // false for pipes and other inputs that cannot be reopened and read again
+    bool regular() const { return regular_; }
+
+    // Whether this build can use io_uring at all
+    static bool io_uring_compiled();
+
+private:
+    struct Ring;
+
+    struct Slot {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;       // bytes filled
+        size_t wanted = 0;     // bytes requested (io_uring)
+        uint64_t offset = 0;   // file offset of data[0] (io_uring)
+        bool ready = false;
+        bool eof = false;      // last block of the file
+    };
+
+    bool start_ring();
+    void request(size_t slot);      // queue the next block of the file into slot
+    void submit(size_t slot);       // (re)queue the unfilled rest of slot
+    void reap();
+    void wait_ring(size_t slot);
+    void reader_loop();
+
+    std::string filename_;
+    ReadAheadConfig config_;
+    int fd_ = -1;
+    bool regular_ = false;
+    std::vector<Slot> slots_;       // block k lives in slots_[k % depth]
+    size_t consumed_ = 0;           // blocks released by the caller
+    bool holding_ = false;          // the caller holds block consumed_
+    bool done_ = false;
+    uint64_t bytes_read_ = 0;
+
+    // io_uring backend
+    std::unique_ptr<Ring> ring_;
+    uint64_t file_size_ = 0;
+    uint64_t next_offset_ = 0;      // file offset of the next block to request
+
+    // Thread backend
+    std::thread reader_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t produced_ = 0;           // blocks handed over by the reader
+    bool stopping_ = false;
+    std::string error_;
+};
+
+}  // namespace fleet
+
+#endif  // READ_AHEAD_H
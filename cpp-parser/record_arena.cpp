@@ -0,0 +1,72 @@
+#include "record_arena.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace fleet {
+
+RecordArena::RecordArena(size_t block_size, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), block_size_(block_size < 4096 ? 4096 : block_size) {}
+
+RecordArena::~RecordArena() {
+    release();
+}
+
+void RecordArena::release() {
+    while (blocks_) {
+        Block* next = blocks_->next;
+        upstream_->deallocate(blocks_, blocks_->size, blocks_->alignment);
+        blocks_ = next;
+    }
+    cursor_ = limit_ = nullptr;
+    bytes_used_ = bytes_reserved_ = block_count_ = 0;
+}
+
+void* RecordArena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t p = (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) & ~(alignment - 1);
+    if (cursor_ == nullptr || p + bytes > reinterpret_cast<uintptr_t>(limit_)) {
+        return allocate_block(bytes, alignment);
+    }
+    cursor_ = reinterpret_cast<char*>(p + bytes);
+    bytes_used_ += bytes;
+    return reinterpret_cast<void*>(p);
+}
+
+void* RecordArena::allocate_block(size_t bytes, size_t alignment) {
+    const size_t header = (sizeof(Block) + alignment - 1) & ~(alignment - 1);
+    const size_t needed = header + bytes;
+    // Oversized requests (e.g. a reserved result vector) get a block of
+    // their own, and the current block keeps serving small strings
+    const bool dedicated = needed > block_size_ / 4;
+    const size_t size = dedicated ? needed : block_size_;
+
+    const size_t block_alignment = alignment > alignof(std::max_align_t) ? alignment : alignof(std::max_align_t);
+    Block* block = static_cast<Block*>(upstream_->allocate(size, block_alignment));
+    block->size = size;
+    block->alignment = block_alignment;
+    bytes_reserved_ += size;
+    block_count_++;
+    bytes_used_ += bytes;
+
+    char* start = reinterpret_cast<char*>(block) + header;
+    if (dedicated && blocks_) {
+        // Keep the partly used block at the head of the list
+        block->next = blocks_->next;
+        blocks_->next = block;
+        return start;
+    }
+    block->next = blocks_;
+    blocks_ = block;
+    cursor_ = start + bytes;
+    limit_ = reinterpret_cast<char*>(block) + size;
+    return start;
+}
+
+void RecordArena::do_deallocate(void*, size_t, size_t) {
+    // Memory comes back in release()
+}
+
+bool RecordArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+}  // namespace fleet
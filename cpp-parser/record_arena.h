@@ -0,0 +1,73 @@
+#ifndef RECORD_ARENA_H
+#define RECORD_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace fleet {
+
+// Monotonic arena for parse results.
+//
+// A std::pmr::memory_resource that hands out memory by bumping a pointer
+// through blocks taken from an upstream resource. deallocate() is a no-op:
+// everything is returned at once by release() or the destructor, so
+// dropping a whole batch of results costs one free per block instead of
+// one per string.
+//
+//   RecordArena arena;
+//   {
+//       auto records = parser.parse_file(path, &arena);
+//       ...
+//   }                    // destructors only hand memory back to the arena
+//   arena.release();     // blocks go back upstream in one pass
+//
+// bytes_used() grows by exactly what the records asked for, which makes
+// the per-record footprint easy to budget; a result vector that outgrows
+// its reserve leaves the old buffer behind until release(). Like std::pmr's
+// monotonic resource it is not thread-safe.
+class RecordArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultBlockSize = 1 << 20;
+
+    explicit RecordArena(size_t block_size = kDefaultBlockSize,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~RecordArena() override;
+
+    RecordArena(const RecordArena&) = delete;
+    RecordArena& operator=(const RecordArena&) = delete;
+
+    // Free every block; memory handed out earlier must no longer be used
+    void release();
+
+    size_t bytes_used() const { return bytes_used_; }          // sum of allocation requests
+    size_t bytes_reserved() const { return bytes_reserved_; }  // taken from upstream
+    size_t block_count() const { return block_count_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    // Header at the start of every upstream block
+    struct Block {
+        Block* next;
+        size_t size;
+        size_t alignment;
+    };
+
+    void* allocate_block(size_t bytes, size_t alignment);
+
+    std::pmr::memory_resource* upstream_;
+    size_t block_size_;
+    Block* blocks_ = nullptr;
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+    size_t bytes_used_ = 0;
+    size_t bytes_reserved_ = 0;
+    size_t block_count_ = 0;
+};
+
+}  // namespace fleet
+
+#endif  // RECORD_ARENA_H
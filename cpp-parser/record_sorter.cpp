@@ -0,0 +1,277 @@
+#include "record_sorter.h"
+#include "binary_format.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace fleet {
+
+// ============================================================================
+// Run sorting
+// ============================================================================
+
+namespace {
+
+// Radix key of one buffered row; index is its position in the buffer
+struct SortKey {
+    uint64_t timestamp;   // sign bit flipped, so unsigned order is signed order
+    uint32_t vehicle;     // rank of the vehicle ID in name order
+    uint32_t index;
+};
+
+constexpr int kDigitBits = 11;
+constexpr size_t kBuckets = size_t(1) << kDigitBits;
+constexpr uint64_t kDigitMask = kBuckets - 1;
+constexpr int kTimestampDigits = 6;                   // 66 bits
+constexpr int kDigits = kTimestampDigits + 3;         // + 33 bits of rank
+
+// Buffer, permuted copy, keys and scatter space
+constexpr size_t kBytesPerRow = 2 * sizeof(TelemetryRecord) + 2 * sizeof(SortKey);
+
+inline size_t digit(const SortKey& key, int d) {
+    return d < kTimestampDigits
+        ? (key.timestamp >> (d * kDigitBits)) & kDigitMask
+        : (key.vehicle >> ((d - kTimestampDigits) * kDigitBits)) & kDigitMask;
+}
+
+// LSD radix sort, least significant digit of the timestamp first and the
+// vehicle rank last. All histograms come from one pass over the keys, and
+// digits every key shares (the high timestamp bits of a run, the high rank
+// bits of a small fleet) cost no scatter pass.
+void radix_sort(std::vector<SortKey>& keys, std::vector<SortKey>& scratch) {
+    const size_t n = keys.size();
+    if (n < 2) return;
+    std::vector<size_t> counts(kDigits * kBuckets, 0);
+    for (const SortKey& key : keys) {
+        for (int d = 0; d < kDigits; d++) counts[d * kBuckets + digit(key, d)]++;
+    }
+
+    scratch.resize(n);
+    for (int d = 0; d < kDigits; d++) {
+        size_t* count = counts.data() + d * kBuckets;
+        if (count[digit(keys[0], d)] == n) continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < kBuckets; b++) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (const SortKey& key : keys) scratch[count[digit(key, d)]++] = key;
+        keys.swap(scratch);
+    }
+}
+
+void fill_data(const TelemetryRecord& r, std::string_view vehicle, std::string_view diagnostic,
+               TelemetryData& out) {
+    out.vehicle_id.assign(vehicle.data(), vehicle.size());
+    out.timestamp = r.timestamp;
+    out.latitude = r.latitude;
+    out.longitude = r.longitude;
+    out.speed = r.speed;
+    out.heading = r.heading;
+    out.engine_rpm = r.engine_rpm;
+    out.fuel_level = r.fuel_level;
+    out.odometer_km = r.odometer_km;
+    out.engine_temp = r.engine_temp;
+    out.battery_volt = r.battery_volt;
+    out.diagnostic_code.assign(diagnostic.data(), diagnostic.size());
+}
+
+// Read position in one sorted run: a spilled file, or the in-memory rest
+struct RunCursor {
+    std::unique_ptr<BinaryReader> reader;
+    BlockBuffer buffer;
+    size_t next_block = 0;
+    const StringTable* vehicles = nullptr;      // in-memory run only
+    const StringTable* diagnostics = nullptr;
+    RecordSpan records;
+    size_t pos = 0;
+
+    const TelemetryRecord& current() const { return records[pos]; }
+
+    std::string_view vehicle() const {
+        return reader ? reader->vehicle(current().vehicle_id) : vehicles->view(current().vehicle_id);
+    }
+    std::string_view diagnostic() const {
+        return reader ? reader->diagnostic(current().diagnostic_code)
+                      : diagnostics->view(current().diagnostic_code);
+    }
+
+    // Load the next non-empty block of a spilled run
+    bool load_block() {
+        while (reader && next_block < reader->block_count()) {
+            records = reader->read_block(next_block++, buffer);
+            pos = 0;
+            if (!records.empty()) return true;
+        }
+        return false;
+    }
+
+    bool advance() {
+        if (++pos < records.size) return true;
+        return load_block();
+    }
+};
+
+}  // namespace
+
+// ============================================================================
+// RecordSorter implementation
+// ============================================================================
+
+RecordSorter::RecordSorter(const SortConfig& config)
+    : config_(config),
+      run_capacity_(std::max<size_t>(config.memory_bytes / kBytesPerRow, 1024)) {}
+
+RecordSorter::~RecordSorter() {
+    remove_spills();
+}
+
+void RecordSorter::add(const TelemetryData& data) {
+    if (buffer_.capacity() == 0) buffer_.reserve(run_capacity_);
+
+    TelemetryRecord& r = buffer_.emplace_back();
+    std::memset(&r, 0, sizeof(r));
+    r.timestamp = data.timestamp;
+    r.latitude = data.latitude;
+    r.longitude = data.longitude;
+    r.speed = data.speed;
+    r.heading = data.heading;
+    r.fuel_level = data.fuel_level;
+    r.odometer_km = data.odometer_km;
+    r.engine_temp = data.engine_temp;
+    r.battery_volt = data.battery_volt;
+    r.engine_rpm = data.engine_rpm;
+    r.vehicle_id = vehicles_.intern(data.vehicle_id);
+    r.diagnostic_code = diagnostics_.intern(data.diagnostic_code);
+    records_in_++;
+
+    if (buffer_.size() >= run_capacity_) spill();
+}
+
+void RecordSorter::sort_buffer() {
+    const size_t n = buffer_.size();
+    if (n < 2) return;
+
+    // Rank every vehicle interned so far by name
+    std::vector<uint32_t> order(vehicles_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [this](uint32_t a, uint32_t b) { return vehicles_.view(a) < vehicles_.view(b); });
+    std::vector<uint32_t> rank(order.size());
+    for (size_t i = 0; i < order.size(); i++) rank[order[i]] = static_cast<uint32_t>(i);
+
+    std::vector<SortKey> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i].timestamp = static_cast<uint64_t>(buffer_[i].timestamp) ^ (uint64_t(1) << 63);
+        keys[i].vehicle = rank[buffer_[i].vehicle_id];
+        keys[i].index = static_cast<uint32_t>(i);
+    }
+    std::vector<SortKey> scratch;
+    radix_sort(keys, scratch);
+    scratch = std::vector<SortKey>();
+
+    std::vector<TelemetryRecord> sorted;
+    sorted.reserve(buffer_.capacity());
+    for (const SortKey& key : keys) sorted.push_back(buffer_[key.index]);
+    buffer_.swap(sorted);
+}
+
+void RecordSorter::spill() {
+    sort_buffer();
+
+    std::string dir = config_.temp_dir;
+    if (dir.empty()) {
+        const char* tmp = std::getenv("TMPDIR");
+        dir = tmp && *tmp ? tmp : "/tmp";
+    }
+    std::string path = dir + "/fleet_sort_XXXXXX";
+    int fd = ::mkstemp(&path[0]);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create sort spill file in " + dir + ": " + std::strerror(errno));
+    }
+    ::close(fd);
+    spill_paths_.push_back(path);
+
+    BinaryWriterConfig config;
+    config.version = binary::kVersion2;
+    BinaryWriter writer(path, config);
+    for (const TelemetryRecord& r : buffer_) writer.write(r, vehicles_, diagnostics_);
+    writer.close();
+
+    buffer_.clear();
+    runs_spilled_++;
+}
+
+void RecordSorter::finish(const std::function<void(TelemetryData&&)>& emit) {
+    sort_buffer();
+    TelemetryData data;
+
+    if (spill_paths_.empty()) {
+        for (const TelemetryRecord& r : buffer_) {
+            fill_data(r, vehicles_.view(r.vehicle_id), diagnostics_.view(r.diagnostic_code), data);
+            emit(std::move(data));
+        }
+    } else {
+        // One cursor per spilled run in spill order, then the buffered rest,
+        // so ties go to the earlier input
+        std::vector<RunCursor> cursors(spill_paths_.size() + 1);
+        for (size_t i = 0; i < spill_paths_.size(); i++) {
+            cursors[i].reader = std::make_unique<BinaryReader>(spill_paths_[i]);
+        }
+        RunCursor& rest = cursors.back();
+        rest.vehicles = &vehicles_;
+        rest.diagnostics = &diagnostics_;
+        rest.records = RecordSpan{buffer_.data(), buffer_.size()};
+
+        // Min-heap of cursor indices on (vehicle, timestamp, run)
+        auto after = [&cursors](size_t a, size_t b) {
+            const RunCursor& x = cursors[a];
+            const RunCursor& y = cursors[b];
+            int c = x.vehicle().compare(y.vehicle());
+            if (c != 0) return c > 0;
+            if (x.current().timestamp != y.current().timestamp) {
+                return x.current().timestamp > y.current().timestamp;
+            }
+            return a > b;
+        };
+        std::vector<size_t> heap;
+        heap.reserve(cursors.size());
+        for (size_t i = 0; i < cursors.size(); i++) {
+            bool has_rows = cursors[i].reader ? cursors[i].load_block() : !cursors[i].records.empty();
+            if (has_rows) heap.push_back(i);
+        }
+        std::make_heap(heap.begin(), heap.end(), after);
+
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), after);
+            RunCursor& cursor = cursors[heap.back()];
+            fill_data(cursor.current(), cursor.vehicle(), cursor.diagnostic(), data);
+            emit(std::move(data));
+            if (cursor.advance()) {
+                std::push_heap(heap.begin(), heap.end(), after);
+            } else {
+                heap.pop_back();
+            }
+        }
+    }
+
+    buffer_ = std::vector<TelemetryRecord>();
+    vehicles_.clear();
+    diagnostics_.clear();
+    remove_spills();
+}
+
+void RecordSorter::remove_spills() {
+    for (const std::string& path : spill_paths_) std::remove(path.c_str());
+    spill_paths_.clear();
+}
+
+}  // namespace fleet
@@ -0,0 +1,74 @@
+#ifndef RECORD_SORTER_H
+#define RECORD_SORTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "string_table.h"
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+struct SortConfig {
+    // Buffered rows plus sort scratch (about 200 bytes a row) before a
+    // sorted run is spilled to disk
+    size_t memory_bytes = size_t(512) << 20;
+    // Spill directory (empty: $TMPDIR, else /tmp)
+    std::string temp_dir;
+};
+
+// External sort of records by (vehicle_id, timestamp).
+//
+// add() buffers records compactly, with vehicle IDs and diagnostic codes
+// interned. When the buffer reaches SortConfig::memory_bytes it is sorted
+// into a run and spilled to a temporary v2 binary file. finish() sorts
+// what is left and k-way merges it with the spilled runs, so inputs far
+// larger than memory come out clustered into per-vehicle runs in time
+// order. Runs are sorted by an LSD radix sort over the vehicle's rank (its
+// position in name order) and the 64-bit timestamp. Both the sort and the
+// merge are stable: rows with equal keys keep their input order.
+//
+//   RecordSorter sorter;
+//   parser.parse_file_streaming(path, [&](TelemetryData&& r) { sorter.add(r); });
+//   sorter.finish([&](TelemetryData&& r) { writer.write(r); });
+//
+// Spill files are removed by finish() and the destructor.
+class RecordSorter {
+public:
+    explicit RecordSorter(const SortConfig& config = SortConfig());
+    ~RecordSorter();
+
+    RecordSorter(const RecordSorter&) = delete;
+    RecordSorter& operator=(const RecordSorter&) = delete;
+
+    void add(const TelemetryData& data);
+
+    // Hand every record over in sorted order; the sorter is empty afterwards
+    void finish(const std::function<void(TelemetryData&&)>& emit);
+
+    uint64_t records_in() const { return records_in_; }
+    size_t runs_spilled() const { return runs_spilled_; }
+
+private:
+    // Sort buffer_ in place by (vehicle name, timestamp)
+    void sort_buffer();
+    void spill();
+    void remove_spills();
+
+    SortConfig config_;
+    size_t run_capacity_;
+
+    std::vector<TelemetryRecord> buffer_;
+    StringTable vehicles_;
+    StringTable diagnostics_;
+
+    std::vector<std::string> spill_paths_;
+    uint64_t records_in_ = 0;
+    size_t runs_spilled_ = 0;
+};
+
+}  // namespace fleet
+
+#endif  // RECORD_SORTER_H
@@ -0,0 +1,282 @@
+#include "record_writer.h"
+#include "telemetry_batch.h"
+#include "window_rollup.h"
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace fleet {
+
+// ============================================================================
+// Field formatting
+// ============================================================================
+
+// One record's fields, borrowed from whichever representation holds it
+struct RowRef {
+    std::string_view vehicle_id;
+    std::string_view diagnostic_code;
+    int64_t timestamp;
+    double latitude;
+    double longitude;
+    double speed;
+    double heading;
+    int engine_rpm;
+    double fuel_level;
+    double odometer_km;
+    double engine_temp;
+    double battery_volt;
+};
+
+static RowRef row_ref(const TelemetryData& d) {
+    return RowRef{d.vehicle_id, d.diagnostic_code, d.timestamp, d.latitude, d.longitude,
+                  d.speed, d.heading, d.engine_rpm, d.fuel_level, d.odometer_km,
+                  d.engine_temp, d.battery_volt};
+}
+
+static RowRef row_ref(const TelemetryBatch& b, size_t i) {
+    return RowRef{b.vehicle(i), b.diagnostic(i), b.timestamp[i], b.latitude[i], b.longitude[i],
+                  b.speed[i], b.heading[i], b.engine_rpm[i], b.fuel_level[i], b.odometer_km[i],
+                  b.engine_temp[i], b.battery_volt[i]};
+}
+
+static void put_int(std::string& out, int64_t value) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, res.ptr);
+}
+
+// Same digits as iostream std::fixed << std::setprecision(precision)
+static void put_fixed(std::string& out, double value, int precision) {
+    // Worst case: sign, 309 integer digits, point, precision digits
+    char buf[330];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+    out.append(buf, res.ptr);
+}
+
+static void put_json_number(std::string& out, double value, int precision) {
+    if (std::isfinite(value)) {
+        put_fixed(out, value, precision);
+    } else {
+        out += "null";
+    }
+}
+
+static void put_json_string(std::string& out, std::string_view str) {
+    static const char kHex[] = "0123456789abcdef";
+    out += '"';
+    size_t run = 0;  // start of the pending unescaped run
+    for (size_t i = 0; i < str.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(str.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xF];
+        }
+    }
+    out.append(str.data() + run, str.size() - run);
+    out += '"';
+}
+
+static void put_csv_string(std::string& out, std::string_view str) {
+    if (str.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(str);
+        return;
+    }
+    out += '"';
+    for (char c : str) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+static void append_json_row(std::string& out, const RowRef& r) {
+    out += "{\"vehicle_id\":";
+    put_json_string(out, r.vehicle_id);
+    out += ",\"timestamp\":";
+    put_int(out, r.timestamp);
+    out += ",\"latitude\":";
+    put_json_number(out, r.latitude, 6);
+    out += ",\"longitude\":";
+    put_json_number(out, r.longitude, 6);
+    out += ",\"speed\":";
+    put_json_number(out, r.speed, 2);
+    out += ",\"heading\":";
+    put_json_number(out, r.heading, 2);
+    out += ",\"engine_rpm\":";
+    put_int(out, r.engine_rpm);
+    out += ",\"fuel_level\":";
+    put_json_number(out, r.fuel_level, 2);
+    out += ",\"odometer_km\":";
+    put_json_number(out, r.odometer_km, 2);
+    out += ",\"engine_temp\":";
+    put_json_number(out, r.engine_temp, 2);
+    out += ",\"battery_volt\":";
+    put_json_number(out, r.battery_volt, 2);
+    if (!r.diagnostic_code.empty()) {
+        out += ",\"diagnostic_code\":";
+        put_json_string(out, r.diagnostic_code);
+    }
+    out += '}';
+}
+
+static void append_csv_row(std::string& out, const RowRef& r) {
+    put_csv_string(out, r.vehicle_id);
+    out += ',';
+    put_int(out, r.timestamp);
+    out += ',';
+    put_fixed(out, r.latitude, 6);
+    out += ',';
+    put_fixed(out, r.longitude, 6);
+    out += ',';
+    put_fixed(out, r.speed, 2);
+    out += ',';
+    put_fixed(out, r.heading, 2);
+    out += ',';
+    put_int(out, r.engine_rpm);
+    out += ',';
+    put_fixed(out, r.fuel_level, 2);
+    out += ',';
+    put_fixed(out, r.odometer_km, 2);
+    out += ',';
+    put_fixed(out, r.engine_temp, 2);
+    out += ',';
+    put_fixed(out, r.battery_volt, 2);
+    out += ',';
+    put_csv_string(out, r.diagnostic_code);
+}
+
+void append_json(std::string& out, const TelemetryData& data) {
+    append_json_row(out, row_ref(data));
+}
+
+void append_csv(std::string& out, const TelemetryData& data) {
+    append_csv_row(out, row_ref(data));
+}
+
+void append_json_string(std::string& out, std::string_view str) {
+    put_json_string(out, str);
+}
+
+void append_json_number(std::string& out, double value, int precision) {
+    put_json_number(out, value, precision);
+}
+
+std::optional<OutputFormat> parse_output_format(std::string_view name) {
+    if (name == "json") return OutputFormat::JsonArray;
+    if (name == "ndjson") return OutputFormat::NDJson;
+    if (name == "csv") return OutputFormat::Csv;
+    return std::nullopt;
+}
+
+// ============================================================================
+// RecordWriter implementation
+// ============================================================================
+
+RecordWriter::RecordWriter(std::ostream& out, OutputFormat format, size_t buffer_size)
+    : out_(out), format_(format), buffer_size_(buffer_size) {
+    // Room for one more record past the threshold without reallocating
+    buffer_.reserve(buffer_size_ + 1024);
+
+    if (format_ == OutputFormat::JsonArray) {
+        buffer_ += "[\n";
+    } else if (format_ == OutputFormat::Csv) {
+        buffer_ += "vehicle_id,timestamp,latitude,longitude,speed,heading,engine_rpm,"
+                   "fuel_level,odometer_km,engine_temp,battery_volt,diagnostic_code\n";
+    }
+}
+
+RecordWriter::~RecordWriter() {
+    try {
+        finish();
+    } catch (...) {
+        // Destructors must not throw; call finish() to observe failures
+    }
+}
+
+template <typename Row>
+void RecordWriter::write_row(const Row& row) {
+    switch (format_) {
+        case OutputFormat::JsonArray:
+            buffer_ += records_written_ == 0 ? "  " : ",\n  ";
+            append_json_row(buffer_, row);
+            break;
+        case OutputFormat::NDJson:
+            append_json_row(buffer_, row);
+            buffer_ += '\n';
+            break;
+        case OutputFormat::Csv:
+            append_csv_row(buffer_, row);
+            buffer_ += '\n';
+            break;
+    }
+    records_written_++;
+    drain(false);
+}
+
+void RecordWriter::write(const TelemetryData& data) {
+    write_row(row_ref(data));
+}
+
+void RecordWriter::write(const TelemetryBatch& batch) {
+    for (size_t i = 0; i < batch.size(); i++) {
+        write_row(row_ref(batch, i));
+    }
+}
+
+void RecordWriter::write(const TelemetryWindow& window) {
+    switch (format_) {
+        case OutputFormat::JsonArray:
+            buffer_ += records_written_ == 0 ? "  " : ",\n  ";
+            append_json(buffer_, window);
+            break;
+        case OutputFormat::NDJson:
+            append_json(buffer_, window);
+            buffer_ += '\n';
+            break;
+        case OutputFormat::Csv:
+            throw std::runtime_error("CSV output does not support windows");
+    }
+    records_written_++;
+    drain(false);
+}
+
+void RecordWriter::drain(bool force) {
+    if (buffer_.empty() || (!force && buffer_.size() < buffer_size_)) return;
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void RecordWriter::flush() {
+    drain(true);
+    out_.flush();
+    if (!out_) {
+        throw std::runtime_error("Failed to write output");
+    }
+}
+
+void RecordWriter::finish() {
+    if (finished_) return;
+    finished_ = true;
+
+    if (format_ == OutputFormat::JsonArray) {
+        buffer_ += records_written_ == 0 ? "]\n" : "\n]\n";
+    }
+    drain(true);
+    out_.flush();
+    if (!out_) {
+        throw std::runtime_error("Failed to write output");
+    }
+}
+
+}  // namespace fleet
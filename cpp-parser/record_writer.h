@@ -0,0 +1,76 @@
+#ifndef RECORD_WRITER_H
+#define RECORD_WRITER_H
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+struct TelemetryWindow;  // window_rollup.h
+
+enum class OutputFormat {
+    JsonArray,  // [\n  {...},\n  {...}\n]
+    NDJson,     // one object per line
+    Csv,        // header row, then one row per record
+};
+
+std::optional<OutputFormat> parse_output_format(std::string_view name);
+
+// Append one record in the to_json() / to_csv() layout: fixed 6 decimals
+// for coordinates, 2 for the other measurements. Strings are escaped
+// (JSON) or quoted when needed (CSV); non-finite numbers become null in JSON.
+void append_json(std::string& out, const TelemetryData& data);
+void append_csv(std::string& out, const TelemetryData& data);
+
+// Field helpers behind append_json(), for other JSON emitters
+void append_json_string(std::string& out, std::string_view str);
+void append_json_number(std::string& out, double value, int precision);
+
+// Streaming record serializer.
+//
+// Records are formatted with std::to_chars into a reusable buffer that is
+// handed to the stream whenever it passes buffer_size, so memory stays flat
+// however many records are written. finish() closes the JSON array and
+// flushes; the destructor calls it if needed.
+class RecordWriter {
+public:
+    RecordWriter(std::ostream& out, OutputFormat format, size_t buffer_size = 1024 * 1024);
+    ~RecordWriter();
+
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    void write(const TelemetryData& data);
+    void write(const TelemetryBatch& batch);
+    
+    // Downsampled windows, in the JSON formats only (throws for Csv)
+    void write(const TelemetryWindow& window);
+
+    // Hand everything buffered so far to the stream and flush it, without
+    // closing the output (for consumers reading a file that is still open)
+    void flush();
+    
+    void finish();
+
+    size_t records_written() const { return records_written_; }
+
+private:
+    template <typename Row>
+    void write_row(const Row& row);
+    void drain(bool force);
+
+    std::ostream& out_;
+    OutputFormat format_;
+    size_t buffer_size_;
+    std::string buffer_;
+    size_t records_written_ = 0;
+    bool finished_ = false;
+};
+
+}  // namespace fleet
+
+#endif  // RECORD_WRITER_H
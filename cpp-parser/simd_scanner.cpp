@@ -0,0 +1,212 @@
+#include "simd_scanner.h"
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FLEET_SCAN_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define FLEET_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace fleet {
+
+namespace {
+
+// Append base + index of every set bit in mask
+inline void emit_bits(uint64_t mask, uint32_t base, uint32_t*& out) {
+    while (mask) {
+        *out++ = base + static_cast<uint32_t>(__builtin_ctzll(mask));
+        mask &= mask - 1;
+    }
+}
+
+inline uint32_t* scan_tail(const char* data, size_t begin, size_t len, char delimiter, uint32_t* out) {
+    for (size_t i = begin; i < len; i++) {
+        if (data[i] == delimiter || data[i] == '\n') {
+            *out++ = static_cast<uint32_t>(i);
+        }
+    }
+    return out;
+}
+
+size_t scan_scalar(const char* data, size_t len, char delimiter, uint32_t* out) {
+    return scan_tail(data, 0, len, delimiter, out) - out;
+}
+
+#if FLEET_SCAN_X86
+
+// Lambdas don't inherit a function's target attribute, so the per-block
+// helpers are spelled out as separate target functions
+
+__attribute__((target("sse4.2")))
+inline uint64_t sse42_block_mask(const char* p, __m128i delim, __m128i newline) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, newline));
+    return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+}
+
+__attribute__((target("sse4.2")))
+size_t scan_sse42(const char* data, size_t len, char delimiter, uint32_t* out) {
+    uint32_t* const begin = out;
+    const __m128i delim = _mm_set1_epi8(delimiter);
+    const __m128i newline = _mm_set1_epi8('\n');
+    
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        uint64_t mask = sse42_block_mask(data + i, delim, newline) |
+                        (sse42_block_mask(data + i + 16, delim, newline) << 16) |
+                        (sse42_block_mask(data + i + 32, delim, newline) << 32) |
+                        (sse42_block_mask(data + i + 48, delim, newline) << 48);
+        emit_bits(mask, static_cast<uint32_t>(i), out);
+    }
+    for (; i + 16 <= len; i += 16) {
+        emit_bits(sse42_block_mask(data + i, delim, newline), static_cast<uint32_t>(i), out);
+    }
+    return scan_tail(data, i, len, delimiter, out) - begin;
+}
+
+__attribute__((target("avx2")))
+inline uint64_t avx2_block_mask(const char* p, __m256i delim, __m256i newline) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(v, delim), _mm256_cmpeq_epi8(v, newline));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+}
+
+__attribute__((target("avx2")))
+size_t scan_avx2(const char* data, size_t len, char delimiter, uint32_t* out) {
+    uint32_t* const begin = out;
+    const __m256i delim = _mm256_set1_epi8(delimiter);
+    const __m256i newline = _mm256_set1_epi8('\n');
+    
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        uint64_t mask = avx2_block_mask(data + i, delim, newline) |
+                        (avx2_block_mask(data + i + 32, delim, newline) << 32);
+        emit_bits(mask, static_cast<uint32_t>(i), out);
+    }
+    if (i + 32 <= len) {
+        emit_bits(avx2_block_mask(data + i, delim, newline), static_cast<uint32_t>(i), out);
+        i += 32;
+    }
+    return scan_tail(data, i, len, delimiter, out) - begin;
+}
+
+#endif  // FLEET_SCAN_X86
+
+#if FLEET_SCAN_NEON
+
+size_t scan_neon(const char* data, size_t len, char delimiter, uint32_t* out) {
+    uint32_t* const begin = out;
+    const uint8x16_t delim = vdupq_n_u8(static_cast<uint8_t>(delimiter));
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    
+    // NEON has no movemask; narrow each 0x00/0xFF lane to a nibble instead
+    // and keep one bit per byte (bit 4*j + 3 for byte j)
+    auto emit_block = [&](size_t offset) {
+        uint8x16_t v = vld1q_u8(bytes + offset);
+        uint8x16_t hits = vorrq_u8(vceqq_u8(v, delim), vceqq_u8(v, newline));
+        uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(hits), 4);
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ull;
+        while (mask) {
+            *out++ = static_cast<uint32_t>(offset + (__builtin_ctzll(mask) >> 2));
+            mask &= mask - 1;
+        }
+    };
+    
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        emit_block(i);
+        emit_block(i + 16);
+        emit_block(i + 32);
+        emit_block(i + 48);
+    }
+    for (; i + 16 <= len; i += 16) {
+        emit_block(i);
+    }
+    return scan_tail(data, i, len, delimiter, out) - begin;
+}
+
+#endif  // FLEET_SCAN_NEON
+
+}  // namespace
+
+const char* scan_kernel_name(ScanKernel kernel) {
+    switch (kernel) {
+        case ScanKernel::Scalar: return "scalar";
+        case ScanKernel::SSE42:  return "sse4.2";
+        case ScanKernel::AVX2:   return "avx2";
+        case ScanKernel::NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+bool StructuralScanner::kernel_supported(ScanKernel kernel) {
+    switch (kernel) {
+        case ScanKernel::Scalar:
+            return true;
+#if FLEET_SCAN_X86
+        case ScanKernel::SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case ScanKernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#if FLEET_SCAN_NEON
+        case ScanKernel::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+ScanKernel StructuralScanner::detect_kernel() {
+    static const ScanKernel detected = []() {
+        if (const char* forced = std::getenv("FLEET_SIMD")) {
+            for (ScanKernel k : {ScanKernel::Scalar, ScanKernel::SSE42, ScanKernel::AVX2, ScanKernel::NEON}) {
+                if (std::strcmp(forced, scan_kernel_name(k)) == 0 && kernel_supported(k)) {
+                    return k;
+                }
+            }
+        }
+        for (ScanKernel k : {ScanKernel::AVX2, ScanKernel::NEON, ScanKernel::SSE42}) {
+            if (kernel_supported(k)) return k;
+        }
+        return ScanKernel::Scalar;
+    }();
+    return detected;
+}
+
+StructuralScanner::StructuralScanner(char delimiter)
+    : StructuralScanner(delimiter, detect_kernel()) {}
+
+StructuralScanner::StructuralScanner(char delimiter, ScanKernel kernel)
+    : delimiter_(delimiter), kernel_(kernel), scan_fn_(scan_scalar) {
+    if (!kernel_supported(kernel)) {
+        throw std::runtime_error(std::string("Scan kernel not supported on this CPU: ") + scan_kernel_name(kernel));
+    }
+    switch (kernel_) {
+#if FLEET_SCAN_X86
+        case ScanKernel::SSE42: scan_fn_ = scan_sse42; break;
+        case ScanKernel::AVX2:  scan_fn_ = scan_avx2; break;
+#endif
+#if FLEET_SCAN_NEON
+        case ScanKernel::NEON:  scan_fn_ = scan_neon; break;
+#endif
+        default: break;
+    }
+}
+
+size_t StructuralScanner::scan(const char* data, size_t len, std::vector<uint32_t>& index) const {
+    // Worst case every byte is structural
+    if (index.size() < len) {
+        index.resize(len);
+    }
+    return scan_fn_(data, len, delimiter_, index.data());
+}
+
+}  // namespace fleet
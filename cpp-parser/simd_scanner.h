@@ -0,0 +1,57 @@
+#ifndef SIMD_SCANNER_H
+#define SIMD_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fleet {
+
+// Structural scanner kernels, best first within each architecture
+enum class ScanKernel {
+    Scalar,
+    SSE42,
+    AVX2,
+    NEON
+};
+
+const char* scan_kernel_name(ScanKernel kernel);
+
+// Vectorized delimiter/newline finder.
+//
+// Scans input in 64-byte blocks and records the offset of every field
+// delimiter and '\n' into a caller-owned index buffer. The kernel is chosen
+// once at runtime from the host CPU's capabilities, so a single portable
+// binary still gets AVX2/SSE4.2/NEON where available. Setting FLEET_SIMD to
+// scalar, sse4.2, avx2 or neon forces a (supported) kernel for testing.
+class StructuralScanner {
+public:
+    explicit StructuralScanner(char delimiter = ',');
+    
+    // Use a specific kernel; throws std::runtime_error if this CPU lacks it
+    StructuralScanner(char delimiter, ScanKernel kernel);
+    
+    // Write the offsets of all structural characters in [data, data + len)
+    // to the front of index and return how many were found. The index is
+    // grown as needed but never shrunk, so it can be reused across calls.
+    size_t scan(const char* data, size_t len, std::vector<uint32_t>& index) const;
+    
+    char delimiter() const { return delimiter_; }
+    ScanKernel kernel() const { return kernel_; }
+    
+    // Best kernel supported by this CPU (honours FLEET_SIMD)
+    static ScanKernel detect_kernel();
+    
+    static bool kernel_supported(ScanKernel kernel);
+
+private:
+    using ScanFn = size_t (*)(const char* data, size_t len, char delimiter, uint32_t* out);
+    
+    char delimiter_;
+    ScanKernel kernel_;
+    ScanFn scan_fn_;
+};
+
+}  // namespace fleet
+
+#endif  // SIMD_SCANNER_H
@@ -0,0 +1,413 @@
+#include "sqlite_loader.h"
+#include "timestamp.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#ifdef FLEET_HAVE_SQLITE
+#include <sqlite3.h>
+#endif
+
+namespace fleet {
+
+// ============================================================================
+// SqliteLoader implementation
+// ============================================================================
+
+bool SqliteLoader::available() {
+#ifdef FLEET_HAVE_SQLITE
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef FLEET_HAVE_SQLITE
+
+namespace {
+
+// As created by internal/db/database.go
+constexpr const char* kSchema = R"SQL(
+CREATE TABLE IF NOT EXISTS vehicles (
+    id TEXT PRIMARY KEY,
+    name TEXT NOT NULL,
+    license_plate TEXT UNIQUE NOT NULL,
+    vehicle_type TEXT NOT NULL,
+    created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+);
+
+CREATE TABLE IF NOT EXISTS telemetry (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    vehicle_id TEXT NOT NULL,
+    timestamp DATETIME NOT NULL,
+    latitude REAL NOT NULL,
+    longitude REAL NOT NULL,
+    speed REAL NOT NULL,
+    heading REAL NOT NULL,
+    engine_rpm INTEGER NOT NULL,
+    fuel_level REAL NOT NULL,
+    odometer_km REAL NOT NULL,
+    engine_temp REAL NOT NULL,
+    battery_volt REAL NOT NULL,
+    diagnostic_code TEXT,
+    FOREIGN KEY (vehicle_id) REFERENCES vehicles(id)
+);
+
+CREATE INDEX IF NOT EXISTS idx_telemetry_vehicle_id ON telemetry(vehicle_id);
+CREATE INDEX IF NOT EXISTS idx_telemetry_timestamp ON telemetry(timestamp);
+CREATE INDEX IF NOT EXISTS idx_telemetry_vehicle_timestamp ON telemetry(vehicle_id, timestamp);
+CREATE INDEX IF NOT EXISTS idx_telemetry_speed ON telemetry(speed);
+CREATE INDEX IF NOT EXISTS idx_telemetry_diagnostic ON telemetry(diagnostic_code) WHERE diagnostic_code IS NOT NULL;
+)SQL";
+
+constexpr size_t kColumns = 12;
+
+// Longest formatted timestamp, plus room for years past 9999
+constexpr size_t kTimestampSize = 40;
+
+inline void put_digits(char* p, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; i--) {
+        p[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+// Unix milliseconds the way go-sqlite3 binds a UTC time.Time
+// ("2006-01-02 15:04:05.999999999-07:00": fraction trimmed, dropped if zero)
+size_t format_timestamp(int64_t ms, char* out) {
+    int64_t days = ms / 86400000;
+    int64_t rem = ms % 86400000;
+    if (rem < 0) {
+        rem += 86400000;
+        days--;
+    }
+    int64_t year;
+    unsigned month, day;
+    detail::civil_from_days(days, year, month, day);
+    const unsigned secs = static_cast<unsigned>(rem / 1000);
+    unsigned millis = static_cast<unsigned>(rem % 1000);
+
+    if (year < 0 || year > 9999) {
+        int n = std::snprintf(out, kTimestampSize, "%04lld-%02u-%02u %02u:%02u:%02u.%03u+00:00",
+                              static_cast<long long>(year), month, day,
+                              secs / 3600, secs / 60 % 60, secs % 60, millis);
+        return static_cast<size_t>(std::max(n, 0));
+    }
+
+    char* p = out;
+    put_digits(p, static_cast<unsigned>(year), 4);
+    p[4] = '-';
+    put_digits(p + 5, month, 2);
+    p[7] = '-';
+    put_digits(p + 8, day, 2);
+    p[10] = ' ';
+    put_digits(p + 11, secs / 3600, 2);
+    p[13] = ':';
+    put_digits(p + 14, secs / 60 % 60, 2);
+    p[16] = ':';
+    put_digits(p + 17, secs % 60, 2);
+    p += 19;
+    if (millis != 0) {
+        int width = 3;
+        while (millis % 10 == 0) {
+            millis /= 10;
+            width--;
+        }
+        *p++ = '.';
+        put_digits(p, millis, width);
+        p += width;
+    }
+    std::memcpy(p, "+00:00", 6);
+    return static_cast<size_t>(p + 6 - out);
+}
+
+std::string quote_identifier(const std::string& name) {
+    std::string out = "\"";
+    for (char c : name) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+    return out;
+}
+
+struct StatementDeleter {
+    void operator()(sqlite3_stmt* stmt) const { sqlite3_finalize(stmt); }
+};
+using Statement = std::unique_ptr<sqlite3_stmt, StatementDeleter>;
+
+}  // namespace
+
+SqliteLoader::SqliteLoader(const std::string& path, const SqliteLoaderConfig& config)
+    : path_(path), config_(config) {
+    config_.batch_rows = std::max<size_t>(config_.batch_rows, 1);
+    config_.queue_depth = std::max<size_t>(config_.queue_depth, 1);
+    config_.rows_per_transaction = std::max<size_t>(config_.rows_per_transaction, 1);
+
+    if (sqlite3_open_v2(path.c_str(), &db_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        std::string message = db_ ? sqlite3_errmsg(db_) : "out of memory";
+        close();
+        throw std::runtime_error("Cannot open SQLite database " + path + ": " + message);
+    }
+
+    try {
+        // A statement may bind at most SQLITE_LIMIT_VARIABLE_NUMBER values
+        size_t max_rows = static_cast<size_t>(sqlite3_limit(db_, SQLITE_LIMIT_VARIABLE_NUMBER, -1)) / kColumns;
+        config_.rows_per_insert = std::clamp<size_t>(config_.rows_per_insert, 1, std::max<size_t>(max_rows, 1));
+
+        exec(kSchema);
+
+        journal_mode_ = pragma("journal_mode");
+        synchronous_ = pragma("synchronous");
+        exec("PRAGMA synchronous=OFF");
+        exec("PRAGMA journal_mode=MEMORY");
+        exec("PRAGMA temp_store=MEMORY");
+        exec(("PRAGMA cache_size=-" + std::to_string(config_.cache_mb * 1024)).c_str());
+
+        // Maintaining five indexes row by row costs more than building them once
+        if (config_.defer_indexes) {
+            sqlite3_stmt* raw = nullptr;
+            if (sqlite3_prepare_v2(db_, "SELECT name, sql FROM sqlite_master WHERE type = 'index' "
+                                        "AND tbl_name = 'telemetry' AND sql IS NOT NULL",
+                                   -1, &raw, nullptr) != SQLITE_OK) {
+                throw std::runtime_error(std::string("SQLite: ") + sqlite3_errmsg(db_));
+            }
+            Statement list(raw);
+            while (sqlite3_step(list.get()) == SQLITE_ROW) {
+                deferred_.push_back(Index{
+                    reinterpret_cast<const char*>(sqlite3_column_text(list.get(), 0)),
+                    reinterpret_cast<const char*>(sqlite3_column_text(list.get(), 1)),
+                });
+            }
+            list.reset();
+            for (const Index& index : deferred_) {
+                exec(("DROP INDEX IF EXISTS " + quote_identifier(index.name)).c_str());
+            }
+        }
+
+        insert_ = prepare_insert(config_.rows_per_insert);
+        exec("BEGIN");
+    } catch (...) {
+        close();
+        throw;
+    }
+
+    pending_.reserve(config_.batch_rows);
+    loader_ = std::thread([this]() { loader_loop(); });
+}
+
+SqliteLoader::~SqliteLoader() {
+    try {
+        finish();
+    } catch (const std::exception&) {
+        // Reported by an explicit finish(); a destructor cannot
+    }
+}
+
+void SqliteLoader::write(const TelemetryData& data) {
+    pending_.append(data);
+    if (pending_.size() >= config_.batch_rows) push_pending();
+}
+
+void SqliteLoader::write(const TelemetryBatch& batch) {
+    for (size_t begin = 0; begin < batch.size();) {
+        size_t take = std::min(batch.size() - begin, config_.batch_rows - pending_.size());
+        pending_.append(batch, begin, begin + take);
+        begin += take;
+        if (pending_.size() >= config_.batch_rows) push_pending();
+    }
+}
+
+void SqliteLoader::push_pending() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return queue_.size() < config_.queue_depth || finished_; });
+    if (finished_) {
+        throw std::runtime_error(error_.empty() ? "SQLite loader has stopped" : error_);
+    }
+    queue_.push_back(std::move(pending_));
+    pending_ = TelemetryBatch();
+    if (!spare_.empty()) {
+        pending_ = std::move(spare_.back());
+        spare_.pop_back();
+    } else {
+        pending_.reserve(config_.batch_rows);
+    }
+    cv_.notify_all();
+}
+
+void SqliteLoader::finish() {
+    if (!db_) return;
+
+    std::string error;
+    try {
+        if (!pending_.empty()) push_pending();
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+    }
+    cv_.notify_all();
+    if (loader_.joinable()) loader_.join();
+    if (error.empty()) error = error_;
+
+    // Indexes and settings come back even when the load failed
+    try {
+        exec(error.empty() ? "COMMIT" : "ROLLBACK");
+        for (const Index& index : deferred_) exec(index.sql.c_str());
+        exec(("PRAGMA journal_mode=" + journal_mode_).c_str());
+        exec(("PRAGMA synchronous=" + synchronous_).c_str());
+    } catch (const std::exception& e) {
+        if (error.empty()) error = e.what();
+    }
+    close();
+    if (!error.empty()) throw std::runtime_error(error);
+}
+
+void SqliteLoader::exec(const char* sql) {
+    char* message = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &message) != SQLITE_OK) {
+        std::string error = "SQLite error in " + path_ + ": " + (message ? message : sqlite3_errmsg(db_));
+        sqlite3_free(message);
+        throw std::runtime_error(error);
+    }
+}
+
+std::string SqliteLoader::pragma(const char* name) {
+    sqlite3_stmt* raw = nullptr;
+    std::string sql = std::string("PRAGMA ") + name;
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &raw, nullptr) != SQLITE_OK) {
+        throw std::runtime_error(std::string("SQLite: ") + sqlite3_errmsg(db_));
+    }
+    Statement stmt(raw);
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) return std::string();
+    const unsigned char* text = sqlite3_column_text(stmt.get(), 0);
+    return text ? reinterpret_cast<const char*>(text) : std::string();
+}
+
+sqlite3_stmt* SqliteLoader::prepare_insert(size_t rows) {
+    std::string sql =
+        "INSERT INTO telemetry (vehicle_id, timestamp, latitude, longitude, speed, heading, "
+        "engine_rpm, fuel_level, odometer_km, engine_temp, battery_volt, diagnostic_code) VALUES ";
+    sql.reserve(sql.size() + rows * 27);
+    for (size_t r = 0; r < rows; r++) {
+        sql += r == 0 ? "(?,?,?,?,?,?,?,?,?,?,?,?)" : ",(?,?,?,?,?,?,?,?,?,?,?,?)";
+    }
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error(std::string("SQLite: ") + sqlite3_errmsg(db_));
+    }
+    return stmt;
+}
+
+void SqliteLoader::insert(const TelemetryBatch& batch) {
+    // Bound as SQLITE_STATIC: each row's formatted timestamp lives here until
+    // the statement has run
+    std::vector<char> timestamps(config_.rows_per_insert * kTimestampSize);
+
+    for (size_t row = 0, n = batch.size(); row < n;) {
+        const size_t rows = std::min(config_.rows_per_insert, n - row);
+        Statement tail;
+        sqlite3_stmt* stmt = insert_;
+        if (rows < config_.rows_per_insert) {
+            tail.reset(prepare_insert(rows));
+            stmt = tail.get();
+        }
+
+        int p = 1;
+        for (size_t i = row; i < row + rows; i++) {
+            char* ts = &timestamps[(i - row) * kTimestampSize];
+            std::string_view vehicle = batch.vehicle(i);
+            std::string_view diagnostic = batch.diagnostic(i);
+            sqlite3_bind_text(stmt, p++, vehicle.data(), static_cast<int>(vehicle.size()), SQLITE_STATIC);
+            sqlite3_bind_text(stmt, p++, ts, static_cast<int>(format_timestamp(batch.timestamp[i], ts)),
+                              SQLITE_STATIC);
+            sqlite3_bind_double(stmt, p++, batch.latitude[i]);
+            sqlite3_bind_double(stmt, p++, batch.longitude[i]);
+            sqlite3_bind_double(stmt, p++, batch.speed[i]);
+            sqlite3_bind_double(stmt, p++, batch.heading[i]);
+            sqlite3_bind_int(stmt, p++, batch.engine_rpm[i]);
+            sqlite3_bind_double(stmt, p++, batch.fuel_level[i]);
+            sqlite3_bind_double(stmt, p++, batch.odometer_km[i]);
+            sqlite3_bind_double(stmt, p++, batch.engine_temp[i]);
+            sqlite3_bind_double(stmt, p++, batch.battery_volt[i]);
+            // Never NULL (as a null data pointer would bind): the Go reader
+            // scans this column into a string
+            sqlite3_bind_text(stmt, p++, diagnostic.empty() ? "" : diagnostic.data(),
+                              static_cast<int>(diagnostic.size()), SQLITE_STATIC);
+        }
+
+        int rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("SQLite insert into " + path_ + " failed: " + sqlite3_errmsg(db_));
+        }
+
+        row += rows;
+        rows_written_ += rows;
+        rows_in_transaction_ += rows;
+        if (rows_in_transaction_ >= config_.rows_per_transaction) {
+            exec("COMMIT");
+            exec("BEGIN");
+            rows_in_transaction_ = 0;
+        }
+    }
+}
+
+void SqliteLoader::loader_loop() {
+    std::string error;
+    try {
+        for (;;) {
+            TelemetryBatch batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return !queue_.empty() || closing_; });
+                if (queue_.empty()) break;
+                batch = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            cv_.notify_all();
+
+            insert(batch);
+
+            batch.clear();
+            std::lock_guard<std::mutex> lock(mutex_);
+            spare_.push_back(std::move(batch));
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    error_ = error;
+    queue_.clear();
+    cv_.notify_all();
+}
+
+void SqliteLoader::close() {
+    if (insert_) sqlite3_finalize(insert_);
+    insert_ = nullptr;
+    if (db_) sqlite3_close(db_);
+    db_ = nullptr;
+}
+
+#else  // !FLEET_HAVE_SQLITE
+
+SqliteLoader::SqliteLoader(const std::string& path, const SqliteLoaderConfig& config)
+    : path_(path), config_(config) {
+    throw std::runtime_error("SQLite output is not supported by this build: " + path);
+}
+
+SqliteLoader::~SqliteLoader() = default;
+
+void SqliteLoader::write(const TelemetryData&) {}
+void SqliteLoader::write(const TelemetryBatch&) {}
+void SqliteLoader::finish() {}
+
+#endif  // FLEET_HAVE_SQLITE
+
+}  // namespace fleet
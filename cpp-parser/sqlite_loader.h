@@ -0,0 +1,103 @@
+#ifndef SQLITE_LOADER_H
+#define SQLITE_LOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "telemetry_batch.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace fleet {
+
+struct SqliteLoaderConfig {
+    size_t batch_rows = 64 * 1024;           // rows per batch handed to the loader thread
+    size_t queue_depth = 4;                  // batches queued before write() blocks
+    size_t rows_per_insert = 64;             // VALUES tuples per INSERT (12 parameters each)
+    size_t rows_per_transaction = 1000000;   // COMMIT after this many rows
+    size_t cache_mb = 256;                   // page cache during the load
+    bool defer_indexes = true;               // drop telemetry indexes, rebuild them in finish()
+};
+
+// Bulk loader into the Go server's SQLite schema (internal/db/database.go).
+//
+// Records are gathered into TelemetryBatches and passed through a bounded
+// queue to a loader thread, which inserts them with a prepared multi-row
+// INSERT inside large transactions, so parsing and inserting overlap and a
+// slow disk pushes back on the parser instead of growing memory. The
+// tables are created if missing. During the load the database runs with
+// synchronous=OFF and an in-memory rollback journal, and the telemetry
+// indexes are dropped; finish() rebuilds them and restores the previous
+// journal and sync modes. A crash mid-load can therefore leave the
+// database corrupt: load into a file nothing else is using.
+//
+// Rows are stored the way InsertTelemetryBatch stores them: timestamps as
+// "YYYY-MM-DD HH:MM:SS[.fff]+00:00" text and an empty diagnostic code as
+// ''.
+class SqliteLoader {
+public:
+    explicit SqliteLoader(const std::string& path, const SqliteLoaderConfig& config = SqliteLoaderConfig());
+    ~SqliteLoader();
+
+    SqliteLoader(const SqliteLoader&) = delete;
+    SqliteLoader& operator=(const SqliteLoader&) = delete;
+
+    // Queue rows for insertion; blocks while the queue is full. Throws
+    // once the loader thread has failed.
+    void write(const TelemetryData& data);
+    void write(const TelemetryBatch& batch);
+
+    // Insert everything queued, commit, rebuild deferred indexes and
+    // restore the database settings. Throws what stopped the load.
+    void finish();
+
+    uint64_t rows_written() const { return rows_written_; }
+
+    // Whether this build links SQLite (FLEET_HAVE_SQLITE)
+    static bool available();
+
+private:
+    struct Index {
+        std::string name;
+        std::string sql;
+    };
+
+    void exec(const char* sql);
+    std::string pragma(const char* name);
+    sqlite3_stmt* prepare_insert(size_t rows);
+    void insert(const TelemetryBatch& batch);
+    void loader_loop();
+    void push_pending();   // hand pending_ to the loader thread
+    void close();
+
+    std::string path_;
+    SqliteLoaderConfig config_;
+    sqlite3* db_ = nullptr;
+    sqlite3_stmt* insert_ = nullptr;      // rows_per_insert tuples
+    std::vector<Index> deferred_;
+    std::string journal_mode_;            // restored by finish()
+    std::string synchronous_;
+    uint64_t rows_written_ = 0;
+    uint64_t rows_in_transaction_ = 0;
+
+    TelemetryBatch pending_;              // filled by write(), queued when full
+
+    std::thread loader_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<TelemetryBatch> queue_;
+    std::vector<TelemetryBatch> spare_;   // inserted batches, reused for their capacity
+    bool closing_ = false;
+    bool finished_ = false;
+    std::string error_;
+};
+
+}  // namespace fleet
+
+#endif  // SQLITE_LOADER_H
@@ -0,0 +1,86 @@
+#include "string_table.h"
+#include <algorithm>
+#include <cstring>
+
+namespace fleet {
+
+StringTable::StringTable() = default;
+
+StringTable::StringTable(const StringTable& other) : StringTable() {
+    *this = other;
+}
+
+StringTable& StringTable::operator=(const StringTable& other) {
+    if (this != &other) {
+        clear();
+        // Re-interning in order reproduces the same handles
+        for (std::string_view str : other.strings_) {
+            intern(str);
+        }
+    }
+    return *this;
+}
+
+StringTable::StringTable(StringTable&& other) noexcept
+    : blocks_(std::move(other.blocks_)),
+      block_used_(other.block_used_),
+      block_capacity_(other.block_capacity_),
+      strings_(std::move(other.strings_)),
+      index_(std::move(other.index_)) {
+    other.clear();
+}
+
+StringTable& StringTable::operator=(StringTable&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        block_used_ = other.block_used_;
+        block_capacity_ = other.block_capacity_;
+        strings_ = std::move(other.strings_);
+        index_ = std::move(other.index_);
+        other.clear();
+    }
+    return *this;
+}
+
+uint32_t StringTable::intern(std::string_view str) {
+    if (str.empty()) return kEmpty;
+    
+    auto it = index_.find(str);
+    if (it != index_.end()) return it->second;
+    
+    std::string_view stored = store(str);
+    strings_.push_back(stored);
+    uint32_t handle = static_cast<uint32_t>(strings_.size());
+    index_.emplace(stored, handle);
+    return handle;
+}
+
+std::optional<uint32_t> StringTable::find(std::string_view str) const {
+    if (str.empty()) return kEmpty;
+    auto it = index_.find(str);
+    if (it == index_.end()) return std::nullopt;
+    return it->second;
+}
+
+void StringTable::clear() noexcept {
+    blocks_.clear();
+    block_used_ = 0;
+    block_capacity_ = 0;
+    strings_.clear();
+    index_.clear();
+}
+
+std::string_view StringTable::store(std::string_view str) {
+    if (block_used_ + str.size() > block_capacity_) {
+        // Oversized strings get a block of their own
+        block_capacity_ = std::max(kBlockSize, str.size());
+        blocks_.emplace_back(new char[block_capacity_]);
+        block_used_ = 0;
+    }
+    char* dest = blocks_.back().get() + block_used_;
+    std::memcpy(dest, str.data(), str.size());
+    block_used_ += str.size();
+    return std::string_view(dest, str.size());
+}
+
+}  // namespace fleet
@@ -0,0 +1,58 @@
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fleet {
+
+// Append-only string interning table.
+//
+// Maps each distinct string to a dense uint32_t handle in first-seen order.
+// Handle 0 is always the empty string. Interned bytes live in stable
+// fixed-size blocks, so views returned by view() stay valid until clear().
+class StringTable {
+public:
+    static constexpr uint32_t kEmpty = 0;
+    
+    StringTable();
+    StringTable(const StringTable& other);
+    StringTable& operator=(const StringTable& other);
+    // The moved-from table is left empty but usable (handle 0 = "")
+    StringTable(StringTable&& other) noexcept;
+    StringTable& operator=(StringTable&& other) noexcept;
+    
+    // Return the handle for str, adding it on first sight
+    uint32_t intern(std::string_view str);
+    
+    // Look up without inserting
+    std::optional<uint32_t> find(std::string_view str) const;
+    
+    std::string_view view(uint32_t handle) const {
+        return handle == kEmpty ? std::string_view() : strings_[handle - 1];
+    }
+    size_t size() const { return strings_.size() + 1; }
+    
+    void clear() noexcept;
+
+private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+    
+    std::string_view store(std::string_view str);
+    
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_used_ = 0;
+    size_t block_capacity_ = 0;
+    // Handle h > 0 lives at strings_[h - 1]; the empty string is implicit so
+    // clearing (and so moving from) a table never allocates
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, uint32_t> index_;
+};
+
+}  // namespace fleet
+
+#endif  // STRING_TABLE_H
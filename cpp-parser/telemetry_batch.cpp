@@ -0,0 +1,128 @@
+#include "telemetry_batch.h"
+
+namespace fleet {
+
+void TelemetryBatch::reserve(size_t rows) {
+    timestamp.reserve(rows);
+    latitude.reserve(rows);
+    longitude.reserve(rows);
+    speed.reserve(rows);
+    heading.reserve(rows);
+    engine_rpm.reserve(rows);
+    fuel_level.reserve(rows);
+    odometer_km.reserve(rows);
+    engine_temp.reserve(rows);
+    battery_volt.reserve(rows);
+    vehicle_id.reserve(rows);
+    diagnostic_code.reserve(rows);
+}
+
+void TelemetryBatch::clear() {
+    timestamp.clear();
+    latitude.clear();
+    longitude.clear();
+    speed.clear();
+    heading.clear();
+    engine_rpm.clear();
+    fuel_level.clear();
+    odometer_km.clear();
+    engine_temp.clear();
+    battery_volt.clear();
+    vehicle_id.clear();
+    diagnostic_code.clear();
+}
+
+void TelemetryBatch::append(const TelemetryData& data) {
+    timestamp.push_back(data.timestamp);
+    latitude.push_back(data.latitude);
+    longitude.push_back(data.longitude);
+    speed.push_back(data.speed);
+    heading.push_back(data.heading);
+    engine_rpm.push_back(data.engine_rpm);
+    fuel_level.push_back(data.fuel_level);
+    odometer_km.push_back(data.odometer_km);
+    engine_temp.push_back(data.engine_temp);
+    battery_volt.push_back(data.battery_volt);
+    vehicle_id.push_back(vehicle_dict.intern(data.vehicle_id));
+    diagnostic_code.push_back(diagnostic_dict.intern(data.diagnostic_code));
+}
+
+void TelemetryBatch::append(const TelemetryBatch& other) {
+    append(other, 0, other.size());
+}
+
+void TelemetryBatch::append(const TelemetryBatch& other, size_t begin, size_t end) {
+    // Build code translations once per batch rather than per row
+    std::vector<uint32_t> vehicle_map(other.vehicle_dict.size());
+    for (uint32_t code = 0; code < vehicle_map.size(); code++) {
+        vehicle_map[code] = vehicle_dict.intern(other.vehicle_dict.view(code));
+    }
+    std::vector<uint32_t> diag_map(other.diagnostic_dict.size());
+    for (uint32_t code = 0; code < diag_map.size(); code++) {
+        diag_map[code] = diagnostic_dict.intern(other.diagnostic_dict.view(code));
+    }
+    
+    auto extend = [begin, end](auto& dst, const auto& src) {
+        dst.insert(dst.end(), src.begin() + begin, src.begin() + end);
+    };
+    extend(timestamp, other.timestamp);
+    extend(latitude, other.latitude);
+    extend(longitude, other.longitude);
+    extend(speed, other.speed);
+    extend(heading, other.heading);
+    extend(engine_rpm, other.engine_rpm);
+    extend(fuel_level, other.fuel_level);
+    extend(odometer_km, other.odometer_km);
+    extend(engine_temp, other.engine_temp);
+    extend(battery_volt, other.battery_volt);
+    
+    vehicle_id.reserve(vehicle_id.size() + (end - begin));
+    diagnostic_code.reserve(diagnostic_code.size() + (end - begin));
+    for (size_t i = begin; i < end; i++) {
+        vehicle_id.push_back(vehicle_map[other.vehicle_id[i]]);
+        diagnostic_code.push_back(diag_map[other.diagnostic_code[i]]);
+    }
+}
+
+void TelemetryBatch::retain(const std::vector<uint64_t>& keep) {
+    // Branch-free compaction: every row is copied, only kept rows advance
+    auto compact = [&keep](auto& column) {
+        size_t out = 0;
+        for (size_t i = 0; i < column.size(); i++) {
+            column[out] = column[i];
+            out += (keep[i >> 6] >> (i & 63)) & 1;
+        }
+        column.resize(out);
+    };
+    compact(timestamp);
+    compact(latitude);
+    compact(longitude);
+    compact(speed);
+    compact(heading);
+    compact(engine_rpm);
+    compact(fuel_level);
+    compact(odometer_km);
+    compact(engine_temp);
+    compact(battery_volt);
+    compact(vehicle_id);
+    compact(diagnostic_code);
+}
+
+TelemetryData TelemetryBatch::row(size_t i) const {
+    TelemetryData data;
+    data.vehicle_id = std::string(vehicle(i));
+    data.timestamp = timestamp[i];
+    data.latitude = latitude[i];
+    data.longitude = longitude[i];
+    data.speed = speed[i];
+    data.heading = heading[i];
+    data.engine_rpm = engine_rpm[i];
+    data.fuel_level = fuel_level[i];
+    data.odometer_km = odometer_km[i];
+    data.engine_temp = engine_temp[i];
+    data.battery_volt = battery_volt[i];
+    data.diagnostic_code = std::string(diagnostic(i));
+    return data;
+}
+
+}  // namespace fleet
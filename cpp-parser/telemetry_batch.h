@@ -0,0 +1,59 @@
+#ifndef TELEMETRY_BATCH_H
+#define TELEMETRY_BATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "string_table.h"
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+// Columnar (structure-of-arrays) telemetry container.
+//
+// Every column has size() entries; row i is the i-th element of each.
+// Measurements keep the parsed double, so batch validation and export see
+// the same values as the per-record path.
+// Vehicle IDs and diagnostic codes are dictionary-coded against the batch's
+// own tables (code 0 = empty). clear() drops rows but keeps the
+// dictionaries, so codes stay stable while a batch is reused for streaming.
+struct TelemetryBatch {
+    std::vector<int64_t> timestamp;         // Unix timestamp in milliseconds
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    std::vector<double> speed;              // km/h
+    std::vector<double> heading;            // degrees
+    std::vector<int32_t> engine_rpm;
+    std::vector<double> fuel_level;         // percentage
+    std::vector<double> odometer_km;
+    std::vector<double> engine_temp;        // Celsius
+    std::vector<double> battery_volt;
+    std::vector<uint32_t> vehicle_id;       // codes into vehicle_dict
+    std::vector<uint32_t> diagnostic_code;  // codes into diagnostic_dict
+    
+    StringTable vehicle_dict;
+    StringTable diagnostic_dict;
+    
+    size_t size() const { return timestamp.size(); }
+    bool empty() const { return timestamp.empty(); }
+    
+    void reserve(size_t rows);
+    void clear();
+    
+    // Append rows, re-coding strings into this batch's dictionaries
+    void append(const TelemetryData& data);
+    void append(const TelemetryBatch& other);
+    void append(const TelemetryBatch& other, size_t begin, size_t end);  // rows [begin, end)
+    
+    // Keep only the rows whose bit is set in keep (bit i of word i / 64,
+    // e.g. BatchValidation::valid), preserving their order
+    void retain(const std::vector<uint64_t>& keep);
+    
+    // Materialize a row
+    TelemetryData row(size_t i) const;
+    std::string_view vehicle(size_t i) const { return vehicle_dict.view(vehicle_id[i]); }
+    std::string_view diagnostic(size_t i) const { return diagnostic_dict.view(diagnostic_code[i]); }
+};
+
+}  // namespace fleet
+
+#endif  // TELEMETRY_BATCH_H
@@ -1,10 +1,26 @@
 #include "telemetry_parser.h"
+#include "batch_ring.h"
+#include "batch_validator.h"
+#include "binary_format.h"
+#include "compressed_input.h"
+#include "fast_decode.h"
+#include "file_follower.h"
+#include "fixed_schema.h"
+#include "mapped_file.h"
+#include "read_ahead.h"
+#include "record_writer.h"
+#include "telemetry_batch.h"
+#include "thread_pool.h"
 #include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <mutex>
 #include <stdexcept>
+#include <sys/stat.h>
 
 namespace fleet {
 
@@ -12,58 +28,128 @@ namespace fleet {
 // TelemetryData implementation
 // ============================================================================
 
+// Range rules shared by every record representation; returns the first
+// one the values break
+static RejectReason check_ranges(double latitude, double longitude, double speed,
+                                 double fuel_level, int engine_rpm) {
+    if (latitude < -90.0 || latitude > 90.0) return RejectReason::Latitude;
+    if (longitude < -180.0 || longitude > 180.0) return RejectReason::Longitude;
+    if (speed < 0) return RejectReason::Speed;
+    if (fuel_level < 0 || fuel_level > 100) return RejectReason::FuelLevel;
+    if (engine_rpm < 0) return RejectReason::EngineRpm;
+    return RejectReason::None;
+}
+
+static RejectReason check_record(const TelemetryData& r) {
+    if (r.vehicle_id.empty()) return RejectReason::MissingVehicleId;
+    return check_ranges(r.latitude, r.longitude, r.speed, r.fuel_level, r.engine_rpm);
+}
+
+static RejectReason check_record(const TelemetryRecord& r) {
+    if (r.vehicle_id == StringTable::kEmpty) return RejectReason::MissingVehicleId;
+    return check_ranges(r.latitude, r.longitude, r.speed, r.fuel_level, r.engine_rpm);
+}
+
 bool TelemetryData::is_valid() const {
+    return check_record(*this) == RejectReason::None;
+}
+
+bool TelemetryRecord::is_valid() const {
+    return check_record(*this) == RejectReason::None;
+}
+
+// Copies the fields of one string-owning record into another
+template <typename To, typename From>
+static void copy_record(To& out, const From& r) {
+    out.vehicle_id.assign(r.vehicle_id.data(), r.vehicle_id.size());
+    out.timestamp = r.timestamp;
+    out.latitude = r.latitude;
+    out.longitude = r.longitude;
+    out.speed = r.speed;
+    out.heading = r.heading;
+    out.engine_rpm = r.engine_rpm;
+    out.fuel_level = r.fuel_level;
+    out.odometer_km = r.odometer_km;
+    out.engine_temp = r.engine_temp;
+    out.battery_volt = r.battery_volt;
+    out.diagnostic_code.assign(r.diagnostic_code.data(), r.diagnostic_code.size());
+}
+
+ArenaTelemetryData::ArenaTelemetryData(const ArenaTelemetryData& other, const allocator_type& alloc)
+    : ArenaTelemetryData(alloc) {
+    copy_record(*this, other);
+}
+
+// Strings are stolen only when both sides share a resource
+ArenaTelemetryData::ArenaTelemetryData(ArenaTelemetryData&& other, const allocator_type& alloc)
+    : vehicle_id(std::move(other.vehicle_id), alloc),
+      timestamp(other.timestamp),
+      latitude(other.latitude),
+      longitude(other.longitude),
+      speed(other.speed),
+      heading(other.heading),
+      engine_rpm(other.engine_rpm),
+      fuel_level(other.fuel_level),
+      odometer_km(other.odometer_km),
+      engine_temp(other.engine_temp),
+      battery_volt(other.battery_volt),
+      diagnostic_code(std::move(other.diagnostic_code), alloc) {}
+
+ArenaTelemetryData::ArenaTelemetryData(const TelemetryData& other, const allocator_type& alloc)
+    : ArenaTelemetryData(alloc) {
+    copy_record(*this, other);
+}
+
+TelemetryData ArenaTelemetryData::to_data() const {
+    TelemetryData out;
+    copy_record(out, *this);
+    return out;
+}
+
+bool ArenaTelemetryData::is_valid() const {
     if (vehicle_id.empty()) return false;
-    if (latitude < -90.0 || latitude > 90.0) return false;
-    if (longitude < -180.0 || longitude > 180.0) return false;
-    if (speed < 0) return false;
-    if (fuel_level < 0 || fuel_level > 100) return false;
-    if (engine_rpm < 0) return false;
-    return true;
+    return check_ranges(latitude, longitude, speed, fuel_level, engine_rpm) == RejectReason::None;
 }
 
 std::string TelemetryData::to_csv() const {
-    std::ostringstream oss;
-    oss << vehicle_id << ","
-        << timestamp << ","
-        << std::fixed << std::setprecision(6) << latitude << ","
-        << longitude << ","
-        << std::setprecision(2) << speed << ","
-        << heading << ","
-        << engine_rpm << ","
-        << fuel_level << ","
-        << odometer_km << ","
-        << engine_temp << ","
-        << battery_volt << ","
-        << diagnostic_code;
-    return oss.str();
+    std::string out;
+    append_csv(out, *this);
+    return out;
 }
 
 std::string TelemetryData::to_json() const {
-    std::ostringstream oss;
-    oss << "{\"vehicle_id\":\"" << vehicle_id << "\","
-        << "\"timestamp\":" << timestamp << ","
-        << "\"latitude\":" << std::fixed << std::setprecision(6) << latitude << ","
-        << "\"longitude\":" << longitude << ","
-        << "\"speed\":" << std::setprecision(2) << speed << ","
-        << "\"heading\":" << heading << ","
-        << "\"engine_rpm\":" << engine_rpm << ","
-        << "\"fuel_level\":" << fuel_level << ","
-        << "\"odometer_km\":" << odometer_km << ","
-        << "\"engine_temp\":" << engine_temp << ","
-        << "\"battery_volt\":" << battery_volt;
-    if (!diagnostic_code.empty()) {
-        oss << ",\"diagnostic_code\":\"" << diagnostic_code << "\"";
-    }
-    oss << "}";
-    return oss.str();
+    std::string out;
+    append_json(out, *this);
+    return out;
+}
+
+// ============================================================================
+// ParseStats implementation
+// ============================================================================
+
+void ParseStats::merge(const ParseStats& other) {
+    total_lines += other.total_lines;
+    valid_records += other.valid_records;
+    invalid_records += other.invalid_records;
+    malformed_records += other.malformed_records;
+    filtered_records += other.filtered_records;
+    skipped_blocks += other.skipped_blocks;
+    bytes_processed += other.bytes_processed;
+    for (size_t i = 0; i < kRejectReasonCount; i++) rejected[i] += other.rejected[i];
+    if (*input == '\0') input = other.input;
+    profile.merge(other.profile);
 }
 
 // ============================================================================
 // TelemetryParser implementation
 // ============================================================================
 
-TelemetryParser::TelemetryParser(const ParserConfig& config) : config_(config) {
+TelemetryParser::TelemetryParser(const ParserConfig& config)
+    : config_(config), scanner_(config.delimiter) {
+    std::vector<std::string>& vehicles = config_.filter.vehicle_ids;
+    std::sort(vehicles.begin(), vehicles.end());
+    vehicles.erase(std::unique(vehicles.begin(), vehicles.end()), vehicles.end());
+    filter_active_ = config_.filter.active();
     reset_stats();
 }
 
@@ -71,118 +157,61 @@ void TelemetryParser::reset_stats() {
     stats_ = ParseStats();
 }
 
-// Optimized string to double conversion
-double TelemetryParser::fast_stod(const char* str, size_t len) {
-    if (len == 0) return 0.0;
-    
-    double result = 0.0;
-    double sign = 1.0;
-    size_t i = 0;
-    
-    // Handle sign
-    if (str[0] == '-') {
-        sign = -1.0;
-        i = 1;
-    } else if (str[0] == '+') {
-        i = 1;
-    }
-    
-    // Integer part
-    while (i < len && str[i] >= '0' && str[i] <= '9') {
-        result = result * 10.0 + (str[i] - '0');
-        i++;
-    }
-    
-    // Decimal part
-    if (i < len && str[i] == '.') {
-        i++;
-        double factor = 0.1;
-        while (i < len && str[i] >= '0' && str[i] <= '9') {
-            result += (str[i] - '0') * factor;
-            factor *= 0.1;
-            i++;
-        }
-    }
-    
-    return result * sign;
+std::optional<MappedFile> TelemetryParser::map_input(const std::string& filename) {
+    // Only stat() a pipe: opening and sniffing it would eat the rows
+    struct stat st;
+    if (::stat(filename.c_str(), &st) == 0 && !S_ISREG(st.st_mode)) return std::nullopt;
+    clock_.start();
+    MappedFile mapped(filename);
+    if (detect_compression(mapped.view().substr(0, 4)) != Compression::None) return std::nullopt;
+    clock_.lap(stats_.profile, ParseStage::Read, mapped.size());
+    stats_.input = "mmap";
+    return mapped;
 }
 
-// Optimized string to int conversion
-int TelemetryParser::fast_stoi(const char* str, size_t len) {
-    if (len == 0) return 0;
-    
-    int result = 0;
-    int sign = 1;
-    size_t i = 0;
-    
-    if (str[0] == '-') {
-        sign = -1;
-        i = 1;
-    } else if (str[0] == '+') {
-        i = 1;
-    }
-    
-    while (i < len && str[i] >= '0' && str[i] <= '9') {
-        result = result * 10 + (str[i] - '0');
-        i++;
-    }
-    
-    return result * sign;
+// Bytes in a file, for sizing result containers; 0 if it cannot be stat()ed
+static size_t file_size_hint(const std::string& filename) {
+    struct stat st;
+    return ::stat(filename.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
 }
 
-int64_t TelemetryParser::parse_timestamp(const std::string& str) {
-    if (str.empty()) return 0;
-    
-    // Fast path: Unix timestamp (all digits)
-    bool all_digits = true;
-    for (char c : str) {
-        if (c < '0' || c > '9') { all_digits = false; break; }
-    }
-    if (all_digits && str.length() <= 13) {
-        int64_t result = 0;
-        for (char c : str) result = result * 10 + (c - '0');
-        return result;
-    }
-    
-    // Fast ISO 8601 parser: 2024-01-15T10:30:00
-    // Format: YYYY-MM-DDTHH:MM:SS (length 19)
-    if (str.length() >= 19 && (str[10] == 'T' || str[10] == ' ')) {
-        int year = (str[0]-'0')*1000 + (str[1]-'0')*100 + (str[2]-'0')*10 + (str[3]-'0');
-        int month = (str[5]-'0')*10 + (str[6]-'0');
-        int day = (str[8]-'0')*10 + (str[9]-'0');
-        int hour = (str[11]-'0')*10 + (str[12]-'0');
-        int min = (str[14]-'0')*10 + (str[15]-'0');
-        int sec = (str[17]-'0')*10 + (str[18]-'0');
-        
-        // Simplified days calculation (approximate, good enough for telemetry)
-        int64_t days = (year - 1970) * 365 + (year - 1969) / 4;
-        static const int month_days[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
-        days += month_days[month - 1] + day - 1;
-        if (month > 2 && (year % 4 == 0)) days++;
-        
-        return (days * 86400 + hour * 3600 + min * 60 + sec) * 1000;
-    }
+void TelemetryParser::set_layout(RowLayout layout) {
+    layout_ = layout;
+    scanner_ = StructuralScanner(layout == RowLayout::Log ? '|' : config_.delimiter);
+}
+
+int64_t TelemetryParser::parse_timestamp(std::string_view str) {
+    return fleet::parse_timestamp(str);
+}
+
+int64_t TelemetryParser::decode_timestamp(std::string_view str) {
+    int64_t ms = 0;
+    if (parse_timestamp_as(str, timestamp_format_, ms)) return ms;
     
-    return 0;
+    // First row, or the input changed format: classify again
+    TimestampFormat format = sniff_timestamp(str);
+    if (format == TimestampFormat::Unknown) return 0;
+    timestamp_format_ = format;
+    return parse_timestamp_as(str, format, ms) ? ms : 0;
 }
 
-void TelemetryParser::split_line(const std::string& line, std::vector<std::string_view>& fields) {
+void TelemetryParser::split_line(std::string_view line, std::vector<std::string_view>& fields) {
     fields.clear();
-    size_t start = 0;
-    size_t pos = 0;
+    size_t count = scanner_.scan(line.data(), line.size(), scan_index_);
     
-    while (pos <= line.size()) {
-        if (pos == line.size() || line[pos] == config_.delimiter) {
-            fields.emplace_back(line.data() + start, pos - start);
-            start = pos + 1;
-        }
-        pos++;
+    size_t start = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t pos = scan_index_[i];
+        fields.emplace_back(line.data() + start, pos - start);
+        start = pos + 1;
     }
+    fields.emplace_back(line.data() + start, line.size() - start);
 }
 
-void TelemetryParser::parse_header(const std::string& header) {
+void TelemetryParser::parse_header(std::string_view header) {
     std::vector<std::string_view> fields;
     split_line(header, fields);
+    standard_schema_ = StandardSchema::matches(fields);
     
     for (size_t i = 0; i < fields.size(); i++) {
         std::string field(fields[i]);
@@ -204,220 +233,678 @@ void TelemetryParser::parse_header(const std::string& header) {
     }
 }
 
-std::optional<TelemetryData> TelemetryParser::parse_line(const std::string& line) {
+std::optional<TelemetryData> TelemetryParser::parse_line(std::string_view line) {
     if (line.empty()) return std::nullopt;
     
-    std::vector<std::string_view> fields;
-    split_line(line, fields);
-    
-    if (fields.size() < 11) return std::nullopt;
+    clock_.start();
+    split_line(line, fields_);
+    clock_.lap(stats_.profile, ParseStage::Split, line.size());
     
     TelemetryData data;
+    if (!decode_row(fields_, data)) return std::nullopt;
+    return data;
+}
+
+bool TelemetryParser::parse_line_compact(std::string_view line, TelemetryRecord& out) {
+    if (line.empty()) return false;
     
-    auto get_field = [&](int idx) -> std::string_view {
-        if (idx >= 0 && idx < static_cast<int>(fields.size())) {
-            return fields[idx];
-        }
-        return std::string_view();
-    };
+    clock_.start();
+    split_line(line, fields_);
+    clock_.lap(stats_.profile, ParseStage::Split, line.size());
+    return decode_row(fields_, out);
+}
+
+bool TelemetryParser::parse_line_into(std::string_view line, TelemetryBatch& batch) {
+    if (line.empty()) return false;
     
-    data.vehicle_id = std::string(get_field(col_vehicle_id_));
-    data.timestamp = parse_timestamp(std::string(get_field(col_timestamp_)));
+    clock_.start();
+    split_line(line, fields_);
+    clock_.lap(stats_.profile, ParseStage::Split, line.size());
+    return append_row(fields_, batch);
+}
+
+// Bytes spanned by a split row
+static size_t row_bytes(const std::vector<std::string_view>& fields) {
+    return fields.back().data() + fields.back().size() - fields.front().data();
+}
+
+// Field at a mapped column index; empty if the row is too short
+static std::string_view field_at(const std::vector<std::string_view>& fields, int idx) {
+    if (idx >= 0 && idx < static_cast<int>(fields.size())) return fields[idx];
+    return std::string_view();
+}
+
+// Vehicle set lookup; the parser keeps filter.vehicle_ids sorted
+static bool keeps_vehicle(const RecordFilter& filter, std::string_view vehicle_id) {
+    return filter.vehicle_ids.empty() ||
+           std::binary_search(filter.vehicle_ids.begin(), filter.vehicle_ids.end(), vehicle_id,
+                              std::less<>());
+}
+
+static bool keeps_time(const RecordFilter& filter, int64_t timestamp) {
+    return timestamp >= filter.min_timestamp && timestamp <= filter.max_timestamp;
+}
+
+// The remaining conditions, for rows decoded in full (binary input)
+static bool keeps_row(const RecordFilter& filter, int64_t timestamp, bool has_diagnostic,
+                      double latitude, double longitude) {
+    return keeps_time(filter, timestamp) && (has_diagnostic || !filter.diagnostics_only) &&
+           (!filter.bbox || filter.bbox->contains(latitude, longitude));
+}
+
+// Cheapest test first: string compares, then the timestamp, then the
+// position. Rows too short to hold the keys (or with an undecodable
+// position) are let through for decode_row() to report as malformed.
+bool TelemetryParser::passes_filter(const std::vector<std::string_view>& fields) {
+    const RecordFilter& filter = config_.filter;
+    std::string_view vehicle_id, timestamp, latitude, longitude, diagnostic_code;
+    if (layout_ == RowLayout::Log) {
+        if (fields.size() < 9) return true;
+        size_t comma = fields[2].find(',');
+        if (comma == std::string_view::npos) return true;
+        timestamp = fields[0];
+        vehicle_id = fields[1];
+        latitude = fields[2].substr(0, comma);
+        longitude = fields[2].substr(comma + 1);
+        diagnostic_code = fields.size() > 9 ? fields[9] : std::string_view();
+    } else {
+        if (fields.size() < 11) return true;
+        vehicle_id = field_at(fields, col_vehicle_id_);
+        timestamp = field_at(fields, col_timestamp_);
+        latitude = field_at(fields, col_latitude_);
+        longitude = field_at(fields, col_longitude_);
+        diagnostic_code = field_at(fields, col_diagnostic_code_);
+    }
     
-    auto lat = get_field(col_latitude_);
-    auto lon = get_field(col_longitude_);
-    data.latitude = fast_stod(lat.data(), lat.size());
-    data.longitude = fast_stod(lon.data(), lon.size());
+    if (!keeps_vehicle(filter, vehicle_id)) return false;
+    if (filter.diagnostics_only && diagnostic_code.empty()) return false;
+    if (filter.has_time_range() && !keeps_time(filter, decode_timestamp(timestamp))) return false;
+    if (filter.bbox) {
+        double lat, lon;
+        if (!fast_stod(latitude, lat) || !fast_stod(longitude, lon)) return true;
+        if (!filter.bbox->contains(lat, lon)) return false;
+    }
+    return true;
+}
+
+bool TelemetryParser::decode_row(const std::vector<std::string_view>& fields, DecodedRow& row) {
+    filtered_ = filter_active_ && !passes_filter(fields);
+    if (filtered_) {
+        clock_.lap(stats_.profile, ParseStage::Decode, row_bytes(fields));
+        stats_.filtered_records++;
+        return false;
+    }
     
-    auto spd = get_field(col_speed_);
-    data.speed = fast_stod(spd.data(), spd.size());
+    bool decoded = layout_ == RowLayout::Log ? decode_log_fields(fields, row)
+                                             : decode_csv_fields(fields, row);
+    clock_.lap(stats_.profile, ParseStage::Decode, row_bytes(fields));
+    if (!decoded) {
+        stats_.malformed_records++;
+        reject(RejectReason::Malformed);
+        return false;
+    }
     
-    auto hdg = get_field(col_heading_);
-    data.heading = fast_stod(hdg.data(), hdg.size());
+    if (config_.validate) {
+        RejectReason reason = row.vehicle_id.empty()
+            ? RejectReason::MissingVehicleId
+            : check_ranges(row.latitude, row.longitude, row.speed, row.fuel_level, row.engine_rpm);
+        clock_.lap(stats_.profile, ParseStage::Validate, row_bytes(fields));
+        if (reason != RejectReason::None) {
+            reject(reason);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TelemetryParser::decode_csv_fields(const std::vector<std::string_view>& fields, DecodedRow& row) {
+    if (standard_schema_ && fields.size() == StandardSchema::kColumns) {
+        return StandardSchema::decode(fields.data(), row,
+                                      [this](std::string_view str) { return decode_timestamp(str); });
+    }
+    if (fields.size() < 11) return false;
+    auto get_field = [&fields](int idx) { return field_at(fields, idx); };
     
-    auto rpm = get_field(col_engine_rpm_);
-    data.engine_rpm = fast_stoi(rpm.data(), rpm.size());
+    row.vehicle_id = get_field(col_vehicle_id_);
+    row.timestamp = decode_timestamp(get_field(col_timestamp_));
     
-    auto fuel = get_field(col_fuel_level_);
-    data.fuel_level = fast_stod(fuel.data(), fuel.size());
+    // Decode every column, then reject the row once if any was malformed
+    bool ok = fast_stod(get_field(col_latitude_), row.latitude);
+    ok &= fast_stod(get_field(col_longitude_), row.longitude);
+    ok &= fast_stod(get_field(col_speed_), row.speed);
+    ok &= fast_stod(get_field(col_heading_), row.heading);
+    ok &= fast_stoi(get_field(col_engine_rpm_), row.engine_rpm);
+    ok &= fast_stod(get_field(col_fuel_level_), row.fuel_level);
+    ok &= fast_stod(get_field(col_odometer_km_), row.odometer_km);
+    ok &= fast_stod(get_field(col_engine_temp_), row.engine_temp);
+    ok &= fast_stod(get_field(col_battery_volt_), row.battery_volt);
     
-    auto odo = get_field(col_odometer_km_);
-    data.odometer_km = fast_stod(odo.data(), odo.size());
+    row.diagnostic_code = get_field(col_diagnostic_code_);
+    return ok;
+}
+
+// timestamp|vehicle_id|lat,lon|speed|rpm|fuel|odo|temp|batt|diag
+// The diagnostic field (and its separator) may be missing.
+bool TelemetryParser::decode_log_fields(const std::vector<std::string_view>& fields, DecodedRow& row) {
+    if (fields.size() < 9) return false;
     
-    auto temp = get_field(col_engine_temp_);
-    data.engine_temp = fast_stod(temp.data(), temp.size());
+    std::string_view position = fields[2];
+    size_t comma = position.find(',');
+    if (comma == std::string_view::npos) return false;
     
-    auto batt = get_field(col_battery_volt_);
-    data.battery_volt = fast_stod(batt.data(), batt.size());
+    row.timestamp = decode_timestamp(fields[0]);
+    row.vehicle_id = fields[1];
     
-    if (col_diagnostic_code_ < static_cast<int>(fields.size())) {
-        data.diagnostic_code = std::string(get_field(col_diagnostic_code_));
-    }
+    bool ok = fast_stod(position.substr(0, comma), row.latitude);
+    ok &= fast_stod(position.substr(comma + 1), row.longitude);
+    ok &= fast_stod(fields[3], row.speed);
+    ok &= fast_stoi(fields[4], row.engine_rpm);
+    ok &= fast_stod(fields[5], row.fuel_level);
+    ok &= fast_stod(fields[6], row.odometer_km);
+    ok &= fast_stod(fields[7], row.engine_temp);
+    ok &= fast_stod(fields[8], row.battery_volt);
+    row.heading = 0.0;  // Not carried by the log format
     
-    if (config_.validate && !data.is_valid()) {
-        return std::nullopt;
-    }
+    row.diagnostic_code = fields.size() > 9 ? fields[9] : std::string_view();
+    return ok;
+}
+
+bool TelemetryParser::decode_row(const std::vector<std::string_view>& fields, TelemetryData& out) {
+    DecodedRow row;
+    if (!decode_row(fields, row)) return false;
+    copy_record(out, row);
+    return true;
+}
+
+bool TelemetryParser::decode_row(const std::vector<std::string_view>& fields, ArenaTelemetryData& out) {
+    DecodedRow row;
+    if (!decode_row(fields, row)) return false;
+    copy_record(out, row);
+    return true;
+}
+
+bool TelemetryParser::decode_row(const std::vector<std::string_view>& fields, TelemetryRecord& out) {
+    DecodedRow row;
+    if (!decode_row(fields, row)) return false;
     
-    return data;
+    out.timestamp = row.timestamp;
+    out.latitude = row.latitude;
+    out.longitude = row.longitude;
+    out.speed = row.speed;
+    out.heading = row.heading;
+    out.fuel_level = row.fuel_level;
+    out.odometer_km = row.odometer_km;
+    out.engine_temp = row.engine_temp;
+    out.battery_volt = row.battery_volt;
+    out.engine_rpm = row.engine_rpm;
+    out.vehicle_id = vehicle_ids_.intern(row.vehicle_id);
+    out.diagnostic_code = diagnostic_codes_.intern(row.diagnostic_code);
+    return true;
 }
 
-std::vector<TelemetryData> TelemetryParser::parse_file(const std::string& filename) {
-    auto start_time = std::chrono::high_resolution_clock::now();
+template <typename Records>
+bool TelemetryParser::append_row(const std::vector<std::string_view>& fields, Records& out) {
+    if (decode_row(fields, out.emplace_back())) return true;
+    out.pop_back();
+    return false;
+}
+
+bool TelemetryParser::append_row(const std::vector<std::string_view>& fields, TelemetryBatch& out) {
+    DecodedRow row;
+    if (!decode_row(fields, row)) return false;
     
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
+    out.timestamp.push_back(row.timestamp);
+    out.latitude.push_back(row.latitude);
+    out.longitude.push_back(row.longitude);
+    out.speed.push_back(row.speed);
+    out.heading.push_back(row.heading);
+    out.engine_rpm.push_back(row.engine_rpm);
+    out.fuel_level.push_back(row.fuel_level);
+    out.odometer_km.push_back(row.odometer_km);
+    out.engine_temp.push_back(row.engine_temp);
+    out.battery_volt.push_back(row.battery_volt);
+    out.vehicle_id.push_back(out.vehicle_dict.intern(row.vehicle_id));
+    out.diagnostic_code.push_back(out.diagnostic_dict.intern(row.diagnostic_code));
+    return true;
+}
+
+// Strip trailing CR/LF/space from a row
+static std::string_view trim_line_end(std::string_view line) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' ')) {
+        line.remove_suffix(1);
     }
-    
-    // Get file size
-    file.seekg(0, std::ios::end);
-    size_t file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    std::vector<TelemetryData> results;
-    results.reserve(file_size / 100);  // Estimate: ~100 bytes per record
-    
-    std::string line;
-    line.reserve(512);
-    
-    // Read and parse header
-    if (config_.has_header && std::getline(file, line)) {
-        parse_header(line);
+    return line;
+}
+
+size_t TelemetryParser::consume_preamble(std::string_view buffer) {
+    size_t pos = 0;
+    while (pos < buffer.size()) {
+        const char* nl = static_cast<const char*>(
+            std::memchr(buffer.data() + pos, '\n', buffer.size() - pos));
+        size_t line_end = nl ? static_cast<size_t>(nl - buffer.data()) : buffer.size();
+        size_t next = nl ? line_end + 1 : line_end;
+        std::string_view line = trim_line_end(buffer.substr(pos, line_end - pos));
+        
+        if (layout_ == RowLayout::Csv) {
+            if (!config_.has_header) break;
+            parse_header(line);
+            stats_.total_lines++;
+            return next;
+        }
+        
+        // Logs: skip leading comments, then at most one header row
+        bool comment = line.empty() || line[0] == '#';
+        bool header = !comment && config_.has_header && !(line[0] >= '0' && line[0] <= '9');
+        if (!comment && !header) break;
         stats_.total_lines++;
+        pos = next;
+        if (header) break;
     }
+    return pos;
+}
+
+// Puts config.has_header back when a pass that overrides it ends
+struct HeaderRestore {
+    ParserConfig& config;
+    bool has_header;
+    ~HeaderRestore() { config.has_header = has_header; }
+};
+
+template <typename RowFn>
+void TelemetryParser::parse_buffer(std::string_view buffer, RowFn&& on_row) {
+    clock_.start();
+    const char* pos = buffer.data() + consume_preamble(buffer);
+    const char* const end = buffer.data() + buffer.size();
+    const bool skip_comments = layout_ == RowLayout::Log;
+    
+    std::vector<std::string_view>& fields = fields_;
     
-    // Parse data lines
-    while (std::getline(file, line)) {
+    auto finish_line = [&](const char* line_start, const char* line_end, bool has_newline) {
         stats_.total_lines++;
-        stats_.bytes_processed += line.size() + 1;
+        // Count the terminator only when it is actually present
+        stats_.bytes_processed += (line_end - line_start) + (has_newline ? 1 : 0);
         
-        // Remove trailing whitespace
-        while (!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' ')) {
-            line.pop_back();
-        }
+        std::string_view line = trim_line_end(std::string_view(line_start, line_end - line_start));
+        if (line.empty()) return;
+        if (skip_comments && line[0] == '#') return;
         
-        if (line.empty()) continue;
+        // Trimming only ever shortens the tail of the row
+        const char* trimmed_end = line.data() + line.size();
+        while (fields.back().data() > trimmed_end) fields.pop_back();
+        fields.back() = std::string_view(fields.back().data(), trimmed_end - fields.back().data());
         
-        auto data = parse_line(line);
-        if (data.has_value()) {
-            results.push_back(std::move(data.value()));
+        // The scan and slicing since the previous row count as splitting
+        clock_.lap(stats_.profile, ParseStage::Split, line.size());
+        if (on_row(fields)) {
+            clock_.lap(stats_.profile, ParseStage::Emit, line.size());
             stats_.valid_records++;
-        } else {
+        } else if (!filtered_) {
             stats_.invalid_records++;
         }
+    };
+    
+    // Scan whole windows of rows at once; every structural offset the scanner
+    // reports is either a field boundary or a row boundary
+    constexpr size_t kScanWindow = 64 * 1024;
+    while (pos < end) {
+        size_t avail = end - pos;
+        size_t window = std::min(avail, kScanWindow);
+        if (window < avail) {
+            const char* last_nl = pos + window;
+            while (last_nl > pos && last_nl[-1] != '\n') last_nl--;
+            if (last_nl > pos) {
+                window = last_nl - pos;
+            } else {
+                // Single row longer than the window
+                const char* nl = static_cast<const char*>(std::memchr(pos + window, '\n', avail - window));
+                window = nl ? nl - pos + 1 : avail;
+            }
+        }
+        
+        size_t count = scanner_.scan(pos, window, scan_index_);
+        const char* line_start = pos;
+        const char* field_start = pos;
+        fields.clear();
+        
+        for (size_t i = 0; i < count; i++) {
+            const char* p = pos + scan_index_[i];
+            fields.emplace_back(field_start, p - field_start);
+            field_start = p + 1;
+            if (*p == '\n') {
+                finish_line(line_start, p, true);
+                line_start = field_start;
+                fields.clear();
+            }
+        }
+        
+        pos += window;
+        if (line_start < pos) {
+            // Final row without a trailing newline
+            fields.emplace_back(field_start, pos - field_start);
+            finish_line(line_start, pos, false);
+        }
+    }
+}
+
+template <typename RowFn>
+void TelemetryParser::parse_read_ahead(const std::string& filename, RowFn&& on_row) {
+    // The codec comes from the first block read, so a pipe is opened and
+    // read exactly once
+    std::optional<ReadAhead> plain;
+    {
+        ReadAheadConfig read_config;
+        read_config.block_size = config_.buffer_size;
+        read_config.depth = config_.read_ahead;
+        plain.emplace(filename, read_config);
+    }
+    clock_.start();
+    std::string_view first = plain->next();
+    if (detect_compression(first.substr(0, 4)) == Compression::None) {
+        stats_.input = plain->backend();
+        parse_blocks(*plain, on_row, first);
+        return;
+    }
+    // DecompressReader maps the file, which a pipe cannot be
+    if (!plain->regular()) {
+        throw std::runtime_error("Compressed input must be a regular file: " + filename);
+    }
+    plain.reset();
+    DecompressConfig decompress_config;
+    decompress_config.block_size = config_.buffer_size;
+    decompress_config.depth = config_.read_ahead;
+    decompress_config.num_threads = config_.num_threads;
+    DecompressReader reader(filename, decompress_config);
+    stats_.input = compression_name(reader.compression());
+    clock_.start();
+    parse_blocks(reader, on_row, reader.next());
+}
+
+template <typename RowFn>
+void TelemetryParser::parse_rows(const std::string& filename, RowFn&& on_row) {
+    std::optional<MappedFile> mapped;
+    if (config_.use_mmap) mapped = map_input(filename);
+    if (mapped) {
+        parse_buffer(mapped->view(), on_row);
+    } else {
+        parse_read_ahead(filename, on_row);
     }
+}
+
+template <typename Source, typename RowFn>
+void TelemetryParser::parse_blocks(Source& source, RowFn&& on_row, std::string_view first) {
+    // Only the first piece parsed can start with the header
+    HeaderRestore restore{config_, config_.has_header};
     
-    auto end_time = std::chrono::high_resolution_clock::now();
-    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
-    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+    // Rows run across block boundaries: whole rows are parsed in place in
+    // the block, and a row cut off at its end is carried into the next
+    std::string carry;
+    for (std::string_view block = first; !block.empty(); block = source.next()) {
+        clock_.lap(stats_.profile, ParseStage::Read, block.size());
+        if (!carry.empty()) {
+            const char* nl = static_cast<const char*>(std::memchr(block.data(), '\n', block.size()));
+            size_t head = nl ? static_cast<size_t>(nl - block.data()) + 1 : block.size();
+            carry.append(block.data(), head);
+            block.remove_prefix(head);
+            if (!nl) continue;
+            parse_buffer(carry, on_row);
+            config_.has_header = false;
+            carry.clear();
+        }
+        size_t last_nl = block.rfind('\n');
+        size_t whole = last_nl == std::string_view::npos ? 0 : last_nl + 1;
+        if (whole > 0) {
+            parse_buffer(block.substr(0, whole), on_row);
+            config_.has_header = false;
+        }
+        carry.assign(block.data() + whole, block.size() - whole);
+    }
+    // Final row without a trailing newline
+    if (!carry.empty()) parse_buffer(carry, on_row);
+}
+
+std::vector<std::string_view> TelemetryParser::split_chunks(std::string_view buffer, size_t num_threads) {
+    // Over-split so uneven chunks still balance across the pool
+    constexpr size_t kMinChunkBytes = 1 << 20;
+    size_t target = std::max(kMinChunkBytes, buffer.size() / (num_threads * 4) + 1);
     
-    return results;
+    std::vector<std::string_view> chunks;
+    for (size_t pos = 0; pos < buffer.size();) {
+        size_t end = std::min(pos + target, buffer.size());
+        if (end < buffer.size()) {
+            const char* nl = static_cast<const char*>(
+                std::memchr(buffer.data() + end, '\n', buffer.size() - end));
+            end = nl ? static_cast<size_t>(nl - buffer.data()) + 1 : buffer.size();
+        }
+        chunks.push_back(buffer.substr(pos, end - pos));
+        pos = end;
+    }
+    return chunks;
 }
 
-void TelemetryParser::parse_file_streaming(
-    const std::string& filename,
-    std::function<void(TelemetryData&&)> callback
-) {
-    auto start_time = std::chrono::high_resolution_clock::now();
+template <typename Output, typename ChunkFn>
+void TelemetryParser::parse_parallel(std::string_view buffer, size_t num_threads, ChunkFn&& on_chunk) {
+    // Parse the header once; every worker inherits the column mapping
+    buffer.remove_prefix(consume_preamble(buffer));
     
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
+    std::vector<std::string_view> chunks = split_chunks(buffer, num_threads);
+    if (chunks.empty()) return;
+    
+    TelemetryParser prototype(*this);
+    prototype.config_.has_header = false;
+    prototype.reset_stats();
+    
+    struct ChunkResult {
+        Output output;
+        TelemetryParser worker;
+    };
+    
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    std::vector<size_t> done;
+    std::vector<std::future<ChunkResult>> futures;
+    futures.reserve(chunks.size());
+    
+    ThreadPool pool(std::min(num_threads, chunks.size()));
+    for (size_t i = 0; i < chunks.size(); i++) {
+        futures.push_back(pool.submit([&, i]() {
+            struct Notify {
+                std::mutex& mutex;
+                std::condition_variable& cv;
+                std::vector<size_t>& done;
+                size_t index;
+                ~Notify() {
+                    { std::lock_guard<std::mutex> lock(mutex); done.push_back(index); }
+                    cv.notify_one();
+                }
+            } notify{done_mutex, done_cv, done, i};
+            
+            ChunkResult result{Output(), prototype};
+            result.output.reserve(chunks[i].size() / 100);
+            TelemetryParser& worker = result.worker;
+            worker.parse_buffer(chunks[i], [&](const std::vector<std::string_view>& fields) {
+                return worker.append_row(fields, result.output);
+            });
+            return result;
+        }));
     }
     
-    std::string line;
-    line.reserve(512);
+    auto deliver = [&](size_t index) {
+        ChunkResult result = futures[index].get();
+        stats_.merge(result.worker.stats_);
+        on_chunk(std::move(result.output), result.worker);
+    };
     
-    // Read and parse header
-    if (config_.has_header && std::getline(file, line)) {
-        parse_header(line);
-        stats_.total_lines++;
+    if (config_.preserve_order) {
+        for (size_t i = 0; i < futures.size(); i++) deliver(i);
+        return;
     }
     
-    // Parse and stream data
-    while (std::getline(file, line)) {
-        stats_.total_lines++;
-        stats_.bytes_processed += line.size() + 1;
-        
-        while (!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' ')) {
-            line.pop_back();
+    for (size_t delivered = 0; delivered < futures.size();) {
+        std::vector<size_t> ready;
+        {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            done_cv.wait(lock, [&done]() { return !done.empty(); });
+            ready.swap(done);
         }
-        
-        if (line.empty()) continue;
-        
-        auto data = parse_line(line);
-        if (data.has_value()) {
-            callback(std::move(data.value()));
-            stats_.valid_records++;
-        } else {
-            stats_.invalid_records++;
+        for (size_t index : ready) {
+            deliver(index);
+            delivered++;
         }
     }
+}
+
+template <typename Results>
+void TelemetryParser::parse_mapped_into(const std::string& filename, Results& results) {
+    // Compressed input streams through the decoder rather than being
+    // inflated whole, and a pipe is read as it arrives
+    std::optional<MappedFile> mapped = map_input(filename);
+    if (!mapped) {
+        parse_read_into(filename, results);
+        return;
+    }
+    parse_view_into(mapped->view(), results);
+}
+
+template <typename Results>
+void TelemetryParser::parse_view_into(std::string_view buffer, Results& results) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    size_t num_threads = ThreadPool::resolve_threads(config_.num_threads);
+    
+    results.reserve(buffer.size() / 100);  // Estimate: ~100 bytes per record
+    
+    if (num_threads > 1) {
+        // Workers fill heap vectors; the insert moves (or, into an arena,
+        // copies) them into results on this thread
+        parse_parallel<std::vector<TelemetryData>>(buffer, num_threads,
+            [&results](std::vector<TelemetryData>&& chunk, const TelemetryParser&) {
+                results.insert(results.end(),
+                               std::make_move_iterator(chunk.begin()),
+                               std::make_move_iterator(chunk.end()));
+            });
+    } else {
+        parse_buffer(buffer, [this, &results](const std::vector<std::string_view>& fields) {
+            return append_row(fields, results);
+        });
+    }
     
     auto end_time = std::chrono::high_resolution_clock::now();
     stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
     stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
 }
 
-std::vector<TelemetryData> TelemetryParser::parse_log(const std::string& filename) {
+std::vector<TelemetryData> TelemetryParser::parse_mapped(const std::string& filename) {
+    std::vector<TelemetryData> results;
+    parse_mapped_into(filename, results);
+    return results;
+}
+
+std::vector<TelemetryData> TelemetryParser::parse_view(std::string_view buffer) {
+    std::vector<TelemetryData> results;
+    parse_view_into(buffer, results);
+    return results;
+}
+
+void TelemetryParser::stream_mapped(
+    const std::string& filename,
+    const std::function<void(TelemetryData&&)>& callback
+) {
     auto start_time = std::chrono::high_resolution_clock::now();
+    std::optional<MappedFile> mapped = map_input(filename);
+    if (!mapped) {
+        stream_read(filename, callback);
+        return;
+    }
+    size_t num_threads = ThreadPool::resolve_threads(config_.num_threads);
     
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
+    if (num_threads > 1) {
+        // Workers parse ahead; the callback always runs on this thread
+        parse_parallel<std::vector<TelemetryData>>(mapped->view(), num_threads,
+            [&callback](std::vector<TelemetryData>&& chunk, const TelemetryParser&) {
+                for (auto& data : chunk) callback(std::move(data));
+            });
+    } else {
+        TelemetryData data;
+        parse_buffer(mapped->view(), [&](const std::vector<std::string_view>& fields) {
+            if (!decode_row(fields, data)) return false;
+            callback(std::move(data));
+            return true;
+        });
     }
     
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+}
+
+template <typename Results>
+void TelemetryParser::parse_stream_into(const std::string& filename, Results& results) {
+    if (config_.use_mmap || ThreadPool::resolve_threads(config_.num_threads) > 1) {
+        parse_mapped_into(filename, results);
+    } else {
+        parse_read_into(filename, results);
+    }
+}
+
+template <typename Results>
+void TelemetryParser::parse_read_into(const std::string& filename, Results& results) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    results.reserve(file_size_hint(filename) / 100);  // Estimate: ~100 bytes per record
+    parse_read_ahead(filename, [this, &results](const std::vector<std::string_view>& fields) {
+        return append_row(fields, results);
+    });
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+}
+
+std::vector<TelemetryData> TelemetryParser::parse_file(const std::string& filename) {
     std::vector<TelemetryData> results;
-    std::string line;
+    parse_stream_into(filename, results);
+    return results;
+}
+
+std::pmr::vector<ArenaTelemetryData> TelemetryParser::parse_file(const std::string& filename,
+                                                                 std::pmr::memory_resource* resource) {
+    std::pmr::vector<ArenaTelemetryData> results(resource);
+    parse_stream_into(filename, results);
+    return results;
+}
+
+std::vector<TelemetryRecord> TelemetryParser::parse_file_compact(const std::string& filename) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    size_t num_threads = ThreadPool::resolve_threads(config_.num_threads);
+    std::optional<MappedFile> mapped;
+    if (num_threads > 1) mapped = map_input(filename);
     
-    while (std::getline(file, line)) {
-        stats_.total_lines++;
-        stats_.bytes_processed += line.size() + 1;
-        
-        // Skip comments and empty lines
-        if (line.empty() || line[0] == '#') continue;
-        
-        // Parse log format: timestamp|vehicle_id|lat,lon|speed|rpm|fuel|odo|temp|batt|diag
-        std::vector<std::string> parts;
-        std::istringstream iss(line);
-        std::string part;
-        while (std::getline(iss, part, '|')) {
-            parts.push_back(part);
-        }
-        
-        if (parts.size() < 10) {
-            stats_.invalid_records++;
-            continue;
-        }
-        
-        TelemetryData data;
-        data.timestamp = parse_timestamp(parts[0]);
-        data.vehicle_id = parts[1];
-        
-        // Parse lat,lon
-        size_t comma = parts[2].find(',');
-        if (comma != std::string::npos) {
-            data.latitude = std::stod(parts[2].substr(0, comma));
-            data.longitude = std::stod(parts[2].substr(comma + 1));
-        }
-        
-        data.speed = std::stod(parts[3]);
-        data.engine_rpm = std::stoi(parts[4]);
-        data.fuel_level = std::stod(parts[5]);
-        data.odometer_km = std::stod(parts[6]);
-        data.engine_temp = std::stod(parts[7]);
-        data.battery_volt = std::stod(parts[8]);
-        
-        if (parts.size() > 9 && !parts[9].empty()) {
-            data.diagnostic_code = parts[9];
-        }
-        
-        if (!config_.validate || data.is_valid()) {
-            results.push_back(std::move(data));
-            stats_.valid_records++;
-        } else {
-            stats_.invalid_records++;
-        }
+    std::vector<TelemetryRecord> results;
+    results.reserve(file_size_hint(filename) / 100);  // Estimate: ~100 bytes per record
+    
+    if (mapped) {
+        // Workers intern into private tables; translate their handles into ours
+        std::vector<uint32_t> vehicle_map;
+        std::vector<uint32_t> diag_map;
+        parse_parallel<std::vector<TelemetryRecord>>(mapped->view(), num_threads,
+            [&](std::vector<TelemetryRecord>&& chunk, const TelemetryParser& worker) {
+                vehicle_map.resize(worker.vehicle_ids_.size());
+                for (uint32_t h = 0; h < vehicle_map.size(); h++) {
+                    vehicle_map[h] = vehicle_ids_.intern(worker.vehicle_ids_.view(h));
+                }
+                diag_map.resize(worker.diagnostic_codes_.size());
+                for (uint32_t h = 0; h < diag_map.size(); h++) {
+                    diag_map[h] = diagnostic_codes_.intern(worker.diagnostic_codes_.view(h));
+                }
+                for (auto& record : chunk) {
+                    record.vehicle_id = vehicle_map[record.vehicle_id];
+                    record.diagnostic_code = diag_map[record.diagnostic_code];
+                }
+                results.insert(results.end(), chunk.begin(), chunk.end());
+            });
+    } else {
+        parse_rows(filename, [this, &results](const std::vector<std::string_view>& fields) {
+            return append_row(fields, results);
+        });
     }
     
     auto end_time = std::chrono::high_resolution_clock::now();
@@ -427,126 +914,665 @@ std::vector<TelemetryData> TelemetryParser::parse_log(const std::string& filenam
     return results;
 }
 
-std::vector<TelemetryData> TelemetryParser::parse_binary(const std::string& filename) {
+// Puts config.validate back after a columnar pass that validates whole
+// batches instead of rows
+struct ValidationDeferral {
+    ParserConfig& config;
+    bool validate;
+    explicit ValidationDeferral(ParserConfig& c) : config(c), validate(c.validate) { config.validate = false; }
+    ~ValidationDeferral() { config.validate = validate; }
+};
+
+void TelemetryParser::validate_columns(TelemetryBatch& batch) {
+    clock_.start();
+    BatchValidation validation;
+    validate_batch(batch, validation);
+    clock_.lap(stats_.profile, ParseStage::Validate, batch.size());
+    
+    size_t rejected = validation.rows - validation.valid_rows;
+    if (rejected == 0) return;
+    batch.retain(validation.valid);
+    for (size_t i = 0; i < kRejectReasonCount; i++) stats_.rejected[i] += validation.rejected[i];
+    stats_.valid_records -= rejected;
+    stats_.invalid_records += rejected;
+}
+
+TelemetryBatch TelemetryParser::parse_file_columnar(const std::string& filename) {
     auto start_time = std::chrono::high_resolution_clock::now();
+    size_t num_threads = ThreadPool::resolve_threads(config_.num_threads);
+    std::optional<MappedFile> mapped;
+    if (num_threads > 1) mapped = map_input(filename);
     
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
+    const bool validate = config_.validate;
+    ValidationDeferral deferral(config_);
+    
+    TelemetryBatch batch;
+    
+    if (mapped) {
+        parse_parallel<TelemetryBatch>(mapped->view(), num_threads,
+            [&batch](TelemetryBatch&& chunk, const TelemetryParser&) {
+                if (batch.empty()) {
+                    batch = std::move(chunk);
+                } else {
+                    batch.append(chunk);
+                }
+            });
+    } else {
+        batch.reserve(file_size_hint(filename) / 100);  // Estimate: ~100 bytes per record
+        parse_rows(filename, [this, &batch](const std::vector<std::string_view>& fields) {
+            return append_row(fields, batch);
+        });
     }
+    if (validate) validate_columns(batch);
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+    
+    return batch;
+}
+
+void TelemetryParser::parse_file_columnar(
+    const std::string& filename,
+    const std::function<void(const TelemetryBatch&)>& on_batch
+) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    size_t num_threads = ThreadPool::resolve_threads(config_.num_threads);
+    std::optional<MappedFile> mapped;
+    if (num_threads > 1) mapped = map_input(filename);
+    const size_t batch_size = std::max<size_t>(config_.batch_size, 1);
+    
+    const bool validate = config_.validate;
+    ValidationDeferral deferral(config_);
     
-    // Read and verify header
-    uint32_t magic;
-    uint8_t version;
-    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    TelemetryBatch batch;
+    batch.reserve(batch_size);
     
-    if (magic != 0x464C4554 || version != 1) {
-        throw std::runtime_error("Invalid binary file format");
+    if (mapped) {
+        // Re-slice worker chunks into batch_size pieces
+        parse_parallel<TelemetryBatch>(mapped->view(), num_threads,
+            [&](TelemetryBatch&& chunk, const TelemetryParser&) {
+                if (validate) validate_columns(chunk);
+                size_t pos = 0;
+                while (pos < chunk.size()) {
+                    size_t take = std::min(batch_size - batch.size(), chunk.size() - pos);
+                    batch.append(chunk, pos, pos + take);
+                    pos += take;
+                    if (batch.size() == batch_size) {
+                        on_batch(batch);
+                        batch.clear();
+                    }
+                }
+            });
+    } else {
+        // Rows that fail validation are dropped when a batch fills, so a
+        // batch can reach the callback with fewer than batch_size rows
+        parse_rows(filename, [&](const std::vector<std::string_view>& fields) {
+            if (!append_row(fields, batch)) return false;
+            if (batch.size() == batch_size) {
+                if (validate) validate_columns(batch);
+                if (!batch.empty()) on_batch(batch);
+                batch.clear();
+            }
+            return true;
+        });
+        if (validate) validate_columns(batch);
     }
+    if (!batch.empty()) on_batch(batch);
     
-    std::vector<TelemetryData> results;
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+}
+
+void TelemetryParser::parse_file_columnar(const std::string& filename, BatchRing<TelemetryBatch>& ring) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    size_t num_threads = ThreadPool::resolve_threads(config_.num_threads);
+    std::optional<MappedFile> mapped;
+    if (num_threads > 1) mapped = map_input(filename);
+    const size_t batch_size = std::max<size_t>(config_.batch_size, 1);
     
-    while (file.peek() != EOF) {
-        TelemetryData data;
-        
-        // Read vehicle_id (length-prefixed string)
-        uint8_t vid_len;
-        file.read(reinterpret_cast<char*>(&vid_len), sizeof(vid_len));
-        data.vehicle_id.resize(vid_len);
-        file.read(data.vehicle_id.data(), vid_len);
+    const bool validate = config_.validate;
+    ValidationDeferral deferral(config_);
+    
+    // Fill slots in place, publishing each as it reaches batch_size.
+    // A producer holds one slot at a time, so it never waits on itself.
+    // slots hands them out (acquire / [] / publish / discard) and
+    // parse(on_row) runs the producer's rows through on_row.
+    auto fill = [batch_size, validate](TelemetryParser& parser, auto&& slots, auto&& parse) {
+        size_t slot = slots.acquire();
+        parse([&](const std::vector<std::string_view>& fields) {
+            if (!parser.append_row(fields, slots[slot])) return false;
+            if (slots[slot].size() == batch_size) {
+                if (validate) parser.validate_columns(slots[slot]);
+                slots.publish(slot);
+                slot = slots.acquire();
+            }
+            return true;
+        });
+        if (validate) parser.validate_columns(slots[slot]);
+        if (slots[slot].empty()) {
+            slots.discard(slot);
+        } else {
+            slots.publish(slot);
+        }
+    };
+    
+    // The ring itself, or one chunk's view of an OrderedPublisher
+    struct RingSlots {
+        BatchRing<TelemetryBatch>& ring;
+        size_t acquire() { return ring.acquire(); }
+        TelemetryBatch& operator[](size_t slot) { return ring[slot]; }
+        void publish(size_t slot) { ring.publish(slot); }
+        void discard(size_t slot) { ring.discard(slot); }
+    };
+    struct ChunkSlots {
+        OrderedPublisher<TelemetryBatch>& publisher;
+        size_t chunk;
+        size_t acquire() { return publisher.acquire(chunk); }
+        TelemetryBatch& operator[](size_t slot) { return publisher[slot]; }
+        void publish(size_t slot) { publisher.publish(chunk, slot); }
+        void discard(size_t slot) { publisher.discard(chunk, slot); }
+    };
+    
+    if (mapped) {
+        // Every worker fills and publishes its own slots: no copy and no
+        // hand-off through this thread
+        std::string_view buffer = mapped->view();
+        buffer.remove_prefix(consume_preamble(buffer));
+        std::vector<std::string_view> chunks = split_chunks(buffer, num_threads);
         
-        // Read fixed-size fields
-        file.read(reinterpret_cast<char*>(&data.timestamp), sizeof(data.timestamp));
-        file.read(reinterpret_cast<char*>(&data.latitude), sizeof(data.latitude));
-        file.read(reinterpret_cast<char*>(&data.longitude), sizeof(data.longitude));
-        file.read(reinterpret_cast<char*>(&data.speed), sizeof(data.speed));
-        file.read(reinterpret_cast<char*>(&data.heading), sizeof(data.heading));
-        file.read(reinterpret_cast<char*>(&data.engine_rpm), sizeof(data.engine_rpm));
-        file.read(reinterpret_cast<char*>(&data.fuel_level), sizeof(data.fuel_level));
-        file.read(reinterpret_cast<char*>(&data.odometer_km), sizeof(data.odometer_km));
-        file.read(reinterpret_cast<char*>(&data.engine_temp), sizeof(data.engine_temp));
-        file.read(reinterpret_cast<char*>(&data.battery_volt), sizeof(data.battery_volt));
+        TelemetryParser prototype(*this);
+        prototype.config_.has_header = false;
+        prototype.reset_stats();
         
-        // Read diagnostic_code (length-prefixed string)
-        uint8_t diag_len;
-        file.read(reinterpret_cast<char*>(&diag_len), sizeof(diag_len));
-        if (diag_len > 0) {
-            data.diagnostic_code.resize(diag_len);
-            file.read(data.diagnostic_code.data(), diag_len);
-        }
+        std::optional<OrderedPublisher<TelemetryBatch>> publisher;
+        if (config_.preserve_order) publisher.emplace(ring, chunks.size());
         
-        stats_.total_lines++;
-        if (!config_.validate || data.is_valid()) {
-            results.push_back(std::move(data));
-            stats_.valid_records++;
-        } else {
-            stats_.invalid_records++;
+        std::vector<std::future<ParseStats>> futures;
+        futures.reserve(chunks.size());
+        {
+            ThreadPool pool(std::min(num_threads, std::max<size_t>(chunks.size(), 1)));
+            for (size_t i = 0; i < chunks.size(); i++) {
+                futures.push_back(pool.submit([&prototype, &fill, &ring, &publisher, &chunks, i]() {
+                    TelemetryParser worker(prototype);
+                    auto parse = [&worker, &chunks, i](auto&& on_row) { worker.parse_buffer(chunks[i], on_row); };
+                    if (!publisher) {
+                        fill(worker, RingSlots{ring}, parse);
+                        return worker.stats_;
+                    }
+                    // A failed worker must still finish its chunk, or the
+                    // ones after it would wait to become head forever
+                    try {
+                        fill(worker, ChunkSlots{*publisher, i}, parse);
+                    } catch (...) {
+                        publisher->fail(std::current_exception());
+                    }
+                    publisher->finish(i);
+                    return worker.stats_;
+                }));
+            }
         }
+        if (publisher) publisher->rethrow();
+        for (auto& future : futures) stats_.merge(future.get());
+    } else {
+        fill(*this, RingSlots{ring}, [this, &filename](auto&& on_row) { parse_rows(filename, on_row); });
     }
     
     auto end_time = std::chrono::high_resolution_clock::now();
     stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
     stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+}
+
+void TelemetryParser::parse_file_batched(
+    const std::string& filename,
+    const std::function<void(Span<TelemetryData>)>& on_batch
+) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    size_t num_threads = ThreadPool::resolve_threads(config_.num_threads);
+    std::optional<MappedFile> mapped;
+    if (num_threads > 1) mapped = map_input(filename);
+    const size_t batch_size = std::max<size_t>(config_.batch_size, 1);
+    
+    if (mapped) {
+        // Worker chunks are already owned buffers; hand them out in slices
+        parse_parallel<std::vector<TelemetryData>>(mapped->view(), num_threads,
+            [&](std::vector<TelemetryData>&& chunk, const TelemetryParser&) {
+                for (size_t pos = 0; pos < chunk.size(); pos += batch_size) {
+                    size_t n = std::min(batch_size, chunk.size() - pos);
+                    on_batch(Span<TelemetryData>{chunk.data() + pos, n});
+                }
+            });
+    } else {
+        // Decode in place over one fixed set of records so string capacity
+        // is recycled from batch to batch
+        std::vector<TelemetryData> buffer(batch_size);
+        size_t filled = 0;
+        parse_rows(filename, [&](const std::vector<std::string_view>& fields) {
+            if (!decode_row(fields, buffer[filled])) return false;
+            if (++filled == batch_size) {
+                on_batch(Span<TelemetryData>{buffer.data(), filled});
+                filled = 0;
+            }
+            return true;
+        });
+        if (filled > 0) on_batch(Span<TelemetryData>{buffer.data(), filled});
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+}
+
+void TelemetryParser::parse_file_streaming(
+    const std::string& filename,
+    std::function<void(TelemetryData&&)> callback
+) {
+    if (config_.use_mmap || ThreadPool::resolve_threads(config_.num_threads) > 1) {
+        stream_mapped(filename, callback);
+    } else {
+        stream_read(filename, callback);
+    }
+}
+
+void TelemetryParser::stream_read(
+    const std::string& filename,
+    const std::function<void(TelemetryData&&)>& callback
+) {
+    auto start_time = std::chrono::high_resolution_clock::now();
     
+    TelemetryData data;
+    parse_read_ahead(filename, [&](const std::vector<std::string_view>& fields) {
+        if (!decode_row(fields, data)) return false;
+        callback(std::move(data));
+        return true;
+    });
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+}
+
+// Switches the parser to the log layout for one call
+struct TelemetryParser::LogLayoutScope {
+    TelemetryParser& parser;
+    explicit LogLayoutScope(TelemetryParser& p) : parser(p) { parser.set_layout(RowLayout::Log); }
+    ~LogLayoutScope() { parser.set_layout(RowLayout::Csv); }
+};
+
+std::vector<TelemetryData> TelemetryParser::parse_log(const std::string& filename) {
+    LogLayoutScope scope(*this);
+    return parse_mapped(filename);
+}
+
+std::pmr::vector<ArenaTelemetryData> TelemetryParser::parse_log(const std::string& filename,
+                                                                std::pmr::memory_resource* resource) {
+    LogLayoutScope scope(*this);
+    std::pmr::vector<ArenaTelemetryData> results(resource);
+    parse_mapped_into(filename, results);
     return results;
 }
 
-// ============================================================================
-// BinaryWriter implementation
-// ============================================================================
+std::vector<TelemetryData> TelemetryParser::parse_string(std::string_view buffer, bool at_start) {
+    HeaderRestore restore{config_, config_.has_header};
+    if (!at_start) config_.has_header = false;
+    return parse_view(buffer);
+}
 
-BinaryWriter::BinaryWriter(const std::string& filename) 
-    : file_(filename, std::ios::binary) {
-    if (!file_.is_open()) {
-        throw std::runtime_error("Failed to create file: " + filename);
+std::vector<TelemetryData> TelemetryParser::parse_log_string(std::string_view buffer, bool at_start) {
+    LogLayoutScope scope(*this);
+    HeaderRestore restore{config_, config_.has_header};
+    if (!at_start) config_.has_header = false;
+    return parse_view(buffer);
+}
+
+size_t TelemetryParser::parse_columns(std::string_view buffer, ColumnArrays& out, bool at_start) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    HeaderRestore restore{config_, config_.has_header};
+    size_t begin = 0;
+    if (at_start) begin = consume_preamble(buffer);
+    config_.has_header = false;
+    
+    // Every row is one line, so stopping after as many lines as there are
+    // free slots guarantees the arrays cannot overflow
+    size_t end = begin;
+    for (size_t slots = out.capacity > out.size ? out.capacity - out.size : 0; slots > 0; slots--) {
+        const char* nl = static_cast<const char*>(
+            std::memchr(buffer.data() + end, '\n', buffer.size() - end));
+        if (!nl) {
+            end = buffer.size();
+            break;
+        }
+        end = static_cast<size_t>(nl - buffer.data()) + 1;
     }
     
-    // Write header
-    file_.write(reinterpret_cast<const char*>(&MAGIC), sizeof(MAGIC));
-    file_.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    DecodedRow row;
+    parse_buffer(buffer.substr(begin, end - begin), [&](const std::vector<std::string_view>& fields) {
+        if (!decode_row(fields, row)) return false;
+        const size_t i = out.size++;
+        if (out.timestamp) out.timestamp[i] = row.timestamp;
+        if (out.latitude) out.latitude[i] = row.latitude;
+        if (out.longitude) out.longitude[i] = row.longitude;
+        if (out.speed) out.speed[i] = row.speed;
+        if (out.heading) out.heading[i] = row.heading;
+        if (out.engine_rpm) out.engine_rpm[i] = row.engine_rpm;
+        if (out.fuel_level) out.fuel_level[i] = row.fuel_level;
+        if (out.odometer_km) out.odometer_km[i] = row.odometer_km;
+        if (out.engine_temp) out.engine_temp[i] = row.engine_temp;
+        if (out.battery_volt) out.battery_volt[i] = row.battery_volt;
+        if (out.vehicle_id) out.vehicle_id[i] = vehicle_ids_.intern(row.vehicle_id);
+        if (out.diagnostic_code) out.diagnostic_code[i] = diagnostic_codes_.intern(row.diagnostic_code);
+        return true;
+    });
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+    
+    return end;
 }
 
-BinaryWriter::~BinaryWriter() {
-    flush();
+size_t TelemetryParser::parse_log_columns(std::string_view buffer, ColumnArrays& out, bool at_start) {
+    LogLayoutScope scope(*this);
+    return parse_columns(buffer, out, at_start);
 }
 
-void BinaryWriter::write(const TelemetryData& data) {
-    // Write vehicle_id (length-prefixed)
-    uint8_t vid_len = static_cast<uint8_t>(std::min(data.vehicle_id.size(), size_t(255)));
-    file_.write(reinterpret_cast<const char*>(&vid_len), sizeof(vid_len));
-    file_.write(data.vehicle_id.data(), vid_len);
+void TelemetryParser::parse_log_streaming(
+    const std::string& filename,
+    std::function<void(TelemetryData&&)> callback
+) {
+    LogLayoutScope scope(*this);
+    stream_mapped(filename, callback);
+}
+
+// ============================================================================
+// Follow mode
+// ============================================================================
+
+void TelemetryParser::follow(
+    const std::string& filename,
+    const std::function<void(TelemetryData&&)>& callback,
+    const FollowOptions& options
+) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    FileFollower follower(filename);
+    
+    // Bytes read per pass; a backlog larger than this is parsed in pieces
+    constexpr size_t kReadChunk = 4 * 1024 * 1024;
+    
+    // The header only exists at the top of the file: later passes parse
+    // with has_header off, and it is restored on the way out
+    HeaderRestore restore{config_, config_.has_header};
+    
+    std::string pending;         // read but not yet parsed; at most one partial line
+    bool at_top = true;          // pending starts at offset 0 of the file
+    bool skip_partial = false;   // drop bytes up to the next newline first
+    
+    auto stopped = [&options]() {
+        return options.stop && options.stop->load(std::memory_order_relaxed);
+    };
+    
+    if (!options.from_start) {
+        // Learn the header, then start at the current end of file
+        uint64_t size = follower.file_size();
+        bool restarted = false;
+        if (restore.has_header && size > 0) {
+            follower.read_appended(pending, 64 * 1024, restarted);
+            size_t last_nl = pending.rfind('\n');
+            if (last_nl != std::string::npos) {
+                consume_preamble(std::string_view(pending.data(), last_nl + 1));
+            }
+            pending.clear();
+        }
+        if (size > 0) {
+            // Mid-line unless the file currently ends with a newline
+            follower.seek(size - 1);
+            follower.read_appended(pending, 1, restarted);
+            skip_partial = pending != "\n";
+            pending.clear();
+        }
+        at_top = false;
+    }
+    
+    TelemetryData data;
+    auto on_row = [&](const std::vector<std::string_view>& fields) {
+        if (!decode_row(fields, data)) return false;
+        callback(std::move(data));
+        return true;
+    };
     
-    // Write fixed-size fields
-    file_.write(reinterpret_cast<const char*>(&data.timestamp), sizeof(data.timestamp));
-    file_.write(reinterpret_cast<const char*>(&data.latitude), sizeof(data.latitude));
-    file_.write(reinterpret_cast<const char*>(&data.longitude), sizeof(data.longitude));
-    file_.write(reinterpret_cast<const char*>(&data.speed), sizeof(data.speed));
-    file_.write(reinterpret_cast<const char*>(&data.heading), sizeof(data.heading));
-    file_.write(reinterpret_cast<const char*>(&data.engine_rpm), sizeof(data.engine_rpm));
-    file_.write(reinterpret_cast<const char*>(&data.fuel_level), sizeof(data.fuel_level));
-    file_.write(reinterpret_cast<const char*>(&data.odometer_km), sizeof(data.odometer_km));
-    file_.write(reinterpret_cast<const char*>(&data.engine_temp), sizeof(data.engine_temp));
-    file_.write(reinterpret_cast<const char*>(&data.battery_volt), sizeof(data.battery_volt));
+    // Parse every complete line in pending, keeping the unfinished tail
+    auto drain = [&]() {
+        if (skip_partial) {
+            size_t nl = pending.find('\n');
+            if (nl == std::string::npos) {
+                pending.clear();
+                return;
+            }
+            pending.erase(0, nl + 1);
+            skip_partial = false;
+        }
+        size_t last_nl = pending.rfind('\n');
+        if (last_nl == std::string::npos) return;
+        
+        config_.has_header = at_top && restore.has_header;
+        parse_buffer(std::string_view(pending.data(), last_nl + 1), on_row);
+        at_top = false;
+        pending.erase(0, last_nl + 1);
+    };
     
-    // Write diagnostic_code (length-prefixed)
-    uint8_t diag_len = static_cast<uint8_t>(std::min(data.diagnostic_code.size(), size_t(255)));
-    file_.write(reinterpret_cast<const char*>(&diag_len), sizeof(diag_len));
-    if (diag_len > 0) {
-        file_.write(data.diagnostic_code.data(), diag_len);
+    bool parsed = false;  // rows parsed since the last on_idle
+    while (!stopped()) {
+        bool restarted = false;
+        clock_.start();
+        size_t got = follower.read_appended(pending, kReadChunk, restarted);
+        clock_.lap(stats_.profile, ParseStage::Read, got);
+        if (restarted) {
+            // Whatever was pending belonged to the old file
+            pending.erase(0, pending.size() - got);
+            at_top = true;
+            skip_partial = false;
+        }
+        if (got > 0) {
+            drain();
+            parsed = true;
+            if (got == kReadChunk) continue;  // more is likely waiting
+        }
+        if (parsed && options.on_idle) options.on_idle();
+        parsed = false;
+        
+        follower.wait(options.poll_interval_ms);
     }
     
-    records_written_++;
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
 }
 
-void BinaryWriter::write_batch(const std::vector<TelemetryData>& data) {
-    for (const auto& d : data) {
-        write(d);
-    }
+void TelemetryParser::follow_file(
+    const std::string& filename,
+    std::function<void(TelemetryData&&)> callback,
+    const FollowOptions& options
+) {
+    follow(filename, callback, options);
+}
+
+void TelemetryParser::follow_log(
+    const std::string& filename,
+    std::function<void(TelemetryData&&)> callback,
+    const FollowOptions& options
+) {
+    LogLayoutScope scope(*this);
+    follow(filename, callback, options);
+}
+
+// Pull one fixed-size field out of a v1 record stream
+template <typename T>
+static bool read_field(const char*& p, const char* end, T& out) {
+    if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+    std::memcpy(&out, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+static bool read_string(const char*& p, const char* end, std::string& out) {
+    uint8_t len;
+    if (!read_field(p, end, len) || static_cast<size_t>(end - p) < len) return false;
+    out.assign(p, len);
+    p += len;
+    return true;
 }
 
-void BinaryWriter::flush() {
-    file_.flush();
+// Decode one v1 record; false if the stream ends mid-record
+static bool read_v1_record(const char*& p, const char* end, TelemetryData& data) {
+    return read_string(p, end, data.vehicle_id) &&
+           read_field(p, end, data.timestamp) &&
+           read_field(p, end, data.latitude) &&
+           read_field(p, end, data.longitude) &&
+           read_field(p, end, data.speed) &&
+           read_field(p, end, data.heading) &&
+           read_field(p, end, data.engine_rpm) &&
+           read_field(p, end, data.fuel_level) &&
+           read_field(p, end, data.odometer_km) &&
+           read_field(p, end, data.engine_temp) &&
+           read_field(p, end, data.battery_volt) &&
+           read_string(p, end, data.diagnostic_code);
+}
+
+std::vector<TelemetryData> TelemetryParser::parse_binary(const std::string& filename) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    clock_.start();
+    BinaryReader reader(filename);
+    clock_.lap(stats_.profile, ParseStage::Read, reader.file_size());
+    std::vector<TelemetryData> results;
+    
+    if (reader.version() == binary::kVersion1) {
+        std::string_view payload = reader.v1_payload();
+        const char* p = payload.data();
+        const char* end = p + payload.size();
+        
+        while (p < end) {
+            const char* record_start = p;
+            TelemetryData data;
+            if (!read_v1_record(p, end, data)) {
+                throw std::runtime_error("Corrupt binary file: " + filename);
+            }
+            const size_t record_bytes = p - record_start;
+            clock_.lap(stats_.profile, ParseStage::Decode, record_bytes);
+            
+            stats_.total_lines++;
+            if (filter_active_ &&
+                !(keeps_vehicle(config_.filter, data.vehicle_id) &&
+                  keeps_row(config_.filter, data.timestamp, !data.diagnostic_code.empty(),
+                            data.latitude, data.longitude))) {
+                stats_.filtered_records++;
+                continue;
+            }
+            if (config_.validate) {
+                RejectReason reason = check_record(data);
+                clock_.lap(stats_.profile, ParseStage::Validate, record_bytes);
+                if (reason != RejectReason::None) {
+                    reject(reason);
+                    stats_.invalid_records++;
+                    continue;
+                }
+            }
+            results.push_back(std::move(data));
+            clock_.lap(stats_.profile, ParseStage::Emit, record_bytes);
+            stats_.valid_records++;
+        }
+    } else {
+        // Raw v2 blocks are used in place; only the strings are materialized
+        const RecordFilter& filter = config_.filter;
+        if (!filter_active_) results.reserve(reader.record_count());
+        const size_t vehicles = reader.vehicle_count();
+        const size_t diagnostics = reader.diagnostic_count();
+        BlockBuffer buffer;
+        
+        // The filter's vehicles as this file's dictionary codes
+        std::vector<uint32_t> wanted_codes;
+        std::vector<char> wanted(vehicles, filter.vehicle_ids.empty());
+        if (!filter.vehicle_ids.empty()) {
+            for (uint32_t code = 0; code < vehicles; code++) {
+                if (keeps_vehicle(filter, reader.vehicle(code))) {
+                    wanted[code] = 1;
+                    wanted_codes.push_back(code);
+                }
+            }
+        }
+        
+        // Whether a block's index range could hold a row the filter keeps
+        auto block_may_match = [&](const binary::BlockIndexEntry& info) {
+            if (info.max_timestamp < filter.min_timestamp || info.min_timestamp > filter.max_timestamp) {
+                return false;
+            }
+            if (filter.vehicle_ids.empty()) return true;
+            auto it = std::lower_bound(wanted_codes.begin(), wanted_codes.end(), info.min_vehicle);
+            return it != wanted_codes.end() && *it <= info.max_vehicle;
+        };
+        
+        for (size_t b = 0; b < reader.block_count(); b++) {
+            if (filter_active_ && !block_may_match(reader.block_info(b))) {
+                const uint32_t count = reader.block_info(b).record_count;
+                stats_.total_lines += count;
+                stats_.filtered_records += count;
+                stats_.skipped_blocks++;
+                continue;
+            }
+            RecordSpan block = reader.read_block(b, buffer);
+            clock_.lap(stats_.profile, ParseStage::Decode, block.size * sizeof(TelemetryRecord));
+            for (const TelemetryRecord& r : block) {
+                if (r.vehicle_id >= vehicles || r.diagnostic_code >= diagnostics) {
+                    throw std::runtime_error("Corrupt binary file: " + filename);
+                }
+                
+                stats_.total_lines++;
+                if (filter_active_ &&
+                    !(wanted[r.vehicle_id] &&
+                      keeps_row(filter, r.timestamp, r.diagnostic_code != StringTable::kEmpty,
+                                r.latitude, r.longitude))) {
+                    stats_.filtered_records++;
+                    continue;
+                }
+                if (config_.validate) {
+                    RejectReason reason = check_record(r);
+                    clock_.lap(stats_.profile, ParseStage::Validate, sizeof(TelemetryRecord));
+                    if (reason != RejectReason::None) {
+                        reject(reason);
+                        stats_.invalid_records++;
+                        continue;
+                    }
+                }
+                
+                TelemetryData& data = results.emplace_back();
+                data.vehicle_id = reader.vehicle(r.vehicle_id);
+                data.timestamp = r.timestamp;
+                data.latitude = r.latitude;
+                data.longitude = r.longitude;
+                data.speed = r.speed;
+                data.heading = r.heading;
+                data.engine_rpm = r.engine_rpm;
+                data.fuel_level = r.fuel_level;
+                data.odometer_km = r.odometer_km;
+                data.engine_temp = r.engine_temp;
+                data.battery_volt = r.battery_volt;
+                data.diagnostic_code = reader.diagnostic(r.diagnostic_code);
+                clock_.lap(stats_.profile, ParseStage::Emit, sizeof(TelemetryRecord));
+                stats_.valid_records++;
+            }
+        }
+    }
+    
+    stats_.bytes_processed += reader.file_size();
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stats_.parse_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    stats_.records_per_second = (stats_.valid_records / stats_.parse_time_ms) * 1000.0;
+    
+    return results;
 }
 
 // ============================================================================
@@ -559,11 +1585,89 @@ std::string format_stats(const ParseStats& stats) {
         << "  Total lines:      " << stats.total_lines << "\n"
         << "  Valid records:    " << stats.valid_records << "\n"
         << "  Invalid records:  " << stats.invalid_records << "\n"
-        << "  Bytes processed:  " << stats.bytes_processed << "\n"
+        << "  Malformed rows:   " << stats.malformed_records << "\n";
+    if (*stats.input != '\0') oss << "  Read via:         " << stats.input << "\n";
+    if (stats.filtered_records > 0) {
+        oss << "  Filtered rows:    " << stats.filtered_records;
+        if (stats.skipped_blocks > 0) oss << " (" << stats.skipped_blocks << " blocks skipped)";
+        oss << "\n";
+    }
+    oss << "  Bytes processed:  " << stats.bytes_processed << "\n"
         << "  Parse time:       " << std::fixed << std::setprecision(2) 
         << stats.parse_time_ms << " ms\n"
         << "  Records/second:   " << std::fixed << std::setprecision(0) 
         << stats.records_per_second;
+    
+    if (stats.invalid_records > 0) {
+        oss << "\n  Rejected by rule:";
+        for (size_t i = 0; i < kRejectReasonCount; i++) {
+            if (stats.rejected[i] == 0) continue;
+            oss << "\n    " << std::left << std::setw(20)
+                << reject_reason_name(static_cast<RejectReason>(i))
+                << std::right << stats.rejected[i];
+        }
+    }
+    
+    if (kProfileEnabled) {
+        const ParseProfile& profile = stats.profile;
+        const double ticks_per_ms = profile_ticks_per_ms();
+        const double total = static_cast<double>(profile.total_ticks());
+        oss << "\n  Stage profile (CPU time summed over threads):"
+            << "\n    stage           ms   share       calls       MB/s     allocs";
+        for (size_t i = 0; i < kParseStageCount; i++) {
+            const StageCounters& c = profile.stages[i];
+            double ms = ticks_per_ms > 0 ? c.ticks / ticks_per_ms : 0.0;
+            oss << "\n    " << std::left << std::setw(9) << stage_name(static_cast<ParseStage>(i))
+                << std::right << std::fixed
+                << std::setw(11) << std::setprecision(2) << ms
+                << std::setw(7) << std::setprecision(1) << (total > 0 ? 100.0 * c.ticks / total : 0.0) << "%"
+                << std::setw(12) << c.calls
+                << std::setw(11) << std::setprecision(1) << (ms > 0 ? c.bytes / ms / 1000.0 : 0.0)
+                << std::setw(11) << c.allocations;
+        }
+    }
+    return oss.str();
+}
+
+std::string stats_to_json(const ParseStats& stats) {
+    std::ostringstream oss;
+    oss << "{\"total_lines\":" << stats.total_lines
+        << ",\"valid_records\":" << stats.valid_records
+        << ",\"invalid_records\":" << stats.invalid_records
+        << ",\"malformed_records\":" << stats.malformed_records
+        << ",\"filtered_records\":" << stats.filtered_records
+        << ",\"skipped_blocks\":" << stats.skipped_blocks
+        << ",\"bytes_processed\":" << stats.bytes_processed
+        << ",\"input\":\"" << stats.input << "\""
+        << std::fixed << std::setprecision(3)
+        << ",\"parse_time_ms\":" << stats.parse_time_ms
+        << std::setprecision(0)
+        << ",\"records_per_second\":"
+        << (std::isfinite(stats.records_per_second) ? stats.records_per_second : 0.0);
+    
+    oss << ",\"rejected\":{";
+    for (size_t i = 0; i < kRejectReasonCount; i++) {
+        oss << (i ? "," : "") << "\"" << reject_reason_name(static_cast<RejectReason>(i))
+            << "\":" << stats.rejected[i];
+    }
+    oss << "}";
+    
+    if (kProfileEnabled) {
+        const double ticks_per_ms = profile_ticks_per_ms();
+        oss << ",\"profile\":{";
+        for (size_t i = 0; i < kParseStageCount; i++) {
+            const StageCounters& c = stats.profile.stages[i];
+            oss << (i ? "," : "") << "\"" << stage_name(static_cast<ParseStage>(i)) << "\":{"
+                << "\"ticks\":" << c.ticks
+                << std::setprecision(3)
+                << ",\"ms\":" << (ticks_per_ms > 0 ? c.ticks / ticks_per_ms : 0.0)
+                << ",\"calls\":" << c.calls
+                << ",\"bytes\":" << c.bytes
+                << ",\"allocations\":" << c.allocations << "}";
+        }
+        oss << "}";
+    }
+    oss << "}";
     return oss.str();
 }
 
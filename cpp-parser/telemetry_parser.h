@@ -2,7 +2,9 @@
 #define TELEMETRY_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 #include <optional>
@@ -10,6 +12,11 @@
 #include <fstream>
 #include <sstream>
 #include <memory>
+#include <memory_resource>
+#include "parse_profile.h"
+#include "simd_scanner.h"
+#include "string_table.h"
+#include "timestamp.h"
 
 namespace fleet {
 
@@ -34,49 +41,324 @@ struct TelemetryData {
     std::string to_json() const;
 };
 
+// TelemetryData whose strings live in a caller-supplied memory resource,
+// returned by the arena overloads of TelemetryParser::parse_file() /
+// parse_log() (see record_arena.h). Allocator-aware: built inside a
+// std::pmr container it allocates from that container's resource.
+struct ArenaTelemetryData {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+    
+    std::pmr::string vehicle_id;
+    int64_t timestamp;          // Unix timestamp in milliseconds
+    double latitude;
+    double longitude;
+    double speed;               // km/h
+    double heading;             // degrees
+    int engine_rpm;
+    double fuel_level;          // percentage
+    double odometer_km;
+    double engine_temp;         // Celsius
+    double battery_volt;
+    std::pmr::string diagnostic_code;
+    
+    ArenaTelemetryData() = default;
+    explicit ArenaTelemetryData(const allocator_type& alloc) : vehicle_id(alloc), diagnostic_code(alloc) {}
+    ArenaTelemetryData(const ArenaTelemetryData& other) = default;
+    ArenaTelemetryData(ArenaTelemetryData&& other) = default;
+    ArenaTelemetryData(const ArenaTelemetryData& other, const allocator_type& alloc);
+    ArenaTelemetryData(ArenaTelemetryData&& other, const allocator_type& alloc);
+    ArenaTelemetryData(const TelemetryData& other, const allocator_type& alloc = {});
+    ArenaTelemetryData& operator=(const ArenaTelemetryData& other) = default;
+    ArenaTelemetryData& operator=(ArenaTelemetryData&& other) = default;
+    
+    // Heap copy, for code that takes a TelemetryData
+    TelemetryData to_data() const;
+    
+    bool is_valid() const;
+};
+
+// Compact telemetry record: strings are replaced by handles into the
+// parser's interning tables (see TelemetryParser::vehicle_ids()), so the
+// record is trivially copyable and parsing it never touches the heap.
+struct TelemetryRecord {
+    int64_t timestamp;          // Unix timestamp in milliseconds
+    double latitude;
+    double longitude;
+    double speed;               // km/h
+    double heading;             // degrees
+    double fuel_level;          // percentage
+    double odometer_km;
+    double engine_temp;         // Celsius
+    double battery_volt;
+    int32_t engine_rpm;
+    uint32_t vehicle_id;        // StringTable handle
+    uint32_t diagnostic_code;   // StringTable handle (StringTable::kEmpty = none)
+    
+    bool is_valid() const;
+};
+
+// Non-owning view of a contiguous run of records
+template <typename T>
+struct Span {
+    T* data = nullptr;
+    size_t size = 0;
+    
+    T* begin() const { return data; }
+    T* end() const { return data + size; }
+    T& operator[](size_t i) const { return data[i]; }
+    bool empty() const { return size == 0; }
+};
+
 // Parser statistics
 struct ParseStats {
     size_t total_lines = 0;
     size_t valid_records = 0;
     size_t invalid_records = 0;
+    size_t malformed_records = 0;      // invalid rows that failed to decode at all
     size_t bytes_processed = 0;
     double parse_time_ms = 0;
     double records_per_second = 0;
+    
+    // Invalid rows by the rule they broke (indexed by RejectReason)
+    size_t rejected[kRejectReasonCount] = {};
+    
+    // Rows dropped by ParserConfig::filter (neither valid nor invalid), and
+    // v2 binary blocks skipped whole by their index metadata
+    size_t filtered_records = 0;
+    size_t skipped_blocks = 0;
+    
+    // How the file was read: "mmap", the ReadAhead backend ("io_uring" or
+    // "thread"), or the codec DecompressReader decoded ("gzip", "zstd");
+    // empty for text parsed from memory
+    const char* input = "";
+    
+    // Per-stage timings; only filled in FLEET_PROFILE builds
+    ParseProfile profile;
+    
+    size_t rejected_by(RejectReason reason) const { return rejected[static_cast<size_t>(reason)]; }
+    
+    // Accumulate counters from another (e.g. per-thread) run
+    void merge(const ParseStats& other);
+};
+
+// Inclusive latitude / longitude box
+struct BoundingBox {
+    double min_latitude = -90.0;
+    double min_longitude = -180.0;
+    double max_latitude = 90.0;
+    double max_longitude = 180.0;
+    
+    bool contains(double latitude, double longitude) const {
+        return latitude >= min_latitude && latitude <= max_latitude &&
+               longitude >= min_longitude && longitude <= max_longitude;
+    }
+};
+
+// Rows to keep while parsing (ParserConfig::filter); every condition that
+// is set must hold. Only the key columns a condition names are decoded
+// before the row is tested, so rows that fail skip decoding the rest (and
+// are counted as filtered even if a later column is malformed). v2 binary
+// input skips whole blocks whose index time / vehicle range cannot match.
+struct RecordFilter {
+    std::vector<std::string> vehicle_ids;          // keep these vehicles (empty = all)
+    int64_t min_timestamp = INT64_MIN;             // inclusive Unix ms range
+    int64_t max_timestamp = INT64_MAX;
+    bool diagnostics_only = false;                 // keep rows with a diagnostic code
+    std::optional<BoundingBox> bbox;
+    
+    bool has_time_range() const { return min_timestamp != INT64_MIN || max_timestamp != INT64_MAX; }
+    bool active() const {
+        return !vehicle_ids.empty() || has_time_range() || diagnostics_only || bbox.has_value();
+    }
 };
 
 // Parser configuration
 struct ParserConfig {
     bool validate = true;
     bool skip_invalid = true;
-    size_t batch_size = 10000;
+    size_t batch_size = 10000;         // Records per callback in the batched streaming APIs
     char delimiter = ',';
     bool has_header = true;
-    size_t buffer_size = 1024 * 1024;  // 1MB buffer for reading
+    size_t buffer_size = 1024 * 1024;  // Read size when not mapping the file (1MB)
+    size_t read_ahead = 3;             // buffer_size reads kept in flight ahead of the parser
+    bool use_mmap = false;             // Map the file and parse it in place (zero-copy)
+    size_t num_threads = 1;            // Parallel chunked parsing (0 = all hardware threads)
+    bool preserve_order = true;        // Keep file row order when parsing in parallel
+    RecordFilter filter;               // Predicate pushdown (default: keep every row)
 };
 
+// Options for following a growing file (TelemetryParser::follow_file)
+struct FollowOptions {
+    bool from_start = true;                   // Parse existing content first; false = only new lines
+    int poll_interval_ms = 100;               // Longest wait between stop / rotation checks
+    const std::atomic<bool>* stop = nullptr;  // Following ends once this becomes true
+    std::function<void()> on_idle;            // Called once a burst of appended rows is parsed
+};
+
+// Caller-owned column arrays filled by TelemetryParser::parse_columns().
+// Rows are written at [size, capacity); any array may be null to skip that
+// column. vehicle_id / diagnostic_code are handles into the parser's
+// string tables.
+struct ColumnArrays {
+    size_t capacity = 0;
+    size_t size = 0;
+    int64_t* timestamp = nullptr;
+    double* latitude = nullptr;
+    double* longitude = nullptr;
+    double* speed = nullptr;
+    double* heading = nullptr;
+    int32_t* engine_rpm = nullptr;
+    double* fuel_level = nullptr;
+    double* odometer_km = nullptr;
+    double* engine_temp = nullptr;
+    double* battery_volt = nullptr;
+    uint32_t* vehicle_id = nullptr;
+    uint32_t* diagnostic_code = nullptr;
+};
+
+struct TelemetryBatch;  // telemetry_batch.h
+template <typename Batch>
+class BatchRing;        // batch_ring.h
+class MappedFile;       // mapped_file.h
+
 // High-performance telemetry parser
 class TelemetryParser {
 public:
     explicit TelemetryParser(const ParserConfig& config = ParserConfig());
     ~TelemetryParser() = default;
+    TelemetryParser(const TelemetryParser&) = default;
+    TelemetryParser& operator=(const TelemetryParser&) = default;
+    TelemetryParser(TelemetryParser&&) = default;
+    TelemetryParser& operator=(TelemetryParser&&) = default;
     
-    // Parse entire file
+    // Parse entire file.
+    //
+    // Every file entry point reads its input the same way: num_threads > 1
+    // maps the file and parses chunks of it in parallel; otherwise it is
+    // mapped with use_mmap, or read through ReadAhead in buffer_size blocks.
+    // gzip / zstd input is always parsed block by block as it is inflated,
+    // on the calling thread, and is never held in memory whole.
     std::vector<TelemetryData> parse_file(const std::string& filename);
     
+    // Same, with the result vector and every record's strings allocated
+    // from resource (e.g. a RecordArena), so they can be released in one
+    // step instead of record by record. resource must outlive the result
+    // and is only used from the calling thread.
+    std::pmr::vector<ArenaTelemetryData> parse_file(const std::string& filename,
+                                                    std::pmr::memory_resource* resource);
+    
     // Parse with callback (for streaming large files)
     void parse_file_streaming(
         const std::string& filename,
         std::function<void(TelemetryData&&)> callback
     );
     
+    // Same, for any callable: records are handed over a batch at a time
+    // internally, so the per-record call can inline
+    template <typename F>
+    void parse_file_streaming(const std::string& filename, F&& callback) {
+        parse_file_batched(filename, [&callback](Span<TelemetryData> batch) {
+            for (auto& data : batch) callback(std::move(data));
+        });
+    }
+    
+    // Stream up to config.batch_size records per call. The span's storage is
+    // reused for the next batch; records may be moved out of it. The file is
+    // read as by parse_file_streaming(): mapped with use_mmap or num_threads
+    // > 1, else through ReadAhead; compressed input streams as it inflates.
+    void parse_file_batched(
+        const std::string& filename,
+        const std::function<void(Span<TelemetryData>)>& on_batch
+    );
+    
     // Parse a single line
-    std::optional<TelemetryData> parse_line(const std::string& line);
+    std::optional<TelemetryData> parse_line(std::string_view line);
     
-    // Parse binary format (custom high-performance format)
+    // Allocation-free variants: vehicle IDs and diagnostic codes are interned
+    // into the parser's string tables and records carry integer handles
+    bool parse_line_compact(std::string_view line, TelemetryRecord& out);
+    std::vector<TelemetryRecord> parse_file_compact(const std::string& filename);
+    
+    // Columnar variants filling a TelemetryBatch directly
+    bool parse_line_into(std::string_view line, TelemetryBatch& batch);
+    TelemetryBatch parse_file_columnar(const std::string& filename);
+    
+    // Stream the file as TelemetryBatches of up to config.batch_size rows.
+    // One batch object is cleared and refilled between calls, so its
+    // dictionary codes stay stable for the whole file.
+    void parse_file_columnar(
+        const std::string& filename,
+        const std::function<void(const TelemetryBatch&)>& on_batch
+    );
+    
+    // Same, into ring slots (batch_ring.h) of up to config.batch_size rows,
+    // published to the ring's sinks as they fill, so sinks run on their own
+    // threads and a slow one only stalls parsing once every slot is in
+    // flight. With num_threads > 1 each worker fills and publishes its own
+    // slots, in file order when preserve_order is set (OrderedPublisher),
+    // else as they fill. Dictionary codes are per slot. A sink error stops
+    // the parse and is thrown here; the caller close()s the ring.
+    void parse_file_columnar(const std::string& filename, BatchRing<TelemetryBatch>& ring);
+    
+    // Interning tables backing TelemetryRecord handles
+    const StringTable& vehicle_ids() const { return vehicle_ids_; }
+    const StringTable& diagnostic_codes() const { return diagnostic_codes_; }
+    
+    // Parse binary format (custom high-performance format, v1 or v2;
+    // see binary_format.h)
     std::vector<TelemetryData> parse_binary(const std::string& filename);
     
     // Parse log format: timestamp|vehicle_id|lat,lon|speed|rpm|fuel|odo|temp|batt|diag
+    // Lines starting with '#' are comments. With has_header, a first
+    // non-comment line that does not start with a digit is skipped as a header.
+    // The file is always mapped; num_threads > 1 parses it in parallel.
     std::vector<TelemetryData> parse_log(const std::string& filename);
+    std::pmr::vector<ArenaTelemetryData> parse_log(const std::string& filename,
+                                                   std::pmr::memory_resource* resource);
+    void parse_log_streaming(
+        const std::string& filename,
+        std::function<void(TelemetryData&&)> callback
+    );
+    
+    // Parse CSV / log text already in memory (e.g. an inline request
+    // payload). A file split at newlines can be parsed piece by piece, on
+    // separate parsers: at_start = false skips the header / leading comment
+    // handling, with the CSV column mapping taken from use_header().
+    std::vector<TelemetryData> parse_string(std::string_view buffer, bool at_start = true);
+    std::vector<TelemetryData> parse_log_string(std::string_view buffer, bool at_start = true);
+    
+    // Map CSV columns from a header line, as if it had started the input
+    void use_header(std::string_view header_line) { parse_header(header_line); }
+    
+    // Decode CSV / log text straight into caller-owned columns. Stops at a
+    // line boundary once the arrays could fill up and returns the bytes
+    // consumed; pass the rest again with at_start = false (the header and
+    // leading comments are only looked for when at_start is set).
+    size_t parse_columns(std::string_view buffer, ColumnArrays& out, bool at_start = true);
+    size_t parse_log_columns(std::string_view buffer, ColumnArrays& out, bool at_start = true);
+    
+    // Follow a growing file like tail -f: complete rows are parsed as they
+    // are appended and handed to callback until options.stop is set. The
+    // consumed offset and any partial trailing line carry over between
+    // reads; truncation or rotation restarts at the top of the new file.
+    void follow_file(
+        const std::string& filename,
+        std::function<void(TelemetryData&&)> callback,
+        const FollowOptions& options = FollowOptions()
+    );
+    void follow_log(
+        const std::string& filename,
+        std::function<void(TelemetryData&&)> callback,
+        const FollowOptions& options = FollowOptions()
+    );
+    
+    // Row-level building blocks (exposed for the benchmark suite).
+    // Sniffs and decodes one timestamp field to Unix milliseconds (see
+    // timestamp.h); 0 if unrecognized.
+    static int64_t parse_timestamp(std::string_view str);
+    
+    // Split line at the configured delimiter; fields view into line
+    void split_line(std::string_view line, std::vector<std::string_view>& fields);
     
     // Get parse statistics
     const ParseStats& get_stats() const { return stats_; }
@@ -88,20 +370,149 @@ private:
     ParserConfig config_;
     ParseStats stats_;
     
-    // Fast string to double conversion
-    double fast_stod(const char* str, size_t len);
+    // Vectorized delimiter/newline finder and its reusable offset buffer
+    StructuralScanner scanner_;
+    std::vector<uint32_t> scan_index_;
     
-    // Fast string to int conversion
-    int fast_stoi(const char* str, size_t len);
+    // Stage timer behind stats_.profile (no-op unless FLEET_PROFILE)
+    StageClock clock_;
     
-    // Parse timestamp
-    int64_t parse_timestamp(const std::string& str);
+    // Map a plain input file, charging the time to the read stage. Nothing
+    // for gzip / zstd (told by the mapped bytes), which is parsed block by
+    // block on one thread as DecompressReader inflates it (decoding
+    // independent members on num_threads) and is never held in memory
+    // whole, nor for a pipe or other non-regular file, which is read
+    // through ReadAhead
+    std::optional<MappedFile> map_input(const std::string& filename);
     
-    // Split line by delimiter (optimized)
-    void split_line(const std::string& line, std::vector<std::string_view>& fields);
+    // Count a rejected row under its reason
+    void reject(RejectReason reason) { stats_.rejected[static_cast<size_t>(reason)]++; }
     
     // Map header to column indices
-    void parse_header(const std::string& header);
+    void parse_header(std::string_view header);
+    
+    // Field layout decode_row() expects: CSV columns mapped from the header,
+    // or the fixed pipe-delimited log layout
+    enum class RowLayout { Csv, Log };
+    void set_layout(RowLayout layout);
+    struct LogLayoutScope;
+    
+    // Consume the CSV header, or the leading comments and optional header of
+    // a log, from the start of buffer; returns the bytes consumed
+    size_t consume_preamble(std::string_view buffer);
+    
+    // Zero-copy view of one decoded row
+    struct DecodedRow {
+        std::string_view vehicle_id;
+        std::string_view diagnostic_code;
+        int64_t timestamp;
+        double latitude;
+        double longitude;
+        double speed;
+        double heading;
+        int engine_rpm;
+        double fuel_level;
+        double odometer_km;
+        double engine_temp;
+        double battery_volt;
+    };
+    
+    // Timestamp decode against the format sniffed from earlier rows
+    int64_t decode_timestamp(std::string_view str);
+    
+    // Test config_.filter on the key columns of a split row; false if the
+    // row is filtered out
+    bool passes_filter(const std::vector<std::string_view>& fields);
+    
+    // Decode an already split row; false if it is filtered out (filtered_
+    // is then set), malformed, or fails validation
+    bool decode_row(const std::vector<std::string_view>& fields, DecodedRow& row);
+    bool decode_csv_fields(const std::vector<std::string_view>& fields, DecodedRow& row);
+    bool decode_log_fields(const std::vector<std::string_view>& fields, DecodedRow& row);
+    bool decode_row(const std::vector<std::string_view>& fields, TelemetryData& out);
+    bool decode_row(const std::vector<std::string_view>& fields, ArenaTelemetryData& out);
+    bool decode_row(const std::vector<std::string_view>& fields, TelemetryRecord& out);
+    
+    // Decode and append to an output container (records are built in
+    // place, so they use the container's allocator)
+    template <typename Records>
+    bool append_row(const std::vector<std::string_view>& fields, Records& out);
+    bool append_row(const std::vector<std::string_view>& fields, TelemetryBatch& out);
+    
+    // Columnar passes append rows unvalidated and check them here a batch at
+    // a time (batch_validator.h), dropping failures and moving them from the
+    // valid to the invalid counters
+    void validate_columns(TelemetryBatch& batch);
+    
+    // Walk an in-memory buffer line by line (mmap path). on_row receives the
+    // split fields of every non-empty data row and returns whether it was valid.
+    template <typename RowFn>
+    void parse_buffer(std::string_view buffer, RowFn&& on_row);
+    
+    // Read a file in buffer_size blocks through ReadAhead (read_ahead.h), or
+    // DecompressReader when the first block is gzip / zstd
+    // (compressed_input.h; regular files only), and parse_blocks() them
+    template <typename RowFn>
+    void parse_read_ahead(const std::string& filename, RowFn&& on_row);
+    // Single-threaded pass over a whole file: mapped and parse_buffer()ed
+    // with config_.use_mmap, else parse_read_ahead(); compressed input and
+    // pipes always take the read path
+    template <typename RowFn>
+    void parse_rows(const std::string& filename, RowFn&& on_row);
+    // parse_buffer() first and then the rest of a source's blocks in order,
+    // carrying rows that straddle two
+    template <typename Source, typename RowFn>
+    void parse_blocks(Source& source, RowFn&& on_row, std::string_view first);
+    
+    // Newline-aligned chunks of a buffer, about four per thread (at least 1 MiB)
+    static std::vector<std::string_view> split_chunks(std::string_view buffer, size_t num_threads);
+    
+    // Split a buffer at newline boundaries and parse the chunks on a thread pool,
+    // each worker appending rows to its own Output. Chunks are handed to
+    // on_chunk(Output&&, const TelemetryParser& worker) on the calling thread,
+    // in file order when config_.preserve_order is set, else as they finish.
+    template <typename Output, typename ChunkFn>
+    void parse_parallel(std::string_view buffer, size_t num_threads, ChunkFn&& on_chunk);
+    
+    // Whole-file parses behind parse_file() / parse_log() / parse_string(),
+    // appending to a std::vector of TelemetryData or a std::pmr::vector of
+    // ArenaTelemetryData
+    template <typename Results>
+    void parse_stream_into(const std::string& filename, Results& results);
+    template <typename Results>
+    void parse_read_into(const std::string& filename, Results& results);
+    template <typename Results>
+    void parse_mapped_into(const std::string& filename, Results& results);
+    template <typename Results>
+    void parse_view_into(std::string_view buffer, Results& results);
+    std::vector<TelemetryData> parse_mapped(const std::string& filename);
+    std::vector<TelemetryData> parse_view(std::string_view buffer);
+    void stream_mapped(const std::string& filename, const std::function<void(TelemetryData&&)>& callback);
+    void stream_read(const std::string& filename, const std::function<void(TelemetryData&&)>& callback);
+    
+    // Incremental loop shared by follow_file() and follow_log()
+    void follow(const std::string& filename, const std::function<void(TelemetryData&&)>& callback,
+                const FollowOptions& options);
+    
+    // Scratch split buffer reused across rows
+    std::vector<std::string_view> fields_;
+    
+    RowLayout layout_ = RowLayout::Csv;
+    TimestampFormat timestamp_format_ = TimestampFormat::Unknown;
+    
+    // config_.filter is set (its vehicle_ids are kept sorted for lookup);
+    // filtered_ tells row loops that the last decode_row() dropped its row
+    // by the filter rather than rejecting it
+    bool filter_active_ = false;
+    bool filtered_ = false;
+    
+    // Interning tables for compact records
+    StringTable vehicle_ids_;
+    StringTable diagnostic_codes_;
+    
+    // Header (or the default mapping) is StandardSchema: rows with exactly
+    // its column count skip the index lookups below (fixed_schema.h)
+    bool standard_schema_ = true;
     
     // Column indices from header
     int col_vehicle_id_ = 0;
@@ -118,27 +529,9 @@ private:
     int col_diagnostic_code_ = 11;
 };
 
-// Binary file format for maximum performance
-class BinaryWriter {
-public:
-    explicit BinaryWriter(const std::string& filename);
-    ~BinaryWriter();
-    
-    void write(const TelemetryData& data);
-    void write_batch(const std::vector<TelemetryData>& data);
-    void flush();
-    
-    size_t records_written() const { return records_written_; }
-
-private:
-    std::ofstream file_;
-    size_t records_written_ = 0;
-    static constexpr uint32_t MAGIC = 0x464C4554;  // "FLET"
-    static constexpr uint8_t VERSION = 1;
-};
-
 // Utility functions
 std::string format_stats(const ParseStats& stats);
+std::string stats_to_json(const ParseStats& stats);  // one-line JSON object
 void benchmark_parser(const std::string& filename, int iterations = 5);
 
 }  // namespace fleet
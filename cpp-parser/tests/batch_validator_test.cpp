@@ -0,0 +1,209 @@
+// Columnar batch validation: validity bitmaps and reject counts against a
+// row-at-a-time reference. The suite is also registered with FLEET_SIMD=scalar
+// (see CMakeLists.txt), so the AVX2 and portable kernels must produce the
+// same bitmaps.
+
+#include "batch_validator.h"
+#include "simd_scanner.h"
+#include "telemetry_batch.h"
+#include "telemetry_parser.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+// Rows of which roughly one in bad_every breaks a random rule, some several
+std::vector<TelemetryData> random_rows(size_t n, unsigned bad_every, unsigned seed) {
+    std::mt19937 rng(seed);
+    auto uniform = [&rng](double lo, double hi) { return std::uniform_real_distribution<double>(lo, hi)(rng); };
+    auto one_in = [&rng](unsigned k) { return rng() % k == 0; };
+
+    std::vector<TelemetryData> rows(n);
+    for (size_t i = 0; i < n; i++) {
+        TelemetryData& r = rows[i];
+        r.vehicle_id = "V" + std::to_string(i % 7);
+        r.timestamp = 1704067200000 + static_cast<int64_t>(i) * 1000;
+        r.latitude = uniform(-90, 90);
+        r.longitude = uniform(-180, 180);
+        r.speed = uniform(0, 140);
+        r.heading = uniform(0, 360);
+        r.engine_rpm = static_cast<int32_t>(rng() % 7000);
+        r.fuel_level = uniform(0, 100);
+        r.odometer_km = uniform(0, 500000);
+        r.engine_temp = uniform(-40, 150);
+        r.battery_volt = uniform(9, 16);
+        if (one_in(5)) r.diagnostic_code = "P0420";
+
+        for (int broken = 0; one_in(bad_every) && broken < 3; broken++) {
+            switch (rng() % 11) {
+                case 0: r.vehicle_id.clear(); break;
+                case 1: r.latitude = one_in(2) ? 90.000001 : -90.5; break;
+                case 2: r.longitude = one_in(2) ? 180.25 : -181; break;
+                case 3: r.speed = -0.001; break;
+                case 4: r.fuel_level = one_in(2) ? 100.000001 : -1e-9; break;
+                case 5: r.engine_rpm = -1; break;
+                case 6: r.engine_temp = one_in(2) ? 150.5 : -41; break;
+                case 7: r.battery_volt = one_in(2) ? 8.99 : 16.01; break;
+                // Exactly on a bound is valid
+                case 8: r.latitude = -90; r.fuel_level = 100; break;
+                case 9: r.longitude = 180; r.speed = 0; break;
+                default: r.engine_rpm = 0; break;
+            }
+        }
+    }
+    return rows;
+}
+
+TelemetryBatch to_batch(const std::vector<TelemetryData>& rows) {
+    TelemetryBatch batch;
+    for (const auto& r : rows) batch.append(r);
+    return batch;
+}
+
+// First rule a row breaks, in the order of the rule lists below
+RejectReason reference_reason(const TelemetryData& r, bool strict) {
+    if (r.vehicle_id.empty()) return RejectReason::MissingVehicleId;
+    if (r.latitude < -90 || r.latitude > 90) return RejectReason::Latitude;
+    if (r.longitude < -180 || r.longitude > 180) return RejectReason::Longitude;
+    if (r.speed < 0) return RejectReason::Speed;
+    if (r.fuel_level < 0 || r.fuel_level > 100) return RejectReason::FuelLevel;
+    if (r.engine_rpm < 0) return RejectReason::EngineRpm;
+    if (strict && (r.engine_temp < -40 || r.engine_temp > 150)) return RejectReason::EngineTemp;
+    if (strict && (r.battery_volt < 9 || r.battery_volt > 16)) return RejectReason::BatteryVolt;
+    return RejectReason::None;
+}
+
+// Bounds wide enough to accept every generated value
+struct Anything {
+    static constexpr double min = -1e9;
+    static constexpr double max = 1e9;
+};
+
+using StrictRules = ValidationRules<VehicleIdRule, LatitudeRule, LongitudeRule, SpeedRule, FuelLevelRule,
+                                    EngineRpmRule, EngineTempRule<>, BatteryVoltRule<>>;
+
+void expect_matches_reference(const std::vector<TelemetryData>& rows, const BatchValidation& result,
+                              bool strict) {
+    ASSERT_EQ(result.rows, rows.size());
+    ASSERT_EQ(result.valid.size(), (rows.size() + 63) / 64);
+    size_t expected[kRejectReasonCount] = {};
+    size_t valid = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+        RejectReason reason = reference_reason(rows[i], strict);
+        if (reason == RejectReason::None) {
+            valid++;
+        } else {
+            expected[static_cast<size_t>(reason)]++;
+        }
+        ASSERT_EQ(result.is_valid(i), reason == RejectReason::None) << "row " << i;
+    }
+    EXPECT_EQ(result.valid_rows, valid);
+    for (size_t i = 0; i < kRejectReasonCount; i++) {
+        EXPECT_EQ(result.rejected[i], expected[i]) << reject_reason_name(static_cast<RejectReason>(i));
+    }
+    // Bits past the last row stay clear
+    if (rows.size() % 64) {
+        EXPECT_EQ(result.valid.back() >> (rows.size() % 64), 0u);
+    }
+}
+
+TEST(BatchValidator, DefaultRulesMatchIsValid) {
+    // Sizes around the 8-row compare and 64-row word boundaries
+    for (size_t n : {0, 1, 5, 7, 8, 9, 63, 64, 65, 100, 127, 128, 129, 1000, 4099}) {
+        SCOPED_TRACE("rows " + std::to_string(n));
+        const auto rows = random_rows(n, 4, static_cast<unsigned>(n));
+        const BatchValidation result = validate_batch(to_batch(rows));
+        expect_matches_reference(rows, result, false);
+        for (size_t i = 0; i < n; i++) {
+            ASSERT_EQ(result.is_valid(i), rows[i].is_valid()) << "row " << i;
+        }
+    }
+}
+
+TEST(BatchValidator, OptInRules) {
+    const auto rows = random_rows(1500, 3, 42);
+    const TelemetryBatch batch = to_batch(rows);
+    const BatchValidation loose = validate_batch(batch);
+    const BatchValidation strict = validate_batch<StrictRules>(batch);
+    expect_matches_reference(rows, strict, true);
+    EXPECT_EQ(loose.rejected_by(RejectReason::EngineTemp), 0u);
+    EXPECT_EQ(loose.rejected_by(RejectReason::BatteryVolt), 0u);
+    EXPECT_GT(strict.rejected_by(RejectReason::EngineTemp), 0u);
+    EXPECT_GT(strict.rejected_by(RejectReason::BatteryVolt), 0u);
+    EXPECT_LT(strict.valid_rows, loose.valid_rows);
+
+    // Custom bounds replace the defaults
+    using Relaxed = ValidationRules<VehicleIdRule, LatitudeRule, LongitudeRule, SpeedRule, FuelLevelRule,
+                                    EngineRpmRule, EngineTempRule<Anything>, BatteryVoltRule<Anything>>;
+    const BatchValidation relaxed = validate_batch<Relaxed>(batch);
+    EXPECT_EQ(relaxed.valid, loose.valid);
+    EXPECT_EQ(relaxed.valid_rows, loose.valid_rows);
+}
+
+TEST(BatchValidator, RejectCountsGoToFirstBrokenRule) {
+    TelemetryData row{};
+    row.vehicle_id = "V1";
+    row.battery_volt = 12;
+    std::vector<TelemetryData> rows(6, row);
+    rows[0].vehicle_id.clear();       // and latitude below
+    rows[0].latitude = -95;
+    rows[1].latitude = 95;            // and speed below
+    rows[1].speed = -1;
+    rows[2].fuel_level = 101;         // and rpm below
+    rows[2].engine_rpm = -5;
+    rows[3].engine_rpm = -5;
+    rows[4].engine_temp = 200;        // only broken under StrictRules
+
+    const TelemetryBatch batch = to_batch(rows);
+    const BatchValidation result = validate_batch(batch);
+    EXPECT_EQ(result.rejected_by(RejectReason::MissingVehicleId), 1u);
+    EXPECT_EQ(result.rejected_by(RejectReason::Latitude), 1u);
+    EXPECT_EQ(result.rejected_by(RejectReason::Speed), 0u);
+    EXPECT_EQ(result.rejected_by(RejectReason::FuelLevel), 1u);
+    EXPECT_EQ(result.rejected_by(RejectReason::EngineRpm), 1u);
+    EXPECT_EQ(result.valid_rows, 2u);
+    EXPECT_EQ(result.valid[0], 0b110000u);
+
+    const BatchValidation strict = validate_batch<StrictRules>(batch);
+    EXPECT_EQ(strict.rejected_by(RejectReason::EngineTemp), 1u);
+    EXPECT_EQ(strict.valid[0], 0b100000u);
+
+    // Only the rules listed run: latitude alone rejects rows 0 and 1
+    const BatchValidation latitude = validate_batch<ValidationRules<LatitudeRule>>(batch);
+    EXPECT_EQ(latitude.rejected_by(RejectReason::Latitude), 2u);
+    EXPECT_EQ(latitude.rejected_by(RejectReason::MissingVehicleId), 0u);
+    EXPECT_EQ(latitude.valid[0], 0b111100u);
+}
+
+TEST(BatchValidator, RetainKeepsValidRowsInOrder) {
+    const auto rows = random_rows(777, 3, 7);
+    TelemetryBatch batch = to_batch(rows);
+    const BatchValidation result = validate_batch(batch);
+    batch.retain(result.valid);
+    ASSERT_EQ(batch.size(), result.valid_rows);
+    size_t kept = 0;
+    for (const auto& r : rows) {
+        if (!r.is_valid()) continue;
+        EXPECT_EQ(batch.timestamp[kept], r.timestamp);
+        EXPECT_EQ(batch.vehicle(kept), r.vehicle_id);
+        kept++;
+    }
+}
+
+TEST(BatchValidator, KernelFollowsSimdOverride) {
+    // Under the FLEET_SIMD=scalar registration the portable kernels run
+    const char* forced = std::getenv("FLEET_SIMD");
+    if (forced && std::strcmp(forced, "scalar") == 0) {
+        EXPECT_EQ(StructuralScanner::detect_kernel(), ScanKernel::Scalar);
+    } else {
+        EXPECT_TRUE(StructuralScanner::kernel_supported(StructuralScanner::detect_kernel()));
+    }
+}
+
+}  // namespace
+}  // namespace fleet
@@ -0,0 +1,218 @@
+// FLET v1 / v2 writer and reader round-trips
+
+#include "binary_format.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+using test::expect_same_records;
+
+std::vector<TelemetryData> sample_records(size_t rows) {
+    TelemetryParser parser;
+    return parser.parse_string(test::make_csv(rows, 16));
+}
+
+void write_records(const std::string& path, const std::vector<TelemetryData>& records,
+                   const BinaryWriterConfig& config) {
+    BinaryWriter writer(path, config);
+    writer.write_batch(records);
+    writer.close();
+    EXPECT_EQ(writer.records_written(), records.size());
+}
+
+TEST(BinaryFormat, V1RoundTrip) {
+    test::TempDir dir;
+    auto records = sample_records(5000);
+    BinaryWriterConfig config;
+    config.version = binary::kVersion1;
+    write_records(dir.file("a.bin"), records, config);
+
+    BinaryReader reader(dir.file("a.bin"));
+    EXPECT_EQ(reader.version(), binary::kVersion1);
+
+    TelemetryParser parser;
+    expect_same_records(parser.parse_binary(dir.file("a.bin")), records);
+}
+
+TEST(BinaryFormat, DefaultsToV1) {
+    test::TempDir dir;
+    write_records(dir.file("a.bin"), sample_records(10), BinaryWriterConfig());
+    EXPECT_EQ(BinaryReader(dir.file("a.bin")).version(), binary::kVersion1);
+
+    BinaryWriterConfig compressed;
+    compressed.codec = binary::Codec::Zlib;
+    EXPECT_THROW(BinaryWriter(dir.file("b.bin"), compressed), std::runtime_error)
+        << "block compression needs an explicit v2";
+}
+
+TEST(BinaryFormat, V2RoundTrip) {
+    test::TempDir dir;
+    auto records = sample_records(10000);
+    BinaryWriterConfig config;
+    config.version = binary::kVersion2;
+    config.block_records = 1000;
+    write_records(dir.file("a.bin"), records, config);
+
+    BinaryReader reader(dir.file("a.bin"));
+    EXPECT_EQ(reader.version(), binary::kVersion2);
+    EXPECT_EQ(reader.record_count(), records.size());
+    EXPECT_EQ(reader.block_count(), 10u);
+    EXPECT_EQ(reader.vehicle_count(), 17u);   // 16 vehicles + code 0
+
+    // Blocks are readable in place and carry their index metadata
+    size_t row = 0;
+    for (size_t b = 0; b < reader.block_count(); b++) {
+        RecordSpan span = reader.block(b);
+        const auto& info = reader.block_info(b);
+        ASSERT_EQ(span.size, info.record_count);
+        for (const auto& r : span) {
+            const auto& expected = records[row++];
+            EXPECT_EQ(reader.vehicle(r.vehicle_id), expected.vehicle_id);
+            EXPECT_EQ(reader.diagnostic(r.diagnostic_code), expected.diagnostic_code);
+            EXPECT_EQ(r.timestamp, expected.timestamp);
+            EXPECT_GE(r.timestamp, info.min_timestamp);
+            EXPECT_LE(r.timestamp, info.max_timestamp);
+        }
+    }
+    EXPECT_EQ(row, records.size());
+
+    TelemetryParser parser;
+    expect_same_records(parser.parse_binary(dir.file("a.bin")), records);
+}
+
+TEST(BinaryFormat, V2CompressedRoundTrip) {
+    for (binary::Codec codec : {binary::Codec::Zlib, binary::Codec::Zstd, binary::Codec::LZ4}) {
+        if (!binary::codec_available(codec)) continue;
+        SCOPED_TRACE(binary::codec_name(codec));
+        test::TempDir dir;
+        auto records = sample_records(6000);
+        BinaryWriterConfig config;
+        config.version = binary::kVersion2;
+        config.codec = codec;
+        config.block_records = 2048;
+        write_records(dir.file("a.bin"), records, config);
+
+        BinaryReader reader(dir.file("a.bin"));
+        BlockBuffer buffer;
+        size_t rows = 0;
+        for (size_t b = 0; b < reader.block_count(); b++) rows += reader.read_block(b, buffer).size;
+        EXPECT_EQ(rows, records.size());
+
+        TelemetryParser parser;
+        expect_same_records(parser.parse_binary(dir.file("a.bin")), records);
+    }
+}
+
+TEST(BinaryFormat, CompactRecordsUseTheirTables) {
+    test::TempDir dir;
+    TelemetryParser parser;
+    const std::string csv = test::make_csv(3000);
+    test::write_file(dir.file("a.csv"), csv);
+    auto compact = parser.parse_file_compact(dir.file("a.csv"));
+    {
+        BinaryWriter writer(dir.file("a.bin"));
+        for (const auto& r : compact) writer.write(r, parser.vehicle_ids(), parser.diagnostic_codes());
+    }
+    TelemetryParser reference;
+    TelemetryParser reader;
+    expect_same_records(reader.parse_binary(dir.file("a.bin")), reference.parse_string(csv));
+}
+
+TEST(BinaryFormat, StreamOutputMatchesFile) {
+    test::TempDir dir;
+    auto records = sample_records(2000);
+    write_records(dir.file("a.bin"), records, BinaryWriterConfig());
+    std::ostringstream out;
+    {
+        BinaryWriter writer(out);
+        writer.write_batch(records);
+    }
+    EXPECT_EQ(out.str(), test::read_file(dir.file("a.bin")));
+}
+
+TEST(BinaryFormat, FilterSkipsBlocks) {
+    test::TempDir dir;
+    auto records = sample_records(8000);
+    BinaryWriterConfig config;
+    config.version = binary::kVersion2;
+    config.block_records = 1000;
+    write_records(dir.file("a.bin"), records, config);
+
+    ParserConfig parser_config;
+    parser_config.filter.min_timestamp = records[7500].timestamp;
+    TelemetryParser parser(parser_config);
+    auto kept = parser.parse_binary(dir.file("a.bin"));
+    EXPECT_EQ(kept.size(), 500u);
+    EXPECT_EQ(parser.get_stats().skipped_blocks, 7u);
+}
+
+TEST(BinaryFormat, RejectsForeignFiles) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.bin"), "not a binary file at all");
+    EXPECT_THROW(BinaryReader(dir.file("a.bin")), std::runtime_error);
+}
+
+// Overwrite a field of a valid v2 image and expect the reader to refuse it
+template <typename T>
+void expect_rejected(const std::string& image, size_t offset, T value, const char* what) {
+    SCOPED_TRACE(what);
+    test::TempDir dir;
+    std::string bad = image;
+    std::memcpy(&bad[offset], &value, sizeof(value));
+    test::write_file(dir.file("bad.bin"), bad);
+    EXPECT_THROW(BinaryReader(dir.file("bad.bin")), std::runtime_error);
+}
+
+TEST(BinaryFormat, RejectsOutOfBoundsSections) {
+    test::TempDir dir;
+    BinaryWriterConfig config;
+    config.version = binary::kVersion2;
+    config.block_records = 100;
+    write_records(dir.file("a.bin"), sample_records(300), config);
+    const std::string image = test::read_file(dir.file("a.bin"));
+    ASSERT_NO_THROW(BinaryReader(dir.file("a.bin")));
+
+    binary::FileTrailer trailer;
+    const size_t trailer_at = image.size() - sizeof(trailer);
+    std::memcpy(&trailer, image.data() + trailer_at, sizeof(trailer));
+    const uint64_t huge = uint64_t(1) << 62;
+    const uint64_t past_end = (image.size() + 8) & ~uint64_t(7);
+
+    expect_rejected(image, trailer_at + offsetof(binary::FileTrailer, index_offset), past_end,
+                    "index after the trailer");
+    expect_rejected(image, trailer_at + offsetof(binary::FileTrailer, index_offset), huge,
+                    "index far past the end");
+    expect_rejected(image, trailer_at + offsetof(binary::FileTrailer, vehicle_dict_offset), past_end,
+                    "vehicle dictionary past the end");
+    expect_rejected(image, trailer_at + offsetof(binary::FileTrailer, diagnostic_dict_offset),
+                    trailer.index_offset + 8, "diagnostic dictionary after the index");
+    expect_rejected(image, trailer_at + offsetof(binary::FileTrailer, block_count), uint32_t(0xFFFFFFFF),
+                    "block count overruns the index");
+
+    const size_t entry_at = trailer.index_offset + sizeof(binary::BlockIndexEntry);
+    expect_rejected(image, entry_at + offsetof(binary::BlockIndexEntry, offset), huge,
+                    "block far past the end");
+    expect_rejected(image, entry_at + offsetof(binary::BlockIndexEntry, offset), trailer.vehicle_dict_offset,
+                    "block header inside the dictionaries");
+    expect_rejected(image, entry_at + offsetof(binary::BlockIndexEntry, payload_bytes), huge,
+                    "payload past the end");
+    expect_rejected(image, entry_at + offsetof(binary::BlockIndexEntry, record_count), uint32_t(1000),
+                    "more records than a block holds");
+
+    // Cut anywhere before the trailer
+    for (size_t keep : {size_t(0), size_t(64), image.size() / 2, image.size() - 1}) {
+        test::write_file(dir.file("cut.bin"), image.substr(0, keep));
+        EXPECT_THROW(BinaryReader(dir.file("cut.bin")), std::runtime_error) << keep << " bytes";
+    }
+}
+
+}  // namespace
+}  // namespace fleet
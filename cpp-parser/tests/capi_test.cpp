@@ -0,0 +1,128 @@
+// C API (fleet_capi.h) against the C++ parser
+
+#include "fleet_capi.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+struct Columns {
+    explicit Columns(size_t n)
+        : timestamp(n), latitude(n), longitude(n), speed(n), heading(n), engine_rpm(n), fuel_level(n),
+          odometer_km(n), engine_temp(n), battery_volt(n), vehicle_id(n), diagnostic_code(n) {
+        out.capacity = n;
+        out.size = 0;
+        out.timestamp = timestamp.data();
+        out.latitude = latitude.data();
+        out.longitude = longitude.data();
+        out.speed = speed.data();
+        out.heading = heading.data();
+        out.engine_rpm = engine_rpm.data();
+        out.fuel_level = fuel_level.data();
+        out.odometer_km = odometer_km.data();
+        out.engine_temp = engine_temp.data();
+        out.battery_volt = battery_volt.data();
+        out.vehicle_id = vehicle_id.data();
+        out.diagnostic_code = diagnostic_code.data();
+    }
+    std::vector<int64_t> timestamp;
+    std::vector<double> latitude, longitude, speed, heading;
+    std::vector<int32_t> engine_rpm;
+    std::vector<double> fuel_level, odometer_km, engine_temp, battery_volt;
+    std::vector<uint32_t> vehicle_id, diagnostic_code;
+    fleet_columns out;
+};
+
+std::string_view dictionary_entry(const char* data, size_t length) { return std::string_view(data, length); }
+
+TEST(CApi, ParsesIntoCallerColumns) {
+    const std::string csv = test::make_csv(2000, 8, 50);
+    TelemetryParser reference;
+    auto expected = reference.parse_string(csv);
+
+    fleet_parser* parser = fleet_parser_create(nullptr);
+    ASSERT_NE(parser, nullptr);
+    Columns columns(fleet_row_capacity(csv.data(), csv.size()));
+    size_t consumed = 0;
+    ASSERT_EQ(fleet_parse(parser, csv.data(), csv.size(), 1, &columns.out, &consumed), 0)
+        << fleet_last_error(parser);
+    EXPECT_EQ(consumed, csv.size());
+    ASSERT_EQ(columns.out.size, expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        size_t length = 0;
+        const char* vehicle = fleet_vehicle(parser, columns.vehicle_id[i], &length);
+        EXPECT_EQ(dictionary_entry(vehicle, length), expected[i].vehicle_id);
+        const char* code = fleet_diagnostic(parser, columns.diagnostic_code[i], &length);
+        EXPECT_EQ(dictionary_entry(code, length), expected[i].diagnostic_code);
+        EXPECT_EQ(columns.timestamp[i], expected[i].timestamp);
+        EXPECT_EQ(columns.latitude[i], expected[i].latitude);
+        EXPECT_EQ(columns.speed[i], expected[i].speed);
+        EXPECT_EQ(columns.engine_rpm[i], expected[i].engine_rpm);
+        EXPECT_EQ(columns.battery_volt[i], expected[i].battery_volt);
+    }
+    EXPECT_EQ(fleet_vehicle_count(parser), 9u);
+
+    fleet_stats stats;
+    fleet_get_stats(parser, &stats);
+    EXPECT_EQ(stats.valid_records, expected.size());
+    EXPECT_EQ(stats.invalid_records, reference.get_stats().invalid_records);
+
+    fleet_parser_reset(parser);
+    fleet_get_stats(parser, &stats);
+    EXPECT_EQ(stats.valid_records, 0u);
+    EXPECT_EQ(fleet_vehicle_count(parser), 1u);
+    fleet_parser_destroy(parser);
+}
+
+TEST(CApi, ResumesAtLineBoundary) {
+    const std::string csv = test::make_csv(100);
+    fleet_parser* parser = fleet_parser_create(nullptr);
+    Columns columns(40);
+    size_t total = 0;
+    size_t offset = 0;
+    int at_start = 1;
+    while (offset < csv.size()) {
+        columns.out.size = 0;
+        size_t consumed = 0;
+        ASSERT_EQ(fleet_parse(parser, csv.data() + offset, csv.size() - offset, at_start, &columns.out, &consumed), 0);
+        ASSERT_GT(consumed, 0u);
+        EXPECT_EQ(csv[offset + consumed - 1], '\n');
+        total += columns.out.size;
+        offset += consumed;
+        at_start = 0;
+    }
+    EXPECT_EQ(total, 100u);
+    fleet_parser_destroy(parser);
+}
+
+TEST(CApi, LogFormatOption) {
+    fleet_options options;
+    fleet_options_init(&options);
+    options.format = FLEET_FORMAT_LOG;
+    fleet_parser* parser = fleet_parser_create(&options);
+    const std::string log = "1704067200000|V1|28.5,-81.3|50|2000|60|100|90|12.5|P0420\n";
+    Columns columns(4);
+    ASSERT_EQ(fleet_parse(parser, log.data(), log.size(), 1, &columns.out, nullptr), 0);
+    ASSERT_EQ(columns.out.size, 1u);
+    size_t length = 0;
+    const char* code = fleet_diagnostic(parser, columns.diagnostic_code[0], &length);
+    EXPECT_EQ(dictionary_entry(code, length), "P0420");
+    EXPECT_EQ(std::string(fleet_last_error(parser)), "");
+    fleet_parser_destroy(parser);
+}
+
+TEST(CApi, RejectsBadArguments) {
+    fleet_parser* parser = fleet_parser_create(nullptr);
+    EXPECT_EQ(fleet_parse(parser, "x", 1, 1, nullptr, nullptr), -1);
+    EXPECT_STRNE(fleet_last_error(parser), "");
+    fleet_parser_destroy(parser);
+    EXPECT_STRNE(fleet_version(), "");
+}
+
+}  // namespace
+}  // namespace fleet
@@ -0,0 +1,498 @@
+// ColumnarWriter round trips through minimal in-tree Arrow IPC and Parquet
+// readers. They decode only what the writer produces (flat columns,
+// uncompressed pages) but check the layout rules other engines rely on.
+
+#include "columnar_export.h"
+#include "telemetry_batch.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+const std::vector<std::string> kColumnNames = {
+    "vehicle_id", "timestamp", "latitude", "longitude", "speed", "heading", "engine_rpm",
+    "fuel_level", "odometer_km", "engine_temp", "battery_volt", "diagnostic_code",
+};
+
+// Bounds-checked little-endian reads from a file image
+struct Bytes {
+    std::string_view data;
+
+    void need(uint64_t pos, uint64_t size) const {
+        if (pos > data.size() || size > data.size() - pos) throw std::runtime_error("read past the end");
+    }
+    template <typename T>
+    T get(uint64_t pos) const {
+        need(pos, sizeof(T));
+        T value;
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        return value;
+    }
+    std::string_view slice(uint64_t pos, uint64_t size) const {
+        need(pos, size);
+        return data.substr(pos, size);
+    }
+};
+
+// ============================================================================
+// Arrow IPC file
+// ============================================================================
+
+// A flatbuffer table at pos in bytes
+struct FlatTable {
+    Bytes bytes;
+    uint64_t pos;
+
+    static FlatTable root(Bytes bytes) { return {bytes, bytes.get<uint32_t>(0)}; }
+
+    uint16_t field(uint16_t id) const {
+        const uint64_t vtable = pos - bytes.get<int32_t>(pos);
+        if (4 + 2u * id >= bytes.get<uint16_t>(vtable)) return 0;
+        return bytes.get<uint16_t>(vtable + 4 + 2u * id);
+    }
+    template <typename T>
+    T scalar(uint16_t id, T fallback = T()) const {
+        const uint16_t at = field(id);
+        return at ? bytes.get<T>(pos + at) : fallback;
+    }
+    FlatTable table(uint16_t id) const {
+        const uint64_t at = pos + field(id);
+        if (!field(id)) throw std::runtime_error("missing table field");
+        return {bytes, at + bytes.get<uint32_t>(at)};
+    }
+    // (count, position of the first element) of a vector field
+    std::pair<uint32_t, uint64_t> vector(uint16_t id) const {
+        if (!field(id)) return {0, 0};
+        const uint64_t at = pos + field(id);
+        const uint64_t start = at + bytes.get<uint32_t>(at);
+        return {bytes.get<uint32_t>(start), start + 4};
+    }
+    std::string_view string(uint16_t id) const {
+        auto [length, start] = vector(id);
+        return bytes.slice(start, length);
+    }
+};
+
+struct ArrowFile {
+    std::vector<TelemetryData> rows;
+    std::vector<std::string> schema;
+    size_t record_batches = 0;
+    size_t dictionary_batches = 0;
+    size_t delta_batches = 0;
+};
+
+// Read the stream part front to back, as a stream reader would: every
+// dictionary must be defined before a record batch uses its codes
+ArrowFile read_arrow(const std::string& image) {
+    const Bytes file{image};
+    if (file.slice(0, 6) != "ARROW1" || file.slice(image.size() - 6, 6) != "ARROW1") {
+        throw std::runtime_error("not an Arrow file");
+    }
+
+    ArrowFile out;
+    std::map<int64_t, std::vector<std::string>> dictionaries;
+    std::vector<int64_t> dictionary_offsets;
+    std::vector<int64_t> batch_offsets;
+
+    // utf8 column of a RecordBatch table: offsets buffer, then bytes buffer
+    auto strings = [&](const FlatTable& batch, uint64_t body, size_t buffer) {
+        auto [count, nodes] = batch.vector(1);
+        auto [buffer_count, buffers] = batch.vector(2);
+        if (count != 1 || buffer_count != 3) throw std::runtime_error("bad dictionary batch");
+        const auto length = static_cast<size_t>(file.get<int64_t>(nodes));
+        const uint64_t offsets = body + file.get<int64_t>(buffers + 16 * buffer);
+        const uint64_t data = body + file.get<int64_t>(buffers + 16 * (buffer + 1));
+        std::vector<std::string> values;
+        for (size_t i = 0; i < length; i++) {
+            const auto lo = file.get<int32_t>(offsets + 4 * i);
+            const auto hi = file.get<int32_t>(offsets + 4 * (i + 1));
+            values.emplace_back(file.slice(data + lo, hi - lo));
+        }
+        return values;
+    };
+
+    uint64_t pos = 8;
+    for (;;) {
+        const int64_t message_offset = static_cast<int64_t>(pos);
+        if (file.get<uint32_t>(pos) != 0xFFFFFFFF) throw std::runtime_error("missing continuation marker");
+        const auto length = file.get<int32_t>(pos + 4);
+        if (length == 0) break;   // end of stream
+        const FlatTable message = FlatTable::root(Bytes{file.slice(pos + 8, length)});
+        const uint64_t body = pos + 8 + length;
+        const auto body_length = message.scalar<int64_t>(3);
+        EXPECT_EQ(message.scalar<int16_t>(0), 4) << "metadata V5";
+        pos = body + body_length;
+
+        // Tables inside the message resolve against the message bytes
+        const FlatTable header = message.table(2);
+        const uint64_t base = message_offset + 8;
+        auto in_file = [&](const FlatTable& t) { return FlatTable{file, base + t.pos}; };
+
+        switch (message.scalar<uint8_t>(1)) {
+            case 1: {   // Schema
+                auto [count, fields] = header.vector(1);
+                for (uint32_t i = 0; i < count; i++) {
+                    const uint64_t at = fields + 4 * i;
+                    const FlatTable field = in_file(FlatTable{header.bytes, at + header.bytes.get<uint32_t>(at)});
+                    out.schema.emplace_back(field.string(0));
+                }
+                break;
+            }
+            case 2: {   // DictionaryBatch
+                const int64_t id = header.scalar<int64_t>(0);
+                const bool delta = header.scalar<uint8_t>(2) != 0;
+                std::vector<std::string> values = strings(in_file(header.table(1)), body, 1);
+                if (delta) {
+                    if (!dictionaries.count(id)) throw std::runtime_error("delta before its dictionary");
+                    dictionaries[id].insert(dictionaries[id].end(), values.begin(), values.end());
+                    out.delta_batches++;
+                } else {
+                    if (dictionaries.count(id)) throw std::runtime_error("dictionary replaced");
+                    dictionaries[id] = std::move(values);
+                }
+                out.dictionary_batches++;
+                dictionary_offsets.push_back(message_offset);
+                break;
+            }
+            case 3: {   // RecordBatch
+                const FlatTable batch = in_file(header);
+                const auto rows = static_cast<size_t>(batch.scalar<int64_t>(0));
+                auto [node_count, nodes] = batch.vector(1);
+                auto [buffer_count, buffers] = batch.vector(2);
+                if (node_count != kColumnNames.size() || buffer_count != 2 * kColumnNames.size()) {
+                    throw std::runtime_error("bad record batch");
+                }
+                auto values = [&](size_t column) {
+                    return body + file.get<int64_t>(buffers + 16 * (2 * column + 1));
+                };
+                auto valid = [&](size_t column, size_t row) {
+                    if (file.get<int64_t>(nodes + 16 * column + 8) == 0) return true;
+                    const uint64_t bitmap = body + file.get<int64_t>(buffers + 16 * (2 * column));
+                    return (file.get<uint8_t>(bitmap + row / 8) >> (row % 8) & 1) != 0;
+                };
+                auto lookup = [&](int64_t id, uint32_t code) -> const std::string& {
+                    auto it = dictionaries.find(id);
+                    if (it == dictionaries.end() || code >= it->second.size()) {
+                        throw std::runtime_error("record batch before its dictionary entries");
+                    }
+                    return it->second[code];
+                };
+                for (size_t r = 0; r < rows; r++) {
+                    TelemetryData row{};
+                    row.vehicle_id = lookup(0, file.get<uint32_t>(values(0) + 4 * r));
+                    row.timestamp = file.get<int64_t>(values(1) + 8 * r);
+                    row.latitude = file.get<double>(values(2) + 8 * r);
+                    row.longitude = file.get<double>(values(3) + 8 * r);
+                    row.speed = file.get<double>(values(4) + 8 * r);
+                    row.heading = file.get<double>(values(5) + 8 * r);
+                    row.engine_rpm = file.get<int32_t>(values(6) + 4 * r);
+                    row.fuel_level = file.get<double>(values(7) + 8 * r);
+                    row.odometer_km = file.get<double>(values(8) + 8 * r);
+                    row.engine_temp = file.get<double>(values(9) + 8 * r);
+                    row.battery_volt = file.get<double>(values(10) + 8 * r);
+                    if (valid(11, r)) row.diagnostic_code = lookup(1, file.get<uint32_t>(values(11) + 4 * r));
+                    out.rows.push_back(std::move(row));
+                }
+                out.record_batches++;
+                batch_offsets.push_back(message_offset);
+                break;
+            }
+            default:
+                throw std::runtime_error("unknown message type");
+        }
+    }
+
+    // The footer lists the same messages, in stream order
+    const auto footer_length = file.get<int32_t>(image.size() - 10);
+    const uint64_t footer_start = image.size() - 10 - footer_length;
+    const FlatTable footer = FlatTable::root(Bytes{file.slice(footer_start, footer_length)});
+    auto blocks = [&](uint16_t id) {
+        auto [count, start] = footer.vector(id);
+        std::vector<int64_t> offsets;
+        for (uint32_t i = 0; i < count; i++) offsets.push_back(footer.bytes.get<int64_t>(start + 24 * i));
+        return offsets;
+    };
+    EXPECT_EQ(blocks(2), dictionary_offsets);
+    EXPECT_EQ(blocks(3), batch_offsets);
+    return out;
+}
+
+// ============================================================================
+// Parquet file
+// ============================================================================
+
+// A decoded thrift compact value: integer, binary, list or struct
+struct Thrift {
+    int64_t i = 0;
+    std::string binary;
+    std::vector<Thrift> list;
+    std::map<int16_t, Thrift> fields;
+
+    const Thrift& operator[](int16_t id) const {
+        auto it = fields.find(id);
+        if (it == fields.end()) throw std::runtime_error("missing thrift field " + std::to_string(id));
+        return it->second;
+    }
+    bool has(int16_t id) const { return fields.count(id) != 0; }
+};
+
+class ThriftReader {
+public:
+    ThriftReader(Bytes bytes, uint64_t pos) : bytes_(bytes), pos_(pos) {}
+
+    uint64_t pos() const { return pos_; }
+
+    Thrift read_struct() {
+        Thrift out;
+        int16_t last = 0;
+        for (;;) {
+            const uint8_t byte = bytes_.get<uint8_t>(pos_++);
+            if (byte == 0) return out;
+            const uint8_t type = byte & 0x0F;
+            const int16_t id = (byte >> 4) ? static_cast<int16_t>(last + (byte >> 4))
+                                           : static_cast<int16_t>(unzigzag(varint()));
+            out.fields[id] = read_value(type);
+            last = id;
+        }
+    }
+
+private:
+    Thrift read_value(uint8_t type) {
+        Thrift value;
+        switch (type) {
+            case 1: value.i = 1; break;   // true
+            case 2: value.i = 0; break;   // false
+            case 3: value.i = static_cast<int8_t>(bytes_.get<uint8_t>(pos_++)); break;
+            case 4: case 5: case 6: value.i = unzigzag(varint()); break;
+            case 7: value.i = bytes_.get<int64_t>(pos_); pos_ += 8; break;
+            case 8: {
+                const uint64_t length = varint();
+                value.binary = std::string(bytes_.slice(pos_, length));
+                pos_ += length;
+                break;
+            }
+            case 9: {
+                const uint8_t header = bytes_.get<uint8_t>(pos_++);
+                uint64_t size = header >> 4;
+                if (size == 15) size = varint();
+                for (uint64_t i = 0; i < size; i++) value.list.push_back(read_value(header & 0x0F));
+                break;
+            }
+            case 12: value = read_struct(); break;
+            default: throw std::runtime_error("unsupported thrift type");
+        }
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            const uint8_t byte = bytes_.get<uint8_t>(pos_++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
+    static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    Bytes bytes_;
+    uint64_t pos_;
+};
+
+// n values of the RLE / bit-packing hybrid encoding starting at pos
+std::vector<uint32_t> decode_hybrid(Bytes bytes, uint64_t pos, size_t n, int bit_width) {
+    std::vector<uint32_t> values;
+    while (values.size() < n) {
+        uint64_t header = 0;
+        for (int shift = 0;; shift += 7) {
+            const uint8_t byte = bytes.get<uint8_t>(pos++);
+            header |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        if (header & 1) {
+            const size_t count = (header >> 1) * 8;
+            uint64_t bits = 0;
+            int filled = 0;
+            for (size_t i = 0; i < count; i++) {
+                while (filled < bit_width) {
+                    bits |= static_cast<uint64_t>(bytes.get<uint8_t>(pos++)) << filled;
+                    filled += 8;
+                }
+                if (values.size() < n) values.push_back(static_cast<uint32_t>(bits & ((1ull << bit_width) - 1)));
+                bits >>= bit_width;
+                filled -= bit_width;
+            }
+        } else {
+            uint32_t value = 0;
+            for (int b = 0; b < (bit_width + 7) / 8; b++) value |= static_cast<uint32_t>(bytes.get<uint8_t>(pos++)) << (8 * b);
+            values.insert(values.end(), std::min<size_t>(header >> 1, n - values.size()), value);
+        }
+    }
+    return values;
+}
+
+struct ParquetFile {
+    std::vector<TelemetryData> rows;
+    std::vector<std::string> schema;
+    size_t row_groups = 0;
+};
+
+// One column chunk of an uncompressed file, as PLAIN bytes per row (empty
+// for nulls)
+std::vector<std::string> read_parquet_column(Bytes file, const Thrift& meta, size_t value_size, bool nullable) {
+    EXPECT_EQ(meta[4].i, 0) << "uncompressed";
+    const auto num_values = static_cast<size_t>(meta[5].i);
+    uint64_t pos = static_cast<uint64_t>(meta.has(11) ? meta[11].i : meta[9].i);
+    std::vector<std::string> dictionary;
+    std::vector<std::string> out;
+    while (out.size() < num_values) {
+        ThriftReader reader(file, pos);
+        const Thrift page = reader.read_struct();
+        const uint64_t data = reader.pos();
+        pos = data + page[3].i;
+        if (page[1].i == 2) {   // dictionary page: PLAIN byte arrays
+            uint64_t at = data;
+            for (int64_t i = 0; i < page[7][1].i; i++) {
+                const auto length = file.get<uint32_t>(at);
+                dictionary.emplace_back(file.slice(at + 4, length));
+                at += 4 + length;
+            }
+            continue;
+        }
+        const auto count = static_cast<size_t>(page[5][1].i);
+        uint64_t at = data;
+        std::vector<uint32_t> present(count, 1);
+        if (nullable) {
+            present = decode_hybrid(file, at + 4, count, 1);
+            at += 4 + file.get<uint32_t>(at);
+        }
+        size_t non_null = 0;
+        for (uint32_t p : present) non_null += p;
+        std::vector<std::string> values;
+        if (page[5][2].i == 2) {   // PLAIN_DICTIONARY indices
+            const int width = file.get<uint8_t>(at);
+            for (uint32_t index : decode_hybrid(file, at + 1, non_null, width)) values.push_back(dictionary.at(index));
+        } else {
+            for (size_t i = 0; i < non_null; i++) values.emplace_back(file.slice(at + i * value_size, value_size));
+        }
+        size_t next = 0;
+        for (uint32_t p : present) out.push_back(p ? values[next++] : std::string());
+    }
+    return out;
+}
+
+ParquetFile read_parquet(const std::string& image) {
+    const Bytes file{image};
+    if (file.slice(0, 4) != "PAR1" || file.slice(image.size() - 4, 4) != "PAR1") {
+        throw std::runtime_error("not a Parquet file");
+    }
+    const auto length = file.get<uint32_t>(image.size() - 8);
+    const Thrift meta = ThriftReader(file, image.size() - 8 - length).read_struct();
+
+    ParquetFile out;
+    for (size_t i = 1; i < meta[2].list.size(); i++) out.schema.push_back(meta[2].list[i][4].binary);
+
+    const size_t sizes[] = {0, 8, 8, 8, 8, 8, 4, 8, 8, 8, 8, 0};
+    for (const Thrift& group : meta[4].list) {
+        std::vector<std::vector<std::string>> columns;
+        for (size_t c = 0; c < group[1].list.size(); c++) {
+            columns.push_back(read_parquet_column(file, group[1].list[c][3], sizes[c], c == 11));
+        }
+        for (size_t r = 0; r < static_cast<size_t>(group[3].i); r++) {
+            auto value = [&](size_t c, auto& field) { std::memcpy(&field, columns[c][r].data(), sizeof(field)); };
+            TelemetryData row{};
+            row.vehicle_id = columns[0][r];
+            value(1, row.timestamp);
+            value(2, row.latitude);
+            value(3, row.longitude);
+            value(4, row.speed);
+            value(5, row.heading);
+            value(6, row.engine_rpm);
+            value(7, row.fuel_level);
+            value(8, row.odometer_km);
+            value(9, row.engine_temp);
+            value(10, row.battery_volt);
+            row.diagnostic_code = columns[11][r];
+            out.rows.push_back(std::move(row));
+        }
+        out.row_groups++;
+    }
+    EXPECT_EQ(meta[3].i, static_cast<int64_t>(out.rows.size()));
+    return out;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+// Rows whose vehicles and codes keep appearing across row groups, so later
+// groups add dictionary entries
+std::vector<TelemetryData> sample_rows(size_t rows) {
+    TelemetryParser parser;
+    std::vector<TelemetryData> out;
+    for (auto& r : parser.parse_string(test::make_csv(rows, 64))) {
+        const size_t i = out.size();
+        r.vehicle_id += "/" + std::to_string(i / 2500);
+        if (i % 7 == 0) r.diagnostic_code = "C" + std::to_string(i / 300);
+        out.push_back(r);
+    }
+    return out;
+}
+
+std::string export_rows(const test::TempDir& dir, ExportFormat format, const std::vector<TelemetryData>& rows,
+                        size_t group_rows) {
+    const std::string path = dir.file(std::string("out.") + export_format_name(format));
+    ColumnarExportConfig config;
+    config.row_group_rows = group_rows;
+    config.page_rows = 700;
+    ColumnarWriter writer(path, format, config);
+    TelemetryBatch batch;
+    for (size_t i = 0; i < rows.size(); i++) {
+        batch.append(rows[i]);
+        if (batch.size() == 333 || i + 1 == rows.size()) {
+            writer.write(batch);
+            batch.clear();
+        }
+    }
+    writer.close();
+    EXPECT_EQ(writer.rows_written(), rows.size());
+    return test::read_file(path);
+}
+
+TEST(ColumnarExport, ArrowDictionariesPrecedeRecordBatches) {
+    test::TempDir dir;
+    const auto rows = sample_rows(10000);
+    ArrowFile file = read_arrow(export_rows(dir, ExportFormat::Arrow, rows, 1000));
+    EXPECT_EQ(file.schema, kColumnNames);
+    EXPECT_EQ(file.record_batches, 10u);
+    EXPECT_GT(file.delta_batches, 0u) << "later batches add vehicles and codes";
+    EXPECT_EQ(file.dictionary_batches, 2 + file.delta_batches);
+    test::expect_same_records(file.rows, rows);
+}
+
+TEST(ColumnarExport, ArrowWithoutRows) {
+    test::TempDir dir;
+    ArrowFile file = read_arrow(export_rows(dir, ExportFormat::Arrow, {}, 1000));
+    EXPECT_EQ(file.schema, kColumnNames);
+    EXPECT_EQ(file.record_batches, 0u);
+    EXPECT_EQ(file.dictionary_batches, 2u);
+    EXPECT_TRUE(file.rows.empty());
+}
+
+TEST(ColumnarExport, ParquetRoundTrip) {
+    test::TempDir dir;
+    const auto rows = sample_rows(10000);
+    ParquetFile file = read_parquet(export_rows(dir, ExportFormat::Parquet, rows, 3000));
+    EXPECT_EQ(file.schema, kColumnNames);
+    EXPECT_EQ(file.row_groups, 4u);
+    test::expect_same_records(file.rows, rows);
+}
+
+}  // namespace
+}  // namespace fleet
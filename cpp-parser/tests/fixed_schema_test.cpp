@@ -0,0 +1,126 @@
+// StandardSchema's unrolled decode must give the same rows and reject
+// counts as the dynamic column-map path it replaces. The same rows are
+// parsed under the standard header (fixed path) and with their columns
+// permuted under a matching reordered header, which must fall back.
+
+#include "fixed_schema.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+std::vector<std::string_view> split(std::string_view line) {
+    std::vector<std::string_view> out;
+    size_t start = 0;
+    for (size_t comma; (comma = line.find(',', start)) != std::string_view::npos; start = comma + 1) {
+        out.push_back(line.substr(start, comma - start));
+    }
+    out.push_back(line.substr(start));
+    return out;
+}
+
+// Every line of csv (header included) with its fields reordered so that
+// output field i is input field order[i]
+std::string permute(const std::string& csv, const std::vector<size_t>& order) {
+    std::string out;
+    size_t start = 0;
+    while (start < csv.size()) {
+        size_t nl = csv.find('\n', start);
+        std::vector<std::string_view> fields = split(std::string_view(csv).substr(start, nl - start));
+        EXPECT_EQ(fields.size(), order.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            if (i) out += ',';
+            out += fields[order[i]];
+        }
+        out += '\n';
+        start = nl + 1;
+    }
+    return out;
+}
+
+void expect_same_stats(const ParseStats& a, const ParseStats& b) {
+    EXPECT_EQ(a.total_lines, b.total_lines);
+    EXPECT_EQ(a.valid_records, b.valid_records);
+    EXPECT_EQ(a.invalid_records, b.invalid_records);
+    EXPECT_EQ(a.malformed_records, b.malformed_records);
+    for (size_t i = 0; i < kRejectReasonCount; i++) {
+        EXPECT_EQ(a.rejected[i], b.rejected[i]) << reject_reason_name(static_cast<RejectReason>(i));
+    }
+}
+
+// Rows that stress the field decoders: malformed and non-finite numbers,
+// empty fields, padding, out-of-range values and timestamp forms
+std::string tricky_rows() {
+    return "V1,1704067200000,28.5,-81.3,50,90,2000,50,1000,90,12.5,\n"
+           "V2,2024-01-01T00:00:01Z, 28.5 ,-81.3,50.25,90,2000,50,1000,90,12.5,P0420\n"
+           "V3,1704067202,28.5x,-81.3,50,90,2000,50,1000,90,12.5,\n"
+           "V4,1704067203000,28.5,-81.3,nan,90,2000,50,1000,90,12.5,\n"
+           "V5,1704067204000,28.5,-81.3,50,,2000,50,1000,90,12.5,\n"
+           "V6,1704067205000,28.5,-81.3,50,90,20.5,50,1000,90,12.5,\n"
+           ",1704067206000,28.5,-81.3,50,90,2000,50,1000,90,12.5,\n"
+           "V8,1704067207000,91,-81.3,50,90,2000,50,1000,90,12.5,\n"
+           "V9,1704067208000,28.5,-181,50,90,2000,50,1000,90,12.5,\n"
+           "V10,1704067209000,28.5,-81.3,-1,90,2000,101,1000,90,12.5,\n"
+           "V11,not-a-time,28.5,-81.3,50,90,-5,50,1000,90,12.5,\n"
+           "V12,1704067211000,1e1,-8.13e1,5E1,90,+2000,50,1000,-40,12.5,C1\n";
+}
+
+TEST(FixedSchema, MatchesOnlyTheExactColumnOrder) {
+    std::string header(test::kCsvHeader);
+    header.pop_back();
+    EXPECT_TRUE(StandardSchema::matches(split(header)));
+    EXPECT_TRUE(StandardSchema::matches(split("VEHICLE_ID,Timestamp,latitude,longitude,speed,heading,"
+                                              "engine_rpm,fuel_level,odometer_km,engine_temp,battery_volt,"
+                                              "Diagnostic_Code")));
+    EXPECT_FALSE(StandardSchema::matches(split("timestamp,vehicle_id,latitude,longitude,speed,heading,"
+                                               "engine_rpm,fuel_level,odometer_km,engine_temp,battery_volt,"
+                                               "diagnostic_code")));
+    EXPECT_FALSE(StandardSchema::matches(split(header + ",extra")));
+    EXPECT_FALSE(StandardSchema::matches(split(header.substr(0, header.rfind(',')))));
+    EXPECT_FALSE(StandardSchema::matches(split("vehicle_id ,timestamp,latitude,longitude,speed,heading,"
+                                               "engine_rpm,fuel_level,odometer_km,engine_temp,battery_volt,"
+                                               "diagnostic_code")));
+}
+
+TEST(FixedSchema, DecodeMatchesColumnMap) {
+    const std::string csv = test::make_csv(3000, 16, 41) + tricky_rows();
+    // Reversed, and a rotation that moves every field
+    const std::vector<std::vector<size_t>> orders = {
+        {11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0},
+        {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0},
+        {4, 0, 7, 1, 10, 2, 5, 11, 3, 8, 6, 9},
+    };
+    TelemetryParser fixed;
+    const auto expected = fixed.parse_string(csv);
+    ASSERT_GT(fixed.get_stats().malformed_records, 0u);
+    ASSERT_GT(fixed.get_stats().invalid_records, fixed.get_stats().malformed_records);
+
+    for (const auto& order : orders) {
+        const std::string reordered = permute(csv, order);
+        ASSERT_FALSE(StandardSchema::matches(split(reordered.substr(0, reordered.find('\n')))));
+        TelemetryParser dynamic;
+        test::expect_same_records(dynamic.parse_string(reordered), expected);
+        expect_same_stats(dynamic.get_stats(), fixed.get_stats());
+    }
+}
+
+TEST(FixedSchema, RowsOfOtherWidthsFallBack) {
+    // Under the standard header, a row with an extra trailing field or
+    // without the diagnostic column takes the column map
+    const std::string row = "V1,1704067200000,28.5,-81.3,50,90,2000,50,1000,90,12.5";
+    TelemetryParser parser;
+    const auto records = parser.parse_string(std::string(test::kCsvHeader) + row + ",P0420\n" +
+                                             row + ",P0420,extra\n" + row + "\n");
+    ASSERT_EQ(records.size(), 3u);
+    test::expect_same_record(records[1], records[0]);
+    EXPECT_EQ(records[2].diagnostic_code, "");
+    EXPECT_EQ(records[2].battery_volt, 12.5);
+}
+
+}  // namespace
+}  // namespace fleet
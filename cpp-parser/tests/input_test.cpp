@@ -0,0 +1,386 @@
+// Input stages: ReadAhead, DecompressReader, compression sniffing, pipes
+// and FileFollower
+
+#include "compressed_input.h"
+#include "file_follower.h"
+#include "mapped_file.h"
+#include "read_ahead.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fleet {
+namespace {
+
+template <typename Reader>
+std::string drain(Reader& reader) {
+    std::string out;
+    for (std::string_view block = reader.next(); !block.empty(); block = reader.next()) out.append(block);
+    return out;
+}
+
+TEST(ReadAhead, ReadsWholeFileInBlocks) {
+    test::TempDir dir;
+    const std::string data = test::make_csv(5000);
+    test::write_file(dir.file("a.csv"), data);
+    for (bool uring : {true, false}) {
+        ReadAheadConfig config;
+        config.block_size = 4096;
+        config.depth = 3;
+        config.use_io_uring = uring;
+        ReadAhead reader(dir.file("a.csv"), config);
+        if (!uring) {
+            EXPECT_STREQ(reader.backend(), "thread");
+        }
+        size_t blocks = 0;
+        std::string out;
+        for (std::string_view block = reader.next(); !block.empty(); block = reader.next()) {
+            if (out.size() + block.size() < data.size()) {
+                EXPECT_EQ(block.size(), 4096u);
+            }
+            out.append(block);
+            blocks++;
+        }
+        EXPECT_EQ(out, data) << reader.backend();
+        EXPECT_EQ(blocks, (data.size() + 4095) / 4096);
+        EXPECT_EQ(reader.bytes_read(), data.size());
+    }
+}
+
+TEST(ReadAhead, EmptyAndMissingFiles) {
+    test::TempDir dir;
+    test::write_file(dir.file("empty"), "");
+    ReadAhead reader(dir.file("empty"));
+    EXPECT_TRUE(reader.next().empty());
+    EXPECT_THROW(ReadAhead(dir.file("missing")), std::runtime_error);
+}
+
+TEST(Compression, DetectsMagic) {
+    EXPECT_EQ(detect_compression(std::string_view("\x1f\x8b\x08\x00", 4)), Compression::Gzip);
+    EXPECT_EQ(detect_compression(std::string_view("\x28\xb5\x2f\xfd", 4)), Compression::Zstd);
+    EXPECT_EQ(detect_compression(std::string_view("vehicle_id,")), Compression::None);
+}
+
+#ifdef FLEET_HAVE_ZLIB
+
+TEST(DecompressReader, GzipMatchesSource) {
+    test::TempDir dir;
+    const std::string data = test::make_csv(20000);
+    test::write_gzip(dir.file("a.gz"), data);
+    EXPECT_EQ(detect_compression(dir.file("a.gz")), Compression::Gzip);
+
+    DecompressConfig config;
+    config.block_size = 64 * 1024;
+    DecompressReader reader(dir.file("a.gz"), config);
+    EXPECT_EQ(drain(reader), data);
+    EXPECT_EQ(reader.bytes_out(), data.size());
+    EXPECT_EQ(decompress_file(dir.file("a.gz")), data);
+}
+
+TEST(DecompressReader, MultiMemberGzip) {
+    test::TempDir dir;
+    const std::string first = test::make_csv(3000);
+    const std::string second = test::make_csv(2000, 4, 0, false);
+    test::write_gzip(dir.file("a.gz"), first);
+    test::write_gzip(dir.file("b.gz"), second);
+    test::write_file(dir.file("ab.gz"), test::read_file(dir.file("a.gz")) + test::read_file(dir.file("b.gz")));
+
+    for (size_t threads : {1, 4}) {
+        DecompressConfig config;
+        config.num_threads = threads;
+        DecompressReader reader(dir.file("ab.gz"), config);
+        EXPECT_EQ(drain(reader), first + second) << threads << " threads";
+    }
+}
+
+TEST(DecompressReader, TruncatedInputThrows) {
+    test::TempDir dir;
+    test::write_gzip(dir.file("a.gz"), test::make_csv(20000));
+    std::string gz = test::read_file(dir.file("a.gz"));
+    test::write_file(dir.file("cut.gz"), gz.substr(0, gz.size() / 2));
+    EXPECT_THROW(
+        {
+            DecompressReader reader(dir.file("cut.gz"));
+            drain(reader);
+        },
+        std::runtime_error);
+}
+
+#endif  // FLEET_HAVE_ZLIB
+
+// A named pipe fed from a thread, like the FIFO behind `-s <(zcat x.gz)`
+class FifoWriter {
+public:
+    FifoWriter(const std::string& path, std::string data) : path_(path) {
+        if (::mkfifo(path_.c_str(), 0600) != 0) throw std::runtime_error("mkfifo failed: " + path_);
+        writer_ = std::thread([this, data = std::move(data)]() {
+            {
+                std::ofstream out(path_, std::ios::binary);   // blocks until a reader opens
+                out << data;
+            }
+            done_ = true;
+        });
+    }
+
+    ~FifoWriter() {
+        // Let a writer nobody opened (or read to the end) finish
+        int fd = ::open(path_.c_str(), O_RDONLY | O_NONBLOCK);
+        char buffer[4096];
+        while (!done_) {
+            if (fd >= 0 && ::read(fd, buffer, sizeof(buffer)) <= 0) std::this_thread::yield();
+        }
+        writer_.join();
+        if (fd >= 0) ::close(fd);
+        ::unlink(path_.c_str());
+    }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    std::thread writer_;
+    std::atomic<bool> done_{false};
+};
+
+TEST(Pipe, EveryReadPathParsesAllRows) {
+    test::TempDir dir;
+    const std::string csv = test::make_csv(20000, 16, 50);
+    test::write_file(dir.file("a.csv"), csv);
+    TelemetryParser reference;
+    const auto expected = reference.parse_file(dir.file("a.csv"));
+
+    // Mapping is skipped for a pipe, so each configuration streams it
+    for (bool use_mmap : {false, true}) {
+        for (size_t threads : {1, 4}) {
+            SCOPED_TRACE(std::string(use_mmap ? "mmap, " : "read, ") + std::to_string(threads) + " threads");
+            ParserConfig config;
+            config.use_mmap = use_mmap;
+            config.num_threads = threads;
+            {
+                FifoWriter fifo(dir.file("fifo"), csv);
+                TelemetryParser parser(config);
+                test::expect_same_records(parser.parse_file(fifo.path()), expected);
+                EXPECT_EQ(parser.get_stats().invalid_records, reference.get_stats().invalid_records);
+                EXPECT_STREQ(parser.get_stats().input, "thread");
+            }
+            {
+                FifoWriter fifo(dir.file("fifo"), csv);
+                TelemetryParser parser(config);
+                EXPECT_EQ(parser.parse_file_columnar(fifo.path()).size(), expected.size());
+            }
+            {
+                FifoWriter fifo(dir.file("fifo"), csv);
+                TelemetryParser parser(config);
+                size_t streamed = 0;
+                parser.parse_file_streaming(fifo.path(), [&streamed](TelemetryData&&) { streamed++; });
+                EXPECT_EQ(streamed, expected.size());
+            }
+        }
+    }
+}
+
+TEST(Pipe, DevicesAreNotMapped) {
+    EXPECT_THROW(MappedFile("/dev/null"), std::runtime_error);
+    ParserConfig config;
+    config.use_mmap = true;
+    TelemetryParser parser(config);
+    EXPECT_TRUE(parser.parse_file("/dev/null").empty());
+    EXPECT_STREQ(parser.get_stats().input, "thread");
+}
+
+#ifdef FLEET_HAVE_ZLIB
+
+TEST(Pipe, CompressedInputIsSniffedFromTheFirstBlock) {
+    test::TempDir dir;
+    const std::string csv = test::make_csv(500);
+    test::write_gzip(dir.file("a.gz"), csv);
+
+    // A regular file is reopened for the decoder...
+    ParserConfig config;
+    config.use_mmap = true;
+    config.num_threads = 4;
+    TelemetryParser parser(config);
+    EXPECT_EQ(parser.parse_file(dir.file("a.gz")).size(), 500u);
+    EXPECT_STREQ(parser.get_stats().input, "gzip");
+
+    // ...but a pipe's bytes are gone once read
+    FifoWriter fifo(dir.file("fifo"), test::read_file(dir.file("a.gz")));
+    TelemetryParser piped;
+    EXPECT_THROW(piped.parse_file(fifo.path()), std::runtime_error);
+}
+
+#endif  // FLEET_HAVE_ZLIB
+
+void append_file(const std::string& path, const std::string& contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    if (!out) throw std::runtime_error("cannot append to " + path);
+}
+
+// Everything read_appended() has for us right now
+std::string read_all(FileFollower& follower, bool& restarted) {
+    std::string out;
+    follower.read_appended(out, 1 << 20, restarted);
+    return out;
+}
+
+TEST(FileFollower, ReadsAppendsAfterEof) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.log"), "one\n");
+    FileFollower follower(dir.file("a.log"));
+    bool restarted = true;
+    EXPECT_EQ(read_all(follower, restarted), "one\n");
+    EXPECT_FALSE(restarted);
+    EXPECT_EQ(read_all(follower, restarted), "");
+
+    append_file(dir.file("a.log"), "two\nthr");
+    EXPECT_EQ(read_all(follower, restarted), "two\nthr");
+    append_file(dir.file("a.log"), "ee\n");
+    EXPECT_EQ(read_all(follower, restarted), "ee\n");
+    EXPECT_FALSE(restarted);
+    EXPECT_EQ(follower.offset(), 14u);
+
+    // max_bytes caps a read; the rest comes next time
+    append_file(dir.file("a.log"), "four\n");
+    std::string out;
+    EXPECT_EQ(follower.read_appended(out, 2, restarted), 2u);
+    EXPECT_EQ(follower.read_appended(out, 100, restarted), 3u);
+    EXPECT_EQ(out, "four\n");
+    EXPECT_THROW(FileFollower(dir.file("missing")), std::runtime_error);
+}
+
+TEST(FileFollower, TruncationRestartsAtTop) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.log"), "first line\nsecond line\n");
+    FileFollower follower(dir.file("a.log"));
+    bool restarted = false;
+    read_all(follower, restarted);
+
+    test::write_file(dir.file("a.log"), "new\n");
+    EXPECT_EQ(read_all(follower, restarted), "new\n");
+    EXPECT_TRUE(restarted);
+    EXPECT_EQ(read_all(follower, restarted), "");
+    EXPECT_FALSE(restarted);
+}
+
+TEST(FileFollower, RotationDrainsOldFileFirst) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.log"), "old 1\n");
+    FileFollower follower(dir.file("a.log"));
+    bool restarted = false;
+    read_all(follower, restarted);
+
+    // Written to the old file just before it is renamed away
+    append_file(dir.file("a.log"), "old 2\n");
+    ASSERT_EQ(std::rename(dir.file("a.log").c_str(), dir.file("a.log.1").c_str()), 0);
+    test::write_file(dir.file("a.log"), "new 1\n");
+
+    EXPECT_EQ(read_all(follower, restarted), "old 2\n");
+    EXPECT_FALSE(restarted);
+    EXPECT_EQ(read_all(follower, restarted), "new 1\n");
+    EXPECT_TRUE(restarted);
+    append_file(dir.file("a.log"), "new 2\n");
+    EXPECT_EQ(read_all(follower, restarted), "new 2\n");
+    EXPECT_FALSE(restarted);
+}
+
+// follow_file() on a background thread, with the rows it delivers
+class FollowRun {
+public:
+    explicit FollowRun(const std::string& path) {
+        FollowOptions options;
+        options.poll_interval_ms = 10;
+        options.stop = &stop_;
+        thread_ = std::thread([this, path, options]() {
+            parser_.follow_file(path, [this](TelemetryData&& row) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                rows_.push_back(std::move(row));
+            }, options);
+        });
+    }
+    ~FollowRun() { finish(); }
+
+    void finish() {
+        stop_ = true;
+        if (thread_.joinable()) thread_.join();
+    }
+
+    // Rows delivered once count have arrived (or after a generous timeout)
+    std::vector<TelemetryData> wait_for(size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (rows_.size() >= count) return rows_;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rows_;
+    }
+
+private:
+    TelemetryParser parser_;
+    std::atomic<bool> stop_{false};
+    std::mutex mutex_;
+    std::vector<TelemetryData> rows_;
+    std::thread thread_;
+};
+
+TEST(FollowFile, CompletesPartialLinesAndFollowsRotation) {
+    test::TempDir dir;
+    const std::string path = dir.file("a.csv");
+    const std::string rows = test::make_csv(3, 4, 0, false);
+    const size_t first_nl = rows.find('\n');
+    const size_t second_nl = rows.find('\n', first_nl + 1);
+    TelemetryParser reference;
+    const auto expected = reference.parse_string(test::kCsvHeader + rows);
+    ASSERT_EQ(expected.size(), 3u);
+
+    // Header, one row and half of the next
+    const size_t cut = first_nl + 1 + (second_nl - first_nl) / 2;
+    test::write_file(path, test::kCsvHeader + rows.substr(0, cut));
+    FollowRun run(path);
+    auto got = run.wait_for(1);
+    ASSERT_EQ(got.size(), 1u);
+    test::expect_same_record(got[0], expected[0]);
+
+    // The rest of the row arrives in a later write
+    append_file(path, rows.substr(cut, second_nl + 1 - cut));
+    got = run.wait_for(2);
+    ASSERT_EQ(got.size(), 2u);
+    test::expect_same_record(got[1], expected[1]);
+
+    // Rotated: the new file starts with its own header
+    const std::string row0 = rows.substr(0, first_nl + 1);
+    const std::string row1 = rows.substr(first_nl + 1, second_nl - first_nl);
+    const std::string row2 = rows.substr(second_nl + 1);
+    ASSERT_EQ(std::rename(path.c_str(), (path + ".1").c_str()), 0);
+    test::write_file(path, test::kCsvHeader + row2 + row0);
+    got = run.wait_for(4);
+    ASSERT_EQ(got.size(), 4u);
+    test::expect_same_record(got[2], expected[2]);
+    test::expect_same_record(got[3], expected[0]);
+
+    // Truncated and rewritten shorter in place
+    test::write_file(path, test::kCsvHeader + row1);
+    got = run.wait_for(5);
+    run.finish();
+    ASSERT_EQ(got.size(), 5u);
+    test::expect_same_record(got[4], expected[1]);
+}
+
+}  // namespace
+}  // namespace fleet
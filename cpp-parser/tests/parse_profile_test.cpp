@@ -0,0 +1,126 @@
+// Per-stage profile counters and their text / JSON output. Built into
+// fleet_tests and, with FLEET_PROFILE defined, into fleet_profile_tests, so
+// both configurations run under ctest.
+
+#include "parse_profile.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace fleet {
+namespace {
+
+constexpr size_t kRows = 2000;
+constexpr size_t kInvalidEvery = 50;
+
+// A parsed file and the stats it produced
+struct ProfiledParse {
+    test::TempDir dir;
+    size_t file_size = 0;
+    size_t valid = 0;
+    ParseStats stats;
+
+    explicit ProfiledParse(bool use_mmap) {
+        const std::string csv = test::make_csv(kRows, 16, kInvalidEvery);
+        file_size = csv.size();
+        test::write_file(dir.file("a.csv"), csv);
+        ParserConfig config;
+        config.use_mmap = use_mmap;
+        TelemetryParser parser(config);
+        valid = parser.parse_file(dir.file("a.csv")).size();
+        stats = parser.get_stats();
+    }
+
+    const StageCounters& stage(ParseStage s) const { return stats.profile[s]; }
+};
+
+TEST(ParseProfile, StageNames) {
+    EXPECT_STREQ(stage_name(ParseStage::Read), "read");
+    EXPECT_STREQ(stage_name(ParseStage::Emit), "emit");
+    EXPECT_STREQ(reject_reason_name(RejectReason::FuelLevel), "fuel_level");
+}
+
+TEST(ParseProfile, MergeAddsCounters) {
+    ParseProfile a;
+    ParseProfile b;
+    a[ParseStage::Split] = {10, 1, 100, 2};
+    b[ParseStage::Split] = {5, 2, 50, 1};
+    b[ParseStage::Emit] = {7, 3, 0, 0};
+    a.merge(b);
+    EXPECT_EQ(a[ParseStage::Split].ticks, 15u);
+    EXPECT_EQ(a[ParseStage::Split].calls, 3u);
+    EXPECT_EQ(a[ParseStage::Split].bytes, 150u);
+    EXPECT_EQ(a[ParseStage::Split].allocations, 3u);
+    EXPECT_EQ(a[ParseStage::Emit].calls, 3u);
+    EXPECT_EQ(a.total_ticks(), 22u);
+}
+
+#ifdef FLEET_PROFILE
+
+TEST(ParseProfile, CountsEveryStage) {
+    for (bool use_mmap : {true, false}) {
+        SCOPED_TRACE(use_mmap ? "mmap" : "read-ahead");
+        ProfiledParse run(use_mmap);
+        ASSERT_EQ(run.stats.invalid_records, kRows / kInvalidEvery);
+        EXPECT_GE(run.stage(ParseStage::Read).calls, 1u);
+        EXPECT_EQ(run.stage(ParseStage::Read).bytes, run.file_size);
+        // Every data row is split, decoded and validated; only valid ones are emitted
+        EXPECT_EQ(run.stage(ParseStage::Split).calls, kRows);
+        EXPECT_EQ(run.stage(ParseStage::Decode).calls, kRows);
+        EXPECT_EQ(run.stage(ParseStage::Validate).calls, kRows);
+        EXPECT_EQ(run.stage(ParseStage::Emit).calls, run.valid);
+        EXPECT_GT(run.stage(ParseStage::Split).bytes, 0u);
+        EXPECT_GT(run.stats.profile.total_ticks(), 0u);
+    }
+}
+
+TEST(ParseProfile, LapChargesAllocationsToItsStage) {
+    ParseProfile profile;
+    StageClock clock;
+    clock.start();
+    auto first = std::make_unique<int>(1);
+    auto second = std::make_unique<std::string>(64, 'x');
+    clock.lap(profile, ParseStage::Decode, 10);
+    clock.lap(profile, ParseStage::Emit);
+    EXPECT_EQ(profile[ParseStage::Decode].allocations, 3u);   // two objects and the string's buffer
+    EXPECT_EQ(profile[ParseStage::Decode].calls, 1u);
+    EXPECT_EQ(profile[ParseStage::Decode].bytes, 10u);
+    EXPECT_EQ(profile[ParseStage::Emit].allocations, 0u);
+}
+
+TEST(ParseProfile, StatsOutputIncludesProfile) {
+    ProfiledParse run(true);
+    const std::string json = stats_to_json(run.stats);
+    EXPECT_NE(json.find(",\"profile\":{\"read\":{\"ticks\":"), std::string::npos) << json;
+    for (size_t i = 0; i < kParseStageCount; i++) {
+        const std::string name = stage_name(static_cast<ParseStage>(i));
+        EXPECT_NE(json.find("\"" + name + "\":{\"ticks\":"), std::string::npos) << name;
+    }
+    EXPECT_NE(json.find("\"calls\":" + std::to_string(kRows) + ","), std::string::npos) << json;
+    EXPECT_EQ(json.back(), '}');
+
+    const std::string text = format_stats(run.stats);
+    EXPECT_NE(text.find("Stage profile (CPU time summed over threads):"), std::string::npos) << text;
+    EXPECT_NE(text.find("\n    validate "), std::string::npos) << text;
+    EXPECT_GT(profile_ticks_per_ms(), 0.0);
+}
+
+#else
+
+TEST(ParseProfile, DisabledBuildLeavesCountersZero) {
+    ProfiledParse run(true);
+    for (size_t i = 0; i < kParseStageCount; i++) {
+        const StageCounters& c = run.stats.profile.stages[i];
+        EXPECT_EQ(c.ticks + c.calls + c.bytes + c.allocations, 0u) << stage_name(static_cast<ParseStage>(i));
+    }
+    EXPECT_EQ(stats_to_json(run.stats).find("\"profile\""), std::string::npos);
+    EXPECT_EQ(format_stats(run.stats).find("Stage profile"), std::string::npos);
+    EXPECT_EQ(profile_ticks_per_ms(), 0.0);
+}
+
+#endif  // FLEET_PROFILE
+
+}  // namespace
+}  // namespace fleet
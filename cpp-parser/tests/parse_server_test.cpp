@@ -0,0 +1,203 @@
+// ParseServer requests over a socket pair
+
+#include "binary_format.h"
+#include "parse_server.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace fleet {
+namespace {
+
+using namespace service;
+
+struct Reply {
+    ResponseHeader header;
+    std::string stats;
+    std::string body;   // the chunks joined
+    size_t chunks = 0;
+};
+
+bool read_exact(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::read(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Body chunks up to the response header, then the stats
+Reply read_reply(int fd) {
+    Reply reply;
+    uint32_t magic = 0;
+    while (read_exact(fd, &magic, sizeof(magic)) && magic == kChunkMagic) {
+        uint32_t size = 0;
+        EXPECT_TRUE(read_exact(fd, &size, sizeof(size)));
+        EXPECT_LE(size, kMaxChunk);
+        const size_t at = reply.body.size();
+        reply.body.resize(at + size);
+        EXPECT_TRUE(read_exact(fd, reply.body.data() + at, size));
+        reply.chunks++;
+    }
+    EXPECT_EQ(magic, kResponseMagic);
+    reply.header.magic = magic;
+    EXPECT_TRUE(read_exact(fd, reinterpret_cast<char*>(&reply.header) + sizeof(magic),
+                           sizeof(reply.header) - sizeof(magic)));
+    EXPECT_EQ(reply.header.body_size, reply.body.size());
+    reply.stats.resize(reply.header.stats_size);
+    EXPECT_TRUE(read_exact(fd, reply.stats.data(), reply.stats.size()));
+    return reply;
+}
+
+// A server on one end of a socket pair, serving until the client end closes
+class ServerConnection {
+public:
+    explicit ServerConnection(const ParserConfig& config = ParserConfig()) : server_(config) {
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds_) != 0) throw std::runtime_error("socketpair");
+        thread_ = std::thread([this]() { server_.serve_connection(fds_[1], fds_[1]); });
+    }
+    ~ServerConnection() {
+        ::shutdown(fds_[0], SHUT_WR);
+        thread_.join();
+        ::close(fds_[0]);
+        ::close(fds_[1]);
+    }
+
+    Reply request(Op op, ResultFormat result, std::string_view payload, uint32_t threads = 0) {
+        RequestHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = kRequestMagic;
+        header.op = static_cast<uint8_t>(op);
+        header.input = static_cast<uint8_t>(InputFormat::Csv);
+        header.result = static_cast<uint8_t>(result);
+        header.threads = threads;
+        header.payload_size = payload.size();
+        EXPECT_EQ(::write(fds_[0], &header, sizeof(header)), static_cast<ssize_t>(sizeof(header)));
+        EXPECT_EQ(::write(fds_[0], payload.data(), payload.size()), static_cast<ssize_t>(payload.size()));
+
+        return read_reply(fds_[0]);
+    }
+
+    const ParseServer& server() const { return server_; }
+
+private:
+    ParseServer server_;
+    int fds_[2];
+    std::thread thread_;
+};
+
+TEST(ParseServer, Ping) {
+    ServerConnection connection;
+    Reply reply = connection.request(Op::Ping, ResultFormat::StatsOnly, {});
+    EXPECT_EQ(reply.header.status, static_cast<uint8_t>(Status::Ok));
+    EXPECT_TRUE(reply.body.empty());
+}
+
+TEST(ParseServer, InlineCsvToCsv) {
+    const std::string csv = test::make_csv(500);
+    ServerConnection connection;
+    Reply reply = connection.request(Op::ParseInline, ResultFormat::Csv, csv);
+    ASSERT_EQ(reply.header.status, static_cast<uint8_t>(Status::Ok)) << reply.stats;
+    EXPECT_NE(reply.stats.find("\"valid_records\":500"), std::string::npos) << reply.stats;
+
+    TelemetryParser expected;
+    TelemetryParser actual;
+    test::expect_same_records(actual.parse_string(reply.body), expected.parse_string(csv));
+}
+
+TEST(ParseServer, PathToBinary) {
+    test::TempDir dir;
+    const std::string csv = test::make_csv(3000);
+    test::write_file(dir.file("a.csv"), csv);
+    ServerConnection connection;
+    Reply reply = connection.request(Op::ParsePath, ResultFormat::Binary, dir.file("a.csv"));
+    ASSERT_EQ(reply.header.status, static_cast<uint8_t>(Status::Ok)) << reply.stats;
+    test::write_file(dir.file("a.bin"), reply.body);
+
+    TelemetryParser expected;
+    TelemetryParser actual;
+    test::expect_same_records(actual.parse_binary(dir.file("a.bin")), expected.parse_string(csv));
+    // The connection stays usable after a request
+    EXPECT_EQ(connection.request(Op::Ping, ResultFormat::StatsOnly, {}).header.status,
+              static_cast<uint8_t>(Status::Ok));
+}
+
+TEST(ParseServer, LargeBodyIsStreamedInChunks) {
+    test::TempDir dir;
+    const std::string csv = test::make_csv(40000);
+    test::write_file(dir.file("a.csv"), csv);
+    ServerConnection connection;
+    Reply reply = connection.request(Op::ParsePath, ResultFormat::NDJson, dir.file("a.csv"));
+    ASSERT_EQ(reply.header.status, static_cast<uint8_t>(Status::Ok)) << reply.stats;
+    EXPECT_GT(reply.body.size(), 2u * kMaxChunk);
+    EXPECT_GE(reply.chunks, 3u);
+    EXPECT_EQ(static_cast<size_t>(std::count(reply.body.begin(), reply.body.end(), '\n')), 40000u);
+}
+
+TEST(ParseServer, RequestThreadsAreCapped) {
+    test::TempDir dir;
+    const std::string csv = test::make_csv(40000);
+    test::write_file(dir.file("a.csv"), csv);
+    ServerConnection connection;
+    Reply reply = connection.request(Op::ParsePath, ResultFormat::StatsOnly, dir.file("a.csv"), 0xFFFFFFFFu);
+    ASSERT_EQ(reply.header.status, static_cast<uint8_t>(Status::Ok)) << reply.stats;
+    EXPECT_NE(reply.stats.find("\"valid_records\":40000"), std::string::npos) << reply.stats;
+}
+
+TEST(ParseServer, UnixSocketIsOwnerOnly) {
+    test::TempDir dir;
+    const std::string path = dir.file("parser.sock");
+    ParseServer server;
+    std::atomic<bool> stop{false};
+    std::thread thread([&]() { server.serve_unix_socket(path, &stop); });
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    bool connected = false;
+    for (int attempt = 0; attempt < 500 && !connected; attempt++) {
+        connected = ::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (!connected) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(connected);
+
+    struct stat st;
+    ASSERT_EQ(::stat(path.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0600u);
+
+    RequestHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kRequestMagic;
+    header.op = static_cast<uint8_t>(Op::Ping);
+    EXPECT_EQ(::write(fd, &header, sizeof(header)), static_cast<ssize_t>(sizeof(header)));
+    EXPECT_EQ(read_reply(fd).header.status, static_cast<uint8_t>(Status::Ok));
+
+    ::close(fd);
+    stop.store(true);
+    thread.join();
+}
+
+TEST(ParseServer, ErrorsAreAnswered) {
+    ServerConnection connection;
+    Reply reply = connection.request(Op::ParsePath, ResultFormat::Csv, "/nonexistent/file.csv");
+    EXPECT_EQ(reply.header.status, static_cast<uint8_t>(Status::Error));
+    EXPECT_FALSE(reply.stats.empty());
+}
+
+}  // namespace
+}  // namespace fleet
@@ -0,0 +1,606 @@
+// TelemetryParser: every whole-file entry point must produce the same rows
+// and counters for the same input, whichever read path (mmap, read-ahead,
+// compressed), thread count and delivery order it takes.
+
+#include "batch_ring.h"
+#include "fast_decode.h"
+#include "file_set.h"
+#include "record_arena.h"
+#include "telemetry_batch.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+using test::expect_batch_matches;
+using test::expect_same_record;
+using test::expect_same_records;
+using test::record_key;
+
+// Large enough for several parallel chunks (split_chunks() cuts >= 1 MiB)
+constexpr size_t kRows = 40000;
+constexpr size_t kInvalidEvery = 97;
+
+struct PathCase {
+    const char* name;
+    bool use_mmap;
+    size_t threads;
+    bool preserve_order;
+    bool compressed;
+};
+
+std::ostream& operator<<(std::ostream& out, const PathCase& c) { return out << c.name; }
+
+class ParsePaths : public ::testing::TestWithParam<PathCase> {
+protected:
+    static void SetUpTestSuite() {
+        dir_ = new test::TempDir();
+        const std::string csv = test::make_csv(kRows, 16, kInvalidEvery);
+        test::write_file(dir_->file("fleet.csv"), csv);
+#ifdef FLEET_HAVE_ZLIB
+        test::write_gzip(dir_->file("fleet.csv.gz"), csv);
+#endif
+        // Reference: the plain single-threaded read-ahead parse
+        TelemetryParser parser;
+        reference_ = new std::vector<TelemetryData>(parser.parse_file(dir_->file("fleet.csv")));
+        reference_stats_ = parser.get_stats();
+    }
+    static void TearDownTestSuite() {
+        delete reference_;
+        delete dir_;
+    }
+
+    void SetUp() override {
+#ifndef FLEET_HAVE_ZLIB
+        if (GetParam().compressed) GTEST_SKIP() << "built without zlib";
+#endif
+    }
+
+    std::string input() const { return dir_->file(GetParam().compressed ? "fleet.csv.gz" : "fleet.csv"); }
+
+    ParserConfig config() const {
+        ParserConfig config;
+        config.use_mmap = GetParam().use_mmap;
+        config.num_threads = GetParam().threads;
+        config.preserve_order = GetParam().preserve_order;
+        config.batch_size = 1000;
+        config.buffer_size = 64 * 1024;   // many blocks, many straddling rows
+        return config;
+    }
+
+    // Row order is only guaranteed when it is preserved
+    void expect_reference(std::vector<TelemetryData> records) const {
+        if (!GetParam().preserve_order) {
+            std::sort(records.begin(), records.end(), [](const TelemetryData& a, const TelemetryData& b) {
+                return record_key(a) < record_key(b);
+            });
+            std::vector<TelemetryData> expected(*reference_);
+            std::sort(expected.begin(), expected.end(), [](const TelemetryData& a, const TelemetryData& b) {
+                return record_key(a) < record_key(b);
+            });
+            expect_same_records(records, expected);
+        } else {
+            expect_same_records(records, *reference_);
+        }
+    }
+
+    void expect_reference_batches(const std::vector<TelemetryData>& rows) const {
+        std::vector<TelemetryData> expected(*reference_);
+        std::vector<TelemetryData> actual(rows);
+        if (!GetParam().preserve_order) {
+            auto by_key = [](const TelemetryData& a, const TelemetryData& b) { return record_key(a) < record_key(b); };
+            std::sort(actual.begin(), actual.end(), by_key);
+            std::sort(expected.begin(), expected.end(), by_key);
+        }
+        expect_same_records(actual, expected);
+    }
+
+    // Counters match the reference, and the file was read the way the
+    // configuration asks: gzip streamed through DecompressReader, parallel
+    // and use_mmap parses mapped, everything else through ReadAhead
+    void expect_reference_stats(const ParseStats& stats) const {
+        EXPECT_EQ(stats.valid_records, reference_stats_.valid_records);
+        EXPECT_EQ(stats.invalid_records, reference_stats_.invalid_records);
+        EXPECT_EQ(stats.total_lines, reference_stats_.total_lines);
+
+        const std::string input = stats.input;
+        if (GetParam().compressed) {
+            EXPECT_EQ(input, "gzip");
+        } else if (GetParam().use_mmap || GetParam().threads > 1) {
+            EXPECT_EQ(input, "mmap");
+        } else {
+            EXPECT_TRUE(input == "io_uring" || input == "thread") << input;
+        }
+    }
+
+    static std::vector<TelemetryData> rows_of(const TelemetryBatch& batch) {
+        std::vector<TelemetryData> rows;
+        for (size_t i = 0; i < batch.size(); i++) rows.push_back(batch.row(i));
+        return rows;
+    }
+
+    static test::TempDir* dir_;
+    static std::vector<TelemetryData>* reference_;
+    static ParseStats reference_stats_;
+};
+
+test::TempDir* ParsePaths::dir_ = nullptr;
+std::vector<TelemetryData>* ParsePaths::reference_ = nullptr;
+ParseStats ParsePaths::reference_stats_;
+
+TEST_P(ParsePaths, ReferenceCountsInvalidRows) {
+    EXPECT_EQ(reference_->size() + reference_stats_.invalid_records, kRows);
+    EXPECT_EQ(reference_stats_.invalid_records, kRows / kInvalidEvery);
+    EXPECT_EQ(reference_stats_.rejected_by(RejectReason::Latitude), kRows / kInvalidEvery);
+}
+
+TEST_P(ParsePaths, ParseFile) {
+    TelemetryParser parser(config());
+    expect_reference(parser.parse_file(input()));
+    expect_reference_stats(parser.get_stats());
+}
+
+TEST_P(ParsePaths, ParseFileIntoArena) {
+    RecordArena arena;
+    TelemetryParser parser(config());
+    auto records = parser.parse_file(input(), &arena);
+    EXPECT_GT(arena.bytes_used(), 0u);
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(records.front().vehicle_id.get_allocator().resource(), &arena);
+    std::vector<TelemetryData> heap;
+    for (const auto& r : records) heap.push_back(r.to_data());
+    expect_reference(std::move(heap));
+}
+
+TEST_P(ParsePaths, StreamingFunction) {
+    TelemetryParser parser(config());
+    std::vector<TelemetryData> records;
+    std::function<void(TelemetryData&&)> callback = [&](TelemetryData&& r) { records.push_back(std::move(r)); };
+    parser.parse_file_streaming(input(), callback);
+    expect_reference(std::move(records));
+    expect_reference_stats(parser.get_stats());
+}
+
+TEST_P(ParsePaths, StreamingLambda) {
+    TelemetryParser parser(config());
+    std::vector<TelemetryData> records;
+    parser.parse_file_streaming(input(), [&](TelemetryData&& r) { records.push_back(std::move(r)); });
+    expect_reference(std::move(records));
+    expect_reference_stats(parser.get_stats());
+}
+
+TEST_P(ParsePaths, Batched) {
+    TelemetryParser parser(config());
+    std::vector<TelemetryData> records;
+    size_t calls = 0;
+    parser.parse_file_batched(input(), [&](Span<TelemetryData> batch) {
+        EXPECT_LE(batch.size, 1000u);
+        calls++;
+        for (auto& r : batch) records.push_back(std::move(r));
+    });
+    EXPECT_GE(calls, reference_->size() / 1000);
+    expect_reference(std::move(records));
+    expect_reference_stats(parser.get_stats());
+}
+
+TEST_P(ParsePaths, ColumnarWhole) {
+    TelemetryParser parser(config());
+    TelemetryBatch batch = parser.parse_file_columnar(input());
+    expect_reference_batches(rows_of(batch));
+    expect_reference_stats(parser.get_stats());
+}
+
+TEST_P(ParsePaths, ColumnarCallback) {
+    TelemetryParser parser(config());
+    std::vector<TelemetryData> rows;
+    parser.parse_file_columnar(input(), [&](const TelemetryBatch& batch) {
+        EXPECT_LE(batch.size(), 1000u);
+        for (size_t i = 0; i < batch.size(); i++) rows.push_back(batch.row(i));
+    });
+    expect_reference_batches(rows);
+    expect_reference_stats(parser.get_stats());
+}
+
+TEST_P(ParsePaths, ColumnarRing) {
+    TelemetryParser parser(config());
+    std::mutex mutex;
+    std::vector<TelemetryData> rows;
+    size_t second_sink_rows = 0;
+    {
+        BatchRing<TelemetryBatch> ring(4, {
+            [&](const TelemetryBatch& batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t i = 0; i < batch.size(); i++) rows.push_back(batch.row(i));
+            },
+            [&](const TelemetryBatch& batch) { second_sink_rows += batch.size(); },
+        });
+        parser.parse_file_columnar(input(), ring);
+        ring.close();
+    }
+    EXPECT_EQ(second_sink_rows, reference_->size());
+    expect_reference_batches(rows);
+    expect_reference_stats(parser.get_stats());
+}
+
+// One slot leaves ordered workers no credits: only the head chunk fills
+TEST_P(ParsePaths, ColumnarRingSingleSlot) {
+    TelemetryParser parser(config());
+    std::vector<TelemetryData> rows;
+    {
+        BatchRing<TelemetryBatch> ring(1, {[&](const TelemetryBatch& batch) {
+            for (size_t i = 0; i < batch.size(); i++) rows.push_back(batch.row(i));
+        }});
+        parser.parse_file_columnar(input(), ring);
+        ring.close();
+    }
+    expect_reference_batches(rows);
+}
+
+TEST_P(ParsePaths, ColumnarRingSinkErrorStopsParse) {
+    TelemetryParser parser(config());
+    size_t batches = 0;
+    BatchRing<TelemetryBatch> ring(2, {[&](const TelemetryBatch&) {
+        if (++batches == 2) throw std::runtime_error("sink failed");
+    }});
+    EXPECT_THROW(parser.parse_file_columnar(input(), ring), std::runtime_error);
+    EXPECT_TRUE(ring.failed());
+    EXPECT_THROW(ring.close(), std::runtime_error);
+    EXPECT_LT(ring.published(), reference_->size() / 1000);
+}
+
+TEST_P(ParsePaths, Compact) {
+    TelemetryParser parser(config());
+    std::vector<TelemetryRecord> records = parser.parse_file_compact(input());
+    ASSERT_EQ(records.size(), reference_->size());
+    std::vector<TelemetryData> rows;
+    for (const auto& r : records) {
+        TelemetryData data;
+        data.vehicle_id = parser.vehicle_ids().view(r.vehicle_id);
+        data.timestamp = r.timestamp;
+        data.latitude = r.latitude;
+        data.longitude = r.longitude;
+        data.speed = r.speed;
+        data.heading = r.heading;
+        data.engine_rpm = r.engine_rpm;
+        data.fuel_level = r.fuel_level;
+        data.odometer_km = r.odometer_km;
+        data.engine_temp = r.engine_temp;
+        data.battery_volt = r.battery_volt;
+        data.diagnostic_code = parser.diagnostic_codes().view(r.diagnostic_code);
+        rows.push_back(std::move(data));
+    }
+    expect_reference(std::move(rows));
+    expect_reference_stats(parser.get_stats());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Parser, ParsePaths,
+    ::testing::Values(
+        PathCase{"ReadAhead", false, 1, true, false},
+        PathCase{"Mmap", true, 1, true, false},
+        PathCase{"ParallelOrdered", true, 4, true, false},
+        PathCase{"ParallelUnordered", true, 4, false, false},
+        PathCase{"Gzip", false, 1, true, true},
+        PathCase{"GzipMmap", true, 1, true, true},
+        PathCase{"GzipParallelOrdered", false, 4, true, true},
+        PathCase{"GzipParallelUnordered", false, 4, false, true}),
+    [](const ::testing::TestParamInfo<PathCase>& info) { return std::string(info.param.name); });
+
+TEST(Parser, ParseLineMapsHeaderColumns) {
+    TelemetryParser parser;
+    parser.use_header("timestamp,vehicle_id,speed,latitude,longitude,fuel_level,engine_rpm,"
+                      "diagnostic_code,heading,odometer_km,engine_temp,battery_volt");
+    auto data = parser.parse_line("1704067200000,TRUCK-7,55.5,28.5,-81.25,40,2100,P0300,180,1200.5,88,12.25");
+    ASSERT_TRUE(data.has_value());
+    EXPECT_EQ(data->vehicle_id, "TRUCK-7");
+    EXPECT_EQ(data->timestamp, 1704067200000);
+    EXPECT_EQ(data->speed, 55.5);
+    EXPECT_EQ(data->latitude, 28.5);
+    EXPECT_EQ(data->longitude, -81.25);
+    EXPECT_EQ(data->fuel_level, 40.0);
+    EXPECT_EQ(data->engine_rpm, 2100);
+    EXPECT_EQ(data->diagnostic_code, "P0300");
+    EXPECT_EQ(data->odometer_km, 1200.5);
+    EXPECT_EQ(data->battery_volt, 12.25);
+}
+
+TEST(Parser, ParseLineRejectsMalformedAndOutOfRange) {
+    TelemetryParser parser;
+    EXPECT_TRUE(parser.parse_line("V1,1704067200000,28.5,-81.3,50,90,2000,50,1000,90,12.5,").has_value());
+    EXPECT_FALSE(parser.parse_line("V1,1704067200000,28.5x,-81.3,50,90,2000,50,1000,90,12.5,").has_value());
+    EXPECT_FALSE(parser.parse_line("V1,1704067200000,91,-81.3,50,90,2000,50,1000,90,12.5,").has_value());
+    EXPECT_FALSE(parser.parse_line(",1704067200000,28.5,-81.3,50,90,2000,50,1000,90,12.5,").has_value());
+    EXPECT_FALSE(parser.parse_line("V1,1704067200000,28.5,-81.3,50,90,2000,101,1000,90,12.5,").has_value());
+    EXPECT_EQ(parser.get_stats().rejected_by(RejectReason::Latitude), 1u);
+    EXPECT_EQ(parser.get_stats().rejected_by(RejectReason::MissingVehicleId), 1u);
+    EXPECT_EQ(parser.get_stats().rejected_by(RejectReason::FuelLevel), 1u);
+}
+
+TEST(Parser, ColumnarValidatesParsedValues) {
+    // 100.000001 would round to 100.0f and pass if the batch stored floats
+    const std::string csv =
+        "vehicle_id,timestamp,latitude,longitude,speed,heading,engine_rpm,fuel_level,odometer_km,"
+        "engine_temp,battery_volt,diagnostic_code\n"
+        "V1,1704067200000,28.5,-81.3,55.123456789,90,2000,100.000001,1000,90,12.5,\n"
+        "V2,1704067200000,28.5,-81.3,55.123456789,90,2000,99.999999,1000,90.1,12.3,\n";
+    test::TempDir dir;
+    test::write_file(dir.file("a.csv"), csv);
+
+    TelemetryParser by_row;
+    const auto records = by_row.parse_file(dir.file("a.csv"));
+    TelemetryParser columnar;
+    const TelemetryBatch batch = columnar.parse_file_columnar(dir.file("a.csv"));
+    expect_batch_matches(batch, records);
+    ASSERT_EQ(batch.size(), 1u);
+    EXPECT_EQ(batch.fuel_level[0], 99.999999);
+    EXPECT_EQ(batch.speed[0], 55.123456789);
+    EXPECT_EQ(columnar.get_stats().rejected_by(RejectReason::FuelLevel), 1u);
+    EXPECT_EQ(by_row.get_stats().rejected_by(RejectReason::FuelLevel), 1u);
+}
+
+TEST(FastDecode, RejectsNonFiniteValues) {
+    double value = 1.0;
+    for (const char* text : {"nan", "-nan", "NaN", "inf", "+inf", "-inf", "Infinity", "1e999", "-1e400"}) {
+        EXPECT_FALSE(fast_stod(text, value)) << text;
+        EXPECT_EQ(value, 0.0) << text;
+    }
+    EXPECT_TRUE(fast_stod("1.5e3", value));
+    EXPECT_EQ(value, 1500.0);
+    EXPECT_TRUE(fast_stod(" -81.3 ", value));
+    EXPECT_EQ(value, -81.3);
+
+    TelemetryParser parser;
+    EXPECT_FALSE(parser.parse_line("V1,1704067200000,28.5,-81.3,nan,90,2000,50,1000,90,12.5,").has_value());
+    EXPECT_FALSE(parser.parse_line("V1,1704067200000,28.5,-81.3,50,90,2000,50,inf,90,12.5,").has_value());
+    EXPECT_FALSE(parser.parse_line("V1,1704067200000,28.5,-81.3,50,90,2000,50,1000,-inf,12.5,").has_value());
+    EXPECT_EQ(parser.get_stats().valid_records, 0u);
+}
+
+TEST(Parser, TimestampFormats) {
+    EXPECT_EQ(TelemetryParser::parse_timestamp("1704067200"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("1704067200000"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T00:00:00Z"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T00:00:01.250000"), 1704067201250);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01 00:00:00"), 1704067200000);
+
+    // UTC offsets: Z, +hh:mm, -hhmm, +hh
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T00:00:00z"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T05:30:00+05:30"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2023-12-31T19:00:00-0500"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T02:00:00+02"), 1704067200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2023-12-31T14:15:00.500-09:45"), 1704067200500);
+
+    // Fractions are truncated to milliseconds
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T00:00:00.123Z"), 1704067200123);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T00:00:00.5"), 1704067200500);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T00:00:00,25"), 1704067200250);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-01-01T00:00:00.123999+00:00"), 1704067200123);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("1704067200.25"), 1704067200250);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("1704067200.0009"), 1704067200000);
+
+    // Leap years: 2000 and 2024 are, 1900 and 2100 are not
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2000-02-29"), 951782400000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2024-02-29T00:00:00Z"), 1709164800000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("1900-02-28"), -2203977600000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("1900-03-01"), -2203891200000);
+    EXPECT_EQ(TelemetryParser::parse_timestamp("2100-03-01"), 4107542400000);
+
+    // Invalid dates, times and offsets decode as 0
+    for (const char* text : {"1900-02-29", "2100-02-29", "2023-02-29", "2024-13-01", "2024-00-10",
+                             "2024-04-31", "2024-01-00", "2024-01-01T24:00:00", "2024-01-01T23:60:00",
+                             "2024-01-01T00:00:00+24:00", "2024-01-01T00:00:00+05:3", "2024-01-01T00:00:00.",
+                             "2024-01-01T00:00:00Zx", "2024-01-01T00:00", "2024/01/01", "12345678901234567890",
+                             "not a time", ""}) {
+        EXPECT_EQ(TelemetryParser::parse_timestamp(text), 0) << text;
+    }
+}
+
+TEST(Parser, TimestampFormatSwitchesMidFile) {
+    // The format sniffed from the first row is re-sniffed when a row stops matching
+    const char* const timestamps[] = {
+        "1704067200000", "1704067201000", "2024-01-01T00:00:02Z", "2024-01-01T05:30:03+05:30",
+        "1704067204", "1704067205.5", "1704067206000", "2024-01-01 00:00:07.250",
+    };
+    const int64_t expected[] = {
+        1704067200000, 1704067201000, 1704067202000, 1704067203000,
+        1704067204000, 1704067205500, 1704067206000, 1704067207250,
+    };
+    std::string csv = test::kCsvHeader;
+    for (const char* ts : timestamps) {
+        csv += std::string("V1,") + ts + ",28.5,-81.3,50,90,2000,50,1000,90,12.5,\n";
+    }
+    TelemetryParser parser;
+    const auto records = parser.parse_string(csv);
+    ASSERT_EQ(records.size(), std::size(expected));
+    for (size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(records[i].timestamp, expected[i]) << timestamps[i];
+    }
+}
+
+TEST(Parser, ParseStringMatchesFile) {
+    test::TempDir dir;
+    const std::string csv = test::make_csv(500);
+    test::write_file(dir.file("a.csv"), csv);
+    TelemetryParser from_file;
+    TelemetryParser from_string;
+    expect_same_records(from_string.parse_string(csv), from_file.parse_file(dir.file("a.csv")));
+}
+
+TEST(Parser, ParseStringPiecewise) {
+    const std::string csv = test::make_csv(300);
+    size_t header_end = csv.find('\n') + 1;
+    size_t cut = csv.find('\n', csv.size() / 2) + 1;
+
+    TelemetryParser whole;
+    auto expected = whole.parse_string(csv);
+
+    TelemetryParser first;
+    TelemetryParser second;
+    second.use_header(std::string_view(csv).substr(0, header_end - 1));
+    auto records = first.parse_string(std::string_view(csv).substr(0, cut));
+    auto rest = second.parse_string(std::string_view(csv).substr(cut), false);
+    records.insert(records.end(), rest.begin(), rest.end());
+    expect_same_records(records, expected);
+}
+
+TEST(Parser, FinalRowWithoutNewline) {
+    test::TempDir dir;
+    std::string csv = test::make_csv(10);
+    csv.pop_back();
+    test::write_file(dir.file("a.csv"), csv);
+    for (bool mmap : {false, true}) {
+        ParserConfig config;
+        config.use_mmap = mmap;
+        config.buffer_size = 16;
+        TelemetryParser parser(config);
+        EXPECT_EQ(parser.parse_file(dir.file("a.csv")).size(), 10u) << "mmap " << mmap;
+    }
+}
+
+TEST(Parser, LogFormat) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.log"),
+                     "# fleet log\n"
+                     "1704067200000|VEH-001|28.5,-81.3|55.5|2100|80.25|1000.5|90.5|12.5|\n"
+                     "1704067201000|VEH-002|28.6,-81.4|60|2200|70|2000|91|12.75|P0420\n"
+                     "1704067202000|VEH-003|95,-81.4|60|2200|70|2000|91|12.75|\n");
+    TelemetryParser parser;
+    auto records = parser.parse_log(dir.file("a.log"));
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].vehicle_id, "VEH-001");
+    EXPECT_EQ(records[0].latitude, 28.5);
+    EXPECT_EQ(records[0].longitude, -81.3);
+    EXPECT_EQ(records[0].speed, 55.5);
+    EXPECT_EQ(records[0].engine_rpm, 2100);
+    EXPECT_EQ(records[0].fuel_level, 80.25);
+    EXPECT_EQ(records[0].odometer_km, 1000.5);
+    EXPECT_EQ(records[1].diagnostic_code, "P0420");
+    EXPECT_EQ(parser.get_stats().invalid_records, 1u);
+}
+
+TEST(Parser, LogFormatIntoArena) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.log"),
+                     "1704067200000|VEH-001|28.5,-81.3|55.5|2100|80.25|1000.5|90.5|12.5|\n"
+                     "1704067201000|VEH-002|28.6,-81.4|60|2200|70|2000|91|12.75|P0420\n");
+    RecordArena arena;
+    TelemetryParser parser;
+    auto records = parser.parse_log(dir.file("a.log"), &arena);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[1].diagnostic_code, "P0420");
+    EXPECT_TRUE(records[1].is_valid());
+    TelemetryData copy = records[1].to_data();
+    EXPECT_EQ(copy.vehicle_id, "VEH-002");
+    EXPECT_EQ(copy.battery_volt, 12.75);
+}
+
+// Heap results keep plain std::string fields callers can bind to
+TEST(Parser, RecordStringsAreStdString) {
+    TelemetryParser parser;
+    auto records = parser.parse_string(test::make_csv(4));
+    ASSERT_EQ(records.size(), 4u);
+    std::string& vehicle = records[0].vehicle_id;
+    const std::string& code = records[0].diagnostic_code;
+    EXPECT_EQ(vehicle, "VEH-001");
+    EXPECT_TRUE(code.empty());
+}
+
+TEST(Parser, FilterPushdown) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.csv"), test::make_csv(1000, 10));
+    ParserConfig config;
+    config.filter.vehicle_ids = {"VEH-003", "VEH-007"};
+    config.filter.min_timestamp = 1704067200000LL + 100 * 1000;
+    TelemetryParser parser(config);
+    auto records = parser.parse_file(dir.file("a.csv"));
+    ASSERT_FALSE(records.empty());
+    for (const auto& r : records) {
+        EXPECT_TRUE(r.vehicle_id == "VEH-003" || r.vehicle_id == "VEH-007");
+        EXPECT_GE(r.timestamp, config.filter.min_timestamp);
+    }
+    EXPECT_EQ(records.size() + parser.get_stats().filtered_records, 1000u);
+}
+
+TEST(Parser, ParseColumnsStopsAtCapacity) {
+    const std::string csv = test::make_csv(100);
+    TelemetryParser reference;
+    auto expected = reference.parse_string(csv);
+
+    TelemetryParser parser;
+    std::vector<int64_t> timestamps(30);
+    std::vector<uint32_t> vehicles(30);
+    std::vector<TelemetryData> seen;
+    std::string_view rest = csv;
+    bool at_start = true;
+    while (!rest.empty()) {
+        ColumnArrays out;
+        out.capacity = 30;
+        out.timestamp = timestamps.data();
+        out.vehicle_id = vehicles.data();
+        size_t used = parser.parse_columns(rest, out, at_start);
+        ASSERT_GT(used, 0u);
+        for (size_t i = 0; i < out.size; i++) {
+            TelemetryData r;
+            r.timestamp = timestamps[i];
+            r.vehicle_id = parser.vehicle_ids().view(vehicles[i]);
+            seen.push_back(r);
+        }
+        rest.remove_prefix(used);
+        at_start = false;
+    }
+    ASSERT_EQ(seen.size(), expected.size());
+    for (size_t i = 0; i < seen.size(); i++) {
+        EXPECT_EQ(seen[i].timestamp, expected[i].timestamp);
+        EXPECT_EQ(seen[i].vehicle_id, expected[i].vehicle_id);
+    }
+}
+
+TEST(FileSet, ParsesEveryFileInOrder) {
+    test::TempDir dir;
+    std::vector<std::string> files;
+    std::vector<TelemetryData> expected;
+    for (int i = 0; i < 5; i++) {
+        std::string path = dir.file("part" + std::to_string(i) + ".csv");
+        test::write_file(path, test::make_csv(2000 + i * 100, 8));
+        TelemetryParser parser;
+        auto records = parser.parse_file(path);
+        expected.insert(expected.end(), records.begin(), records.end());
+        files.push_back(path);
+    }
+
+    FileSetConfig config;
+    config.parser.num_threads = 4;
+    config.chunk_bytes = 64 * 1024;   // split every file into pieces
+    FileSetParser set(config);
+    std::vector<TelemetryData> records;
+    set.parse(files, [&](size_t, std::vector<TelemetryData>&& piece) {
+        records.insert(records.end(), std::make_move_iterator(piece.begin()),
+                       std::make_move_iterator(piece.end()));
+    });
+    expect_same_records(records, expected);
+    EXPECT_EQ(set.stats().valid_records, expected.size());
+    ASSERT_EQ(set.files().size(), files.size());
+    for (const auto& result : set.files()) EXPECT_TRUE(result.error.empty()) << result.error;
+}
+
+TEST(FileSet, DetectsFormats) {
+    test::TempDir dir;
+    test::write_file(dir.file("a.csv"), test::make_csv(3));
+    test::write_file(dir.file("a.log"), "# log\n1704067200000|V|1,2|3|4|5|6|7|8|\n");
+    EXPECT_EQ(detect_format(dir.file("a.csv")), InputFormat::Csv);
+    EXPECT_EQ(detect_format(dir.file("a.log")), InputFormat::Log);
+#ifdef FLEET_HAVE_ZLIB
+    test::write_gzip(dir.file("b.gz"), "# log\n1704067200000|V|1,2|3|4|5|6|7|8|\n");
+    EXPECT_EQ(detect_format(dir.file("b.gz")), InputFormat::Log);
+#endif
+}
+
+}  // namespace
+}  // namespace fleet
@@ -0,0 +1,90 @@
+// RecordSorter in memory and through spilled runs
+
+#include "record_sorter.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+using test::expect_same_records;
+
+std::vector<TelemetryData> shuffled_records(size_t rows) {
+    TelemetryParser parser;
+    auto records = parser.parse_string(test::make_csv(rows, 37));
+    // Deterministic shuffle, with duplicate keys to check stability
+    for (size_t i = 0; i < records.size(); i++) {
+        std::swap(records[i], records[(i * 7919) % records.size()]);
+    }
+    for (size_t i = 0; i + 1 < records.size(); i += 50) {
+        records[i + 1].vehicle_id = records[i].vehicle_id;
+        records[i + 1].timestamp = records[i].timestamp;
+    }
+    return records;
+}
+
+std::vector<TelemetryData> sorted_copy(std::vector<TelemetryData> records) {
+    std::stable_sort(records.begin(), records.end(), [](const TelemetryData& a, const TelemetryData& b) {
+        if (a.vehicle_id != b.vehicle_id) return a.vehicle_id < b.vehicle_id;
+        return a.timestamp < b.timestamp;
+    });
+    return records;
+}
+
+size_t count_entries(const std::string& dir) {
+    size_t n = 0;
+    if (DIR* d = ::opendir(dir.c_str())) {
+        while (dirent* e = ::readdir(d)) {
+            if (std::string(e->d_name) != "." && std::string(e->d_name) != "..") n++;
+        }
+        ::closedir(d);
+    }
+    return n;
+}
+
+std::vector<TelemetryData> run_sorter(const std::vector<TelemetryData>& input, const SortConfig& config,
+                                      size_t* runs) {
+    RecordSorter sorter(config);
+    for (const auto& r : input) sorter.add(r);
+    EXPECT_EQ(sorter.records_in(), input.size());
+    std::vector<TelemetryData> out;
+    sorter.finish([&](TelemetryData&& r) { out.push_back(std::move(r)); });
+    *runs = sorter.runs_spilled();
+    return out;
+}
+
+TEST(RecordSorter, InMemory) {
+    test::TempDir dir;
+    auto input = shuffled_records(5000);
+    SortConfig config;
+    config.temp_dir = dir.path();
+    size_t runs = 0;
+    expect_same_records(run_sorter(input, config, &runs), sorted_copy(input));
+    EXPECT_EQ(runs, 0u);
+}
+
+TEST(RecordSorter, SpillAndMerge) {
+    test::TempDir dir;
+    auto input = shuffled_records(20000);
+    SortConfig config;
+    config.memory_bytes = 256 * 1024;   // ~1300 rows per run
+    config.temp_dir = dir.path();
+    size_t runs = 0;
+    expect_same_records(run_sorter(input, config, &runs), sorted_copy(input));
+    EXPECT_GT(runs, 5u);
+    EXPECT_EQ(count_entries(dir.path()), 0u) << "spill files left behind";
+}
+
+TEST(RecordSorter, Empty) {
+    SortConfig config;
+    size_t runs = 0;
+    EXPECT_TRUE(run_sorter({}, config, &runs).empty());
+}
+
+}  // namespace
+}  // namespace fleet
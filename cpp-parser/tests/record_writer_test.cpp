@@ -0,0 +1,94 @@
+// RecordWriter output read back through the parser
+
+#include "record_writer.h"
+#include "telemetry_batch.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+using test::expect_same_records;
+
+std::vector<TelemetryData> sample_records(size_t rows) {
+    TelemetryParser parser;
+    return parser.parse_string(test::make_csv(rows, 8));
+}
+
+std::string write_all(OutputFormat format, const std::vector<TelemetryData>& records,
+                      size_t buffer_size = 1024 * 1024) {
+    std::ostringstream out;
+    RecordWriter writer(out, format, buffer_size);
+    for (const auto& r : records) writer.write(r);
+    writer.finish();
+    EXPECT_EQ(writer.records_written(), records.size());
+    return out.str();
+}
+
+TEST(RecordWriter, CsvRoundTrip) {
+    auto records = sample_records(3000);
+    // A small buffer drains many times mid-row-stream
+    std::string csv = write_all(OutputFormat::Csv, records, 4096);
+    TelemetryParser parser;
+    expect_same_records(parser.parse_string(csv), records);
+}
+
+TEST(RecordWriter, CsvQuotesStrings) {
+    TelemetryParser parser;
+    auto records = parser.parse_string(test::make_csv(1));
+    records[0].vehicle_id = "VEH,\"7\"";
+    std::string csv = write_all(OutputFormat::Csv, records);
+    EXPECT_NE(csv.find("\"VEH,\"\"7\"\"\""), std::string::npos);
+}
+
+TEST(RecordWriter, NdjsonMatchesToJson) {
+    auto records = sample_records(200);
+    std::string ndjson = write_all(OutputFormat::NDJson, records);
+    std::istringstream lines(ndjson);
+    std::string line;
+    size_t i = 0;
+    while (std::getline(lines, line)) {
+        ASSERT_LT(i, records.size());
+        EXPECT_EQ(line, records[i].to_json());
+        i++;
+    }
+    EXPECT_EQ(i, records.size());
+}
+
+TEST(RecordWriter, JsonArray) {
+    auto records = sample_records(3);
+    std::string json = write_all(OutputFormat::JsonArray, records);
+    EXPECT_EQ(json, "[\n  " + records[0].to_json() + ",\n  " + records[1].to_json() + ",\n  " +
+                        records[2].to_json() + "\n]\n");
+    EXPECT_EQ(write_all(OutputFormat::JsonArray, {}), "[\n]\n");
+}
+
+TEST(RecordWriter, JsonEscapesAndNulls) {
+    std::string out;
+    append_json_string(out, "a\"b\\c\n\x01");
+    EXPECT_EQ(out, "\"a\\\"b\\\\c\\n\\u0001\"");
+    out.clear();
+    append_json_number(out, std::numeric_limits<double>::quiet_NaN(), 2);
+    EXPECT_EQ(out, "null");
+}
+
+TEST(RecordWriter, BatchMatchesRecords) {
+    auto records = sample_records(1500);
+    TelemetryBatch batch;
+    for (const auto& r : records) batch.append(r);
+    for (OutputFormat format : {OutputFormat::Csv, OutputFormat::NDJson, OutputFormat::JsonArray}) {
+        std::ostringstream out;
+        {
+            RecordWriter writer(out, format);
+            writer.write(batch);
+        }
+        EXPECT_EQ(out.str(), write_all(format, records)) << static_cast<int>(format);
+    }
+}
+
+}  // namespace
+}  // namespace fleet
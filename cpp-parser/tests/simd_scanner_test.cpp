@@ -0,0 +1,91 @@
+// Every runtime-dispatched scan kernel must agree with the scalar kernel
+#include "simd_scanner.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fleet {
+namespace {
+
+const ScanKernel kAllKernels[] = {ScanKernel::Scalar, ScanKernel::SSE42, ScanKernel::AVX2, ScanKernel::NEON};
+
+std::vector<uint32_t> scan_with(ScanKernel kernel, char delimiter, const char* data, size_t len) {
+    StructuralScanner scanner(delimiter, kernel);
+    std::vector<uint32_t> index;
+    size_t count = scanner.scan(data, len, index);
+    index.resize(count);
+    return index;
+}
+
+// Compare every supported kernel with scalar on every prefix of input, so
+// the 64-byte loop, the 16/32-byte steps and the scalar tail all get hit
+void expect_kernels_agree(const std::string& input, char delimiter) {
+    for (ScanKernel kernel : kAllKernels) {
+        if (kernel == ScanKernel::Scalar || !StructuralScanner::kernel_supported(kernel)) continue;
+        for (size_t len = 0; len <= input.size(); len++) {
+            ASSERT_EQ(scan_with(kernel, delimiter, input.data(), len),
+                      scan_with(ScanKernel::Scalar, delimiter, input.data(), len))
+                << scan_kernel_name(kernel) << " length " << len;
+        }
+    }
+}
+
+std::string repeat_rows(const std::string& rows, size_t min_size) {
+    std::string out;
+    while (out.size() < min_size) out += rows;
+    return out;
+}
+
+TEST(SimdScanner, ScalarFindsDelimitersAndNewlines) {
+    std::string input = "a,b\r\n\"c,d\",e\n";
+    EXPECT_EQ(scan_with(ScanKernel::Scalar, ',', input.data(), input.size()),
+              (std::vector<uint32_t>{1, 4, 7, 10, 12}));
+}
+
+TEST(SimdScanner, QuotedFieldsMatchScalar) {
+    // The scanner is quote-unaware: commas inside quotes are reported too
+    expect_kernels_agree(repeat_rows("V001,\"Depot, north\",37.7749,\"a,b,,c\"\n", 200), ',');
+}
+
+TEST(SimdScanner, CrlfRowsMatchScalar) {
+    expect_kernels_agree(repeat_rows("V001,1705312800000,37.7749,-122.4194,45.5\r\n", 200), ',');
+}
+
+TEST(SimdScanner, DenseAndEmptyInputMatchScalar) {
+    expect_kernels_agree(std::string(130, ','), ',');
+    expect_kernels_agree(std::string(130, '\n'), ',');
+    expect_kernels_agree(std::string(130, 'x'), ',');
+}
+
+TEST(SimdScanner, OtherDelimiterMatchesScalar) {
+    // Commas are ordinary bytes when the delimiter is '|'
+    expect_kernels_agree(repeat_rows("V001|a,b|37.7749\r\n||\n", 200), '|');
+}
+
+TEST(SimdScanner, UnalignedInputMatchesScalar) {
+    std::string input = repeat_rows("x,\"y,z\"\r\nlonger_field,,\n", 260);
+    for (ScanKernel kernel : kAllKernels) {
+        if (!StructuralScanner::kernel_supported(kernel)) continue;
+        std::vector<uint32_t> aligned = scan_with(kernel, ',', input.data(), 200);
+        for (size_t offset = 1; offset < 32; offset++) {
+            std::string shifted = std::string(offset, '.') + input;
+            std::vector<uint32_t> got = scan_with(kernel, ',', shifted.data() + offset, 200);
+            EXPECT_EQ(got, aligned) << scan_kernel_name(kernel) << " offset " << offset;
+        }
+    }
+}
+
+TEST(SimdScanner, UnsupportedKernelThrows) {
+    for (ScanKernel kernel : kAllKernels) {
+        if (StructuralScanner::kernel_supported(kernel)) {
+            EXPECT_EQ(StructuralScanner(',', kernel).kernel(), kernel);
+        } else {
+            EXPECT_THROW(StructuralScanner(',', kernel), std::runtime_error);
+        }
+    }
+}
+
+}  // namespace
+}  // namespace fleet
@@ -0,0 +1,357 @@
+// Consumers of parsed rows: BatchRing, VehicleAggregator, WindowRollup and
+// the SQLite loader
+
+#include "batch_ring.h"
+#include "sqlite_loader.h"
+#include "telemetry_batch.h"
+#include "telemetry_parser.h"
+#include "test_support.h"
+#include "vehicle_aggregator.h"
+#include "window_rollup.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef FLEET_HAVE_SQLITE
+#include <sqlite3.h>
+#endif
+
+namespace fleet {
+namespace {
+
+std::vector<TelemetryData> sample_records(size_t rows, size_t vehicles = 8) {
+    TelemetryParser parser;
+    return parser.parse_string(test::make_csv(rows, vehicles));
+}
+
+// ============================================================================
+// BatchRing
+// ============================================================================
+
+TEST(BatchRing, EverySinkSeesEveryBatchInOrder) {
+    std::vector<int64_t> first;
+    std::vector<int64_t> second;
+    {
+        BatchRing<TelemetryBatch> ring(3, {
+            [&](const TelemetryBatch& b) { first.push_back(b.timestamp[0]); },
+            [&](const TelemetryBatch& b) { second.push_back(b.timestamp[0]); },
+        });
+        for (int64_t i = 0; i < 1000; i++) {
+            size_t slot = ring.acquire();
+            EXPECT_TRUE(ring[slot].empty()) << "slots come back cleared";
+            TelemetryData data;
+            data.vehicle_id = "V";
+            data.timestamp = i;
+            ring[slot].append(data);
+            ring.publish(slot);
+        }
+        ring.close();
+        EXPECT_EQ(ring.published(), 1000u);
+    }
+    ASSERT_EQ(first.size(), 1000u);
+    for (int64_t i = 0; i < 1000; i++) EXPECT_EQ(first[i], i);
+    EXPECT_EQ(first, second);
+}
+
+TEST(BatchRing, ManyProducers) {
+    std::atomic<uint64_t> sum{0};
+    {
+        BatchRing<TelemetryBatch> ring(4, {[&](const TelemetryBatch& b) {
+            for (int64_t t : b.timestamp) sum += static_cast<uint64_t>(t);
+        }});
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; p++) {
+            producers.emplace_back([&ring, p]() {
+                for (int i = 0; i < 500; i++) {
+                    size_t slot = ring.acquire();
+                    TelemetryData data;
+                    data.timestamp = p * 500 + i;
+                    ring[slot].append(data);
+                    ring.publish(slot);
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        ring.close();
+    }
+    EXPECT_EQ(sum.load(), 1999u * 2000u / 2);
+}
+
+TEST(BatchRing, SinkErrorStopsProducers) {
+    BatchRing<TelemetryBatch> ring(2, {[](const TelemetryBatch&) { throw std::runtime_error("sink failed"); }});
+    size_t published = 0;
+    EXPECT_THROW(
+        for (;;) {
+            size_t slot = ring.acquire();
+            ring[slot].append(TelemetryData());
+            ring.publish(slot);
+            published++;
+        },
+        std::runtime_error);
+    EXPECT_TRUE(ring.failed());
+    EXPECT_GE(published, 1u);
+    EXPECT_THROW(ring.acquire(), std::runtime_error);
+    EXPECT_THROW(ring.close(), std::runtime_error);
+}
+
+// Producers finishing out of order still publish in sequence order, with
+// fewer slots than producers
+TEST(OrderedPublisher, PublishesInSequenceOrder) {
+    constexpr size_t kSequences = 16;
+    constexpr int64_t kBatches = 50;
+    std::vector<int64_t> seen;
+    {
+        BatchRing<TelemetryBatch> ring(3, {[&](const TelemetryBatch& b) { seen.push_back(b.timestamp[0]); }});
+        OrderedPublisher<TelemetryBatch> publisher(ring, kSequences);
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < 4; p++) {
+            producers.emplace_back([&publisher, p]() {
+                for (size_t s = 3 - p; s < kSequences; s += 4) {
+                    for (int64_t b = 0; b < kBatches; b++) {
+                        size_t slot = publisher.acquire(s);
+                        TelemetryData data;
+                        data.timestamp = static_cast<int64_t>(s) * kBatches + b;
+                        publisher[slot].append(data);
+                        publisher.publish(s, slot);
+                    }
+                    publisher.finish(s);
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        publisher.rethrow();
+        ring.close();
+    }
+    ASSERT_EQ(seen.size(), kSequences * kBatches);
+    for (size_t i = 0; i < seen.size(); i++) EXPECT_EQ(seen[i], static_cast<int64_t>(i));
+}
+
+TEST(OrderedPublisher, FailureStopsOtherProducers) {
+    BatchRing<TelemetryBatch> ring(2, {[](const TelemetryBatch&) {}});
+    OrderedPublisher<TelemetryBatch> publisher(ring, 2);
+    // Sequence 1 parks a slot, then waits for credits that never come
+    size_t parked = publisher.acquire(1);
+    publisher[parked].append(TelemetryData());
+    publisher.publish(1, parked);
+    std::thread waiter([&publisher]() { EXPECT_THROW(publisher.acquire(1), std::runtime_error); });
+    publisher.fail(std::make_exception_ptr(std::runtime_error("parse failed")));
+    waiter.join();
+    EXPECT_THROW(publisher.rethrow(), std::runtime_error);
+    ring.close();
+    EXPECT_EQ(ring.published(), 0u);
+}
+
+// ============================================================================
+// VehicleAggregator
+// ============================================================================
+
+TEST(VehicleAggregator, Summaries) {
+    auto records = sample_records(4000, 8);
+    VehicleAggregator aggregator;
+    for (const auto& r : records) aggregator.add(r);
+    EXPECT_EQ(aggregator.vehicle_count(), 8u);
+    EXPECT_EQ(aggregator.record_count(), records.size());
+
+    auto summary = aggregator.summary("VEH-003");
+    ASSERT_TRUE(summary.has_value());
+    uint64_t count = 0;
+    double max_speed = 0;
+    double min_odo = 1e300, max_odo = 0;
+    uint64_t alerts = 0;
+    for (const auto& r : records) {
+        if (r.vehicle_id != "VEH-003") continue;
+        count++;
+        max_speed = std::max(max_speed, r.speed);
+        min_odo = std::min(min_odo, r.odometer_km);
+        max_odo = std::max(max_odo, r.odometer_km);
+        alerts += !r.diagnostic_code.empty();
+    }
+    EXPECT_EQ(summary->total_records, count);
+    EXPECT_EQ(summary->max_speed, max_speed);
+    EXPECT_DOUBLE_EQ(summary->total_distance_km, max_odo - min_odo);
+    EXPECT_EQ(summary->diagnostic_alerts, alerts);
+    EXPECT_FALSE(aggregator.summary("nope").has_value());
+
+    auto all = aggregator.summaries();
+    ASSERT_EQ(all.size(), 8u);
+    EXPECT_EQ(all.front().vehicle_id, "VEH-001");
+}
+
+TEST(VehicleAggregator, BatchesAndMergeMatchRows) {
+    auto records = sample_records(3000, 5);
+    VehicleAggregator by_row;
+    TelemetryBatch batch;
+    for (const auto& r : records) {
+        by_row.add(r);
+        batch.append(r);
+    }
+
+    // Split in two aggregators, in order, then merged
+    VehicleAggregator head;
+    VehicleAggregator tail;
+    TelemetryBatch first;
+    TelemetryBatch second;
+    first.append(batch, 0, 1200);
+    second.append(batch, 1200, batch.size());
+    head.add(first);
+    tail.add(second);
+    head.merge(tail);
+
+    auto expected = by_row.summaries();
+    auto merged = head.summaries();
+    ASSERT_EQ(merged.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(merged[i].vehicle_id, expected[i].vehicle_id);
+        EXPECT_EQ(merged[i].total_records, expected[i].total_records);
+        EXPECT_EQ(merged[i].first_timestamp, expected[i].first_timestamp);
+        EXPECT_EQ(merged[i].last_timestamp, expected[i].last_timestamp);
+        // Summed in two parts, so only equal to rounding
+        EXPECT_NEAR(merged[i].avg_speed, expected[i].avg_speed, 1e-12 * expected[i].avg_speed);
+        EXPECT_DOUBLE_EQ(merged[i].fuel_consumed_pct, expected[i].fuel_consumed_pct);
+        EXPECT_EQ(merged[i].engine_temp_p90, expected[i].engine_temp_p90);
+        EXPECT_EQ(merged[i].diagnostic_codes, expected[i].diagnostic_codes);
+    }
+}
+
+TEST(VehicleAggregator, IndependentOfRowOrder) {
+    auto records = sample_records(4000, 4);
+    VehicleAggregator ordered;
+    for (const auto& r : records) ordered.add(r);
+
+    // Rows shuffled, then split in two merged the "wrong" way round, as an
+    // unordered parallel parse would deliver them
+    std::mt19937 rng(7);
+    std::shuffle(records.begin(), records.end(), rng);
+    VehicleAggregator head;
+    VehicleAggregator tail;
+    for (size_t i = 0; i < records.size(); i++) (i < 1500 ? head : tail).add(records[i]);
+    tail.merge(head);
+
+    auto expected = ordered.summaries();
+    auto shuffled = tail.summaries();
+    ASSERT_EQ(shuffled.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        SCOPED_TRACE(expected[i].vehicle_id);
+        EXPECT_EQ(shuffled[i].first_timestamp, expected[i].first_timestamp);
+        EXPECT_EQ(shuffled[i].last_timestamp, expected[i].last_timestamp);
+        EXPECT_GT(expected[i].fuel_consumed_pct, 0.0);
+        EXPECT_EQ(shuffled[i].fuel_consumed_pct, expected[i].fuel_consumed_pct);
+        EXPECT_EQ(shuffled[i].total_distance_km, expected[i].total_distance_km);
+        EXPECT_EQ(shuffled[i].engine_temp_p90, expected[i].engine_temp_p90);
+    }
+
+    // Earliest level minus latest; a refuel above the start counts as none
+    VehicleAggregator refuel;
+    TelemetryData row{};
+    row.vehicle_id = "V";
+    for (auto [timestamp, fuel] : {std::pair<int64_t, double>{3000, 90}, {1000, 60}, {2000, 20}}) {
+        row.timestamp = timestamp;
+        row.fuel_level = fuel;
+        refuel.add(row);
+    }
+    EXPECT_EQ(refuel.summary("V")->fuel_consumed_pct, 0.0);
+    row.timestamp = 500;
+    row.fuel_level = 95;
+    refuel.add(row);
+    EXPECT_EQ(refuel.summary("V")->fuel_consumed_pct, 5.0);
+}
+
+// ============================================================================
+// WindowRollup
+// ============================================================================
+
+TEST(WindowRollup, TumblingWindows) {
+    auto records = sample_records(600, 3);   // one row per second, 3 vehicles
+    std::vector<TelemetryWindow> windows;
+    WindowConfig config;
+    config.window_ms = 60000;
+    WindowRollup rollup(config, [&](TelemetryWindow&& w) { windows.push_back(std::move(w)); });
+    for (const auto& r : records) rollup.add(r);
+    rollup.flush();
+
+    uint64_t rows = 0;
+    for (const auto& w : windows) {
+        EXPECT_EQ(w.window_end - w.window_start, 60000);
+        EXPECT_EQ(w.window_start % 60000, 0);
+        EXPECT_GE(w.first_timestamp, w.window_start);
+        EXPECT_LT(w.last_timestamp, w.window_end);
+        rows += w.records;
+    }
+    EXPECT_EQ(rows, records.size());
+    EXPECT_EQ(rollup.late_records(), 0u);
+    EXPECT_EQ(windows.size(), rollup.windows_out());
+    EXPECT_EQ(parse_window_duration("5m"), 300000);
+    EXPECT_FALSE(parse_window_duration("-1s").has_value());
+}
+
+// ============================================================================
+// SqliteLoader
+// ============================================================================
+
+#ifdef FLEET_HAVE_SQLITE
+
+struct Database {
+    sqlite3* db = nullptr;
+    explicit Database(const std::string& path) { sqlite3_open(path.c_str(), &db); }
+    ~Database() { sqlite3_close(db); }
+};
+
+TEST(SqliteLoader, LoadsEveryRow) {
+    test::TempDir dir;
+    auto records = sample_records(5000);
+    SqliteLoaderConfig config;
+    config.batch_rows = 700;
+    config.rows_per_transaction = 2000;
+    {
+        SqliteLoader loader(dir.file("fleet.db"), config);
+        for (const auto& r : records) loader.write(r);
+        loader.finish();
+        EXPECT_EQ(loader.rows_written(), records.size());
+    }
+
+    Database db(dir.file("fleet.db"));
+    sqlite3_stmt* stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(db.db,
+                                 "SELECT vehicle_id, latitude, longitude, engine_rpm, odometer_km, "
+                                 "diagnostic_code, speed, heading, fuel_level, engine_temp, battery_volt "
+                                 "FROM telemetry ORDER BY id",
+                                 -1, &stmt, nullptr),
+              SQLITE_OK);
+    size_t i = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ASSERT_LT(i, records.size());
+        const auto& r = records[i++];
+        EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))), r.vehicle_id);
+        EXPECT_EQ(sqlite3_column_double(stmt, 1), r.latitude);
+        EXPECT_EQ(sqlite3_column_double(stmt, 2), r.longitude);
+        EXPECT_EQ(sqlite3_column_int(stmt, 3), r.engine_rpm);
+        EXPECT_EQ(sqlite3_column_double(stmt, 4), r.odometer_km);
+        EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5))), r.diagnostic_code);
+        EXPECT_EQ(sqlite3_column_double(stmt, 6), r.speed);
+        EXPECT_EQ(sqlite3_column_double(stmt, 7), r.heading);
+        EXPECT_EQ(sqlite3_column_double(stmt, 8), r.fuel_level);
+        EXPECT_EQ(sqlite3_column_double(stmt, 9), r.engine_temp);
+        EXPECT_EQ(sqlite3_column_double(stmt, 10), r.battery_volt);
+        if (::testing::Test::HasFailure()) break;
+    }
+    sqlite3_finalize(stmt);
+    EXPECT_EQ(i, records.size());
+
+    // Deferred indexes are back
+    ASSERT_EQ(sqlite3_prepare_v2(db.db, "SELECT count(*) FROM sqlite_master WHERE type = 'index' "
+                                        "AND name LIKE 'idx_telemetry_%'", -1, &stmt, nullptr),
+              SQLITE_OK);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 5);
+    sqlite3_finalize(stmt);
+}
+
+#endif  // FLEET_HAVE_SQLITE
+
+}  // namespace
+}  // namespace fleet
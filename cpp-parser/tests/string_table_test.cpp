@@ -0,0 +1,59 @@
+#include "string_table.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+
+namespace fleet {
+namespace {
+
+TEST(StringTable, InternsInFirstSeenOrder) {
+    StringTable table;
+    EXPECT_EQ(table.size(), 1u);
+    EXPECT_EQ(table.intern(""), StringTable::kEmpty);
+    EXPECT_EQ(table.intern("a"), 1u);
+    EXPECT_EQ(table.intern("b"), 2u);
+    EXPECT_EQ(table.intern("a"), 1u);
+    EXPECT_EQ(table.view(2), "b");
+    EXPECT_EQ(table.find("b"), 2u);
+    EXPECT_FALSE(table.find("c").has_value());
+}
+
+TEST(StringTable, ViewsSurviveGrowth) {
+    StringTable table;
+    std::string_view first = table.view(table.intern("first"));
+    for (int i = 0; i < 100000; i++) table.intern("key-" + std::to_string(i));
+    EXPECT_EQ(first, "first");
+    EXPECT_EQ(table.view(table.intern("key-99999")), "key-99999");
+}
+
+TEST(StringTable, CopyKeepsHandles) {
+    StringTable table;
+    table.intern("x");
+    table.intern("y");
+    StringTable copy(table);
+    EXPECT_EQ(copy.size(), 3u);
+    EXPECT_EQ(copy.view(2), "y");
+    EXPECT_EQ(copy.intern("x"), 1u);
+}
+
+TEST(StringTable, MovedFromTableKeepsEmptyHandle) {
+    StringTable table;
+    table.intern("x");
+    StringTable moved(std::move(table));
+    EXPECT_EQ(moved.view(1), "x");
+    ASSERT_EQ(table.size(), 1u);
+    EXPECT_EQ(table.view(StringTable::kEmpty), "");
+    EXPECT_EQ(table.intern(""), StringTable::kEmpty);
+    EXPECT_EQ(table.find(""), StringTable::kEmpty);
+    EXPECT_FALSE(table.find("x").has_value());
+    EXPECT_EQ(table.intern("y"), 1u);
+
+    StringTable assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.view(1), "x");
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(moved.intern("z"), 1u);
+}
+
+}  // namespace
+}  // namespace fleet
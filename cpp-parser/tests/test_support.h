@@ -0,0 +1,197 @@
+#ifndef FLEET_TEST_SUPPORT_H
+#define FLEET_TEST_SUPPORT_H
+
+// Fixtures shared by the fleet_tests suites: a scratch directory, a
+// deterministic synthetic fleet and record / batch comparisons.
+
+#include "telemetry_batch.h"
+#include "telemetry_parser.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef FLEET_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace fleet {
+namespace test {
+
+const char* const kCsvHeader =
+    "vehicle_id,timestamp,latitude,longitude,speed,heading,engine_rpm,"
+    "fuel_level,odometer_km,engine_temp,battery_volt,diagnostic_code\n";
+
+// Directory under $TMPDIR removed with everything in it on destruction
+class TempDir {
+public:
+    TempDir() {
+        const char* base = std::getenv("TMPDIR");
+        std::string pattern = std::string(base && *base ? base : "/tmp") + "/fleet_test_XXXXXX";
+        std::vector<char> buf(pattern.begin(), pattern.end());
+        buf.push_back('\0');
+        if (::mkdtemp(buf.data()) == nullptr) throw std::runtime_error("mkdtemp failed");
+        path_ = buf.data();
+    }
+    ~TempDir() { remove_tree(path_); }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    const std::string& path() const { return path_; }
+    std::string file(const std::string& name) const { return path_ + "/" + name; }
+
+private:
+    static void remove_tree(const std::string& path) {
+        if (DIR* dir = ::opendir(path.c_str())) {
+            while (dirent* entry = ::readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name == "." || name == "..") continue;
+                std::string child = path + "/" + name;
+                struct stat st;
+                if (::lstat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+                    remove_tree(child);
+                } else {
+                    ::unlink(child.c_str());
+                }
+            }
+            ::closedir(dir);
+        }
+        ::rmdir(path.c_str());
+    }
+
+    std::string path_;
+};
+
+inline void write_file(const std::string& path, const std::string& contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    if (!out) throw std::runtime_error("cannot write " + path);
+}
+
+inline std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+#ifdef FLEET_HAVE_ZLIB
+// Gzip contents into path as one member
+inline void write_gzip(const std::string& path, const std::string& contents) {
+    gzFile gz = gzopen(path.c_str(), "wb6");
+    if (gz == nullptr) throw std::runtime_error("cannot write " + path);
+    size_t pos = 0;
+    while (pos < contents.size()) {
+        unsigned n = static_cast<unsigned>(std::min<size_t>(contents.size() - pos, 1 << 20));
+        gzwrite(gz, contents.data() + pos, n);
+        pos += n;
+    }
+    gzclose(gz);
+}
+#endif
+
+// Synthetic fleet rows, the same every run. Values carry at most six
+// (coordinates) or two decimals, so they survive the text writers exactly.
+// Every invalid_every-th row has an out-of-range latitude.
+inline std::string make_csv(size_t rows, size_t vehicles = 16, size_t invalid_every = 0,
+                            bool header = true) {
+    static const char* const kCodes[] = {"", "", "", "", "", "P0420", "", "P0171"};
+    std::string out = header ? kCsvHeader : "";
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    auto next = [&state](uint64_t range) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state % range;
+    };
+    char buf[256];
+    for (size_t i = 0; i < rows; i++) {
+        const size_t v = i % vehicles;
+        const bool invalid = invalid_every != 0 && i % invalid_every == invalid_every - 1;
+        int n = std::snprintf(
+            buf, sizeof(buf), "VEH-%03zu,%lld,%.6f,%.6f,%.2f,%.2f,%d,%.2f,%.2f,%.2f,%.2f,%s\n",
+            v + 1,
+            static_cast<long long>(1704067200000LL + static_cast<int64_t>(i) * 1000),
+            invalid ? 123.0 : 28.5 + static_cast<double>(next(100000)) / 1e6,
+            -81.3 + static_cast<double>(next(100000)) / 1e6,
+            static_cast<double>(next(12000)) / 100,
+            static_cast<double>(next(36000)) / 100,
+            800 + static_cast<int>(next(5200)),
+            100.0 - static_cast<double>(i / vehicles % 8000) / 100,
+            50000.0 + static_cast<double>(v) * 7 + static_cast<double>(i / vehicles) / 100,
+            75.0 + static_cast<double>(next(3500)) / 100,
+            11.5 + static_cast<double>(next(250)) / 100,
+            kCodes[i % 8]);
+        out.append(buf, static_cast<size_t>(n));
+    }
+    return out;
+}
+
+// Order-insensitive key for comparing parallel unordered output
+inline std::pair<std::string, int64_t> record_key(const TelemetryData& r) {
+    return {std::string(r.vehicle_id), r.timestamp};
+}
+
+inline void expect_same_record(const TelemetryData& a, const TelemetryData& b) {
+    EXPECT_EQ(a.vehicle_id, b.vehicle_id);
+    EXPECT_EQ(a.timestamp, b.timestamp);
+    EXPECT_EQ(a.latitude, b.latitude);
+    EXPECT_EQ(a.longitude, b.longitude);
+    EXPECT_EQ(a.speed, b.speed);
+    EXPECT_EQ(a.heading, b.heading);
+    EXPECT_EQ(a.engine_rpm, b.engine_rpm);
+    EXPECT_EQ(a.fuel_level, b.fuel_level);
+    EXPECT_EQ(a.odometer_km, b.odometer_km);
+    EXPECT_EQ(a.engine_temp, b.engine_temp);
+    EXPECT_EQ(a.battery_volt, b.battery_volt);
+    EXPECT_EQ(a.diagnostic_code, b.diagnostic_code);
+}
+
+template <typename A, typename B>
+void expect_same_records(const A& a, const B& b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        SCOPED_TRACE("record " + std::to_string(i));
+        expect_same_record(a[i], b[i]);
+        if (::testing::Test::HasFailure()) return;
+    }
+}
+
+// Row i of a batch against a record
+inline void expect_batch_row(const TelemetryBatch& batch, size_t i, const TelemetryData& r) {
+    EXPECT_EQ(batch.vehicle(i), r.vehicle_id);
+    EXPECT_EQ(batch.timestamp[i], r.timestamp);
+    EXPECT_EQ(batch.latitude[i], r.latitude);
+    EXPECT_EQ(batch.longitude[i], r.longitude);
+    EXPECT_EQ(batch.speed[i], r.speed);
+    EXPECT_EQ(batch.heading[i], r.heading);
+    EXPECT_EQ(batch.engine_rpm[i], r.engine_rpm);
+    EXPECT_EQ(batch.fuel_level[i], r.fuel_level);
+    EXPECT_EQ(batch.odometer_km[i], r.odometer_km);
+    EXPECT_EQ(batch.engine_temp[i], r.engine_temp);
+    EXPECT_EQ(batch.battery_volt[i], r.battery_volt);
+    EXPECT_EQ(batch.diagnostic(i), r.diagnostic_code);
+}
+
+inline void expect_batch_matches(const TelemetryBatch& batch, const std::vector<TelemetryData>& records) {
+    ASSERT_EQ(batch.size(), records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        SCOPED_TRACE("row " + std::to_string(i));
+        expect_batch_row(batch, i, records[i]);
+        if (::testing::Test::HasFailure()) return;
+    }
+}
+
+}  // namespace test
+}  // namespace fleet
+
+#endif  // FLEET_TEST_SUPPORT_H
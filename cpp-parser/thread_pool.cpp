@@ -0,0 +1,117 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <utility>
+
+namespace fleet {
+
+size_t ThreadPool::resolve_threads(size_t requested) {
+    if (requested > 0) return requested;
+    size_t hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    size_t count = resolve_threads(num_threads);
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::worker_loop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            // Drain remaining work before shutting down
+            if (tasks_.empty()) return;
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+// ============================================================================
+// WorkStealingPool implementation
+// ============================================================================
+
+WorkStealingPool::WorkStealingPool(size_t num_threads, size_t count,
+                                   std::function<void(size_t task)> run)
+    : run_(std::move(run)) {
+    size_t threads = std::max<size_t>(1, std::min(ThreadPool::resolve_threads(num_threads), count));
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; i++) queues_.push_back(std::make_unique<Queue>());
+    for (size_t task = 0; task < count; task++) queues_[task % threads]->tasks.push_back(task);
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        workers_.emplace_back([this, i]() { worker_loop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    join();
+}
+
+void WorkStealingPool::join() {
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void WorkStealingPool::wait() {
+    join();
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+bool WorkStealingPool::take(size_t self, size_t& task) {
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues_.size(); i++) {
+        Queue& victim = *queues_[(self + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(size_t self) {
+    // No task is added after construction, so empty queues everywhere mean done
+    size_t task;
+    while (take(self, task)) {
+        try {
+            run_(task);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+    }
+}
+
+}  // namespace fleet
@@ -0,0 +1,106 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fleet {
+
+// Fixed-size worker pool executing queued tasks in FIFO order
+class ThreadPool {
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task; the returned future carries its result or exception
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    size_t size() const { return workers_.size(); }
+
+    // Resolve a requested thread count (0 = hardware concurrency, at least 1)
+    static size_t resolve_threads(size_t requested);
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+// Work-stealing execution of a fixed set of tasks.
+//
+// Tasks [0, count) are dealt round-robin onto one deque per worker. A
+// worker runs its own tasks oldest first and, once its deque is empty,
+// steals the newest task from another worker's, so a worker held up by a
+// large task sheds the rest of its queue to idle ones. Construction starts
+// the workers; wait() joins them and rethrows the first exception a task
+// threw, after the remaining tasks have run. The destructor only joins.
+class WorkStealingPool {
+public:
+    // 0 threads means one per hardware thread
+    WorkStealingPool(size_t num_threads, size_t count, std::function<void(size_t task)> run);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void wait();
+
+    size_t size() const { return workers_.size(); }
+    size_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void worker_loop(size_t self);
+    bool take(size_t self, size_t& task);
+    void join();
+
+    std::function<void(size_t)> run_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> steals_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+template <typename F>
+auto ThreadPool::submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+
+    // std::function needs a copyable target, so the packaged task lives on the heap
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> future = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace([packaged]() { (*packaged)(); });
+    }
+    cv_.notify_one();
+    return future;
+}
+
+}  // namespace fleet
+
+#endif  // THREAD_POOL_H
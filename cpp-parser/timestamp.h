@@ -0,0 +1,289 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include "fast_decode.h"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace fleet {
+
+// Timestamp decoder shared by the CSV and log paths.
+//
+// Every form is returned as Unix milliseconds:
+//   ISO 8601       2024-01-15T10:30:00[.fff][Z | +hh:mm | -hh:mm | +hhmm | +hh]
+//                  ('T' may be a space; no offset means UTC; a bare date is midnight)
+//   epoch seconds  1705314600 or 1705314600.25 (at most 10 integer digits)
+//   epoch millis   1705314600000 (11 to 18 digits)
+//
+// Working out which form a field holds is the branchy part, so it is kept
+// apart: sniff_timestamp() classifies a field once, and parse_timestamp_as()
+// decodes against a known format with fixed-position SWAR checks. The
+// parser sniffs the first row of a file and re-sniffs only when a row stops
+// matching. Decoding never allocates.
+
+enum class TimestampFormat : uint8_t {
+    Unknown,
+    EpochSeconds,
+    EpochMillis,
+    Iso8601,
+};
+
+namespace detail {
+
+// Days from 1970-01-01 to y-m-d in the proleptic Gregorian calendar
+// (Howard Hinnant's days_from_civil)
+constexpr int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Inverse of days_from_civil (Hinnant's civil_from_days)
+constexpr void civil_from_days(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+constexpr bool is_leap_year(int64_t y) {
+    return (y % 4 == 0) && (y % 100 != 0 || y % 400 == 0);
+}
+
+// Days before each month in common and leap years
+constexpr uint16_t kMonthStart[2][13] = {
+    {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+    {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366},
+};
+
+// days_from_civil(year, 1, 1) for 1900-2155; other years use the formula
+struct YearTable {
+    static constexpr unsigned kFirst = 1900;
+    static constexpr unsigned kCount = 256;
+    int32_t days[kCount];
+
+    constexpr YearTable() : days() {
+        for (unsigned i = 0; i < kCount; i++) {
+            days[i] = static_cast<int32_t>(days_from_civil(kFirst + i, 1, 1));
+        }
+    }
+};
+inline constexpr YearTable kYearTable{};
+
+static_assert(kYearTable.days[70] == 0, "1970-01-01 is day 0");
+static_assert(kYearTable.days[200] == 47482, "2000 is a leap year, 2100 is not");
+static_assert(days_from_civil(2100, 3, 1) - days_from_civil(2100, 2, 28) == 1, "no Feb 29, 2100");
+
+inline unsigned digit_at(const char* p, size_t i) {
+    return static_cast<unsigned>(p[i] - '0');
+}
+
+inline unsigned two_digits(const char* p, size_t i) {
+    return digit_at(p, i) * 10 + digit_at(p, i + 1);
+}
+
+inline uint64_t load_word(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// One 8-byte window of an ISO date-time: ASCII digits in the digit_mask
+// bytes and the expected separators in the sep_mask bytes
+inline bool window_matches(uint64_t v, uint64_t digit_mask, uint64_t sep_mask, uint64_t separators) {
+    uint64_t digits = (v & digit_mask) | (0x3030303030303030ull & ~digit_mask);
+    return is_eight_digits(digits) & ((v & sep_mask) == separators);
+}
+
+// Unsigned decimal of n (1-18) digits, eight at a time
+inline bool parse_digits(const char* p, size_t n, uint64_t& value) {
+    value = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t chunk = load_word(p + i);
+        if (!is_eight_digits(chunk)) return false;
+        value = value * 100000000 + parse_eight_digits(chunk);
+    }
+    for (; i < n; i++) {
+        unsigned d = digit_at(p, i);
+        if (d > 9) return false;
+        value = value * 10 + d;
+    }
+    return true;
+}
+
+// Fraction digits after a decimal point, truncated to milliseconds
+inline bool parse_fraction_ms(const char* p, size_t n, unsigned& ms) {
+    if (n == 0) return false;
+    uint64_t value;
+    if (!parse_digits(p, n < 3 ? n : 3, value)) return false;
+    for (size_t i = 3; i < n; i++) {
+        if (digit_at(p, i) > 9) return false;
+    }
+    static constexpr unsigned kScale[] = {1000, 100, 10, 1};
+    ms = static_cast<unsigned>(value) * kScale[n < 3 ? n : 3];
+    return true;
+}
+
+// Offset after the time: "Z", "+hh", "+hhmm", "+hh:mm" (or '-'); in ms
+inline bool parse_utc_offset(const char* p, size_t n, int64_t& offset_ms) {
+    if (n == 1 && (p[0] == 'Z' || p[0] == 'z')) {
+        offset_ms = 0;
+        return true;
+    }
+    if (p[0] != '+' && p[0] != '-') return false;
+    unsigned hours;
+    unsigned minutes = 0;
+    bool ok;
+    switch (n) {
+        case 3:
+            ok = (digit_at(p, 1) < 10) & (digit_at(p, 2) < 10);
+            break;
+        case 5:
+            ok = (digit_at(p, 1) < 10) & (digit_at(p, 2) < 10) &
+                 (digit_at(p, 3) < 10) & (digit_at(p, 4) < 10);
+            minutes = two_digits(p, 3);
+            break;
+        case 6:
+            ok = (digit_at(p, 1) < 10) & (digit_at(p, 2) < 10) & (p[3] == ':') &
+                 (digit_at(p, 4) < 10) & (digit_at(p, 5) < 10);
+            minutes = two_digits(p, 4);
+            break;
+        default:
+            return false;
+    }
+    hours = two_digits(p, 1);
+    if (!ok || hours > 23 || minutes > 59) return false;
+    int64_t offset = (hours * 60 + minutes) * int64_t(60000);
+    offset_ms = p[0] == '-' ? -offset : offset;
+    return true;
+}
+
+inline bool parse_iso8601(std::string_view str, int64_t& out) {
+    const char* p = str.data();
+    const size_t n = str.size();
+    if (n < 10) return false;
+
+    // "YYYY-MM-" then "DD"
+    bool ok = window_matches(load_word(p), 0x00FFFF00FFFFFFFFull,
+                             0xFF0000FF00000000ull, 0x2D00002D00000000ull);
+    ok &= (digit_at(p, 8) < 10) & (digit_at(p, 9) < 10);
+    if (!ok) return false;
+
+    const unsigned year = digit_at(p, 0) * 1000 + digit_at(p, 1) * 100 + two_digits(p, 2);
+    const unsigned month = two_digits(p, 5);
+    const unsigned day = two_digits(p, 8);
+    const int leap = is_leap_year(year);
+    if (month - 1 >= 12) return false;
+    if (day - 1 >= static_cast<unsigned>(kMonthStart[leap][month] - kMonthStart[leap][month - 1])) {
+        return false;
+    }
+
+    int64_t days = year - YearTable::kFirst < YearTable::kCount
+        ? kYearTable.days[year - YearTable::kFirst]
+        : days_from_civil(year, 1, 1);
+    days += kMonthStart[leap][month - 1] + day - 1;
+    int64_t ms = days * 86400000;
+    if (n == 10) {
+        out = ms;
+        return true;
+    }
+
+    // "THH:MM:SS"; the window at 11 covers "HH:MM:SS"
+    if (n < 19) return false;
+    const char t = p[10];
+    ok = (t == 'T') | (t == ' ') | (t == 't');
+    ok &= window_matches(load_word(p + 11), 0xFFFF00FFFF00FFFFull,
+                         0x0000FF0000FF0000ull, 0x00003A00003A0000ull);
+    if (!ok) return false;
+
+    const unsigned hour = two_digits(p, 11);
+    const unsigned minute = two_digits(p, 14);
+    const unsigned second = two_digits(p, 17);  // 60 = leap second
+    if (hour > 23 || minute > 59 || second > 60) return false;
+    ms += (hour * 3600 + minute * 60 + second) * int64_t(1000);
+
+    size_t i = 19;
+    if (i < n && (p[i] == '.' || p[i] == ',')) {
+        size_t start = ++i;
+        while (i < n && digit_at(p, i) < 10) i++;
+        unsigned frac;
+        if (!parse_fraction_ms(p + start, i - start, frac)) return false;
+        ms += frac;
+    }
+
+    if (i < n) {
+        int64_t offset;
+        if (!parse_utc_offset(p + i, n - i, offset)) return false;
+        ms -= offset;
+    }
+    out = ms;
+    return true;
+}
+
+inline bool parse_epoch_seconds(std::string_view str, int64_t& out) {
+    const char* p = str.data();
+    const size_t n = str.size();
+    const char* dot = static_cast<const char*>(std::memchr(p, '.', n));
+    const size_t int_digits = dot ? static_cast<size_t>(dot - p) : n;
+    if (int_digits - 1 >= 10) return false;
+
+    uint64_t seconds;
+    if (!parse_digits(p, int_digits, seconds)) return false;
+    unsigned frac = 0;
+    if (dot && !parse_fraction_ms(dot + 1, n - int_digits - 1, frac)) return false;
+    out = static_cast<int64_t>(seconds) * 1000 + frac;
+    return true;
+}
+
+inline bool parse_epoch_millis(std::string_view str, int64_t& out) {
+    if (str.size() - 11 >= 8) return false;
+    uint64_t ms;
+    if (!parse_digits(str.data(), str.size(), ms)) return false;
+    out = static_cast<int64_t>(ms);
+    return true;
+}
+
+}  // namespace detail
+
+// Classify one timestamp field
+inline TimestampFormat sniff_timestamp(std::string_view str) {
+    if (str.size() >= 10 && str[4] == '-' && str[7] == '-') return TimestampFormat::Iso8601;
+    size_t digits = 0;
+    while (digits < str.size() && detail::digit_at(str.data(), digits) < 10) digits++;
+    if (digits == 0) return TimestampFormat::Unknown;
+    if (digits <= 10) return TimestampFormat::EpochSeconds;
+    if (digits == str.size() && digits <= 18) return TimestampFormat::EpochMillis;
+    return TimestampFormat::Unknown;
+}
+
+// Decode str as format into Unix milliseconds; false (out untouched) if
+// str is not a valid value of that format
+inline bool parse_timestamp_as(std::string_view str, TimestampFormat format, int64_t& out) {
+    switch (format) {
+        case TimestampFormat::Iso8601: return detail::parse_iso8601(str, out);
+        case TimestampFormat::EpochSeconds: return detail::parse_epoch_seconds(str, out);
+        case TimestampFormat::EpochMillis: return detail::parse_epoch_millis(str, out);
+        case TimestampFormat::Unknown: break;
+    }
+    return false;
+}
+
+// Sniff and decode in one step; 0 if str is not a recognized timestamp
+inline int64_t parse_timestamp(std::string_view str) {
+    int64_t ms = 0;
+    return parse_timestamp_as(str, sniff_timestamp(str), ms) ? ms : 0;
+}
+
+}  // namespace fleet
+
+#endif  // TIMESTAMP_H
@@ -0,0 +1,330 @@
+#include "vehicle_aggregator.h"
+#include "record_writer.h"
+#include "telemetry_batch.h"
+#include <algorithm>
+#include <functional>
+
+namespace fleet {
+
+static constexpr uint32_t kUnmapped = UINT32_MAX;
+static constexpr size_t kInitialIndexSize = 64;
+
+VehicleAggregator::VehicleAggregator() {
+    index_.assign(kInitialIndexSize, 0);
+}
+
+void VehicleAggregator::clear() {
+    index_.assign(kInitialIndexSize, 0);
+    hashes_.clear();
+    names_.clear();
+    accumulators_.clear();
+    temp_histogram_.clear();
+    diagnostic_counts_.clear();
+    diagnostic_names_.clear();
+    diagnostic_index_.clear();
+    total_records_ = 0;
+    total_alerts_ = 0;
+}
+
+// ============================================================================
+// Vehicle and diagnostic lookup
+// ============================================================================
+
+uint32_t VehicleAggregator::slot(std::string_view id) {
+    const uint64_t hash = std::hash<std::string_view>()(id);
+    const size_t mask = index_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint32_t entry = index_[i];
+        if (entry == 0) {
+            const uint32_t s = static_cast<uint32_t>(names_.size());
+            index_[i] = s + 1;
+            hashes_.push_back(hash);
+            names_.emplace_back(id);
+            accumulators_.emplace_back();
+            temp_histogram_.resize(temp_histogram_.size() + kTempBins, 0);
+            diagnostic_counts_.emplace_back();
+            // Keep the load factor at or below one half
+            if (names_.size() * 2 > index_.size()) grow_index();
+            return s;
+        }
+        if (hashes_[entry - 1] == hash && names_[entry - 1] == id) return entry - 1;
+    }
+}
+
+std::optional<uint32_t> VehicleAggregator::find_slot(std::string_view id) const {
+    const uint64_t hash = std::hash<std::string_view>()(id);
+    const size_t mask = index_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint32_t entry = index_[i];
+        if (entry == 0) return std::nullopt;
+        if (hashes_[entry - 1] == hash && names_[entry - 1] == id) return entry - 1;
+    }
+}
+
+void VehicleAggregator::grow_index() {
+    index_.assign(index_.size() * 2, 0);
+    const size_t mask = index_.size() - 1;
+    for (uint32_t s = 0; s < hashes_.size(); s++) {
+        size_t i = hashes_[s] & mask;
+        while (index_[i] != 0) i = (i + 1) & mask;
+        index_[i] = s + 1;
+    }
+}
+
+uint32_t VehicleAggregator::diagnostic(std::string_view code) {
+    auto [it, inserted] = diagnostic_index_.try_emplace(std::string(code),
+                                                        static_cast<uint32_t>(diagnostic_names_.size()));
+    if (inserted) diagnostic_names_.emplace_back(code);
+    return it->second;
+}
+
+void VehicleAggregator::count_diagnostic(uint32_t s, uint32_t code, uint64_t n) {
+    // A vehicle reports few distinct codes; a short scan beats a map
+    auto& counts = diagnostic_counts_[s];
+    for (auto& entry : counts) {
+        if (entry.first == code) {
+            entry.second += n;
+            return;
+        }
+    }
+    counts.emplace_back(code, n);
+}
+
+// ============================================================================
+// Accumulation
+// ============================================================================
+
+// Called before the timestamps themselves are widened. Ties are broken by
+// level, so the result does not depend on which row arrived first.
+void VehicleAggregator::take_fuel_samples(Accumulator& a, int64_t first, double first_fuel,
+                                          int64_t last, double last_fuel) {
+    if (first < a.first_timestamp || (first == a.first_timestamp && first_fuel > a.fuel_first)) {
+        a.fuel_first = first_fuel;
+    }
+    if (last > a.last_timestamp || (last == a.last_timestamp && last_fuel < a.fuel_last)) {
+        a.fuel_last = last_fuel;
+    }
+}
+
+void VehicleAggregator::add_row(uint32_t s, int64_t timestamp, double speed, double odometer,
+                                double fuel, double temp) {
+    Accumulator& a = accumulators_[s];
+    if (a.count == 0) {
+        a.first_timestamp = a.last_timestamp = timestamp;
+        a.speed_min = a.speed_max = speed;
+        a.odometer_min = a.odometer_max = odometer;
+        a.fuel_first = a.fuel_last = fuel;
+        a.temp_min = a.temp_max = temp;
+    } else {
+        take_fuel_samples(a, timestamp, fuel, timestamp, fuel);
+        a.first_timestamp = std::min(a.first_timestamp, timestamp);
+        a.last_timestamp = std::max(a.last_timestamp, timestamp);
+        a.speed_min = std::min(a.speed_min, speed);
+        a.speed_max = std::max(a.speed_max, speed);
+        a.odometer_min = std::min(a.odometer_min, odometer);
+        a.odometer_max = std::max(a.odometer_max, odometer);
+        a.temp_min = std::min(a.temp_min, temp);
+        a.temp_max = std::max(a.temp_max, temp);
+    }
+    a.count++;
+    a.speed_sum += speed;
+    a.fuel_sum += fuel;
+    a.temp_sum += temp;
+
+    // NaN and readings below the range land in the first bin
+    double pos = temp - kTempMin;
+    size_t bin = pos >= 0 ? std::min(static_cast<size_t>(pos), kTempBins - 1) : 0;
+    temp_histogram_[s * kTempBins + bin]++;
+    total_records_++;
+}
+
+void VehicleAggregator::add(const TelemetryData& data) {
+    uint32_t s = slot(data.vehicle_id);
+    add_row(s, data.timestamp, data.speed, data.odometer_km, data.fuel_level, data.engine_temp);
+    if (!data.diagnostic_code.empty()) {
+        count_diagnostic(s, diagnostic(data.diagnostic_code), 1);
+        accumulators_[s].alerts++;
+        total_alerts_++;
+    }
+}
+
+void VehicleAggregator::add(const TelemetryBatch& batch) {
+    // Resolve each dictionary code the first time a row uses it
+    vehicle_map_.assign(batch.vehicle_dict.size(), kUnmapped);
+    diagnostic_map_.assign(batch.diagnostic_dict.size(), kUnmapped);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        uint32_t& s = vehicle_map_[batch.vehicle_id[i]];
+        if (s == kUnmapped) s = slot(batch.vehicle(i));
+        add_row(s, batch.timestamp[i], batch.speed[i], batch.odometer_km[i],
+                batch.fuel_level[i], batch.engine_temp[i]);
+
+        const uint32_t code = batch.diagnostic_code[i];
+        if (code != StringTable::kEmpty) {
+            uint32_t& d = diagnostic_map_[code];
+            if (d == kUnmapped) d = diagnostic(batch.diagnostic(i));
+            count_diagnostic(s, d, 1);
+            accumulators_[s].alerts++;
+            total_alerts_++;
+        }
+    }
+}
+
+void VehicleAggregator::merge(const VehicleAggregator& other) {
+    for (uint32_t o = 0; o < other.names_.size(); o++) {
+        const Accumulator& b = other.accumulators_[o];
+        uint32_t s = slot(other.names_[o]);
+        Accumulator& a = accumulators_[s];
+        if (a.count == 0) {
+            a = b;
+        } else if (b.count != 0) {
+            take_fuel_samples(a, b.first_timestamp, b.fuel_first, b.last_timestamp, b.fuel_last);
+            a.first_timestamp = std::min(a.first_timestamp, b.first_timestamp);
+            a.last_timestamp = std::max(a.last_timestamp, b.last_timestamp);
+            a.speed_min = std::min(a.speed_min, b.speed_min);
+            a.speed_max = std::max(a.speed_max, b.speed_max);
+            a.odometer_min = std::min(a.odometer_min, b.odometer_min);
+            a.odometer_max = std::max(a.odometer_max, b.odometer_max);
+            a.temp_min = std::min(a.temp_min, b.temp_min);
+            a.temp_max = std::max(a.temp_max, b.temp_max);
+            a.count += b.count;
+            a.speed_sum += b.speed_sum;
+            a.fuel_sum += b.fuel_sum;
+            a.temp_sum += b.temp_sum;
+            a.alerts += b.alerts;
+        }
+
+        const uint32_t* from = &other.temp_histogram_[o * kTempBins];
+        uint32_t* to = &temp_histogram_[s * kTempBins];
+        for (size_t bin = 0; bin < kTempBins; bin++) to[bin] += from[bin];
+
+        for (const auto& [code, n] : other.diagnostic_counts_[o]) {
+            count_diagnostic(s, diagnostic(other.diagnostic_names_[code]), n);
+        }
+    }
+    total_records_ += other.total_records_;
+    total_alerts_ += other.total_alerts_;
+}
+
+// ============================================================================
+// Summaries
+// ============================================================================
+
+// Value below which a fraction q of the histogram's samples fall,
+// interpolated linearly inside the bin and clamped to the observed range
+static double histogram_percentile(const uint32_t* bins, uint64_t count, double q,
+                                   double min, double max) {
+    const double rank = q * static_cast<double>(count);
+    uint64_t below = 0;
+    for (size_t bin = 0; bin < VehicleAggregator::kTempBins; bin++) {
+        if (bins[bin] == 0) continue;
+        if (static_cast<double>(below + bins[bin]) >= rank) {
+            double frac = (rank - static_cast<double>(below)) / bins[bin];
+            double value = VehicleAggregator::kTempMin + static_cast<double>(bin) + frac;
+            return std::clamp(value, min, max);
+        }
+        below += bins[bin];
+    }
+    return max;
+}
+
+VehicleSummary VehicleAggregator::make_summary(uint32_t s) const {
+    const Accumulator& a = accumulators_[s];
+    const double n = static_cast<double>(a.count);
+    const uint32_t* bins = &temp_histogram_[s * kTempBins];
+
+    VehicleSummary out;
+    out.vehicle_id = names_[s];
+    out.total_records = a.count;
+    out.first_timestamp = a.first_timestamp;
+    out.last_timestamp = a.last_timestamp;
+    out.min_speed = a.speed_min;
+    out.max_speed = a.speed_max;
+    out.avg_speed = a.speed_sum / n;
+    out.total_distance_km = a.odometer_max - a.odometer_min;
+    out.avg_fuel_level = a.fuel_sum / n;
+    out.fuel_consumed_pct = std::max(0.0, a.fuel_first - a.fuel_last);
+    out.min_engine_temp = a.temp_min;
+    out.max_engine_temp = a.temp_max;
+    out.avg_engine_temp = a.temp_sum / n;
+    out.engine_temp_p50 = histogram_percentile(bins, a.count, 0.50, a.temp_min, a.temp_max);
+    out.engine_temp_p90 = histogram_percentile(bins, a.count, 0.90, a.temp_min, a.temp_max);
+    out.engine_temp_p99 = histogram_percentile(bins, a.count, 0.99, a.temp_min, a.temp_max);
+    out.diagnostic_alerts = a.alerts;
+
+    for (const auto& [code, count] : diagnostic_counts_[s]) {
+        out.diagnostic_codes.emplace_back(diagnostic_names_[code], count);
+    }
+    std::sort(out.diagnostic_codes.begin(), out.diagnostic_codes.end(),
+              [](const auto& x, const auto& y) {
+                  return x.second != y.second ? x.second > y.second : x.first < y.first;
+              });
+    return out;
+}
+
+std::vector<VehicleSummary> VehicleAggregator::summaries() const {
+    std::vector<uint32_t> order(names_.size());
+    for (uint32_t s = 0; s < order.size(); s++) order[s] = s;
+    std::sort(order.begin(), order.end(),
+              [this](uint32_t x, uint32_t y) { return names_[x] < names_[y]; });
+
+    std::vector<VehicleSummary> out;
+    out.reserve(order.size());
+    for (uint32_t s : order) {
+        if (accumulators_[s].count != 0) out.push_back(make_summary(s));
+    }
+    return out;
+}
+
+std::optional<VehicleSummary> VehicleAggregator::summary(std::string_view vehicle_id) const {
+    auto s = find_slot(vehicle_id);
+    if (!s || accumulators_[*s].count == 0) return std::nullopt;
+    return make_summary(*s);
+}
+
+std::string summaries_to_json(const std::vector<VehicleSummary>& summaries) {
+    std::string out = "[\n";
+    for (size_t i = 0; i < summaries.size(); i++) {
+        const VehicleSummary& v = summaries[i];
+        out += i ? ",\n  {" : "  {";
+        out += "\"vehicle_id\":";
+        append_json_string(out, v.vehicle_id);
+        out += ",\"total_records\":" + std::to_string(v.total_records);
+        out += ",\"first_timestamp\":" + std::to_string(v.first_timestamp);
+        out += ",\"last_timestamp\":" + std::to_string(v.last_timestamp);
+
+        const std::pair<const char*, double> measures[] = {
+            {"min_speed", v.min_speed},
+            {"max_speed", v.max_speed},
+            {"avg_speed", v.avg_speed},
+            {"total_distance_km", v.total_distance_km},
+            {"avg_fuel_level", v.avg_fuel_level},
+            {"fuel_consumed_pct", v.fuel_consumed_pct},
+            {"min_engine_temp", v.min_engine_temp},
+            {"max_engine_temp", v.max_engine_temp},
+            {"avg_engine_temp", v.avg_engine_temp},
+            {"engine_temp_p50", v.engine_temp_p50},
+            {"engine_temp_p90", v.engine_temp_p90},
+            {"engine_temp_p99", v.engine_temp_p99},
+        };
+        for (const auto& [name, value] : measures) {
+            out += ",\"";
+            out += name;
+            out += "\":";
+            append_json_number(out, value, 2);
+        }
+
+        out += ",\"diagnostic_alerts\":" + std::to_string(v.diagnostic_alerts);
+        out += ",\"diagnostic_codes\":{";
+        for (size_t c = 0; c < v.diagnostic_codes.size(); c++) {
+            if (c) out += ',';
+            append_json_string(out, v.diagnostic_codes[c].first);
+            out += ':' + std::to_string(v.diagnostic_codes[c].second);
+        }
+        out += "}}";
+    }
+    out += summaries.empty() ? "]\n" : "\n]\n";
+    return out;
+}
+
+}  // namespace fleet
@@ -0,0 +1,135 @@
+#ifndef VEHICLE_AGGREGATOR_H
+#define VEHICLE_AGGREGATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+struct TelemetryBatch;  // telemetry_batch.h
+
+// Rollup of one vehicle's rows (the dashboard fields of the Go API's
+// TelemetrySummary, plus fuel use, temperature percentiles and codes)
+struct VehicleSummary {
+    std::string vehicle_id;
+    uint64_t total_records = 0;
+    int64_t first_timestamp = 0;    // earliest / latest Unix ms
+    int64_t last_timestamp = 0;
+    double min_speed = 0;
+    double max_speed = 0;
+    double avg_speed = 0;
+    double total_distance_km = 0;   // max - min odometer
+    double avg_fuel_level = 0;
+    double fuel_consumed_pct = 0;   // level at the earliest row minus at the latest (0 if higher)
+    double min_engine_temp = 0;
+    double max_engine_temp = 0;
+    double avg_engine_temp = 0;
+    double engine_temp_p50 = 0;     // from a 1 °C histogram, see VehicleAggregator
+    double engine_temp_p90 = 0;
+    double engine_temp_p99 = 0;
+    uint64_t diagnostic_alerts = 0; // rows with a diagnostic code
+    std::vector<std::pair<std::string, uint64_t>> diagnostic_codes;  // most frequent first
+};
+
+// In-process per-vehicle aggregation.
+//
+// Feed it parsed records or TelemetryBatches (e.g. from the streaming
+// parse_file_columnar() overload) and read summaries() at the end; no row
+// is kept. Vehicles are interned once into dense slots through a flat
+// open-addressing index, so the per-row work is one probe (or, for a
+// batch, one probe per distinct vehicle) and updates to a fixed-size
+// accumulator. Engine temperatures go into a per-vehicle histogram of
+// kTempBins 1 °C bins from kTempMin, clamped at both ends, so percentiles
+// are exact to the bin and interpolated inside it.
+//
+// Every field is independent of the order rows arrive in, so batches from
+// an unordered parallel parse, and merge() in either direction, give the
+// same summaries as a file-order pass. Not thread-safe: use one aggregator
+// per thread and merge() them.
+class VehicleAggregator {
+public:
+    static constexpr double kTempMin = -40.0;
+    static constexpr size_t kTempBins = 192;  // -40 .. 152 °C
+
+    VehicleAggregator();
+
+    void add(const TelemetryData& data);
+    void add(const TelemetryBatch& batch);
+    void merge(const VehicleAggregator& other);
+    void clear();
+
+    size_t vehicle_count() const { return names_.size(); }
+    uint64_t record_count() const { return total_records_; }
+    uint64_t diagnostic_alerts() const { return total_alerts_; }
+
+    // All vehicles sorted by ID, or one vehicle
+    std::vector<VehicleSummary> summaries() const;
+    std::optional<VehicleSummary> summary(std::string_view vehicle_id) const;
+
+private:
+    struct Accumulator {
+        uint64_t count = 0;
+        int64_t first_timestamp = 0;
+        int64_t last_timestamp = 0;
+        double speed_min = 0;
+        double speed_max = 0;
+        double speed_sum = 0;
+        double odometer_min = 0;
+        double odometer_max = 0;
+        double fuel_sum = 0;
+        double fuel_first = 0;      // level at first_timestamp (highest on a tie)
+        double fuel_last = 0;       // level at last_timestamp (lowest on a tie)
+        double temp_min = 0;
+        double temp_max = 0;
+        double temp_sum = 0;
+        uint64_t alerts = 0;
+    };
+
+    // Vehicle slot for id, created on first sight
+    uint32_t slot(std::string_view id);
+    std::optional<uint32_t> find_slot(std::string_view id) const;
+    void grow_index();
+
+    // Global code for a non-empty diagnostic code
+    uint32_t diagnostic(std::string_view code);
+    void count_diagnostic(uint32_t slot, uint32_t code, uint64_t n);
+
+    void add_row(uint32_t slot, int64_t timestamp, double speed, double odometer,
+                 double fuel, double temp);
+    // Adopt the fuel levels of an earlier first / later last sample
+    static void take_fuel_samples(Accumulator& a, int64_t first, double first_fuel,
+                                  int64_t last, double last_fuel);
+    VehicleSummary make_summary(uint32_t slot) const;
+
+    // Flat index: power-of-two table of slot + 1 (0 = empty), probed linearly
+    std::vector<uint32_t> index_;
+    std::vector<uint64_t> hashes_;            // per slot
+    std::vector<std::string> names_;          // per slot
+    std::vector<Accumulator> accumulators_;   // per slot
+    std::vector<uint32_t> temp_histogram_;    // kTempBins per slot
+    std::vector<std::vector<std::pair<uint32_t, uint64_t>>> diagnostic_counts_;  // per slot
+
+    std::vector<std::string> diagnostic_names_;
+    std::unordered_map<std::string, uint32_t> diagnostic_index_;
+
+    // Batch dictionary code -> slot / diagnostic code, rebuilt per batch
+    std::vector<uint32_t> vehicle_map_;
+    std::vector<uint32_t> diagnostic_map_;
+
+    uint64_t total_records_ = 0;
+    uint64_t total_alerts_ = 0;
+};
+
+// JSON array of summaries, one object per line
+std::string summaries_to_json(const std::vector<VehicleSummary>& summaries);
+
+}  // namespace fleet
+
+#endif  // VEHICLE_AGGREGATOR_H
@@ -0,0 +1,239 @@
+#include "window_rollup.h"
+#include "record_writer.h"
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace fleet {
+
+// ============================================================================
+// Window configuration
+// ============================================================================
+
+std::optional<int64_t> parse_window_duration(std::string_view text) {
+    int64_t value = 0;
+    auto res = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (res.ec != std::errc() || value <= 0) return std::nullopt;
+
+    std::string_view unit(res.ptr, text.data() + text.size() - res.ptr);
+    int64_t scale;
+    if (unit == "ms") scale = 1;
+    else if (unit.empty() || unit == "s") scale = 1000;
+    else if (unit == "m") scale = 60 * 1000;
+    else if (unit == "h") scale = 3600 * 1000;
+    else if (unit == "d") scale = 86400 * 1000;
+    else return std::nullopt;
+
+    if (value > std::numeric_limits<int64_t>::max() / scale) return std::nullopt;
+    return value * scale;
+}
+
+// ============================================================================
+// Window accumulation
+// ============================================================================
+
+void WindowRollup::FieldAccumulator::add(double v, bool earliest, bool latest) {
+    if (earliest) first = v;
+    if (latest) last = v;
+    if (v < min) min = v;
+    if (v > max) max = v;
+    sum += v;
+}
+
+FieldStats WindowRollup::FieldAccumulator::stats(uint64_t n) const {
+    return FieldStats{first, last, min, max, sum / static_cast<double>(n)};
+}
+
+// The position of a row counts as a fix unless it is out of range or the
+// all-zero placeholder some units send before they lock
+static bool is_gps_fix(double latitude, double longitude) {
+    return latitude >= -90.0 && latitude <= 90.0 &&
+           longitude >= -180.0 && longitude <= 180.0 &&
+           !(latitude == 0.0 && longitude == 0.0);
+}
+
+WindowRollup::WindowRollup(const WindowConfig& config, WindowFn on_window)
+    : config_(config), on_window_(std::move(on_window)) {
+    if (config_.window_ms <= 0) config_.window_ms = 60000;
+    if (config_.grace_ms < 0) config_.grace_ms = config_.window_ms;
+}
+
+int64_t WindowRollup::window_start(int64_t timestamp) const {
+    int64_t rem = timestamp % config_.window_ms;
+    if (rem < 0) rem += config_.window_ms;
+    return timestamp - rem;
+}
+
+void WindowRollup::open_window(VehicleWindow& w, int64_t start) {
+    w.open = true;
+    w.window_start = start;
+    w.records = 0;
+    w.fix_timestamp = INT64_MIN;
+    w.diagnostic_alerts = 0;
+    w.diagnostic_timestamp = INT64_MIN;
+    w.diagnostic_code.clear();
+}
+
+void WindowRollup::add(const TelemetryData& data) {
+    records_in_++;
+    const int64_t ts = data.timestamp;
+    const int64_t start = window_start(ts);
+
+    auto [it, inserted] = index_.try_emplace(std::string(data.vehicle_id),
+                                             static_cast<uint32_t>(vehicles_.size()));
+    if (inserted) {
+        vehicles_.emplace_back();
+        vehicles_.back().vehicle_id = it->first;
+    }
+    VehicleWindow& w = vehicles_[it->second];
+
+    if (w.open && start > w.window_start) close_window(w);
+
+    // Behind the open window, or in one already emitted
+    if (ts < w.closed_until || (w.open && start < w.window_start)) {
+        late_records_++;
+    } else {
+        const double values[7] = {data.speed, data.heading, static_cast<double>(data.engine_rpm),
+                                  data.fuel_level, data.odometer_km, data.engine_temp,
+                                  data.battery_volt};
+        if (!w.open) {
+            open_window(w, start);
+            w.first_timestamp = w.last_timestamp = ts;
+            for (size_t f = 0; f < 7; f++) w.fields[f].start(values[f]);
+        } else {
+            const bool earliest = ts < w.first_timestamp;
+            const bool latest = ts >= w.last_timestamp;
+            for (size_t f = 0; f < 7; f++) w.fields[f].add(values[f], earliest, latest);
+            if (earliest) w.first_timestamp = ts;
+            if (latest) w.last_timestamp = ts;
+        }
+        w.records++;
+
+        if (ts >= w.fix_timestamp && is_gps_fix(data.latitude, data.longitude)) {
+            w.latitude = data.latitude;
+            w.longitude = data.longitude;
+            w.fix_timestamp = ts;
+        }
+        if (!data.diagnostic_code.empty()) {
+            w.diagnostic_alerts++;
+            if (ts >= w.diagnostic_timestamp) {
+                w.diagnostic_code.assign(data.diagnostic_code.data(), data.diagnostic_code.size());
+                w.diagnostic_timestamp = ts;
+            }
+        }
+    }
+
+    // Close quiet vehicles' windows once per window length of data time
+    if (ts > newest_timestamp_) {
+        newest_timestamp_ = ts;
+        if (ts >= next_sweep_) {
+            advance(ts - config_.grace_ms);
+            next_sweep_ = start + config_.window_ms;
+        }
+    }
+}
+
+void WindowRollup::advance(int64_t watermark_ms) {
+    for (VehicleWindow& w : vehicles_) {
+        if (w.open && w.window_start + config_.window_ms <= watermark_ms) close_window(w);
+    }
+}
+
+void WindowRollup::flush() {
+    for (VehicleWindow& w : vehicles_) {
+        if (w.open) close_window(w);
+    }
+}
+
+void WindowRollup::close_window(VehicleWindow& w) {
+    TelemetryWindow out;
+    out.vehicle_id = w.vehicle_id;
+    out.window_start = w.window_start;
+    out.window_end = w.window_start + config_.window_ms;
+    out.records = w.records;
+    out.first_timestamp = w.first_timestamp;
+    out.last_timestamp = w.last_timestamp;
+
+    FieldStats* stats[7] = {&out.speed, &out.heading, &out.engine_rpm, &out.fuel_level,
+                            &out.odometer_km, &out.engine_temp, &out.battery_volt};
+    for (size_t f = 0; f < 7; f++) *stats[f] = w.fields[f].stats(w.records);
+
+    const bool has_fix = w.fix_timestamp != INT64_MIN;
+    out.latitude = has_fix ? w.latitude : std::numeric_limits<double>::quiet_NaN();
+    out.longitude = has_fix ? w.longitude : std::numeric_limits<double>::quiet_NaN();
+    out.fix_timestamp = has_fix ? w.fix_timestamp : 0;
+    out.diagnostic_alerts = w.diagnostic_alerts;
+    out.diagnostic_code = std::move(w.diagnostic_code);
+
+    w.open = false;
+    w.closed_until = out.window_end;
+    windows_out_++;
+    on_window_(std::move(out));
+}
+
+TelemetryData TelemetryWindow::to_record() const {
+    TelemetryData data;
+    data.vehicle_id.assign(vehicle_id.data(), vehicle_id.size());
+    data.timestamp = window_start;
+    data.latitude = latitude;
+    data.longitude = longitude;
+    data.speed = speed.mean;
+    data.heading = heading.mean;
+    data.engine_rpm = static_cast<int>(std::lround(engine_rpm.mean));
+    data.fuel_level = fuel_level.mean;
+    data.odometer_km = odometer_km.last;
+    data.engine_temp = engine_temp.mean;
+    data.battery_volt = battery_volt.mean;
+    data.diagnostic_code.assign(diagnostic_code.data(), diagnostic_code.size());
+    return data;
+}
+
+// ============================================================================
+// JSON output
+// ============================================================================
+
+static void append_field(std::string& out, const char* name, const FieldStats& s) {
+    out += ",\"";
+    out += name;
+    out += "\":{\"first\":";
+    append_json_number(out, s.first, 2);
+    out += ",\"last\":";
+    append_json_number(out, s.last, 2);
+    out += ",\"min\":";
+    append_json_number(out, s.min, 2);
+    out += ",\"max\":";
+    append_json_number(out, s.max, 2);
+    out += ",\"mean\":";
+    append_json_number(out, s.mean, 2);
+    out += '}';
+}
+
+void append_json(std::string& out, const TelemetryWindow& w) {
+    out += "{\"vehicle_id\":";
+    append_json_string(out, w.vehicle_id);
+    out += ",\"window_start\":" + std::to_string(w.window_start);
+    out += ",\"window_end\":" + std::to_string(w.window_end);
+    out += ",\"records\":" + std::to_string(w.records);
+    out += ",\"first_timestamp\":" + std::to_string(w.first_timestamp);
+    out += ",\"last_timestamp\":" + std::to_string(w.last_timestamp);
+    out += ",\"latitude\":";
+    append_json_number(out, w.latitude, 6);
+    out += ",\"longitude\":";
+    append_json_number(out, w.longitude, 6);
+    out += ",\"fix_timestamp\":" + std::to_string(w.fix_timestamp);
+    append_field(out, "speed", w.speed);
+    append_field(out, "heading", w.heading);
+    append_field(out, "engine_rpm", w.engine_rpm);
+    append_field(out, "fuel_level", w.fuel_level);
+    append_field(out, "odometer_km", w.odometer_km);
+    append_field(out, "engine_temp", w.engine_temp);
+    append_field(out, "battery_volt", w.battery_volt);
+    out += ",\"diagnostic_alerts\":" + std::to_string(w.diagnostic_alerts);
+    if (!w.diagnostic_code.empty()) {
+        out += ",\"diagnostic_code\":";
+        append_json_string(out, w.diagnostic_code);
+    }
+    out += '}';
+}
+
+}  // namespace fleet
@@ -0,0 +1,148 @@
+#ifndef WINDOW_ROLLUP_H
+#define WINDOW_ROLLUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "telemetry_parser.h"
+
+namespace fleet {
+
+// first / last (by timestamp), min, max and mean of one field over a window
+struct FieldStats {
+    double first = 0;
+    double last = 0;
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+};
+
+// One vehicle's rows inside one tumbling window [window_start, window_end)
+struct TelemetryWindow {
+    std::string vehicle_id;
+    int64_t window_start = 0;       // Unix ms, a multiple of the window length
+    int64_t window_end = 0;
+    uint64_t records = 0;
+    int64_t first_timestamp = 0;
+    int64_t last_timestamp = 0;
+
+    FieldStats speed;
+    FieldStats heading;
+    FieldStats engine_rpm;
+    FieldStats fuel_level;
+    FieldStats odometer_km;
+    FieldStats engine_temp;
+    FieldStats battery_volt;
+
+    // Latest in-range, non-zero position (NaN if the window had none)
+    double latitude = 0;
+    double longitude = 0;
+    int64_t fix_timestamp = 0;
+
+    uint64_t diagnostic_alerts = 0;  // rows with a diagnostic code
+    std::string diagnostic_code;     // the latest one
+
+    // One record standing for the window, for record-oriented outputs such
+    // as BinaryWriter: stamped at window_start, at the last fix, with the
+    // mean of each measurement except the odometer (last reading); the
+    // diagnostic code is the latest one
+    TelemetryData to_record() const;
+};
+
+struct WindowConfig {
+    int64_t window_ms = 60000;
+    // A vehicle that goes quiet has its window closed once the newest
+    // timestamp seen from any vehicle passes the window end by grace_ms
+    // (< 0: one window length)
+    int64_t grace_ms = -1;
+};
+
+// Window length from "500ms", "30s", "5m", "1h", "1d" (a bare number is
+// seconds); nullopt if malformed or not positive
+std::optional<int64_t> parse_window_duration(std::string_view text);
+
+// Incremental tumbling-window downsampler.
+//
+// add() records as they are parsed (any order across vehicles, roughly in
+// time order per vehicle); every finished window is handed to on_window.
+// A window closes when its vehicle sends a row for a later window, when
+// the data clock passes it (see WindowConfig::grace_ms), or at flush().
+// Rows older than a vehicle's last closed window are counted as late and
+// dropped. Works the same for whole files, streaming and follow mode.
+class WindowRollup {
+public:
+    using WindowFn = std::function<void(TelemetryWindow&&)>;
+
+    WindowRollup(const WindowConfig& config, WindowFn on_window);
+
+    void add(const TelemetryData& data);
+
+    // Close every window ending at or before watermark_ms
+    void advance(int64_t watermark_ms);
+
+    // Close every open window (end of input)
+    void flush();
+
+    uint64_t records_in() const { return records_in_; }
+    uint64_t windows_out() const { return windows_out_; }
+    uint64_t late_records() const { return late_records_; }
+
+private:
+    struct FieldAccumulator {
+        double first = 0;
+        double last = 0;
+        double min = 0;
+        double max = 0;
+        double sum = 0;
+
+        void start(double v) { first = last = min = max = sum = v; }
+        void add(double v, bool earliest, bool latest);
+        FieldStats stats(uint64_t n) const;
+    };
+
+    struct VehicleWindow {
+        std::string vehicle_id;
+        bool open = false;
+        int64_t window_start = 0;
+        int64_t closed_until = INT64_MIN;  // end of the last emitted window
+        uint64_t records = 0;
+        int64_t first_timestamp = 0;
+        int64_t last_timestamp = 0;
+        FieldAccumulator fields[7];        // speed .. battery_volt, as in TelemetryWindow
+        double latitude = 0;
+        double longitude = 0;
+        int64_t fix_timestamp = INT64_MIN;
+        uint64_t diagnostic_alerts = 0;
+        int64_t diagnostic_timestamp = INT64_MIN;
+        std::string diagnostic_code;
+    };
+
+    void open_window(VehicleWindow& w, int64_t start);
+    void close_window(VehicleWindow& w);
+    int64_t window_start(int64_t timestamp) const;
+
+    WindowConfig config_;
+    WindowFn on_window_;
+
+    std::unordered_map<std::string, uint32_t> index_;
+    std::vector<VehicleWindow> vehicles_;
+
+    int64_t newest_timestamp_ = INT64_MIN;
+    int64_t next_sweep_ = INT64_MIN;
+
+    uint64_t records_in_ = 0;
+    uint64_t windows_out_ = 0;
+    uint64_t late_records_ = 0;
+};
+
+// JSON object for one window (the layout of RecordWriter::write(window))
+void append_json(std::string& out, const TelemetryWindow& window);
+
+}  // namespace fleet
+
+#endif  // WINDOW_ROLLUP_H
@@ -0,0 +1,360 @@
+package parser
+
+import (
+	"bytes"
+	"encoding/binary"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"io"
+	"math"
+	"net"
+	"strings"
+	"sync"
+	"time"
+
+	"fleet-telemetry-monitor/internal/models"
+)
+
+// Wire protocol of a resident `fleet_parser --serve <socket>` process.
+// See cpp-parser/parse_server.h for the frame layouts.
+const (
+	nativeRequestMagic  = 0x51524A46 // "FJRQ"
+	nativeResponseMagic = 0x53524A46 // "FJRS"
+	nativeChunkMagic    = 0x43524A46 // "FJRC"
+	nativeHeaderSize    = 24
+	nativeChunkSize     = 8
+	nativeMaxChunk      = 1 << 20
+
+	opPing        = 0
+	opParsePath   = 1
+	opParseInline = 2
+	opShutdown    = 3
+)
+
+// ResultFormat selects what the native parser sends back for a parse job
+type ResultFormat uint8
+
+const (
+	ResultStatsOnly ResultFormat = 0
+	ResultBinary    ResultFormat = 1 // FLET v2 file image, see DecodeBinary
+	ResultNDJSON    ResultFormat = 2
+	ResultCSV       ResultFormat = 3
+	ResultJSON      ResultFormat = 4
+)
+
+// NativeStats mirrors the C++ ParseStats
+type NativeStats struct {
+	TotalLines       int64   `json:"total_lines"`
+	ValidRecords     int64   `json:"valid_records"`
+	InvalidRecords   int64   `json:"invalid_records"`
+	MalformedRecords int64   `json:"malformed_records"`
+	BytesProcessed   int64   `json:"bytes_processed"`
+	ParseTimeMs      float64 `json:"parse_time_ms"`
+	RecordsPerSecond float64 `json:"records_per_second"`
+
+	// Invalid rows keyed by the rule they broke ("malformed", "latitude", ...)
+	Rejected map[string]int64 `json:"rejected,omitempty"`
+	// Per-stage counters keyed by stage ("read", "split", "decode",
+	// "validate", "emit"); only reported by FLEET_PROFILE builds
+	Profile map[string]NativeStageStats `json:"profile,omitempty"`
+}
+
+// NativeStageStats is one pipeline stage of a profiled parse
+type NativeStageStats struct {
+	Ticks       uint64  `json:"ticks"`
+	Ms          float64 `json:"ms"`
+	Calls       uint64  `json:"calls"`
+	Bytes       uint64  `json:"bytes"`
+	Allocations uint64  `json:"allocations"`
+}
+
+// NativeResult is the reply to one parse job
+type NativeResult struct {
+	Stats  NativeStats
+	Format ResultFormat
+	Body   []byte
+}
+
+// NativeOptions tunes a single parse job; the zero value uses the server defaults
+type NativeOptions struct {
+	NoHeader   bool
+	NoValidate bool
+	Delimiter  byte
+	Threads    uint32
+}
+
+// NativeClient sends parse jobs to a resident C++ parser over a Unix socket,
+// avoiding a process start per request. Requests on one client are serialized.
+type NativeClient struct {
+	mu   sync.Mutex
+	conn net.Conn
+}
+
+// DialNative connects to a parser started with `fleet_parser --serve socketPath`
+func DialNative(socketPath string) (*NativeClient, error) {
+	conn, err := net.Dial("unix", socketPath)
+	if err != nil {
+		return nil, fmt.Errorf("failed to connect to native parser: %w", err)
+	}
+	return &NativeClient{conn: conn}, nil
+}
+
+// Close closes the connection
+func (c *NativeClient) Close() error {
+	return c.conn.Close()
+}
+
+// Ping checks that the server is answering
+func (c *NativeClient) Ping() error {
+	_, err := c.roundTrip(opPing, 0, ResultStatsOnly, NativeOptions{}, nil, io.Discard)
+	return err
+}
+
+// ParseFile asks the server to parse a file it can read (format: csv, log or binary)
+func (c *NativeClient) ParseFile(path, format string, result ResultFormat, opts NativeOptions) (*NativeResult, error) {
+	var body bytes.Buffer
+	res, err := c.ParseFileTo(path, format, result, opts, &body)
+	if err != nil {
+		return nil, err
+	}
+	res.Body = body.Bytes()
+	return res, nil
+}
+
+// ParseFileTo is ParseFile with the body copied to w as the server streams
+// it, so large results are never held in memory. If the job fails part way
+// through, w has already received a partial body that must be discarded.
+func (c *NativeClient) ParseFileTo(path, format string, result ResultFormat, opts NativeOptions, w io.Writer) (*NativeResult, error) {
+	input, err := nativeInputFormat(format)
+	if err != nil {
+		return nil, err
+	}
+	return c.roundTrip(opParsePath, input, result, opts, []byte(path), w)
+}
+
+// ParseInline sends CSV or log text to be parsed
+func (c *NativeClient) ParseInline(data []byte, format string, result ResultFormat, opts NativeOptions) (*NativeResult, error) {
+	input, err := nativeInputFormat(format)
+	if err != nil {
+		return nil, err
+	}
+	var body bytes.Buffer
+	res, err := c.roundTrip(opParseInline, input, result, opts, data, &body)
+	if err != nil {
+		return nil, err
+	}
+	res.Body = body.Bytes()
+	return res, nil
+}
+
+// Shutdown asks the server process to exit
+func (c *NativeClient) Shutdown() error {
+	_, err := c.roundTrip(opShutdown, 0, ResultStatsOnly, NativeOptions{}, nil, io.Discard)
+	return err
+}
+
+func nativeInputFormat(format string) (uint8, error) {
+	switch strings.ToLower(format) {
+	case "csv":
+		return 0, nil
+	case "log":
+		return 1, nil
+	case "binary":
+		return 2, nil
+	default:
+		return 0, fmt.Errorf("unsupported format: %s", format)
+	}
+}
+
+func (c *NativeClient) roundTrip(op, input uint8, result ResultFormat, opts NativeOptions, payload []byte, body io.Writer) (*NativeResult, error) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	var flags uint8
+	if opts.NoHeader {
+		flags |= 1
+	}
+	if opts.NoValidate {
+		flags |= 2
+	}
+
+	header := make([]byte, nativeHeaderSize)
+	binary.LittleEndian.PutUint32(header[0:], nativeRequestMagic)
+	header[4] = op
+	header[5] = input
+	header[6] = uint8(result)
+	header[7] = flags
+	header[8] = 0 // codec: raw blocks, readable by DecodeBinary
+	header[9] = opts.Delimiter
+	binary.LittleEndian.PutUint32(header[12:], opts.Threads)
+	binary.LittleEndian.PutUint64(header[16:], uint64(len(payload)))
+	if _, err := c.conn.Write(append(header, payload...)); err != nil {
+		return nil, fmt.Errorf("failed to send request: %w", err)
+	}
+
+	// Body chunks come first, then the response header and stats
+	sink := &stickyWriter{w: body}
+	var streamed uint64
+	for {
+		if _, err := io.ReadFull(c.conn, header[:nativeChunkSize]); err != nil {
+			return nil, fmt.Errorf("failed to read response: %w", err)
+		}
+		if binary.LittleEndian.Uint32(header[0:]) != nativeChunkMagic {
+			break
+		}
+		size := binary.LittleEndian.Uint32(header[4:])
+		if size > nativeMaxChunk {
+			return nil, errors.New("bad response from native parser")
+		}
+		if _, err := io.CopyN(sink, c.conn, int64(size)); err != nil {
+			return nil, fmt.Errorf("failed to read response: %w", err)
+		}
+		streamed += uint64(size)
+	}
+	if _, err := io.ReadFull(c.conn, header[nativeChunkSize:]); err != nil {
+		return nil, fmt.Errorf("failed to read response: %w", err)
+	}
+	if binary.LittleEndian.Uint32(header[0:]) != nativeResponseMagic {
+		return nil, errors.New("bad response from native parser")
+	}
+	status := header[4]
+	res := &NativeResult{Format: ResultFormat(header[5])}
+	statsSize := binary.LittleEndian.Uint32(header[8:])
+	if binary.LittleEndian.Uint64(header[16:]) != streamed {
+		return nil, errors.New("bad response from native parser")
+	}
+
+	stats := make([]byte, statsSize)
+	if _, err := io.ReadFull(c.conn, stats); err != nil {
+		return nil, fmt.Errorf("failed to read response: %w", err)
+	}
+
+	if status != 0 {
+		return nil, fmt.Errorf("native parser: %s", stats)
+	}
+	if sink.err != nil {
+		return nil, fmt.Errorf("failed to write result: %w", sink.err)
+	}
+	if len(stats) > 0 {
+		if err := json.Unmarshal(stats, &res.Stats); err != nil {
+			return nil, fmt.Errorf("failed to decode parse stats: %w", err)
+		}
+	}
+	return res, nil
+}
+
+// stickyWriter keeps the connection in frame when the body writer fails:
+// the rest of the body is read and dropped, and the first error is kept
+type stickyWriter struct {
+	w   io.Writer
+	err error
+}
+
+func (s *stickyWriter) Write(p []byte) (int, error) {
+	if s.err == nil {
+		_, s.err = s.w.Write(p)
+	}
+	return len(p), nil
+}
+
+// DecodeBinary converts an uncompressed FLET v2 image (ResultBinary) into records
+func DecodeBinary(data []byte) ([]models.TelemetryData, error) {
+	const (
+		fileHeaderSize  = 64
+		blockHeaderSize = 64
+		indexEntrySize  = 48
+		trailerSize     = 40
+		recordSize      = 88
+	)
+	corrupt := errors.New("corrupt binary result")
+	le := binary.LittleEndian
+
+	if len(data) < fileHeaderSize+trailerSize || le.Uint32(data) != 0x464C4554 || data[4] != 2 {
+		return nil, corrupt
+	}
+	trailer := data[len(data)-trailerSize:]
+	if le.Uint32(trailer[36:]) != 0x58444E49 {
+		return nil, corrupt
+	}
+	vehicleDict := le.Uint64(trailer[0:])
+	diagDict := le.Uint64(trailer[8:])
+	indexOffset := le.Uint64(trailer[16:])
+	recordCount := le.Uint64(trailer[24:])
+	blockCount := uint64(le.Uint32(trailer[32:]))
+	if vehicleDict > diagDict || diagDict > indexOffset ||
+		indexOffset+blockCount*indexEntrySize > uint64(len(data)-trailerSize) {
+		return nil, corrupt
+	}
+
+	vehicles, err := decodeDictionary(data[vehicleDict:diagDict])
+	if err != nil {
+		return nil, err
+	}
+	diagnostics, err := decodeDictionary(data[diagDict:indexOffset])
+	if err != nil {
+		return nil, err
+	}
+
+	f64 := func(b []byte) float64 { return math.Float64frombits(le.Uint64(b)) }
+	records := make([]models.TelemetryData, 0, recordCount)
+	for i := uint64(0); i < blockCount; i++ {
+		entry := data[indexOffset+i*indexEntrySize:]
+		offset := le.Uint64(entry[0:])
+		count := uint64(le.Uint32(entry[8:]))
+		if entry[12] != 0 {
+			return nil, errors.New("compressed binary blocks are not supported")
+		}
+		start := offset + blockHeaderSize
+		if start+count*recordSize > vehicleDict {
+			return nil, corrupt
+		}
+		for r := uint64(0); r < count; r++ {
+			rec := data[start+r*recordSize:]
+			vehicle := le.Uint32(rec[76:])
+			diag := le.Uint32(rec[80:])
+			if int(vehicle) >= len(vehicles) || int(diag) >= len(diagnostics) {
+				return nil, corrupt
+			}
+			records = append(records, models.TelemetryData{
+				Timestamp:      time.UnixMilli(int64(le.Uint64(rec[0:]))),
+				Latitude:       f64(rec[8:]),
+				Longitude:      f64(rec[16:]),
+				Speed:          f64(rec[24:]),
+				Heading:        f64(rec[32:]),
+				FuelLevel:      f64(rec[40:]),
+				OdometerKM:     f64(rec[48:]),
+				EngineTemp:     f64(rec[56:]),
+				BatteryVolt:    f64(rec[64:]),
+				EngineRPM:      int(int32(le.Uint32(rec[72:]))),
+				VehicleID:      vehicles[vehicle],
+				DiagnosticCode: diagnostics[diag],
+			})
+		}
+	}
+	return records, nil
+}
+
+// Dictionary: uint32 count, uint32 reserved, uint32 offsets[count+1], bytes
+func decodeDictionary(b []byte) ([]string, error) {
+	corrupt := errors.New("corrupt binary result")
+	if len(b) < 8 {
+		return nil, corrupt
+	}
+	count := uint64(binary.LittleEndian.Uint32(b))
+	offsetsEnd := 8 + (count+1)*4
+	if offsetsEnd > uint64(len(b)) {
+		return nil, corrupt
+	}
+	bytes := b[offsetsEnd:]
+	out := make([]string, count)
+	for i := uint64(0); i < count; i++ {
+		lo := binary.LittleEndian.Uint32(b[8+i*4:])
+		hi := binary.LittleEndian.Uint32(b[12+i*4:])
+		if lo > hi || uint64(hi) > uint64(len(bytes)) {
+			return nil, corrupt
+		}
+		out[i] = string(bytes[lo:hi])
+	}
+	return out, nil
+}
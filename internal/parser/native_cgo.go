@@ -0,0 +1,173 @@
+//go:build cgo && fleet_native
+
+package parser
+
+/*
+#cgo CFLAGS: -I${SRCDIR}/../../cpp-parser
+#cgo LDFLAGS: -L${SRCDIR}/../../cpp-parser/build -lfleet_parser
+#include <stdlib.h>
+#include "fleet_capi.h"
+
+// cgo may not store Go pointers in C memory, so the column pointers are
+// passed as arguments and the descriptor is built on the C stack
+static int fleet_parse_into(fleet_parser* p, const char* data, size_t size, int at_start,
+                            size_t capacity, size_t* rows, size_t* consumed,
+                            int64_t* timestamp, double* latitude, double* longitude,
+                            double* speed, double* heading, int32_t* engine_rpm,
+                            double* fuel_level, double* odometer_km, double* engine_temp,
+                            double* battery_volt, uint32_t* vehicle_id, uint32_t* diagnostic_code) {
+	fleet_columns out = {capacity, *rows, timestamp, latitude, longitude, speed, heading,
+	                     engine_rpm, fuel_level, odometer_km, engine_temp, battery_volt,
+	                     vehicle_id, diagnostic_code};
+	int rc = fleet_parse(p, data, size, at_start, &out, consumed);
+	*rows = out.size;
+	return rc;
+}
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"strings"
+	"unsafe"
+)
+
+// Columns holds parsed telemetry as typed slices; VehicleID and
+// DiagnosticCode index into Vehicles and Diagnostics ("" = code 0)
+type Columns struct {
+	Timestamp      []int64 // Unix milliseconds
+	Latitude       []float64
+	Longitude      []float64
+	Speed          []float64
+	Heading        []float64
+	EngineRPM      []int32
+	FuelLevel      []float64
+	OdometerKM     []float64
+	EngineTemp     []float64
+	BatteryVolt    []float64
+	VehicleID      []uint32
+	DiagnosticCode []uint32
+	Vehicles       []string
+	Diagnostics    []string
+	Stats          NativeStats
+}
+
+// Len returns the number of parsed rows
+func (c *Columns) Len() int {
+	return len(c.Timestamp)
+}
+
+// ParseColumnsNative decodes CSV or log text with the in-process C++
+// parser (libfleet_parser.so) straight into Go-allocated column slices
+func ParseColumnsNative(data []byte, format string, opts NativeOptions) (*Columns, error) {
+	var options C.fleet_options
+	C.fleet_options_init(&options)
+	switch strings.ToLower(format) {
+	case "csv":
+		options.format = C.FLEET_FORMAT_CSV
+	case "log":
+		options.format = C.FLEET_FORMAT_LOG
+	default:
+		return nil, fmt.Errorf("unsupported format: %s", format)
+	}
+	if opts.NoHeader {
+		options.has_header = 0
+	}
+	if opts.NoValidate {
+		options.validate = 0
+	}
+	if opts.Delimiter != 0 {
+		options.delimiter = C.char(opts.Delimiter)
+	}
+
+	p := C.fleet_parser_create(&options)
+	if p == nil {
+		return nil, errors.New("failed to create native parser")
+	}
+	defer C.fleet_parser_destroy(p)
+
+	cols := &Columns{}
+	if len(data) == 0 {
+		return cols, nil
+	}
+	src := (*C.char)(unsafe.Pointer(&data[0]))
+	n := int(C.fleet_row_capacity(src, C.size_t(len(data))))
+	cols.Timestamp = make([]int64, n)
+	cols.Latitude = make([]float64, n)
+	cols.Longitude = make([]float64, n)
+	cols.Speed = make([]float64, n)
+	cols.Heading = make([]float64, n)
+	cols.EngineRPM = make([]int32, n)
+	cols.FuelLevel = make([]float64, n)
+	cols.OdometerKM = make([]float64, n)
+	cols.EngineTemp = make([]float64, n)
+	cols.BatteryVolt = make([]float64, n)
+	cols.VehicleID = make([]uint32, n)
+	cols.DiagnosticCode = make([]uint32, n)
+
+	var rows, consumed C.size_t
+	rc := C.fleet_parse_into(p, src, C.size_t(len(data)), 1, C.size_t(n), &rows, &consumed,
+		(*C.int64_t)(unsafe.Pointer(&cols.Timestamp[0])),
+		(*C.double)(unsafe.Pointer(&cols.Latitude[0])),
+		(*C.double)(unsafe.Pointer(&cols.Longitude[0])),
+		(*C.double)(unsafe.Pointer(&cols.Speed[0])),
+		(*C.double)(unsafe.Pointer(&cols.Heading[0])),
+		(*C.int32_t)(unsafe.Pointer(&cols.EngineRPM[0])),
+		(*C.double)(unsafe.Pointer(&cols.FuelLevel[0])),
+		(*C.double)(unsafe.Pointer(&cols.OdometerKM[0])),
+		(*C.double)(unsafe.Pointer(&cols.EngineTemp[0])),
+		(*C.double)(unsafe.Pointer(&cols.BatteryVolt[0])),
+		(*C.uint32_t)(unsafe.Pointer(&cols.VehicleID[0])),
+		(*C.uint32_t)(unsafe.Pointer(&cols.DiagnosticCode[0])))
+	if rc != 0 {
+		return nil, fmt.Errorf("native parser: %s", C.GoString(C.fleet_last_error(p)))
+	}
+
+	m := int(rows)
+	cols.Timestamp = cols.Timestamp[:m]
+	cols.Latitude = cols.Latitude[:m]
+	cols.Longitude = cols.Longitude[:m]
+	cols.Speed = cols.Speed[:m]
+	cols.Heading = cols.Heading[:m]
+	cols.EngineRPM = cols.EngineRPM[:m]
+	cols.FuelLevel = cols.FuelLevel[:m]
+	cols.OdometerKM = cols.OdometerKM[:m]
+	cols.EngineTemp = cols.EngineTemp[:m]
+	cols.BatteryVolt = cols.BatteryVolt[:m]
+	cols.VehicleID = cols.VehicleID[:m]
+	cols.DiagnosticCode = cols.DiagnosticCode[:m]
+
+	cols.Vehicles = dictionary(p, C.fleet_vehicle_count(p), func(code C.uint32_t, length *C.size_t) *C.char {
+		return C.fleet_vehicle(p, code, length)
+	})
+	cols.Diagnostics = dictionary(p, C.fleet_diagnostic_count(p), func(code C.uint32_t, length *C.size_t) *C.char {
+		return C.fleet_diagnostic(p, code, length)
+	})
+
+	var stats C.fleet_stats
+	C.fleet_get_stats(p, &stats)
+	cols.Stats = NativeStats{
+		TotalLines:       int64(stats.total_lines),
+		ValidRecords:     int64(stats.valid_records),
+		InvalidRecords:   int64(stats.invalid_records),
+		MalformedRecords: int64(stats.malformed_records),
+		BytesProcessed:   int64(stats.bytes_processed),
+		ParseTimeMs:      float64(stats.parse_time_ms),
+	}
+	if cols.Stats.ParseTimeMs > 0 {
+		cols.Stats.RecordsPerSecond = float64(cols.Stats.ValidRecords) / cols.Stats.ParseTimeMs * 1000
+	}
+	return cols, nil
+}
+
+func dictionary(p *C.fleet_parser, count C.uint32_t, entry func(C.uint32_t, *C.size_t) *C.char) []string {
+	out := make([]string, int(count))
+	for i := range out {
+		var length C.size_t
+		if s := entry(C.uint32_t(i), &length); s != nil {
+			out[i] = C.GoStringN(s, C.int(length))
+		}
+	}
+	return out
+}